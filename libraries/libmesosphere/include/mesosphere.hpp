@@ -84,6 +84,10 @@
 #include <mesosphere/kern_k_object_name.hpp>
 #include <mesosphere/kern_k_unsafe_memory.hpp>
 #include <mesosphere/kern_k_scoped_resource_reservation.hpp>
+#include <mesosphere/kern_k_swap_manager.hpp>
+#include <mesosphere/kern_k_lru_tracker.hpp>
+#include <mesosphere/kern_k_huge_page_compactor.hpp>
+#include <mesosphere/kern_k_zeroed_block_worker.hpp>
 
 /* Supervisor Calls. */
 #include <mesosphere/kern_svc.hpp>
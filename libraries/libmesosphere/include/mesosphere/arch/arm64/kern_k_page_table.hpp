@@ -105,6 +105,7 @@ namespace ams::kern::arch::arm64 {
             Result OperateImpl(PageLinkedList *page_list, KProcessAddress virt_addr, size_t num_pages, KPhysicalAddress phys_addr, bool is_pa_valid, const KPageProperties properties, OperationType operation, bool reuse_ll);
             Result OperateImpl(PageLinkedList *page_list, KProcessAddress virt_addr, size_t num_pages, const KPageGroup &page_group, const KPageProperties properties, OperationType operation, bool reuse_ll);
             void FinalizeUpdateImpl(PageLinkedList *page_list);
+            bool FindSwappedPageImpl(KProcessAddress *out_address, u64 *out_swap_offset, KProcessAddress address, size_t size);
 
             KPageTableManager &GetPageTableManager() const { return *m_manager; }
         private:
@@ -176,6 +177,10 @@ namespace ams::kern::arch::arm64 {
 
                 return entry;
             }
+
+            PageTableEntry GetSwapInEntryTemplate(KProcessAddress virt_addr) const {
+                return this->GetEntryTemplate(this->GetSwapInProperties(virt_addr));
+            }
         public:
             constexpr explicit KPageTable(util::ConstantInitializeTag) : KPageTableBase(util::ConstantInitialize), m_manager(), m_asid() { /* ... */ }
             explicit KPageTable() { /* ... */ }
@@ -204,10 +209,26 @@ namespace ams::kern::arch::arm64 {
             bool GetEntry(PageTableEntry *out, KProcessAddress virt_addr) const;
             Result MarkAsSwapped(KProcessAddress virt_addr, u64 sector_offset);
             Result MarkAsResident(KProcessAddress virt_addr, KPhysicalAddress phys_addr);
-            Result MarkAsResidentAndWake(KProcessAddress virt_addr, KPhysicalAddress phys_addr, KThread *thread);
-            Result EmergencyRevertSwap();
-            Result MarkAsSwappedEvict(KProcessAddress virt_addr, u64 sector_offset);
-            bool IsAppletRegion(KProcessAddress virt_addr) const;
+            Result MarkAsResidentAndWake(KProcessAddress virt_addr, KPhysicalAddress *phys_addr, KThread *thread);
+            size_t GetSwappedRunLength(KProcessAddress virt_addr, size_t max_pages);
+            size_t MarkRangeAsResidentAndWake(KProcessAddress virt_addr, u64 sector_offset, KPhysicalAddress *phys_addrs, size_t num_pages, KThread *thread);
+            size_t GetSwappedPages(ams::svc::SwapPageInfo *out_infos, KProcessAddress address, KProcessAddress end_address, size_t max_count);
+            size_t GetResidentPages(u64 *out_addresses, KProcessAddress address, KProcessAddress end_address, size_t max_count);
+            size_t RestoreSwappedPages(const ams::svc::SwapPageInfo *infos, KPhysicalAddress *phys_addrs, size_t num_pages);
+            Result MarkAsSwappedEvict(u64 process_id, KProcessAddress virt_addr, bool clean, PageLinkedList *page_list);
+            Result EvictSwapPages(size_t *out_num_evicted, u64 process_id, KProcessAddress address, size_t num_pages);
+            bool CompleteSwapEviction(u32 eviction_id, KProcessAddress virt_addr, KPhysicalAddress phys_addr, u64 sector_offset, bool written);
+            bool RelocateSwappedPage(KProcessAddress virt_addr, u64 old_offset, u64 new_offset);
+            bool CancelSwapEviction(u64 process_id, KProcessAddress virt_addr);
+
+            using AccessFlagSweepCallback = void (*)(KProcessAddress virt_addr, bool accessed, void *arg);
+
+            void SweepAccessFlags(KProcessAddress address, size_t size, AccessFlagSweepCallback callback, void *arg);
+            bool RestoreAccessFlag(KProcessAddress virt_addr);
+            bool RestoreAccessFlagWithoutLock(KProcessAddress virt_addr);
+
+            KProcessAddress FindHugePageCandidate(KProcessAddress address, KProcessAddress end_address);
+            Result PromoteHugePage(KProcessAddress address, u32 allocate_option);
 
             static void NoteUpdatedCallback(const void *pt) {
                 /* Note the update. */
@@ -227,6 +248,10 @@ namespace ams::kern::arch::arm64 {
             Result SeparatePagesImpl(TraversalEntry *entry, TraversalContext *context, KProcessAddress virt_addr, size_t block_size, PageLinkedList *page_list, bool reuse_ll);
             Result SeparatePages(KProcessAddress virt_addr, size_t num_pages, PageLinkedList *page_list, bool reuse_ll);
 
+            Result SeparatePageForSwap(TraversalEntry *entry, TraversalContext *context, KProcessAddress virt_addr, PageLinkedList *page_list);
+            void MergeResidentPages(KProcessAddress virt_addr, size_t num_pages, PageLinkedList *page_list);
+            PageTableEntry *GetHugePageCandidateEntries(KProcessAddress address);
+
             Result ChangePermissions(KProcessAddress virt_addr, size_t num_pages, PageTableEntry entry_template, DisableMergeAttribute disable_merge_attr, bool refresh_mapping, bool flush_mapping, PageLinkedList *page_list, bool reuse_ll);
 
             static ALWAYS_INLINE void PteDataMemoryBarrier() {
@@ -81,6 +81,8 @@ namespace ams::kern::arch::arm64 {
                 SoftwareReservedBit_Valid                   = (1u << 3),
                 SoftwareReservedBit_Swapped                 = (1u << 4),
                 SoftwareReservedBit_Dirty                   = (1u << 5),
+                SoftwareReservedBit_SwapPending             = (1u << 6),
+                SoftwareReservedBit_Promoting               = (1u << 7),
             };
 
             static constexpr ALWAYS_INLINE std::underlying_type<SoftwareReservedBit>::type EncodeSoftwareReservedBits(bool head, bool head_body, bool tail) {
@@ -93,6 +95,9 @@ namespace ams::kern::arch::arm64 {
                 ExtensionFlag_DisableMergeTail        = (static_cast<u64>(SoftwareReservedBit_DisableMergeHeadTail)    << 55),
                 ExtensionFlag_Valid                   = (static_cast<u64>(SoftwareReservedBit_Valid)                   << 55),
                 ExtensionFlag_Swapped                 = (static_cast<u64>(SoftwareReservedBit_Swapped)                 << 55),
+                ExtensionFlag_Dirty                   = (static_cast<u64>(SoftwareReservedBit_Dirty)                   << 55),
+                ExtensionFlag_SwapPending             = (static_cast<u64>(SoftwareReservedBit_SwapPending)             << 55),
+                ExtensionFlag_Promoting               = (static_cast<u64>(SoftwareReservedBit_Promoting)               << 55),
 
                 ExtensionFlag_ValidAndMapped = (ExtensionFlag_Valid | MappingFlag_Mapped),
                 ExtensionFlag_TestTableMask  = (ExtensionFlag_Valid | (1ul << 1)),
@@ -178,9 +183,11 @@ namespace ams::kern::arch::arm64 {
                 }
             }
         public:
-            constexpr ALWAYS_INLINE u8 GetSoftwareReservedBits()            const { return this->GetBits(55, 6); }
-            constexpr ALWAYS_INLINE bool IsSwapped()                        const { return this->GetBits(52, 1) != 0; }
+            constexpr ALWAYS_INLINE u8 GetSoftwareReservedBits()            const { return this->GetBits(55, 8); }
+            constexpr ALWAYS_INLINE bool IsSwapped()                        const { return (this->GetSoftwareReservedBits() & SoftwareReservedBit_Swapped) != 0; }
+            constexpr ALWAYS_INLINE bool IsSwapPending()                    const { return (this->GetSoftwareReservedBits() & SoftwareReservedBit_SwapPending) != 0; }
             constexpr ALWAYS_INLINE bool IsDirty()                          const { return (this->GetSoftwareReservedBits() & SoftwareReservedBit_Dirty) != 0; }
+            constexpr ALWAYS_INLINE bool IsPromoting()                      const { return (this->GetSoftwareReservedBits() & SoftwareReservedBit_Promoting) != 0; }
             constexpr ALWAYS_INLINE bool IsHeadMergeDisabled()              const { return (this->GetSoftwareReservedBits() & SoftwareReservedBit_DisableMergeHead) != 0; }
             constexpr ALWAYS_INLINE bool IsHeadAndBodyMergeDisabled()       const { return (this->GetSoftwareReservedBits() & SoftwareReservedBit_DisableMergeHeadAndBody) != 0; }
             constexpr ALWAYS_INLINE bool IsTailMergeDisabled()              const { return (this->GetSoftwareReservedBits() & SoftwareReservedBit_DisableMergeHeadTail) != 0; }
@@ -223,8 +230,9 @@ namespace ams::kern::arch::arm64 {
             constexpr ALWAYS_INLINE decltype(auto) SetUserAccessible(bool en)         { this->SetBit(6, en); return *this; }
             constexpr ALWAYS_INLINE decltype(auto) SetPageAttribute(PageAttribute a)  { this->SetBitsDirect(2, 3, a); return *this; }
             constexpr ALWAYS_INLINE decltype(auto) SetMapped(bool m)                  { static_assert(static_cast<u64>(MappingFlag_Mapped == (1 << 0))); this->SetBit(0, m); return *this; }
-            constexpr ALWAYS_INLINE decltype(auto) SetSwapped(bool en)                { this->SetBit(52, en); return *this; }
+            constexpr ALWAYS_INLINE decltype(auto) SetSwapped(bool en)                { this->SetBit(59, en); return *this; }
             constexpr ALWAYS_INLINE decltype(auto) SetDirty(bool en)                  { this->SetBit(60, en); return *this; }
+            constexpr ALWAYS_INLINE decltype(auto) SetSwapPending(bool en)            { this->SetBit(61, en); return *this; }
 
             constexpr ALWAYS_INLINE u64 GetSwapOffset() const { return this->GetBits(12, 36); }
             constexpr ALWAYS_INLINE decltype(auto) SetSwapOffset(u64 offset) { this->SetBits(12, 36, offset); return *this; }
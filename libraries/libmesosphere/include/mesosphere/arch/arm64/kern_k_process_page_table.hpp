@@ -218,6 +218,34 @@ namespace ams::kern::arch::arm64 {
                 R_RETURN(m_page_table.UnlockForCodeMemory(address, size, pg));
             }
 
+            void OpenSwapHold() {
+                return m_page_table.OpenSwapHold();
+            }
+
+            void CloseSwapHold() {
+                return m_page_table.CloseSwapHold();
+            }
+
+            Result MakeResident(KProcessAddress address, size_t size) {
+                R_RETURN(m_page_table.MakeResident(address, size));
+            }
+
+            Result LockForSwapFaultRing(KPhysicalAddress *out, KProcessAddress address) {
+                R_RETURN(m_page_table.LockForSwapFaultRing(out, address));
+            }
+
+            Result UnlockForSwapFaultRing(KProcessAddress address) {
+                R_RETURN(m_page_table.UnlockForSwapFaultRing(address));
+            }
+
+            Result MapSwapInFrames(KProcessAddress *out_address, const KPageGroup &pg) {
+                R_RETURN(m_page_table.MapSwapInFrames(out_address, pg));
+            }
+
+            Result UnmapSwapInFrames(KPhysicalAddress *out_phys_addrs, KProcessAddress address, size_t num_pages) {
+                R_RETURN(m_page_table.UnmapSwapInFrames(out_phys_addrs, address, num_pages));
+            }
+
             Result OpenMemoryRangeForProcessCacheOperation(KPageTableBase::MemoryRange *out, KProcessAddress address, size_t size) {
                 R_RETURN(m_page_table.OpenMemoryRangeForProcessCacheOperation(out, address, size));
             }
@@ -297,6 +325,7 @@ namespace ams::kern::arch::arm64 {
             bool Contains(KProcessAddress addr, size_t size) const { return m_page_table.Contains(addr, size); }
 
             bool IsInAliasRegion(KProcessAddress addr, size_t size) const { return m_page_table.IsInAliasRegion(addr, size); }
+            bool IsInSwappableRegion(KProcessAddress addr, size_t size) const { return m_page_table.IsInSwappableRegion(addr, size); }
             bool IsInUnsafeAliasRegion(KProcessAddress addr, size_t size) const { return m_page_table.IsInUnsafeAliasRegion(addr, size); }
 
             bool CanContain(KProcessAddress addr, size_t size, KMemoryState state) const { return m_page_table.CanContain(addr, size, state); }
@@ -309,6 +338,8 @@ namespace ams::kern::arch::arm64 {
             KProcessAddress GetKernelMapRegionStart() const { return m_page_table.GetKernelMapRegionStart(); }
             KProcessAddress GetAliasCodeRegionStart() const { return m_page_table.GetAliasCodeRegionStart(); }
 
+            KProcessAddress GetProcessCodeRegionStart() const { return m_page_table.GetProcessCodeRegionStart(); }
+
             size_t GetAddressSpaceSize()    const { return m_page_table.GetAddressSpaceSize(); }
             size_t GetHeapRegionSize()      const { return m_page_table.GetHeapRegionSize(); }
             size_t GetAliasRegionSize()     const { return m_page_table.GetAliasRegionSize(); }
@@ -316,6 +347,8 @@ namespace ams::kern::arch::arm64 {
             size_t GetKernelMapRegionSize() const { return m_page_table.GetKernelMapRegionSize(); }
             size_t GetAliasCodeRegionSize() const { return m_page_table.GetAliasCodeRegionSize(); }
 
+            size_t GetProcessCodeRegionSize() const { return m_page_table.GetProcessCodeRegionSize(); }
+
             size_t GetAliasRegionExtraSize() const { return m_page_table.GetAliasRegionExtraSize(); }
 
             size_t GetNormalMemorySize() const { return m_page_table.GetNormalMemorySize(); }
@@ -361,8 +394,8 @@ namespace ams::kern::arch::arm64 {
                 return m_page_table.GetEntry(out, virt_addr);
             }
 
-            bool IsInsideAliasRegion(KProcessAddress addr) const {
-                return m_page_table.IsInAliasRegion(addr, PageSize);
+            bool IsInsideSwappableRegion(KProcessAddress addr) const {
+                return m_page_table.IsInSwappableRegion(addr, PageSize);
             }
     }; // <--- Ensure this semicolon and brace are here to close the class KProcessPageTable
 
@@ -90,4 +90,21 @@ namespace ams::kern::arch::arm64 {
         );
     }
 
+    template<typename T> requires SlabHeapNode<T>
+    ALWAYS_INLINE void FreeListToSlabAtomic(T **head, T *first, T *last) {
+        u32 tmp;
+        T *next;
+
+        __asm__ __volatile__(
+            "1:\n"
+            "    ldaxr  %[next], [%[head]]\n"
+            "    str    %[next], [%[last]]\n"
+            "    stlxr  %w[tmp], %[first], [%[head]]\n"
+            "    cbnz   %w[tmp], 1b\n"
+            : [tmp]"=&r"(tmp), [first]"+&r"(first), [last]"+&r"(last), [next]"=&r"(next), [head]"+&r"(head)
+            :
+            : "cc", "memory"
+        );
+    }
+
 }
@@ -78,6 +78,19 @@ namespace ams::kern {
                         return true;
                     }
 
+                    ALWAYS_INLINE bool TryOpen() {
+                        /* Atomically increment the reference count, only if it's positive, without auditing that it is. */
+                        u32 cur = m_value.Load<std::memory_order_relaxed>();
+                        do {
+                            if (AMS_UNLIKELY(cur == 0)) {
+                                return false;
+                            }
+                            MESOSPHERE_ABORT_UNLESS(cur < cur + 1);
+                        } while (AMS_UNLIKELY(!m_value.CompareExchangeWeak<std::memory_order_relaxed>(cur, cur + 1)));
+
+                        return true;
+                    }
+
                     ALWAYS_INLINE bool Close() {
                         /* Atomically decrement the reference count, not allowing it to decrement past zero. */
                         u32 cur = m_value.Load<std::memory_order_relaxed>();
@@ -183,6 +196,15 @@ namespace ams::kern {
                 return m_ref_count.Open();
             }
 
+            /* NOTE: Unlike Open, this may be called on an object which is being destroyed, or whose slab slot is free, */
+            /* by a caller which found the object without holding a reference to it, and will check that it's the       */
+            /* object it was looking for once it has opened it.                                                         */
+            ALWAYS_INLINE bool TryOpen() {
+                MESOSPHERE_ASSERT_THIS();
+
+                return m_ref_count.TryOpen();
+            }
+
             MESOSPHERE_ALWAYS_INLINE_IF_RELEASE void Close() {
                 MESOSPHERE_ASSERT_THIS();
 
@@ -257,6 +279,10 @@ namespace ams::kern {
                 }
             }
 
+            constexpr ALWAYS_INLINE KScopedAutoObject(T *o, std::adopt_lock_t) : m_obj(o) {
+                /* The caller has already opened a reference to the object, which we take over. */
+            }
+
             ALWAYS_INLINE ~KScopedAutoObject() {
                 if (m_obj != nullptr) {
                     m_obj->Close();
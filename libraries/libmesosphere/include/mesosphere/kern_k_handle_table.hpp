@@ -64,15 +64,16 @@ namespace ams::kern {
             EntryInfo m_entry_infos[MaxTableSize];
             KAutoObject *m_objects[MaxTableSize];
             mutable KSpinLock m_lock;
+            util::Atomic<u32> m_sequence;
             s32 m_free_head_index;
             u16 m_table_size;
             u16 m_max_count;
             u16 m_next_linear_id;
             u16 m_count;
         public:
-            constexpr explicit KHandleTable(util::ConstantInitializeTag) : m_entry_infos(), m_objects(), m_lock(), m_free_head_index(-1), m_table_size(), m_max_count(), m_next_linear_id(), m_count() { /* ... */ }
+            constexpr explicit KHandleTable(util::ConstantInitializeTag) : m_entry_infos(), m_objects(), m_lock(), m_sequence(0), m_free_head_index(-1), m_table_size(), m_max_count(), m_next_linear_id(), m_count() { /* ... */ }
 
-            explicit KHandleTable() : m_lock(), m_free_head_index(-1), m_table_size(), m_max_count(), m_next_linear_id(), m_count() { MESOSPHERE_ASSERT_THIS(); }
+            explicit KHandleTable() : m_lock(), m_sequence(0), m_free_head_index(-1), m_table_size(), m_max_count(), m_next_linear_id(), m_count() { MESOSPHERE_ASSERT_THIS(); }
 
             MESOSPHERE_NOINLINE_IF_DEBUG Result Initialize(s32 size) {
                 MESOSPHERE_ASSERT_THIS();
@@ -83,6 +84,7 @@ namespace ams::kern {
                 /* Lock. */
                 KScopedDisableDispatch dd;
                 KScopedSpinLock lk(m_lock);
+                KScopedUpdate up(this);
 
                 /* Initialize all fields. */
                 m_max_count       = 0;
@@ -110,19 +112,8 @@ namespace ams::kern {
 
             template<typename T = KAutoObject>
             ALWAYS_INLINE KScopedAutoObject<T> GetObjectWithoutPseudoHandle(ams::svc::Handle handle) const {
-                /* Lock and look up in table. */
-                KScopedDisableDispatch dd;
-                KScopedSpinLock lk(m_lock);
-
-                if constexpr (std::is_same<T, KAutoObject>::value) {
-                    return this->GetObjectImpl(handle);
-                } else {
-                    if (auto *obj = this->GetObjectImpl(handle); AMS_LIKELY(obj != nullptr)) {
-                        return obj->DynamicCast<T*>();
-                    } else {
-                        return nullptr;
-                    }
-                }
+                /* Look up and open the object, casting it to the desired type. */
+                return KScopedAutoObject<KAutoObject>(this->OpenObject(handle), std::adopt_lock);
             }
 
             template<typename T = KAutoObject>
@@ -148,12 +139,9 @@ namespace ams::kern {
             }
 
             KScopedAutoObject<KAutoObject> GetObjectForIpcWithoutPseudoHandle(ams::svc::Handle handle) const {
-                /* Lock and look up in table. */
-                KScopedDisableDispatch dd;
-                KScopedSpinLock lk(m_lock);
-
-                KAutoObject *obj = this->GetObjectImpl(handle);
-                if (AMS_LIKELY(obj != nullptr)) {
+                /* Look up and open the object. */
+                KScopedAutoObject<KAutoObject> obj(this->OpenObject(handle), std::adopt_lock);
+                if (AMS_LIKELY(obj.IsNotNull())) {
                     if (AMS_UNLIKELY(obj->DynamicCast<KInterruptEvent *>() != nullptr)) {
                         return nullptr;
                     }
@@ -195,30 +183,24 @@ namespace ams::kern {
             ALWAYS_INLINE bool GetMultipleObjects(T **out, const ams::svc::Handle *handles, size_t num_handles) const {
                 /* Try to convert and open all the handles. */
                 size_t num_opened;
-                {
-                    /* Lock the table. */
-                    KScopedDisableDispatch dd;
-                    KScopedSpinLock lk(m_lock);
-                    for (num_opened = 0; num_opened < num_handles; num_opened++) {
-                        /* Get the current handle. */
-                        const auto cur_handle = handles[num_opened];
-
-                        /* Get the object for the current handle. */
-                        KAutoObject *cur_object = this->GetObjectImpl(cur_handle);
-                        if (AMS_UNLIKELY(cur_object == nullptr)) {
-                            break;
-                        }
-
-                        /* Cast the current object to the desired type. */
-                        T *cur_t = cur_object->DynamicCast<T*>();
-                        if (AMS_UNLIKELY(cur_t == nullptr)) {
-                            break;
-                        }
-
-                        /* Open a reference to the current object. */
-                        cur_t->Open();
-                        out[num_opened] = cur_t;
+                for (num_opened = 0; num_opened < num_handles; num_opened++) {
+                    /* Get the current handle. */
+                    const auto cur_handle = handles[num_opened];
+
+                    /* Get and open the object for the current handle. */
+                    KAutoObject *cur_object = this->OpenObject(cur_handle);
+                    if (AMS_UNLIKELY(cur_object == nullptr)) {
+                        break;
                     }
+
+                    /* Cast the current object to the desired type. */
+                    T *cur_t = cur_object->DynamicCast<T*>();
+                    if (AMS_UNLIKELY(cur_t == nullptr)) {
+                        cur_object->Close();
+                        break;
+                    }
+
+                    out[num_opened] = cur_t;
                 }
 
                 /* If we converted every object, succeed. */
@@ -234,6 +216,72 @@ namespace ams::kern {
                 return false;
             }
         private:
+            /* NOTE: Updates to the table are made under the lock, and bracketed by making the sequence odd and then even again. */
+            /* Lookups don't take the lock. Instead, they open the object they find, then check that the sequence was even and */
+            /* is unchanged, which means the table held its reference to the object throughout. The object might not be the   */
+            /* one found otherwise, but objects are only ever freed back to their slab heap, so opening one is harmless: it    */
+            /* fails once the object is destroyed, and otherwise the lookup closes it again and retries under the lock.       */
+            class KScopedUpdate {
+                NON_COPYABLE(KScopedUpdate);
+                NON_MOVEABLE(KScopedUpdate);
+                private:
+                    KHandleTable *m_table;
+                public:
+                    explicit ALWAYS_INLINE KScopedUpdate(KHandleTable *table) : m_table(table) {
+                        /* Make the sequence odd, before we change any entry. */
+                        m_table->m_sequence.Store<std::memory_order_relaxed>(m_table->m_sequence.Load<std::memory_order_relaxed>() + 1);
+                        cpu::DataMemoryBarrierInnerShareableStore();
+                    }
+
+                    ALWAYS_INLINE ~KScopedUpdate() {
+                        /* Make the sequence even, once we've changed every entry. */
+                        m_table->m_sequence.Store<std::memory_order_release>(m_table->m_sequence.Load<std::memory_order_relaxed>() + 1);
+                    }
+            };
+
+            ALWAYS_INLINE bool TryOpenObjectLockFree(KAutoObject **out, ams::svc::Handle handle) const {
+                /* Get the sequence; if it's odd, the table is being updated. */
+                const u32 sequence = m_sequence.Load<std::memory_order_acquire>();
+                if (AMS_UNLIKELY((sequence & 1) != 0)) {
+                    return false;
+                }
+
+                /* Look up the object, and try to open it. */
+                KAutoObject *obj = this->GetObjectImpl(handle);
+                if (obj != nullptr && AMS_UNLIKELY(!obj->TryOpen())) {
+                    return false;
+                }
+
+                /* Check that the table wasn't updated while we looked. */
+                cpu::DataMemoryBarrierInnerShareable();
+                if (AMS_UNLIKELY(m_sequence.Load<std::memory_order_relaxed>() != sequence)) {
+                    if (obj != nullptr) {
+                        obj->Close();
+                    }
+                    return false;
+                }
+
+                *out = obj;
+                return true;
+            }
+
+            ALWAYS_INLINE KAutoObject *OpenObject(ams::svc::Handle handle) const {
+                KScopedDisableDispatch dd;
+
+                /* Try to look up the object without taking the lock. */
+                if (KAutoObject *obj; AMS_LIKELY(this->TryOpenObjectLockFree(std::addressof(obj), handle))) {
+                    return obj;
+                }
+
+                /* We raced with an update to the table, so look up the object under the lock. */
+                KScopedSpinLock lk(m_lock);
+
+                KAutoObject *obj = this->GetObjectImpl(handle);
+                if (obj != nullptr) {
+                    obj->Open();
+                }
+                return obj;
+            }
 
             constexpr ALWAYS_INLINE s32 AllocateEntry() {
                 MESOSPHERE_ASSERT_THIS();
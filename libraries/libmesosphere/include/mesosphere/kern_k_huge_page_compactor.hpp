@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <mesosphere/kern_common.hpp>
+
+namespace ams::kern {
+
+    class KProcess;
+
+    /* NOTE: Compaction relies on the access flag to detect writes during a copy, so it runs on the lru sweeper's thread. */
+    class KHugePageCompactor {
+        public:
+            static constexpr size_t MaxPromotionsPerPass = 4;
+            static constexpr size_t MinPoolFreeSize      = 64_MB;
+        public:
+            static void CompactProcess(KProcess *process);
+    };
+
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <mesosphere/kern_common.hpp>
+#include <mesosphere/kern_k_typed_address.hpp>
+#include <mesosphere/svc/kern_svc_k_user_pointer.hpp>
+
+namespace ams::kern {
+
+    class KProcess;
+
+    class KLRUTracker {
+        public:
+            static constexpr size_t MaxTrackedProcesses = 8;
+            static constexpr size_t MaxCandidates       = 0x4000;
+            static constexpr s32 SweeperThreadPriority  = 60;
+        public:
+            static NOINLINE void Initialize();
+
+            static void SweepProcess(KProcess *process);
+            static Result GetCandidates(s32 *out_count, ams::kern::svc::KUserPointer<u64 *> out_addresses, u64 process_id, s32 max_count);
+    };
+
+}
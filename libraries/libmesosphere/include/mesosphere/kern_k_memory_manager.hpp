@@ -16,6 +16,7 @@
 #pragma once
 #include <mesosphere/kern_common.hpp>
 #include <mesosphere/kern_k_light_lock.hpp>
+#include <mesosphere/kern_k_spin_lock.hpp>
 #include <mesosphere/kern_k_memory_layout.hpp>
 #include <mesosphere/kern_k_page_heap.hpp>
 
@@ -49,7 +50,33 @@ namespace ams::kern {
                 Direction_Mask  = (0xF << Direction_Shift),
             };
 
+            /* NOTE: Callers holding a lock which sys-swap needs to reclaim memory must not wait for it to do so. */
+            enum AllocateFlag {
+                AllocateFlag_None          = 0,
+                AllocateFlag_NoReclaimWait = (1 << 8),
+            };
+
             static constexpr size_t MaxManagerCount = 10;
+
+            /* NOTE: Each pool keeps a reservoir of blocks which KZeroedBlockWorker has already cleared, so that */
+            /* zero-filled allocations can skip clearing them. Reservoir blocks still count as free memory.     */
+            static constexpr size_t ZeroedBlockSize     = 2_MB;
+            static constexpr size_t ZeroedBlockNumPages = ZeroedBlockSize / PageSize;
+            static constexpr size_t MaxZeroedBlocks     = 0x100;
+
+            /* NOTE: Each core also keeps a cache of free pages for each pool, so that single page allocations can usually be */
+            /* served without taking the pool lock. Caches are refilled from and drained to the heap a batch at a time, and   */
+            /* are drained entirely whenever the heap can't satisfy an allocation. Cached pages still count as free memory,   */
+            /* and a count of them is kept per pool so that free memory can be measured without visiting every core.         */
+            static constexpr size_t PageCacheCapacity  = 64;
+            static constexpr size_t PageCacheBatchSize = 16;
+        private:
+            struct alignas(cpu::DataCacheLineSize) PageCache {
+                mutable KSpinLock lock;
+                size_t count;
+                KPhysicalAddress pages[PageCacheCapacity];
+                KPageBitmap::RandomBitGenerator rng;
+            };
         private:
             class Impl {
                 private:
@@ -96,6 +123,9 @@ namespace ams::kern {
                     constexpr size_t GetPageOffset(KPhysicalAddress address)      const { return m_heap.GetPageOffset(address); }
                     constexpr size_t GetPageOffsetToEnd(KPhysicalAddress address) const { return m_heap.GetPageOffsetToEnd(address); }
 
+                    /* NOTE: Single pages are closed without the pool lock, so every reference count update must be atomic. */
+                    util::AtomicRef<RefCount> GetReferenceCount(size_t index) const { return util::AtomicRef<RefCount>(m_page_reference_counts[index]); }
+
                     constexpr void SetNext(Impl *n) { m_next = n; }
                     constexpr void SetPrev(Impl *n) { m_prev = n; }
                     constexpr Impl *GetNext() const { return m_next; }
@@ -105,7 +135,7 @@ namespace ams::kern {
                         size_t index = this->GetPageOffset(address);
                         const size_t end = index + num_pages;
                         while (index < end) {
-                            const RefCount ref_count = (++m_page_reference_counts[index]);
+                            const RefCount ref_count = this->GetReferenceCount(index).FetchAdd(1) + 1;
                             MESOSPHERE_ABORT_UNLESS(ref_count == 1);
 
                             index++;
@@ -116,13 +146,20 @@ namespace ams::kern {
                         size_t index = this->GetPageOffset(address);
                         const size_t end = index + num_pages;
                         while (index < end) {
-                            const RefCount ref_count = (++m_page_reference_counts[index]);
+                            const RefCount ref_count = this->GetReferenceCount(index).FetchAdd(1) + 1;
                             MESOSPHERE_ABORT_UNLESS(ref_count > 1);
 
                             index++;
                         }
                     }
 
+                    bool CloseWithoutFree(KPhysicalAddress address) {
+                        const RefCount ref_count = this->GetReferenceCount(this->GetPageOffset(address)).FetchSub(1);
+                        MESOSPHERE_ABORT_UNLESS(ref_count > 0);
+
+                        return ref_count == 1;
+                    }
+
                     void Close(KPhysicalAddress address, size_t num_pages) {
                         size_t index = this->GetPageOffset(address);
                         const size_t end = index + num_pages;
@@ -130,8 +167,9 @@ namespace ams::kern {
                         size_t free_start = 0;
                         size_t free_count = 0;
                         while (index < end) {
-                            MESOSPHERE_ABORT_UNLESS(m_page_reference_counts[index] > 0);
-                            const RefCount ref_count = (--m_page_reference_counts[index]);
+                            const RefCount prev_count = this->GetReferenceCount(index).FetchSub(1);
+                            MESOSPHERE_ABORT_UNLESS(prev_count > 0);
+                            const RefCount ref_count = prev_count - 1;
 
                             /* Keep track of how many zero refcounts we see in a row, to minimize calls to free. */
                             if (ref_count == 0) {
@@ -165,6 +203,10 @@ namespace ams::kern {
             u64 m_optimized_process_ids[Pool_Count];
             bool m_has_optimized_process[Pool_Count];
             s32 m_min_heap_indexes[Pool_Count];
+            KPhysicalAddress m_zeroed_blocks[Pool_Count][MaxZeroedBlocks];
+            size_t m_num_zeroed_blocks[Pool_Count];
+            PageCache m_page_caches[cpu::NumCores][Pool_Count];
+            util::Atomic<size_t> m_num_cached_pages[Pool_Count];
         private:
             Impl &GetManager(KPhysicalAddress address) {
                 return m_managers[KMemoryLayout::GetPhysicalLinearRegion(address).GetAttributes()];
@@ -186,10 +228,22 @@ namespace ams::kern {
                 }
             }
 
-            Result AllocatePageGroupImpl(KPageGroup *out, size_t num_pages, Pool pool, Direction dir, bool unoptimized, bool random, s32 min_heap_index);
+            Result AllocatePageGroupImpl(KPageGroup *out, size_t *out_num_zeroed_pages, size_t num_pages, Pool pool, Direction dir, bool unoptimized, bool random, s32 min_heap_index);
+            Result AllocateAndOpenImpl(KPageGroup *out, size_t *out_num_zeroed_pages, size_t num_pages, size_t align_pages, u32 option);
+
+            size_t GetHeapFreePagesLocked(Pool pool) const;
+            void ReleaseZeroedBlocksLocked(Pool pool);
+            size_t GetReclaimPagesLocked(Pool pool) const;
+
+            KPhysicalAddress AllocatePageFromCache(Pool pool, bool random);
+            void FreePageToCache(KPhysicalAddress address, Pool pool);
+            void DrainPageCachesLocked(Pool pool);
+            size_t GetCachedPages(Pool pool) const { return m_num_cached_pages[pool].Load(); }
+
+            void ClosePage(KPhysicalAddress address);
         public:
             KMemoryManager()
-                : m_pool_locks(), m_pool_managers_head(), m_pool_managers_tail(), m_managers(), m_num_managers(), m_optimized_process_ids(), m_has_optimized_process(), m_min_heap_indexes()
+                : m_pool_locks(), m_pool_managers_head(), m_pool_managers_tail(), m_managers(), m_num_managers(), m_optimized_process_ids(), m_has_optimized_process(), m_min_heap_indexes(), m_zeroed_blocks(), m_num_zeroed_blocks(), m_page_caches(), m_num_cached_pages()
             {
                 /* ... */
             }
@@ -201,12 +255,20 @@ namespace ams::kern {
 
             NOINLINE KPhysicalAddress AllocateAndOpenContinuous(size_t num_pages, size_t align_pages, u32 option);
             NOINLINE Result AllocateAndOpen(KPageGroup *out, size_t num_pages, size_t align_pages, u32 option);
+            NOINLINE Result AllocateAndOpenWithFill(KPageGroup *out, size_t num_pages, size_t align_pages, u32 option, u8 fill_pattern);
             NOINLINE Result AllocateForProcess(KPageGroup *out, size_t num_pages, u32 option, u64 process_id, u8 fill_pattern);
 
+            bool RefillZeroedBlock(Pool pool);
+
             Pool GetPool(KPhysicalAddress address) const {
                 return this->GetManager(address).GetPool();
             }
 
+            size_t GetReferenceCount(KPhysicalAddress address) const {
+                const auto &manager = this->GetManager(address);
+                return manager.GetReferenceCount(manager.GetPageOffset(address)).Load();
+            }
+
             void Open(KPhysicalAddress address, size_t num_pages) {
                 /* Repeatedly open references until we've done so for all pages. */
                 while (num_pages) {
@@ -240,6 +302,11 @@ namespace ams::kern {
             }
 
             void Close(KPhysicalAddress address, size_t num_pages) {
+                /* Single pages are freed to the current core's page cache, rather than to the heap. */
+                if (num_pages == 1) {
+                    return this->ClosePage(address);
+                }
+
                 /* Repeatedly close references until we've done so for all pages. */
                 while (num_pages) {
                     auto &manager = this->GetManager(address);
@@ -278,6 +345,11 @@ namespace ams::kern {
                     KScopedLightLock lk(m_pool_locks[m_managers[i].GetPool()]);
                     total += m_managers[i].GetFreeSize();
                 }
+                for (size_t i = 0; i < Pool_Count; i++) {
+                    KScopedLightLock lk(m_pool_locks[i]);
+                    total += m_num_zeroed_blocks[i] * ZeroedBlockSize;
+                    total += this->GetCachedPages(static_cast<Pool>(i)) * PageSize;
+                }
                 return total;
             }
 
@@ -285,7 +357,7 @@ namespace ams::kern {
                 KScopedLightLock lk(m_pool_locks[pool]);
 
                 constexpr Direction GetSizeDirection = Direction_FromFront;
-                size_t total = 0;
+                size_t total = m_num_zeroed_blocks[pool] * ZeroedBlockSize + this->GetCachedPages(pool) * PageSize;
                 for (auto *manager = this->GetFirstManager(pool, GetSizeDirection); manager != nullptr; manager = this->GetNextManager(manager, GetSizeDirection)) {
                     total += manager->GetFreeSize();
                 }
@@ -321,6 +393,10 @@ namespace ams::kern {
                 return static_cast<Direction>((option & Direction_Mask) >> Direction_Shift);
             }
 
+            static constexpr ALWAYS_INLINE bool CanWaitForReclaim(u32 option) {
+                return (option & AllocateFlag_NoReclaimWait) == 0;
+            }
+
             static constexpr ALWAYS_INLINE std::tuple<Pool, Direction> DecodeOption(u32 option) {
                 return std::make_tuple(GetPool(option), GetDirection(option));
             }
@@ -174,6 +174,29 @@ namespace ams::kern {
 
                     PageLinkedList *GetPageList() { return std::addressof(m_ll); }
             };
+        public:
+            class KScopedSwapHold {
+                private:
+                    KPageTableBase *m_pt;
+                public:
+                    ALWAYS_INLINE explicit KScopedSwapHold(KPageTableBase *pt) : m_pt(pt) { m_pt->OpenSwapHold(); }
+                    ALWAYS_INLINE explicit KScopedSwapHold(KPageTableBase &pt) : KScopedSwapHold(std::addressof(pt)) { /* ... */ }
+                    ALWAYS_INLINE ~KScopedSwapHold() { m_pt->CloseSwapHold(); }
+            };
+
+            class KScopedResidentPage {
+                private:
+                    KPageTableBase *m_pt;
+                    KPhysicalAddress m_phys_addr;
+                public:
+                    ALWAYS_INLINE explicit KScopedResidentPage(KPageTableBase &pt) : m_pt(std::addressof(pt)), m_phys_addr(Null<KPhysicalAddress>) { /* ... */ }
+                    ALWAYS_INLINE ~KScopedResidentPage() { m_pt->CloseResidentPage(m_phys_addr); }
+
+                    Result Open(KProcessAddress address) {
+                        MESOSPHERE_ASSERT(m_phys_addr == Null<KPhysicalAddress>);
+                        R_RETURN(m_pt->OpenResidentPage(std::addressof(m_phys_addr), address));
+                    }
+            };
         private:
             KProcessAddress m_address_space_start;
             KProcessAddress m_address_space_end;
@@ -184,12 +207,15 @@ namespace ams::kern {
             KProcessAddress m_alias_code_region_end;
             KProcessAddress m_code_region_start;
             KProcessAddress m_code_region_end;
+            KProcessAddress m_process_code_start;
+            KProcessAddress m_process_code_end;
             size_t m_max_heap_size;
             size_t m_mapped_physical_memory_size;
             size_t m_mapped_unsafe_physical_memory;
             size_t m_mapped_insecure_memory;
             size_t m_mapped_ipc_server_memory;
             size_t m_alias_region_extra_size;
+            u32 m_swap_hold_count;
             mutable KLightLock m_general_lock;
             mutable KLightLock m_map_physical_memory_lock;
             KLightLock m_device_map_lock;
@@ -200,6 +226,7 @@ namespace ams::kern {
             bool m_is_kernel;
             bool m_enable_aslr;
             bool m_enable_device_address_space_merge;
+            bool m_is_code_modified;
             KMemoryBlockSlabManager *m_memory_block_slab_manager;
             KBlockInfoManager *m_block_info_manager;
             KResourceLimit *m_resource_limit;
@@ -215,9 +242,10 @@ namespace ams::kern {
                   m_region_ends{Null<KProcessAddress>, Null<KProcessAddress>, Null<KProcessAddress>, Null<KProcessAddress>},
                   m_current_heap_end(Null<KProcessAddress>), m_alias_code_region_start(Null<KProcessAddress>),
                   m_alias_code_region_end(Null<KProcessAddress>), m_code_region_start(Null<KProcessAddress>), m_code_region_end(Null<KProcessAddress>),
-                  m_max_heap_size(), m_mapped_physical_memory_size(), m_mapped_unsafe_physical_memory(), m_mapped_insecure_memory(), m_mapped_ipc_server_memory(), m_alias_region_extra_size(),
+                  m_process_code_start(Null<KProcessAddress>), m_process_code_end(Null<KProcessAddress>),
+                  m_max_heap_size(), m_mapped_physical_memory_size(), m_mapped_unsafe_physical_memory(), m_mapped_insecure_memory(), m_mapped_ipc_server_memory(), m_alias_region_extra_size(), m_swap_hold_count(),
                   m_general_lock(), m_map_physical_memory_lock(), m_device_map_lock(), m_impl(util::ConstantInitialize), m_memory_block_manager(util::ConstantInitialize),
-                  m_allocate_option(), m_address_space_width(), m_is_kernel(), m_enable_aslr(), m_enable_device_address_space_merge(),
+                  m_allocate_option(), m_address_space_width(), m_is_kernel(), m_enable_aslr(), m_enable_device_address_space_merge(), m_is_code_modified(),
                   m_memory_block_slab_manager(), m_block_info_manager(), m_resource_limit(), m_cached_physical_linear_region(), m_cached_physical_heap_region(),
                   m_heap_fill_value(), m_ipc_fill_value(), m_stack_fill_value()
             {
@@ -246,6 +274,20 @@ namespace ams::kern {
                 return this->Contains(addr, size) && m_region_starts[RegionType_Alias] <= addr && addr + size - 1 <= m_region_ends[RegionType_Alias] - 1;
             }
 
+            constexpr bool IsInHeapRegion(KProcessAddress addr, size_t size) const {
+                return this->Contains(addr, size) && m_region_starts[RegionType_Heap] <= addr && addr + size - 1 <= m_region_ends[RegionType_Heap] - 1;
+            }
+
+            constexpr bool IsInProcessCodeRegion(KProcessAddress addr, size_t size) const {
+                return this->Contains(addr, size) && m_process_code_start <= addr && addr + size - 1 <= m_process_code_end - 1;
+            }
+
+            constexpr bool IsInSwappableRegion(KProcessAddress addr, size_t size) const {
+                /* Heap memory may be swapped either where it was allocated, or where it has been aliased. */
+                /* The process's own code may additionally be discarded, as the loader can reproduce it.  */
+                return this->IsInHeapRegion(addr, size) || this->IsInAliasRegion(addr, size) || this->IsInProcessCodeRegion(addr, size);
+            }
+
             bool IsInUnsafeAliasRegion(KProcessAddress addr, size_t size) const {
                 /* Even though Unsafe physical memory is KMemoryState_Normal, it must be mapped inside the alias code region. */
                 return this->CanContain(addr, size, ams::svc::MemoryState_AliasCode);
@@ -270,6 +312,7 @@ namespace ams::kern {
             Result Operate(PageLinkedList *page_list, KProcessAddress virt_addr, size_t num_pages, KPhysicalAddress phys_addr, bool is_pa_valid, const KPageProperties properties, OperationType operation, bool reuse_ll);
             Result Operate(PageLinkedList *page_list, KProcessAddress virt_addr, size_t num_pages, const KPageGroup &page_group, const KPageProperties properties, OperationType operation, bool reuse_ll);
             void FinalizeUpdate(PageLinkedList *page_list);
+            bool FindSwappedPage(KProcessAddress *out_address, u64 *out_swap_offset, KProcessAddress address, size_t size);
 
             ALWAYS_INLINE KPageTableImpl &GetImpl() { return m_impl; }
             ALWAYS_INLINE const KPageTableImpl &GetImpl() const { return m_impl; }
@@ -309,6 +352,47 @@ namespace ams::kern {
             ALWAYS_INLINE bool ContainsPages(KProcessAddress addr, size_t num_pages) const {
                 return (m_address_space_start <= addr) && (num_pages <= (m_address_space_end - m_address_space_start) / PageSize) && (addr + num_pages * PageSize - 1 <= m_address_space_end - 1);
             }
+
+            size_t GetNumPagesToBlockEnd(KProcessAddress addr) const {
+                MESOSPHERE_ASSERT(this->IsLockedByCurrentThread());
+
+                const KMemoryBlock *block = m_memory_block_manager.FindBlock(addr);
+                return block != nullptr ? (block->GetEndAddress() - addr) / PageSize : 0;
+            }
+
+            KPageProperties GetSwapInProperties(KProcessAddress addr) const {
+                MESOSPHERE_ASSERT(this->IsLockedByCurrentThread());
+
+                /* A block's permission and attributes may change while its pages are swapped out, so pages are restored with the current ones. */
+                const KMemoryBlock *block = m_memory_block_manager.FindBlock(addr);
+                MESOSPHERE_ABORT_UNLESS(block != nullptr);
+
+                return { block->GetPermission(), false, (block->GetAttribute() & KMemoryAttribute_Uncached) != 0, DisableMergeAttribute_None };
+            }
+
+            bool IsSwapHeld() const {
+                MESOSPHERE_ASSERT(this->IsLockedByCurrentThread());
+
+                return m_swap_hold_count != 0;
+            }
+
+            Result CheckMemoryStateForSwap(KProcessAddress addr, size_t size) const {
+                /* Only unlocked, user read-write memory which the process owns exclusively (its heap and data) may be swapped out. */
+                /* Other reference counted memory may be shared with another process, or mapped from one, e.g. as an alias or stack. */
+                R_SUCCEED_IF(R_SUCCEEDED(this->CheckMemoryState(addr, size, KMemoryState_All, KMemoryState_Normal, KMemoryPermission_UserReadWrite, KMemoryPermission_UserReadWrite, KMemoryAttribute_All, KMemoryAttribute_None, KMemoryAttribute_None)));
+                R_RETURN(this->CheckMemoryState(addr, size, KMemoryState_All, KMemoryState_CodeData, KMemoryPermission_UserReadWrite, KMemoryPermission_UserReadWrite, KMemoryAttribute_All, KMemoryAttribute_None, KMemoryAttribute_None));
+            }
+
+            Result CheckMemoryStateForHugePage(KProcessAddress addr, size_t size) const {
+                /* Only unlocked, user read-write heap memory may be moved into a huge page. */
+                R_RETURN(this->CheckMemoryState(addr, size, KMemoryState_All, KMemoryState_Normal, KMemoryPermission_UserReadWrite, KMemoryPermission_UserReadWrite, KMemoryAttribute_All, KMemoryAttribute_None, KMemoryAttribute_None));
+            }
+
+            Result CheckMemoryStateForDiscard(KProcessAddress addr, size_t size) const {
+                /* Only unlocked, non-writable code may be discarded, and only if it still matches what the loader mapped. */
+                R_UNLESS(!m_is_code_modified, svc::ResultInvalidState());
+                R_RETURN(this->CheckMemoryState(addr, size, KMemoryState_All, KMemoryState_Code, KMemoryPermission_UserWrite, KMemoryPermission_None, KMemoryAttribute_All, KMemoryAttribute_None, KMemoryAttribute_None));
+            }
         private:
             constexpr size_t GetNumGuardPages() const { return this->IsKernel() ? 1 : 4; }
             ALWAYS_INLINE KProcessAddress FindFreeArea(KProcessAddress region_start, size_t region_num_pages, size_t num_pages, size_t alignment, size_t offset, size_t guard_pages) const;
@@ -450,6 +534,18 @@ namespace ams::kern {
             Result LockForCodeMemory(KPageGroup *out, KProcessAddress address, size_t size);
             Result UnlockForCodeMemory(KProcessAddress address, size_t size, const KPageGroup &pg);
 
+            void OpenSwapHold();
+            void CloseSwapHold();
+            Result MakeResident(KProcessAddress address, size_t size);
+            Result OpenResidentPage(KPhysicalAddress *out, KProcessAddress address);
+            void CloseResidentPage(KPhysicalAddress phys_addr);
+
+            Result LockForSwapFaultRing(KPhysicalAddress *out, KProcessAddress address);
+            Result UnlockForSwapFaultRing(KProcessAddress address);
+
+            Result MapSwapInFrames(KProcessAddress *out_address, const KPageGroup &pg);
+            Result UnmapSwapInFrames(KPhysicalAddress *out_phys_addrs, KProcessAddress address, size_t num_pages);
+
             Result OpenMemoryRangeForProcessCacheOperation(MemoryRange *out, KProcessAddress address, size_t size);
 
             Result CopyMemoryFromLinearToUser(KProcessAddress dst_addr, size_t size, KProcessAddress src_addr, u32 src_state_mask, u32 src_state, KMemoryPermission src_test_perm, u32 src_attr_mask, u32 src_attr);
@@ -500,6 +596,8 @@ namespace ams::kern {
 
             KProcessAddress GetAliasCodeRegionStart() const { return m_alias_code_region_start; }
 
+            KProcessAddress GetProcessCodeRegionStart() const { return m_process_code_start; }
+
             size_t GetAddressSpaceSize()    const { return m_address_space_end - m_address_space_start; }
 
             size_t GetHeapRegionSize()      const { return m_region_ends[RegionType_Heap]      - m_region_starts[RegionType_Heap]; }
@@ -509,6 +607,8 @@ namespace ams::kern {
 
             size_t GetAliasCodeRegionSize() const { return m_alias_code_region_end - m_alias_code_region_start; }
 
+            size_t GetProcessCodeRegionSize() const { return m_process_code_end - m_process_code_start; }
+
             size_t GetAliasRegionExtraSize() const { return m_alias_region_extra_size; }
 
             size_t GetNormalMemorySize() const {
@@ -32,6 +32,8 @@
 #include <mesosphere/kern_k_dynamic_resource_manager.hpp>
 #include <mesosphere/kern_k_page_table_manager.hpp>
 #include <mesosphere/kern_k_system_resource.hpp>
+#include <mesosphere/kern_k_swap_statistics.hpp>
+#include <mesosphere/kern_k_swap_fault_wait_table.hpp>
 
 namespace ams::kern {
 
@@ -121,6 +123,8 @@ namespace ams::kern {
             util::Atomic<s64>           m_num_ipc_messages;
             util::Atomic<s64>           m_num_ipc_replies;
             util::Atomic<s64>           m_num_ipc_receives;
+            KSwapStatistics             m_swap_statistics;
+            KSwapFaultWaitTable         m_swap_fault_wait_table;
         private:
             Result Initialize(const ams::svc::CreateProcessParameter &params);
 
@@ -252,6 +256,11 @@ namespace ams::kern {
             constexpr KProcessPageTable &GetPageTable() { return m_page_table; }
             constexpr const KProcessPageTable &GetPageTable() const { return m_page_table; }
 
+            constexpr KSwapStatistics &GetSwapStatistics() { return m_swap_statistics; }
+            constexpr const KSwapStatistics &GetSwapStatistics() const { return m_swap_statistics; }
+
+            constexpr KSwapFaultWaitTable &GetSwapFaultWaitTable() { return m_swap_fault_wait_table; }
+
             KPageTable &GetPageTableImpl() { return m_page_table.GetPageTableImpl(); }
 
             constexpr KHandleTable &GetHandleTable() { return m_handle_table; }
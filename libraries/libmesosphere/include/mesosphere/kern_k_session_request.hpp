@@ -139,14 +139,15 @@ namespace ams::kern {
         private:
             SessionMappings m_mappings;
             KThread *m_thread;
+            KProcess *m_client;
             KProcess *m_server;
             KEvent *m_event;
             uintptr_t m_address;
             size_t m_size;
         public:
-            constexpr explicit KSessionRequest(util::ConstantInitializeTag) : KAutoObject(util::ConstantInitialize), m_mappings(util::ConstantInitialize), m_thread(), m_server(), m_event(), m_address(), m_size() { /* ... */ }
+            constexpr explicit KSessionRequest(util::ConstantInitializeTag) : KAutoObject(util::ConstantInitialize), m_mappings(util::ConstantInitialize), m_thread(), m_client(), m_server(), m_event(), m_address(), m_size() { /* ... */ }
 
-            explicit KSessionRequest() : m_thread(nullptr), m_server(nullptr), m_event(nullptr) { /* ... */ }
+            explicit KSessionRequest() : m_thread(nullptr), m_client(nullptr), m_server(nullptr), m_event(nullptr) { /* ... */ }
 
             static KSessionRequest *Create() {
                 KSessionRequest *req = KSessionRequest::Allocate();
@@ -183,6 +184,8 @@ namespace ams::kern {
                 }
             }
 
+            Result HoldClientBuffers();
+
             static void PostDestroy(uintptr_t arg) { MESOSPHERE_UNUSED(arg); /* ... */ }
 
             constexpr ALWAYS_INLINE KThread *GetThread() const { return m_thread; }
@@ -230,10 +233,16 @@ namespace ams::kern {
             constexpr ALWAYS_INLINE size_t          GetExchangeSize(size_t i)          const { return m_mappings.GetExchangeSize(i);           }
             constexpr ALWAYS_INLINE KMemoryState    GetExchangeMemoryState(size_t i)   const { return m_mappings.GetExchangeMemoryState(i);    }
         private:
+            void ReleaseClientBuffers();
+
             /* NOTE: This is public and virtual in Nintendo's kernel. */
             void Finalize() {
                 m_mappings.Finalize();
 
+                if (m_client) {
+                    this->ReleaseClientBuffers();
+                }
+
                 if (m_thread) {
                     m_thread->Close();
                 }
@@ -17,6 +17,8 @@
 #include <mesosphere/kern_common.hpp>
 #include <mesosphere/kern_k_typed_address.hpp>
 #include <mesosphere/kern_k_memory_layout.hpp>
+#include <mesosphere/kern_k_spin_lock.hpp>
+#include <mesosphere/kern_k_current_context.hpp>
 
 #if defined(ATMOSPHERE_ARCH_ARM64)
 
@@ -25,6 +27,7 @@
         using ams::kern::arch::arm64::IsSlabAtomicValid;
         using ams::kern::arch::arm64::AllocateFromSlabAtomic;
         using ams::kern::arch::arm64::FreeToSlabAtomic;
+        using ams::kern::arch::arm64::FreeListToSlabAtomic;
     }
 
 #else
@@ -66,6 +69,10 @@ namespace ams::kern {
                 ALWAYS_INLINE void Free(void *obj) {
                     return FreeToSlabAtomic(std::addressof(m_head), static_cast<Node *>(obj));
                 }
+
+                ALWAYS_INLINE void FreeList(Node *first, Node *last) {
+                    return FreeListToSlabAtomic(std::addressof(m_head), first, last);
+                }
         };
 
     }
@@ -74,11 +81,48 @@ namespace ams::kern {
     class KSlabHeapBase : protected impl::KSlabHeapImpl {
         NON_COPYABLE(KSlabHeapBase);
         NON_MOVEABLE(KSlabHeapBase);
+        public:
+            static constexpr size_t MagazineSize = 8;
+        private:
+            struct Magazine {
+                Node *head{nullptr};
+                Node *tail{nullptr};
+                size_t count{0};
+
+                ALWAYS_INLINE void Push(Node *node) {
+                    node->next = head;
+                    if (count == 0) {
+                        tail = node;
+                    }
+                    head = node;
+                    ++count;
+                }
+
+                ALWAYS_INLINE Node *Pop() {
+                    Node *node = head;
+                    head = node->next;
+                    --count;
+                    return node;
+                }
+            };
+
+            /* NOTE: Each core caches up to two magazines of free objects in front of the shared list, Bonwick style. The   */
+            /* loaded magazine serves allocations and frees, and the previous magazine is always either empty or full, so   */
+            /* that a core alternating between allocating and freeing at a magazine boundary never touches the shared list. */
+            /* A full magazine is flushed to the shared list in a single push, but refills pop from it one node at a time.  */
+            struct alignas(cpu::DataCacheLineSize) PerCoreCache {
+                KSpinLock lock{};
+                Magazine loaded{};
+                Magazine previous{};
+                u64 num_hits{};
+                u64 num_misses{};
+            };
         private:
             size_t m_obj_size{};
             uintptr_t m_peak{};
             uintptr_t m_start{};
             uintptr_t m_end{};
+            PerCoreCache m_caches[cpu::NumCores]{};
         private:
             ALWAYS_INLINE void UpdatePeakImpl(uintptr_t obj) {
                 const util::AtomicRef<uintptr_t> peak_ref(m_peak);
@@ -91,6 +135,79 @@ namespace ams::kern {
                     }
                 } while (!peak_ref.CompareExchangeStrong(cur_peak, alloc_peak));
             }
+
+            ALWAYS_INLINE void *AllocateFromCache() {
+                /* Allocations and frees on a core are serialized by disabling interrupts, so that its cache is only contended by stealing. */
+                KScopedInterruptDisable di;
+
+                const s32 core_id = GetCurrentCoreId();
+                {
+                    PerCoreCache &cache = m_caches[core_id];
+                    KScopedSpinLock lk(cache.lock);
+
+                    /* If our loaded magazine is empty, switch to our previous one. */
+                    if (cache.loaded.count == 0 && cache.previous.count != 0) {
+                        std::swap(cache.loaded, cache.previous);
+                    }
+
+                    /* If both of our magazines are empty, refill the loaded one from the shared list. */
+                    /* NOTE: Each node is popped with its own exclusive load/store pair. Walking several nodes inside one pair could livelock */
+                    /* under contention, as the architecture makes no forward progress guarantee for it, and we refill when most contended.   */
+                    if (cache.loaded.count != 0) {
+                        ++cache.num_hits;
+                    } else {
+                        ++cache.num_misses;
+
+                        while (cache.loaded.count < MagazineSize) {
+                            Node *node = static_cast<Node *>(KSlabHeapImpl::Allocate());
+                            if (node == nullptr) {
+                                break;
+                            }
+
+                            cache.loaded.Push(node);
+                        }
+                    }
+
+                    if (AMS_LIKELY(cache.loaded.count != 0)) {
+                        return cache.loaded.Pop();
+                    }
+                }
+
+                /* The shared list is exhausted, so steal an object cached by another core rather than failing while free objects remain. */
+                for (size_t i = 1; i < cpu::NumCores; ++i) {
+                    PerCoreCache &cache = m_caches[(core_id + i) % cpu::NumCores];
+                    KScopedSpinLock lk(cache.lock);
+
+                    if (cache.loaded.count == 0 && cache.previous.count != 0) {
+                        std::swap(cache.loaded, cache.previous);
+                    }
+
+                    if (cache.loaded.count != 0) {
+                        return cache.loaded.Pop();
+                    }
+                }
+
+                return nullptr;
+            }
+
+            ALWAYS_INLINE void FreeToCache(void *obj) {
+                KScopedInterruptDisable di;
+
+                PerCoreCache &cache = m_caches[GetCurrentCoreId()];
+                KScopedSpinLock lk(cache.lock);
+
+                /* If our loaded magazine is full, flush our previous one to the shared list if it is full too, and switch to it. */
+                if (cache.loaded.count == MagazineSize) {
+                    if (cache.previous.count == MagazineSize) {
+                        KSlabHeapImpl::FreeList(cache.previous.head, cache.previous.tail);
+                        cache.previous = {};
+                    }
+
+                    std::swap(cache.loaded, cache.previous);
+                }
+
+                cache.loaded.Push(static_cast<Node *>(obj));
+            }
         public:
             constexpr KSlabHeapBase() = default;
 
@@ -132,7 +249,7 @@ namespace ams::kern {
             }
 
             ALWAYS_INLINE void *Allocate() {
-                void *obj = KSlabHeapImpl::Allocate();
+                void *obj = this->AllocateFromCache();
 
                 /* Track the allocated peak. */
                 #if defined(MESOSPHERE_BUILD_FOR_DEBUGGING)
@@ -162,7 +279,7 @@ namespace ams::kern {
                     MESOSPHERE_ABORT_UNLESS(contained);
                 }
 
-                KSlabHeapImpl::Free(obj);
+                this->FreeToCache(obj);
             }
 
             ALWAYS_INLINE size_t GetObjectIndex(const void *obj) const {
@@ -210,10 +327,30 @@ namespace ams::kern {
                         break;
                     }
                 }
+
+                for (const auto &cache : m_caches) {
+                    remaining += cache.loaded.count + cache.previous.count;
+                }
                 #endif
 
                 return remaining;
             }
+
+            ALWAYS_INLINE u64 GetMagazineHitCount() const {
+                u64 count = 0;
+                for (const auto &cache : m_caches) {
+                    count += cache.num_hits;
+                }
+                return count;
+            }
+
+            ALWAYS_INLINE u64 GetMagazineMissCount() const {
+                u64 count = 0;
+                for (const auto &cache : m_caches) {
+                    count += cache.num_misses;
+                }
+                return count;
+            }
     };
 
     template<typename T, bool SupportDynamicExpansion>
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <mesosphere/kern_common.hpp>
+#include <mesosphere/kern_k_typed_address.hpp>
+
+namespace ams::kern {
+
+    class KThread;
+
+    /* NOTE: The wait table coalesces a process's faults on the same swapped page. The first thread to fault on a page */
+    /* issues the request to sys-swap, and any later threads wait behind it, so that one resolution wakes them all.   */
+    class KSwapFaultWaitTable {
+        public:
+            static constexpr size_t NumBuckets = 0x10;
+        private:
+            KThread *m_buckets[NumBuckets];
+        private:
+            static constexpr ALWAYS_INLINE size_t GetBucketIndex(KProcessAddress page_address) {
+                return (GetInteger(page_address) / PageSize) % NumBuckets;
+            }
+        public:
+            constexpr KSwapFaultWaitTable() : m_buckets() { /* ... */ }
+
+            void Initialize() {
+                std::fill(std::begin(m_buckets), std::end(m_buckets), nullptr);
+            }
+
+            /* NOTE: Wait/Remove/WakeAll must be called with the scheduler lock held. */
+            /* Remove returns the thread which takes over the removed thread's request, if any. */
+            bool Wait(KThread *thread);
+            KThread *Remove(KThread *thread);
+            void WakeAll(KThread *thread);
+    };
+
+}
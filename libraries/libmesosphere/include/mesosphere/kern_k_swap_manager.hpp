@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <mesosphere/kern_common.hpp>
+#include <mesosphere/kern_k_typed_address.hpp>
+#include <mesosphere/kern_k_memory_manager.hpp>
+
+namespace ams::kern {
+
+    class KThread;
+
+    class KSwapManager {
+        public:
+            static constexpr size_t MaxEvictions       = 0x400;
+            static constexpr size_t MaxReleasedOffsets = 0x800;
+            static constexpr size_t MaxActivityRequests = 0x10;
+        public:
+            static void SignalSwapEvent();
+
+            /* NOTE: EnqueueEviction/CancelEviction must be called with the owning page table's lock held. */
+            static Result EnqueueEviction(u64 process_id, KProcessAddress address, KPhysicalAddress phys_addr, bool clean);
+            static void CancelEviction(u64 process_id, KProcessAddress address);
+            static void CancelEviction(KPhysicalAddress phys_addr);
+
+            static s32 BeginEvictions(ams::svc::SwapEvictionInfo *out_infos, KPhysicalAddress *out_phys_addrs, s32 max_count);
+            static void AbortEvictions(const ams::svc::SwapEvictionInfo *infos, s32 count);
+            static Result CompleteEviction(u32 id, ams::svc::SwapEvictionStatus status, size_t stored_size, u64 sector_offset);
+
+            static bool IsEvictionCancelled(u32 id);
+
+            static Result RegisterFaultRings(KProcessAddress request_ring, KProcessAddress completion_ring);
+
+            /* NOTE: WaitForFault blocks the current thread until its page is swapped back in; it must be called without any locks held. */
+            static void WaitForFault(KProcessAddress address, u64 swap_offset, s64 fault_tick);
+            static bool IsWaitingForFault(const KThread *thread);
+            static Result TakeFaultRequest(u64 *out_process_id, u64 *out_thread_id, KProcessAddress *out_address);
+            /* NOTE: ResolveFault/ResolveFaultRange take the swap-in frames at buffer from the current process, which must be sys-swap. */
+            static Result ResolveFault(u64 process_id, u64 thread_id, KProcessAddress address, KProcessAddress buffer);
+            static Result ResolveFaultRange(size_t *out_num_installed, u64 process_id, u64 thread_id, KProcessAddress address, u64 sector_offset, KProcessAddress buffer, size_t num_pages);
+            static s32 ProcessFaultCompletions();
+
+            /* NOTE: ReleaseSwapOffset must be called with the owning page table's lock held, if a page table entry refers to the offset. */
+            static void ReleaseSwapOffset(u64 swap_offset);
+            static s32 TakeReleasedSwapOffsets(u64 *out_offsets, s32 max_count);
+
+            static void RequestReclaim(KMemoryManager::Pool pool, size_t num_pages);
+            static bool WaitForReclaim(s64 timeout);
+            static Result TakeReclaimRequest(ams::svc::SwapReclaimRequest *out);
+            static void NotifyReclaimProgress();
+
+            static void NotifyProcessActivity(u64 process_id, KMemoryManager::Pool pool, ams::svc::ProcessActivity activity);
+            static Result TakeActivityRequest(ams::svc::SwapActivityRequest *out);
+    };
+
+}
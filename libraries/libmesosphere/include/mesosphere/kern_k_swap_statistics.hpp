@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <mesosphere/kern_common.hpp>
+
+namespace ams::kern {
+
+    class KSwapStatistics {
+        public:
+            static constexpr size_t NumLatencyBuckets = ams::svc::SwapFaultLatencyBucketCount;
+        private:
+            util::Atomic<u64> m_num_faults;
+            util::Atomic<u64> m_num_major_faults;
+            util::Atomic<u64> m_num_pages_in;
+            util::Atomic<u64> m_num_pages_out;
+            util::Atomic<u64> m_num_bytes_written;
+            util::Atomic<u64> m_fault_latency_histogram[NumLatencyBuckets];
+        private:
+            static constexpr ALWAYS_INLINE size_t GetLatencyBucket(s64 ticks) {
+                const u64 us = static_cast<u64>(std::max<s64>(ticks, 0)) * 1'000'000 / ams::svc::TicksPerSecond;
+                return std::min<size_t>(BITSIZEOF(u64) - util::CountLeadingZeros(us), NumLatencyBuckets - 1);
+            }
+        public:
+            KSwapStatistics() { /* ... */ }
+
+            void Initialize() {
+                m_num_faults        = 0;
+                m_num_major_faults  = 0;
+                m_num_pages_in      = 0;
+                m_num_pages_out     = 0;
+                m_num_bytes_written = 0;
+
+                for (auto &bucket : m_fault_latency_histogram) {
+                    bucket = 0;
+                }
+            }
+
+            void OnFault(bool major) {
+                m_num_faults.FetchAdd(1);
+                if (major) {
+                    m_num_major_faults.FetchAdd(1);
+                }
+            }
+
+            void OnFaultResolved(s64 latency_ticks, size_t num_pages_in) {
+                m_fault_latency_histogram[GetLatencyBucket(latency_ticks)].FetchAdd(1);
+                m_num_pages_in.FetchAdd(num_pages_in);
+            }
+
+            void OnPageOut(size_t stored_size) {
+                m_num_pages_out.FetchAdd(1);
+                m_num_bytes_written.FetchAdd(stored_size);
+            }
+
+            Result GetInfo(u64 *out, u64 info_subtype) const {
+                switch (info_subtype) {
+                    case ams::svc::SwapStatisticsInfo_Faults:       *out = m_num_faults.Load();        break;
+                    case ams::svc::SwapStatisticsInfo_MajorFaults:  *out = m_num_major_faults.Load();  break;
+                    case ams::svc::SwapStatisticsInfo_PagesIn:      *out = m_num_pages_in.Load();      break;
+                    case ams::svc::SwapStatisticsInfo_PagesOut:     *out = m_num_pages_out.Load();     break;
+                    case ams::svc::SwapStatisticsInfo_BytesWritten: *out = m_num_bytes_written.Load(); break;
+                    default:
+                        {
+                            const u64 bucket = info_subtype - ams::svc::SwapStatisticsInfo_FaultLatencyHistogram;
+                            R_UNLESS(info_subtype >= ams::svc::SwapStatisticsInfo_FaultLatencyHistogram && bucket < NumLatencyBuckets, svc::ResultInvalidCombination());
+
+                            *out = m_fault_latency_histogram[bucket].Load();
+                        }
+                        break;
+                }
+
+                R_SUCCEED();
+            }
+    };
+
+}
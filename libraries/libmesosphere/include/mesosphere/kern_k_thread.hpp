@@ -344,6 +344,11 @@ namespace ams::kern {
             bool                                                m_resource_limit_release_hint;
             KThread                                            *m_swap_next;
             KProcessAddress                                     m_swap_vaddr;
+            u64                                                 m_swap_sector_offset;
+            s64                                                 m_swap_fault_tick;
+            KThread                                            *m_swap_wait_next;
+            KThread                                            *m_swap_waiters;
+            util::Atomic<bool>                                  m_swap_queued;
         public:
             constexpr explicit KThread(util::ConstantInitializeTag)
                 : KAutoObjectWithSlabHeapAndContainer<KThread, KWorkerTask>(util::ConstantInitialize), KTimerTask(util::ConstantInitialize),
@@ -356,7 +361,8 @@ namespace ams::kern {
                   m_physical_ideal_core_id{}, m_virtual_ideal_core_id{}, m_num_kernel_waiters{}, m_current_core_id{}, m_core_id{}, m_original_physical_affinity_mask{},
                   m_original_physical_ideal_core_id{}, m_num_core_migration_disables{}, m_thread_state{}, m_termination_requested{false}, m_wait_cancelled{},
                   m_cancellable{}, m_signaled{}, m_initialized{}, m_debug_attached{}, m_priority_inheritance_count{}, m_resource_limit_release_hint{},
-                  m_swap_next{nullptr}, m_swap_vaddr{Null<KProcessAddress>}
+                  m_swap_next{nullptr}, m_swap_vaddr{Null<KProcessAddress>}, m_swap_sector_offset{}, m_swap_fault_tick{}, m_swap_wait_next{nullptr}, m_swap_waiters{nullptr},
+                  m_swap_queued{false}
             {
                 /* ... */
             }
@@ -603,6 +609,7 @@ namespace ams::kern {
             constexpr KThread *GetLockOwner() const { return m_waiting_lock_info != nullptr ? m_waiting_lock_info->GetOwner() : nullptr; }
 
             constexpr void ClearWaitQueue() { m_wait_queue = nullptr; }
+            constexpr const KThreadQueue *GetWaitQueue() const { return m_wait_queue; }
 
             void BeginWait(KThreadQueue *queue);
             void NotifyAvailable(KSynchronizationObject *signaled_object, Result wait_result);
@@ -646,6 +653,16 @@ namespace ams::kern {
             constexpr void SetSwapNext(KThread *t) { m_swap_next = t; }
             constexpr KProcessAddress GetSwapVirtualAddress() const { return m_swap_vaddr; }
             constexpr void SetSwapVirtualAddress(KProcessAddress addr) { m_swap_vaddr = addr; }
+            constexpr u64 GetSwapSectorOffset() const { return m_swap_sector_offset; }
+            constexpr void SetSwapSectorOffset(u64 offset) { m_swap_sector_offset = offset; }
+            constexpr s64 GetSwapFaultTick() const { return m_swap_fault_tick; }
+            constexpr void SetSwapFaultTick(s64 tick) { m_swap_fault_tick = tick; }
+            constexpr KThread *GetSwapWaitNext() const { return m_swap_wait_next; }
+            constexpr void SetSwapWaitNext(KThread *t) { m_swap_wait_next = t; }
+            constexpr KThread *GetSwapWaiters() const { return m_swap_waiters; }
+            constexpr void SetSwapWaiters(KThread *t) { m_swap_waiters = t; }
+            bool TrySetSwapQueued() { return !m_swap_queued.Exchange(true); }
+            void ClearSwapQueued() { m_swap_queued.Store(false); }
 
             constexpr KSynchronizationObject **GetSynchronizationObjectBuffer() { return std::addressof(m_sync_object_buffer.m_sync_objects[0]); }
             constexpr ams::svc::Handle *GetHandleBuffer() { return std::addressof(m_sync_object_buffer.m_handles[sizeof(m_sync_object_buffer.m_sync_objects) / (sizeof(ams::svc::Handle)) - ams::svc::ArgumentHandleCountMax]); }
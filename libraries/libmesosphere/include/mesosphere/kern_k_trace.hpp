@@ -33,17 +33,23 @@ namespace ams::kern {
     class KTrace {
         public:
             enum Type {
-                Type_ThreadSwitch   =  1,
+                Type_ThreadSwitch      = ams::svc::KernelTraceRecordType_ThreadSwitch,
 
-                Type_SvcEntry0      =  3,
-                Type_SvcEntry1      =  4,
-                Type_SvcExit0       =  5,
-                Type_SvcExit1       =  6,
-                Type_Interrupt      =  7,
+                Type_SvcEntry0         = ams::svc::KernelTraceRecordType_SvcEntry0,
+                Type_SvcEntry1         = ams::svc::KernelTraceRecordType_SvcEntry1,
+                Type_SvcExit0          = ams::svc::KernelTraceRecordType_SvcExit0,
+                Type_SvcExit1          = ams::svc::KernelTraceRecordType_SvcExit1,
+                Type_Interrupt         = ams::svc::KernelTraceRecordType_Interrupt,
 
-                Type_ScheduleUpdate = 11,
+                Type_ScheduleUpdate    = ams::svc::KernelTraceRecordType_ScheduleUpdate,
 
-                Type_CoreMigration  = 14,
+                Type_CoreMigration     = ams::svc::KernelTraceRecordType_CoreMigration,
+
+                Type_IpcSend           = ams::svc::KernelTraceRecordType_IpcSend,
+                Type_IpcReply          = ams::svc::KernelTraceRecordType_IpcReply,
+                Type_PageFault         = ams::svc::KernelTraceRecordType_PageFault,
+                Type_SwapFault         = ams::svc::KernelTraceRecordType_SwapFault,
+                Type_SwapFaultResolved = ams::svc::KernelTraceRecordType_SwapFaultResolved,
             };
         private:
             static bool s_is_active;
@@ -51,6 +57,7 @@ namespace ams::kern {
             static void Initialize(KVirtualAddress address, size_t size);
             static void Start();
             static void Stop();
+            static void Reset();
 
             static void PushRecord(u8 type, u64 param0 = 0, u64 param1 = 0, u64 param2 = 0, u64 param3 = 0, u64 param4 = 0, u64 param5 = 0);
 
@@ -73,6 +80,13 @@ namespace ams::kern {
         }                                             \
     })
 
+#define MESOSPHERE_KTRACE_RESET()                     \
+    ({                                                \
+        if constexpr (::ams::kern::IsKTraceEnabled) { \
+            ::ams::kern::KTrace::Reset();             \
+        }                                             \
+    })
+
 #define MESOSPHERE_KTRACE_PUSH_RECORD(TYPE, ...)                       \
     ({                                                                 \
         if constexpr (::ams::kern::IsKTraceEnabled) {                  \
@@ -113,3 +127,18 @@ namespace ams::kern {
 
 #define MESOSPHERE_KTRACE_CORE_MIGRATION(THREAD_ID, PREV, NEXT, REASON) \
     MESOSPHERE_KTRACE_PUSH_RECORD(::ams::kern::KTrace::Type_CoreMigration,  THREAD_ID, PREV, NEXT, REASON)
+
+#define MESOSPHERE_KTRACE_IPC_SEND(SESSION, IS_ASYNC) \
+    MESOSPHERE_KTRACE_PUSH_RECORD(::ams::kern::KTrace::Type_IpcSend, reinterpret_cast<uintptr_t>(SESSION), IS_ASYNC)
+
+#define MESOSPHERE_KTRACE_IPC_REPLY(SESSION, CLIENT_THREAD_ID, RESULT) \
+    MESOSPHERE_KTRACE_PUSH_RECORD(::ams::kern::KTrace::Type_IpcReply, reinterpret_cast<uintptr_t>(SESSION), CLIENT_THREAD_ID, RESULT)
+
+#define MESOSPHERE_KTRACE_PAGE_FAULT(ADDRESS, ESR, PC) \
+    MESOSPHERE_KTRACE_PUSH_RECORD(::ams::kern::KTrace::Type_PageFault, ADDRESS, ESR, PC)
+
+#define MESOSPHERE_KTRACE_SWAP_FAULT(ADDRESS, SECTOR_OFFSET) \
+    MESOSPHERE_KTRACE_PUSH_RECORD(::ams::kern::KTrace::Type_SwapFault, ADDRESS, SECTOR_OFFSET)
+
+#define MESOSPHERE_KTRACE_SWAP_FAULT_RESOLVED(PROCESS_ID, THREAD_ID, ADDRESS, NUM_PAGES) \
+    MESOSPHERE_KTRACE_PUSH_RECORD(::ams::kern::KTrace::Type_SwapFaultResolved, PROCESS_ID, THREAD_ID, ADDRESS, NUM_PAGES)
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <mesosphere/kern_common.hpp>
+
+namespace ams::kern {
+
+    /* NOTE: The worker runs at the lowest priority, so it only clears blocks when its core would otherwise be idle. */
+    class KZeroedBlockWorker {
+        public:
+            static constexpr s32 WorkerThreadPriority = ams::svc::LowestThreadPriority;
+        public:
+            static NOINLINE void Initialize();
+
+            static void Notify();
+    };
+
+}
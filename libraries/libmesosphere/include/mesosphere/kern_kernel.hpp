@@ -158,8 +158,6 @@ namespace ams::kern {
     }
 
     /* Swap signaling objects. */
-    extern KThread *g_SwapRequestListHead;
-    extern KThread *g_SwapRequestListTail;
     class KEvent;
     extern KEvent *g_SwapEvent;
 
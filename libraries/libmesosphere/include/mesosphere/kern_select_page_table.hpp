@@ -52,6 +52,11 @@ namespace ams::kern {
         static_cast<KPageTable *>(this)->FinalizeUpdateImpl(page_list);
     }
 
+    /* FindSwappedPage needs to inspect the architecture's entries, and so is forwarded in the same way. */
+    ALWAYS_INLINE bool KPageTableBase::FindSwappedPage(KProcessAddress *out_address, u64 *out_swap_offset, KProcessAddress address, size_t size) {
+        return static_cast<KPageTable *>(this)->FindSwappedPageImpl(out_address, out_swap_offset, address, size);
+    }
+
     /* Add arch::arm64:: here to tell the compiler where the entry type is defined */
     ALWAYS_INLINE bool KPageTableBase::GetEntry(arch::arm64::PageTableEntry *out, KProcessAddress virt_addr) const {
         return static_cast<const KPageTable *>(this)->GetEntry(out, virt_addr);
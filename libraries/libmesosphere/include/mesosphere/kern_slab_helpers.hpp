@@ -62,6 +62,9 @@ namespace ams::kern {
             static uintptr_t GetSlabHeapAddress() { return s_slab_heap.GetSlabHeapAddress(); }
 
             static size_t GetNumRemaining() { return s_slab_heap.GetNumRemaining(); }
+
+            static u64 GetMagazineHitCount() { return s_slab_heap.GetMagazineHitCount(); }
+            static u64 GetMagazineMissCount() { return s_slab_heap.GetMagazineMissCount(); }
     };
 
     template<typename Derived, typename Base, bool SupportDynamicExpansion> requires std::derived_from<Base, KAutoObject>
@@ -151,6 +154,9 @@ namespace ams::kern {
             static uintptr_t GetSlabHeapAddress() { return s_slab_heap.GetSlabHeapAddress(); }
 
             static size_t GetNumRemaining() { return s_slab_heap.GetNumRemaining(); }
+
+            static u64 GetMagazineHitCount() { return s_slab_heap.GetMagazineHitCount(); }
+            static u64 GetMagazineMissCount() { return s_slab_heap.GetMagazineMissCount(); }
     };
 
     template<typename Derived, typename Base, bool SupportDynamicExpansion = false>
@@ -46,6 +46,19 @@ namespace ams::kern::svc {
         template<typename T>
         concept Aligned64Pointer  = AlignedNPointer<T, sizeof(u64)> && Aligned32Pointer<T>;
 
+        /* An access to user memory fails if the memory has been swapped out, so a failed access faults it in and is retried once. */
+        /* NOTE: This is defined with the memory svcs, as the page tables can't be included here. */
+        Result MakeUserMemoryResident(const void *address, size_t size);
+
+        template<typename F>
+        ALWAYS_INLINE bool AccessUserMemory(const void *address, size_t size, F access) {
+            if (AMS_LIKELY(access())) {
+                return true;
+            }
+
+            return R_SUCCEEDED(MakeUserMemoryResident(address, size)) && access();
+        }
+
         template<typename _T>
         class KUserPointerImplTraits;
 
@@ -55,12 +68,12 @@ namespace ams::kern::svc {
                 using T = typename std::remove_const<typename std::remove_pointer<_T>::type>::type;
             public:
                 static ALWAYS_INLINE Result CopyFromUserspace(void *dst, const void *src, size_t size) {
-                    R_UNLESS(UserspaceAccess::CopyMemoryFromUser(dst, src, size), svc::ResultInvalidPointer());
+                    R_UNLESS(AccessUserMemory(src, size, [&]() ALWAYS_INLINE_LAMBDA { return UserspaceAccess::CopyMemoryFromUser(dst, src, size); }), svc::ResultInvalidPointer());
                     R_SUCCEED();
                 }
 
                 static ALWAYS_INLINE Result CopyToUserspace(void *dst, const void *src, size_t size) {
-                    R_UNLESS(UserspaceAccess::CopyMemoryToUser(dst, src, size),   svc::ResultInvalidPointer());
+                    R_UNLESS(AccessUserMemory(dst, size, [&]() ALWAYS_INLINE_LAMBDA { return UserspaceAccess::CopyMemoryToUser(dst, src, size); }), svc::ResultInvalidPointer());
                     R_SUCCEED();
                 }
         };
@@ -71,12 +84,12 @@ namespace ams::kern::svc {
                 using T = typename std::remove_const<typename std::remove_pointer<_T>::type>::type;
             public:
                 static ALWAYS_INLINE Result CopyFromUserspace(void *dst, const void *src, size_t size) {
-                    R_UNLESS(UserspaceAccess::CopyMemoryFromUserAligned32Bit(dst, src, size), svc::ResultInvalidPointer());
+                    R_UNLESS(AccessUserMemory(src, size, [&]() ALWAYS_INLINE_LAMBDA { return UserspaceAccess::CopyMemoryFromUserAligned32Bit(dst, src, size); }), svc::ResultInvalidPointer());
                     R_SUCCEED();
                 }
 
                 static ALWAYS_INLINE Result CopyToUserspace(void *dst, const void *src, size_t size) {
-                    R_UNLESS(UserspaceAccess::CopyMemoryToUserAligned32Bit(dst, src, size),   svc::ResultInvalidPointer());
+                    R_UNLESS(AccessUserMemory(dst, size, [&]() ALWAYS_INLINE_LAMBDA { return UserspaceAccess::CopyMemoryToUserAligned32Bit(dst, src, size); }), svc::ResultInvalidPointer());
                     R_SUCCEED();
                 }
         };
@@ -87,12 +100,12 @@ namespace ams::kern::svc {
                 using T = typename std::remove_const<typename std::remove_pointer<_T>::type>::type;
             public:
                 static ALWAYS_INLINE Result CopyFromUserspace(void *dst, const void *src, size_t size) {
-                    R_UNLESS(UserspaceAccess::CopyMemoryFromUserAligned64Bit(dst, src, size), svc::ResultInvalidPointer());
+                    R_UNLESS(AccessUserMemory(src, size, [&]() ALWAYS_INLINE_LAMBDA { return UserspaceAccess::CopyMemoryFromUserAligned64Bit(dst, src, size); }), svc::ResultInvalidPointer());
                     R_SUCCEED();
                 }
 
                 static ALWAYS_INLINE Result CopyToUserspace(void *dst, const void *src, size_t size) {
-                    R_UNLESS(UserspaceAccess::CopyMemoryToUserAligned64Bit(dst, src, size),   svc::ResultInvalidPointer());
+                    R_UNLESS(AccessUserMemory(dst, size, [&]() ALWAYS_INLINE_LAMBDA { return UserspaceAccess::CopyMemoryToUserAligned64Bit(dst, src, size); }), svc::ResultInvalidPointer());
                     R_SUCCEED();
                 }
         };
@@ -144,7 +157,7 @@ namespace ams::kern::svc {
             protected:
                 ALWAYS_INLINE Result CopyStringTo(char *dst, size_t size) const {
                     static_assert(sizeof(char) == 1);
-                    R_UNLESS(UserspaceAccess::CopyStringFromUser(dst, m_ptr, size) > 0, svc::ResultInvalidPointer());
+                    R_UNLESS(AccessUserMemory(m_ptr, size, [&]() ALWAYS_INLINE_LAMBDA { return UserspaceAccess::CopyStringFromUser(dst, m_ptr, size) > 0; }), svc::ResultInvalidPointer());
                     R_SUCCEED();
                 }
 
@@ -110,6 +110,30 @@ namespace ams::kern::arch::arm64 {
             return insn;
         }
 
+        constexpr ALWAYS_INLINE bool IsAccessFlagFault(u64 esr) {
+            /* DFSC/IFSC 0b0010xx: Access flag fault, at any level. */
+            return (esr & 0x3C) == 0x08;
+        }
+
+        bool HandleSupervisorAccessFlagFault(KExceptionContext *context, u64 esr, u64 far) {
+            /* Only a userspace access function touching a page whose access flag the sweeper cleared can get here. */
+            const uintptr_t pc = context->pc;
+            if (((esr >> 26) & 0x3F) != EsrEc_DataAbortEl1 || !IsAccessFlagFault(esr) || pc < reinterpret_cast<uintptr_t>(UserspaceAccessFunctionAreaBegin) || pc >= reinterpret_cast<uintptr_t>(UserspaceAccessFunctionAreaEnd)) {
+                return false;
+            }
+
+            /* Restore the flag and retry the access. */
+            /* NOTE: The access may have been made with the scheduler lock held, so we must not take the page table lock. */
+            if (GetCurrentProcess().GetPageTable().GetPageTableImpl().RestoreAccessFlagWithoutLock(far)) {
+                return true;
+            }
+
+            /* If the page is no longer mapped, fail the access, as the userspace access fault handler would have. */
+            context->x[0] = 0;
+            context->pc   = context->x[30];
+            return true;
+        }
+
         void HandleUserException(KExceptionContext *context, u64 raw_esr, u64 raw_far, u64 afsr0, u64 afsr1, u32 data) {
             /* Pre-process exception registers as needed. */
             u64 esr = raw_esr;
@@ -136,55 +160,63 @@ namespace ams::kern::arch::arm64 {
             KThread  &cur_thread  = GetCurrentThread();
 
             /* Check if this is a swap fault. */
+            /* NOTE: Only user accesses are swapped in here. The kernel can't wait for sys-swap from an exception, so it makes */
+            /* any process memory it accesses resident beforehand, via KPageTableBase::MakeResident. */
             if (ec == EsrEc_InstructionAbortEl0 || ec == EsrEc_DataAbortEl0) {
                 /* ISR Safety Check: Swapping is forbidden in interrupt context. */
                 if (cur_thread.IsInExceptionHandler() || !KInterruptManager::AreInterruptsEnabled()) {
                     MESOSPHERE_PANIC("Swap fault detected in unsafe ISR/Exception context!");
                 }
 
+                /* Trace the fault. */
+                MESOSPHERE_KTRACE_PAGE_FAULT(far, esr, context->pc);
+
+                /* If the working set sweeper cleared the page's access flag, restore it and retry the access. */
+                if (IsAccessFlagFault(esr)) {
+                    KScopedLightLock lk(cur_process.GetPageTable().GetLock());
+                    if (cur_process.GetPageTable().GetPageTableImpl().RestoreAccessFlag(far)) {
+                        return;
+                    }
+                }
+
                 /* Capture start tick for timeout logic (V1/Erista safety). */
                 const s64 start_tick = svc::GetSystemTick();
 
                 /* Check for swapped state while holding the page table lock. */
                 bool is_swapped = false;
+                u64 sector_offset = 0;
                 {
                     KScopedLightLock lk(cur_process.GetPageTable().GetLock());
                     PageTableEntry pte;
-                    if (cur_process.GetPageTable().IsInsideAliasRegion(far) && cur_process.GetPageTable().GetEntry(std::addressof(pte), far) && pte.IsSwapped()) {
+
+                    /* If the page is still waiting to be written out, it's still in memory; just cancel the eviction and retry. */
+                    if (cur_process.GetPageTable().GetEntry(std::addressof(pte), far) && pte.IsSwapPending()) {
+                        if (cur_process.GetPageTable().GetPageTableImpl().CancelSwapEviction(cur_process.GetId(), far)) {
+                            cur_process.GetSwapStatistics().OnFault(false);
+                            return;
+                        }
+                    }
+
+                    if (cur_process.GetPageTable().IsInsideSwappableRegion(far) && cur_process.GetPageTable().GetEntry(std::addressof(pte), far) && pte.IsSwapped()) {
                         /* Pool Safety Check: Only Application or Applet pools are allowed to swap. */
                         const auto pool = cur_process.GetMemoryPool();
                         if (pool == KMemoryManager::Pool_Application || pool == KMemoryManager::Pool_Applet) {
-                            is_swapped = true;
+                            is_swapped    = true;
+                            sector_offset = pte.GetSwapOffset();
                         }
                     }
                 }
 
                 /* If the page is swapped, stall the thread. */
                 if (is_swapped) {
-                    /* Defer to sys-swap by enqueuing the thread and signalling the event. */
-                    /* NOTE: We MUST release the page table lock before stalling to avoid deadlock. */
-                    {
-                        KScopedSchedulerLock sl;
+                    cur_process.GetSwapStatistics().OnFault(true);
 
-                        cur_thread.Open();
-                        cur_thread.SetSwapVirtualAddress(far);
-                        cur_thread.SetSwapNext(nullptr);
-                        if (g_SwapRequestListTail != nullptr) {
-                            g_SwapRequestListTail->SetSwapNext(std::addressof(cur_thread));
-                        } else {
-                            g_SwapRequestListHead = std::addressof(cur_thread);
-                        }
-                        g_SwapRequestListTail = std::addressof(cur_thread);
-
-                        if (g_SwapEvent != nullptr) {
-                            g_SwapEvent->Signal();
-                        }
-
-                        /* Stall the thread. KScheduler::SetThreadState will call OnThreadStateChanged internally. */
-                        KScheduler::SetThreadState(std::addressof(cur_thread), KThread::ThreadState_Waiting);
-                    }
+                    /* Defer to sys-swap, and wait for it to swap the page back in. */
+                    /* NOTE: We MUST release the page table lock before stalling to avoid deadlock. */
+                    MESOSPHERE_KTRACE_SWAP_FAULT(far, sector_offset);
+                    KSwapManager::WaitForFault(far, sector_offset, start_tick);
 
-                    /* When the thread resumes here, sys-swap has marked the page as resident. */
+                    /* When the thread resumes here, sys-swap has marked the page as resident, or our wait was cancelled and we're about to be terminated. */
                     /* V1 Coherency: Cache maintenance happens in MarkAsResidentAndWake before thread resumes. */
 
                     /* Safety limit check (approx 5 seconds at 19.2MHz). */
@@ -688,6 +720,8 @@ namespace ams::kern::arch::arm64 {
 
                     HandleUserException(context, esr, far, afsr0, afsr1, data);
                 }
+            } else if (HandleSupervisorAccessFlagFault(context, esr, far)) {
+                /* The kernel faulted accessing user memory whose access flag was cleared; the access has been resolved. */
             } else {
                 const s32 core_id = GetCurrentCoreId();
 
@@ -85,6 +85,25 @@ namespace ams::kern::arch::arm64 {
             return (static_cast<u64>(asid) << 48) | (static_cast<u64>(GetInteger(table)));
         }
 
+        constexpr u8 GetRemapSoftwareReservedBits(const PageTableEntry &entry) {
+            /* An entry which replaces another keeps its merge attributes, so the page can be merged with its neighbours again. */
+            return PageTableEntry::EncodeSoftwareReservedBits(entry.IsHeadMergeDisabled(), entry.IsHeadAndBodyMergeDisabled(), entry.IsTailMergeDisabled());
+        }
+
+        ALWAYS_INLINE KPhysicalAddress GetPagePhysicalAddress(const PageTableEntry &entry) {
+            return static_cast<const L3PageTableEntry &>(entry).GetBlock();
+        }
+
+        ALWAYS_INLINE bool StoreSwappedInPageForExecute(KPhysicalAddress phys_addr, const PageTableEntry &resident_entry) {
+            /* A page which will be executed must have its new contents written back before instruction fetch can see them. */
+            if (resident_entry.IsUserExecuteNever()) {
+                return false;
+            }
+
+            MESOSPHERE_R_ABORT_UNLESS(cpu::StoreDataCache(GetVoidPointer(KMemoryLayout::GetLinearVirtualAddress(phys_addr)), PageSize));
+            return true;
+        }
+
     }
 
     ALWAYS_INLINE void KPageTable::NoteUpdated() const {
@@ -170,10 +189,14 @@ namespace ams::kern::arch::arm64 {
 
         /* 1. Clear swap bit and restore physical address. */
         entry.SetSwapped(false);
+        KSwapManager::ReleaseSwapOffset(entry.GetSwapOffset());
         
         /* 2. Map the new physical page. */
-        /* Memory Attributes: PageAttribute_NormalMemory (Inner/Outer WB Cacheable), Shareable_InnerShareable. */
-        PageTableEntry resident_entry = PageTableEntry(PageTableEntry::BlockTag{}, phys_addr, this->GetEntryTemplate({.perm = KMemoryPermission_UserReadWrite, .io = false, .uncached = false, .disable_merge_attributes = DisableMergeAttribute_None}), 0, false, true);
+        /* The page takes its block's current permission and attributes, which may have changed while it was swapped out. */
+        PageTableEntry resident_entry = PageTableEntry(PageTableEntry::BlockTag{}, phys_addr, this->GetSwapInEntryTemplate(virt_addr), GetRemapSoftwareReservedBits(entry), false, true);
+        if (StoreSwappedInPageForExecute(phys_addr, resident_entry)) {
+            cpu::InvalidateEntireInstructionCache();
+        }
 
         /* Update the entry in the table. */
         *context.level_entries[context.level] = resident_entry;
@@ -188,63 +211,255 @@ namespace ams::kern::arch::arm64 {
         R_SUCCEED();
     }
 
-    Result KPageTable::EmergencyRevertSwap() {
-        /* This function is triggered by the HID kill switch. */
+    Result KPageTable::MarkAsResidentAndWake(KProcessAddress virt_addr, KPhysicalAddress *phys_addr, KThread *thread) {
+        /* This function is called after sys-swap completes. */
+        KScopedLightLock lk(this->GetLock());
+
+        /* Re-map page. */
+        /* Note: If another thread already restored the page, we ignore the error and still wake this thread. */
+        /* NOTE: If the frame is installed, it's taken from the caller; with no frame, the thread is only woken. */
+        if (*phys_addr != Null<KPhysicalAddress>) {
+            const auto res = this->MarkAsResident(virt_addr, *phys_addr);
+            if (R_SUCCEEDED(res)) {
+                *phys_addr = Null<KPhysicalAddress>;
+            } else if (!svc::ResultInvalidState::Includes(res)) {
+                return res;
+            }
+        }
+
+        /* TLB Maintenance: Invalidate specific Virtual Address for the current ASID. */
+        /* Note: This prevents the CPU from re-triggering the same fault due to stale TLB entries. */
+        cpu::InvalidateTlbByVaDataOnly(virt_addr);
+        cpu::DataSynchronizationBarrierInnerShareable();
+        cpu::DataSynchronizationBarrier();
+
+        /* If the page's block is now entirely resident, re-form it. */
+        {
+            PageLinkedList page_list;
+            this->MergeResidentPages(util::AlignDown(GetInteger(virt_addr), PageSize), 1, std::addressof(page_list));
+            this->FinalizeUpdate(std::addressof(page_list));
+        }
+
+        /* Wake up the thread, along with any threads which faulted on the page after it. */
+        KScopedSchedulerLock sl;
+        thread->GetOwnerProcess()->GetSwapFaultWaitTable().WakeAll(thread);
+
+        R_SUCCEED();
+    }
+
+    size_t KPageTable::GetSwappedRunLength(KProcessAddress virt_addr, size_t max_pages) {
+        /* Lock the table. */
         KScopedLightLock lk(this->GetLock());
 
-        /* Iterate through the entire address space and restore residency. */
-        /* This is a high-cost operation but necessary for recovery. */
+        const KProcessAddress address = util::AlignDown(GetInteger(virt_addr), PageSize);
+
+        /* Count the swapped pages whose sectors directly follow those of the page before them. */
+        auto &impl = this->GetImpl();
+        u64 sector_offset = 0;
+        size_t num_pages  = 0;
+        while (num_pages < max_pages) {
+            TraversalContext context;
+            TraversalEntry t_entry;
+            if (!impl.BeginTraversal(std::addressof(t_entry), std::addressof(context), address + num_pages * PageSize) || context.level != KPageTableImpl::EntryLevel_L3) {
+                break;
+            }
+
+            const PageTableEntry entry = *context.level_entries[context.level];
+            if (entry.IsMapped() || !entry.IsSwapped()) {
+                break;
+            }
+
+            if (num_pages == 0) {
+                sector_offset = entry.GetSwapOffset();
+            } else if (entry.GetSwapOffset() != sector_offset + num_pages * ams::svc::SwapSectorsPerPage) {
+                break;
+            }
+
+            ++num_pages;
+        }
+
+        return num_pages;
+    }
+
+    size_t KPageTable::MarkRangeAsResidentAndWake(KProcessAddress virt_addr, u64 sector_offset, KPhysicalAddress *phys_addrs, size_t num_pages, KThread *thread) {
+        /* Lock the table. */
+        KScopedLightLock lk(this->GetLock());
+
+        const KProcessAddress address = util::AlignDown(GetInteger(virt_addr), PageSize);
+
+        /* Map each page which is still swapped out to the sectors that were read for it. */
+        /* NOTE: A page may have been restored (or swapped out again elsewhere) since it was read; such pages are left alone. */
+        /* NOTE: Frames which are installed are taken from the array; the caller is responsible for closing the rest.       */
+        auto &impl = this->GetImpl();
+        size_t num_installed = 0;
+        bool any_executable  = false;
+        for (size_t i = 0; i < num_pages; ++i) {
+            TraversalContext context;
+            TraversalEntry t_entry;
+            if (!impl.BeginTraversal(std::addressof(t_entry), std::addressof(context), address + i * PageSize) || context.level != KPageTableImpl::EntryLevel_L3) {
+                continue;
+            }
+
+            const PageTableEntry entry = *context.level_entries[context.level];
+            if (entry.IsMapped() || !entry.IsSwapped() || entry.GetSwapOffset() != sector_offset + i * ams::svc::SwapSectorsPerPage) {
+                continue;
+            }
+
+            const PageTableEntry resident_entry = PageTableEntry(PageTableEntry::BlockTag{}, phys_addrs[i], this->GetSwapInEntryTemplate(address + i * PageSize), GetRemapSoftwareReservedBits(entry), false, true);
+            any_executable |= StoreSwappedInPageForExecute(phys_addrs[i], resident_entry);
+
+            *context.level_entries[context.level] = resident_entry;
+            KSwapManager::ReleaseSwapOffset(entry.GetSwapOffset());
+            phys_addrs[i] = Null<KPhysicalAddress>;
+            ++num_installed;
+        }
+
+        /* An invalid entry can't be cached in the TLB, so a single barrier makes the whole range visible. */
+        if (num_installed > 0) {
+            cpu::DataSynchronizationBarrierInnerShareableStore();
+            if (any_executable) {
+                cpu::InvalidateEntireInstructionCache();
+            }
+
+            /* Re-form any blocks which are now entirely resident. */
+            PageLinkedList page_list;
+            this->MergeResidentPages(address, num_pages, std::addressof(page_list));
+            this->FinalizeUpdate(std::addressof(page_list));
+        }
+
+        /* Wake up the faulting thread, along with any threads which faulted on the page after it. */
+        {
+            KScopedSchedulerLock sl;
+            thread->GetOwnerProcess()->GetSwapFaultWaitTable().WakeAll(thread);
+        }
+
+        return num_installed;
+    }
+
+    size_t KPageTable::GetSwappedPages(ams::svc::SwapPageInfo *out_infos, KProcessAddress address, KProcessAddress end_address, size_t max_count) {
+        /* Lock the table. */
+        KScopedLightLock lk(this->GetLock());
+
+        /* Begin traversal. */
         auto &impl = this->GetImpl();
         TraversalContext context;
-        TraversalEntry entry;
+        TraversalEntry t_entry;
+        impl.BeginTraversal(std::addressof(t_entry), std::addressof(context), address);
 
-        bool valid = impl.BeginTraversal(std::addressof(entry), std::addressof(context), this->GetAddressSpaceStart());
-        while (valid && entry.block_size > 0) {
+        /* Walk the range in address order, so that the caller can resume after the last page we report. */
+        KProcessAddress cur_address = address;
+        size_t count = 0;
+        while (t_entry.block_size != 0 && count < max_count) {
             if (context.level == KPageTableImpl::EntryLevel_L3) {
-                PageTableEntry pte = *context.level_entries[context.level];
-                if (pte.IsSwapped()) {
-                    /* TODO: Trigger high-priority fetch for this page. */
-                    /* For now, just clear the bit to stop future faults (unsafe if data not resident). */
-                    pte.SetSwapped(false);
-                    *context.level_entries[context.level] = pte;
+                const PageTableEntry entry = *context.level_entries[context.level];
+                if (!entry.IsMapped() && entry.IsSwapped()) {
+                    out_infos[count++] = { .address = GetInteger(cur_address), .swap_offset = entry.GetSwapOffset() };
                 }
             }
-            valid = impl.ContinueTraversal(std::addressof(entry), std::addressof(context));
+
+            /* Advance to the next entry. */
+            cur_address = util::AlignDown(GetInteger(cur_address), t_entry.block_size) + t_entry.block_size;
+            if (cur_address >= end_address) {
+                break;
+            }
+
+            impl.ContinueTraversal(std::addressof(t_entry), std::addressof(context));
         }
 
-        this->NoteUpdated();
-        R_SUCCEED();
+        return count;
     }
 
-    Result KPageTable::MarkAsResidentAndWake(KProcessAddress virt_addr, KPhysicalAddress phys_addr, KThread *thread) {
-        /* This function is called after sys-swap completes. */
+    size_t KPageTable::GetResidentPages(u64 *out_addresses, KProcessAddress address, KProcessAddress end_address, size_t max_count) {
+        /* Lock the table. */
         KScopedLightLock lk(this->GetLock());
 
-        /* Re-map page. */
-        /* Note: If another thread already restored the page, we ignore the error and still wake this thread. */
-        {
-            const auto res = this->MarkAsResident(virt_addr, phys_addr);
-            if (R_FAILED(res) && !svc::ResultInvalidState::Includes(res)) {
-                return res;
+        /* Begin traversal. */
+        auto &impl = this->GetImpl();
+        TraversalContext context;
+        TraversalEntry t_entry;
+        bool is_valid = impl.BeginTraversal(std::addressof(t_entry), std::addressof(context), address);
+
+        /* Walk the range in address order, so that the caller can resume after the last page we report. */
+        KProcessAddress cur_address = address;
+        size_t count = 0;
+        while (t_entry.block_size != 0 && count < max_count) {
+            /* Report the pages which the LRU tracker would, as only those can be swapped or discarded. */
+            if (is_valid && (context.level == KPageTableImpl::EntryLevel_L3 || context.level == KPageTableImpl::EntryLevel_L2)) {
+                const KProcessAddress block_address    = util::AlignDown(GetInteger(cur_address), t_entry.block_size);
+                const KPhysicalAddress block_phys_addr = util::AlignDown(GetInteger(t_entry.phys_addr), t_entry.block_size);
+
+                const PageTableEntry entry = *context.level_entries[context.level];
+                if (entry.IsMapped() && (entry.IsUserAccessible() || !entry.IsUserExecuteNever()) && this->IsHeapPhysicalAddress(block_phys_addr, t_entry.block_size)) {
+                    const KProcessAddress report_end = std::min(block_address + t_entry.block_size, end_address);
+                    for (KProcessAddress page_address = std::max(block_address, address); page_address < report_end && count < max_count; page_address += PageSize) {
+                        out_addresses[count++] = GetInteger(page_address);
+                    }
+                }
             }
+
+            /* Advance to the next entry. */
+            cur_address = util::AlignDown(GetInteger(cur_address), t_entry.block_size) + t_entry.block_size;
+            if (cur_address >= end_address) {
+                break;
+            }
+
+            is_valid = impl.ContinueTraversal(std::addressof(t_entry), std::addressof(context));
         }
 
-        /* TLB Maintenance: Invalidate specific Virtual Address for the current ASID. */
-        /* Note: This prevents the CPU from re-triggering the same fault due to stale TLB entries. */
-        cpu::InvalidateTlbByVaDataOnly(virt_addr);
-        cpu::DataSynchronizationBarrierInnerShareable();
-        cpu::DataSynchronizationBarrier();
+        return count;
+    }
 
-        /* Wake up the thread. */
-        KScopedSchedulerLock sl;
-        if (thread->GetState() == KThread::ThreadState_Waiting) {
-            KScheduler::SetThreadState(thread, KThread::ThreadState_Runnable);
+    size_t KPageTable::RestoreSwappedPages(const ams::svc::SwapPageInfo *infos, KPhysicalAddress *phys_addrs, size_t num_pages) {
+        /* Lock the table. */
+        KScopedLightLock lk(this->GetLock());
+
+        /* Map each page which is still swapped out to the offset its contents were read from. */
+        /* NOTE: Frames which are installed are taken from the array; the caller is responsible for closing the rest. */
+        auto &impl = this->GetImpl();
+        size_t num_restored = 0;
+        bool any_executable = false;
+        for (size_t i = 0; i < num_pages; ++i) {
+            TraversalContext context;
+            TraversalEntry t_entry;
+            if (!impl.BeginTraversal(std::addressof(t_entry), std::addressof(context), infos[i].address) || context.level != KPageTableImpl::EntryLevel_L3) {
+                continue;
+            }
+
+            const PageTableEntry entry = *context.level_entries[context.level];
+            if (entry.IsMapped() || !entry.IsSwapped() || entry.GetSwapOffset() != infos[i].swap_offset) {
+                continue;
+            }
+
+            const PageTableEntry resident_entry = PageTableEntry(PageTableEntry::BlockTag{}, phys_addrs[i], this->GetSwapInEntryTemplate(infos[i].address), GetRemapSoftwareReservedBits(entry), false, true);
+            any_executable |= StoreSwappedInPageForExecute(phys_addrs[i], resident_entry);
+
+            *context.level_entries[context.level] = resident_entry;
+            KSwapManager::ReleaseSwapOffset(entry.GetSwapOffset());
+            phys_addrs[i] = Null<KPhysicalAddress>;
+            ++num_restored;
         }
 
-        R_SUCCEED();
+        /* An invalid entry can't be cached in the TLB, so a single barrier makes the whole batch visible. */
+        if (num_restored > 0) {
+            cpu::DataSynchronizationBarrierInnerShareableStore();
+            if (any_executable) {
+                cpu::InvalidateEntireInstructionCache();
+            }
+
+            /* Re-form any blocks which are now entirely resident. */
+            PageLinkedList page_list;
+            for (size_t i = 0; i < num_pages; ++i) {
+                if (phys_addrs[i] == Null<KPhysicalAddress>) {
+                    this->MergeResidentPages(infos[i].address, 1, std::addressof(page_list));
+                }
+            }
+            this->FinalizeUpdate(std::addressof(page_list));
+        }
+
+        return num_restored;
     }
 
-    Result KPageTable::MarkAsSwappedEvict(KProcessAddress virt_addr, u64 sector_offset) {
+    Result KPageTable::MarkAsSwappedEvict(u64 process_id, KProcessAddress virt_addr, bool clean, PageLinkedList *page_list) {
         MESOSPHERE_ASSERT(this->IsLockedByCurrentThread());
 
         /* Traversal to find the entry. */
@@ -253,44 +468,659 @@ namespace ams::kern::arch::arm64 {
         TraversalEntry t_entry;
         R_UNLESS(impl.BeginTraversal(std::addressof(t_entry), std::addressof(context), virt_addr), svc::ResultInvalidAddress());
 
-        /* Ensure we are dealing with a Page descriptor. */
-        R_UNLESS(context.level == KPageTableImpl::EntryLevel_L3, svc::ResultInvalidState());
+        /* Ensure page is resident, and not already swapped or being swapped. */
+        R_UNLESS(context.level_entries[context.level]->IsMapped() && !context.level_entries[context.level]->IsSwapped() && !context.level_entries[context.level]->IsSwapPending(), svc::ResultInvalidState());
 
-        PageTableEntry entry = *context.level_entries[context.level];
+        /* Ensure that the page is heap memory that we can free once it has been written. */
+        const KPhysicalAddress phys_addr = t_entry.phys_addr;
+        R_UNLESS(this->IsHeapPhysicalAddress(phys_addr), svc::ResultInvalidState());
 
-        /* Ensure page is resident and not already swapped. */
-        R_UNLESS(entry.IsMapped() && !entry.IsSwapped(), svc::ResultInvalidState());
+        /* Ensure that nothing else refers to the page, as nothing else would see it leave. */
+        /* NOTE: Memory in a swappable state can still be shared, e.g. mapped into a debugger with MapProcessMemory. */
+        R_UNLESS(Kernel::GetMemoryManager().GetReferenceCount(phys_addr) == 1, svc::ResultInvalidState());
 
-        /* Dirty-Page Optimization: If not dirty, we don't need to write to SD. */
-        bool is_dirty = entry.IsDirty();
+        /* If the page is part of a block or contiguous run, split it out so that it can be swapped on its own. */
+        R_TRY(this->SeparatePageForSwap(std::addressof(t_entry), std::addressof(context), virt_addr, page_list));
 
-        if (is_dirty) {
-            /* TODO: Signal sys-swap to WRITE this page to the sector_offset. */
-            MESOSPHERE_LOG("Evicting Dirty Page: %lx -> %lx\n", virt_addr, sector_offset);
-        } else {
-            MESOSPHERE_LOG("Evicting Clean Page: %lx (discarding)\n", virt_addr);
-        }
+        PageTableEntry entry = *context.level_entries[context.level];
+
+        /* Hand the page to sys-swap. The eviction queue holds a reference to the page until the write completes. */
+        /* NOTE: The dirty bit is not maintained by hardware, so every evicted page must be written back, unless it */
+        /* NOTE: is code which can never have been written, in which case sys-swap may drop it and reload it later.  */
+        R_TRY(KSwapManager::EnqueueEviction(process_id, virt_addr, phys_addr, clean));
 
-        /* Update state. */
+        /* Unmap the page, but keep the physical address in the entry so that the eviction can be cancelled. */
         entry.SetMapped(false);
-        entry.SetSwapped(true);
-        entry.SetSwapOffset(sector_offset);
-        entry.SetDirty(false); // Reset dirty bit for future residency
+        entry.SetSwapPending(true);
 
         /* Update the entry in the table. */
+        /* NOTE: The caller is responsible for TLB maintenance, so that it may be batched. */
         *context.level_entries[context.level] = entry;
 
-        /* Invalidate TLB. */
-        this->NoteUpdated();
+        R_SUCCEED();
+    }
+
+    Result KPageTable::EvictSwapPages(size_t *out_num_evicted, u64 process_id, KProcessAddress address, size_t num_pages) {
+        /* Lock the table. */
+        KScopedLightLock lk(this->GetLock());
+
+        /* Validate that the memory may be swapped. */
+        /* NOTE: Swap faults are only handled inside the heap, alias and process code regions. */
+        R_UNLESS(this->ContainsPages(address, num_pages),                  svc::ResultInvalidCurrentMemory());
+
+        /* Stop at the end of the memory block containing the address, as the pages after it are in another state. */
+        num_pages = std::min(num_pages, this->GetNumPagesToBlockEnd(address));
+        R_UNLESS(num_pages > 0,                                            svc::ResultInvalidCurrentMemory());
+        R_UNLESS(this->IsInSwappableRegion(address, num_pages * PageSize), svc::ResultInvalidMemoryRegion());
+
+        /* The kernel may be operating on the process's memory after making it resident, e.g. for an ipc request in flight. */
+        R_UNLESS(!this->IsSwapHeld(),                                      svc::ResultBusy());
+
+        /* The process's unmodified code is never written back; it is discarded instead. Its data is swapped like heap memory. */
+        const bool clean = this->IsInProcessCodeRegion(address, num_pages * PageSize) && R_SUCCEEDED(this->CheckMemoryStateForDiscard(address, num_pages * PageSize));
+        if (!clean) {
+            R_TRY(this->CheckMemoryStateForSwap(address, num_pages * PageSize));
+        }
+
+        /* Splitting large mappings may need new tables. */
+        PageLinkedList page_list;
+        ON_SCOPE_EXIT { this->FinalizeUpdate(std::addressof(page_list)); };
 
+        /* Evict as many pages as we can. */
+        Result result = ResultSuccess();
+        size_t num_evicted = 0;
+        while (num_evicted < num_pages) {
+            result = this->MarkAsSwappedEvict(process_id, address + num_evicted * PageSize, clean, std::addressof(page_list));
+            if (R_FAILED(result)) {
+                break;
+            }
+
+            ++num_evicted;
+        }
+
+        /* If we evicted anything, perform a single TLB maintenance pass for the whole batch. */
+        if (num_evicted > 0) {
+            this->NoteUpdated();
+        }
+
+        /* If we couldn't evict anything, return the reason why. */
+        R_UNLESS(num_evicted > 0, result);
+
+        *out_num_evicted = num_evicted;
         R_SUCCEED();
     }
 
-    bool KPageTable::IsAppletRegion(KProcessAddress virt_addr) const {
-        /* Applet region typically starts at 0x10000000. */
-        constexpr KProcessAddress AppletRegionStart = 0x10000000ul;
-        constexpr size_t AppletRegionSize = 512 * 1024 * 1024; // 512MB
-        return AppletRegionStart <= virt_addr && virt_addr < AppletRegionStart + AppletRegionSize;
+    bool KPageTable::CompleteSwapEviction(u32 eviction_id, KProcessAddress virt_addr, KPhysicalAddress phys_addr, u64 sector_offset, bool written) {
+        /* Lock the table. */
+        KScopedLightLock lk(this->GetLock());
+
+        /* If the eviction was cancelled by a fault, the page has already been restored. */
+        if (KSwapManager::IsEvictionCancelled(eviction_id)) {
+            return false;
+        }
+
+        /* Find the entry. */
+        auto &impl = this->GetImpl();
+        TraversalContext context;
+        TraversalEntry t_entry;
+        if (!impl.BeginTraversal(std::addressof(t_entry), std::addressof(context), virt_addr) || context.level != KPageTableImpl::EntryLevel_L3) {
+            return false;
+        }
+
+        /* Ensure the entry still refers to the page being evicted (it may have been unmapped in the meantime). */
+        PageTableEntry entry = *context.level_entries[context.level];
+        if (entry.IsMapped() || !entry.IsSwapPending() || t_entry.phys_addr != phys_addr) {
+            return false;
+        }
+
+        entry.SetSwapPending(false);
+        if (written) {
+            /* The page's contents are durable, so replace the physical address with the swap offset. */
+            entry.SetSwapped(true);
+            entry.SetSwapOffset(sector_offset);
+            *context.level_entries[context.level] = entry;
+
+            /* Release the table's reference to the page. */
+            Kernel::GetMemoryManager().Close(phys_addr, 1);
+            return true;
+        } else {
+            /* The write failed, so the page must stay resident. */
+            entry.SetMapped(true);
+            *context.level_entries[context.level] = entry;
+            cpu::DataSynchronizationBarrierInnerShareableStore();
+
+            /* The page kept its frame, so its block may be re-formed. */
+            PageLinkedList page_list;
+            this->MergeResidentPages(virt_addr, 1, std::addressof(page_list));
+            this->FinalizeUpdate(std::addressof(page_list));
+            return false;
+        }
+    }
+
+    bool KPageTable::RelocateSwappedPage(KProcessAddress virt_addr, u64 old_offset, u64 new_offset) {
+        /* Lock the table. */
+        KScopedLightLock lk(this->GetLock());
+
+        /* Find the entry. */
+        auto &impl = this->GetImpl();
+        TraversalContext context;
+        TraversalEntry t_entry;
+        if (!impl.BeginTraversal(std::addressof(t_entry), std::addressof(context), virt_addr) || context.level != KPageTableImpl::EntryLevel_L3) {
+            return false;
+        }
+
+        /* Only move a page which is still swapped out where sys-swap found it. If it has been restored since, its old */
+        /* offset has already been released, and sys-swap frees the copy it just wrote instead.                        */
+        PageTableEntry entry = *context.level_entries[context.level];
+        if (entry.IsMapped() || !entry.IsSwapped() || entry.GetSwapOffset() != old_offset) {
+            return false;
+        }
+
+        /* NOTE: The entry isn't mapped, so no TLB maintenance is needed. */
+        entry.SetSwapOffset(new_offset);
+        *context.level_entries[context.level] = entry;
+
+        return true;
+    }
+
+    bool KPageTable::CancelSwapEviction(u64 process_id, KProcessAddress virt_addr) {
+        MESOSPHERE_ASSERT(this->IsLockedByCurrentThread());
+
+        /* Find the entry. */
+        auto &impl = this->GetImpl();
+        TraversalContext context;
+        TraversalEntry t_entry;
+        if (!impl.BeginTraversal(std::addressof(t_entry), std::addressof(context), virt_addr) || context.level != KPageTableImpl::EntryLevel_L3) {
+            return false;
+        }
+
+        /* Check that the page is still waiting to be written. */
+        PageTableEntry entry = *context.level_entries[context.level];
+        if (entry.IsMapped() || !entry.IsSwapPending()) {
+            return false;
+        }
+
+        /* Cancel the eviction, so that it is not finalized after the write completes. */
+        KSwapManager::CancelEviction(process_id, util::AlignDown(GetInteger(virt_addr), PageSize));
+
+        /* Restore the mapping. The page was never freed, so its contents are still valid. */
+        entry.SetSwapPending(false);
+        entry.SetMapped(true);
+        *context.level_entries[context.level] = entry;
+
+        /* An invalid entry can't be cached in the TLB, so we only need to ensure the write is visible. */
+        cpu::DataSynchronizationBarrierInnerShareableStore();
+
+        /* The page kept its frame, so its block may be re-formed. */
+        {
+            PageLinkedList page_list;
+            this->MergeResidentPages(util::AlignDown(GetInteger(virt_addr), PageSize), 1, std::addressof(page_list));
+            this->FinalizeUpdate(std::addressof(page_list));
+        }
+
+        return true;
+    }
+
+    bool KPageTable::FindSwappedPageImpl(KProcessAddress *out_address, u64 *out_swap_offset, KProcessAddress address, size_t size) {
+        MESOSPHERE_ASSERT(this->IsLockedByCurrentThread());
+
+        const KProcessAddress end_address = address + size;
+
+        /* Begin traversal. */
+        auto &impl = this->GetImpl();
+        TraversalContext context;
+        TraversalEntry t_entry;
+        impl.BeginTraversal(std::addressof(t_entry), std::addressof(context), address);
+
+        /* Walk the range, restoring any page which is still waiting to be written, until we find one which has been swapped out. */
+        /* NOTE: Pages are swapped individually, so a swapped or evicting entry is always a lone L3 page. */
+        KProcessAddress cur_address = address;
+        bool found     = false;
+        bool cancelled = false;
+        while (t_entry.block_size != 0) {
+            if (context.level == KPageTableImpl::EntryLevel_L3) {
+                PageTableEntry entry = *context.level_entries[context.level];
+                if (!entry.IsMapped() && entry.IsSwapped()) {
+                    *out_address     = util::AlignDown(GetInteger(cur_address), PageSize);
+                    *out_swap_offset = entry.GetSwapOffset();
+                    found = true;
+                    break;
+                } else if (!entry.IsMapped() && entry.IsSwapPending()) {
+                    /* The page was never freed, so cancel the eviction and restore the mapping. */
+                    KSwapManager::CancelEviction(t_entry.phys_addr);
+
+                    entry.SetSwapPending(false);
+                    entry.SetMapped(true);
+                    *context.level_entries[context.level] = entry;
+                    cancelled = true;
+                }
+            }
+
+            /* Advance to the next entry. */
+            cur_address = util::AlignDown(GetInteger(cur_address), t_entry.block_size) + t_entry.block_size;
+            if (cur_address >= end_address) {
+                break;
+            }
+
+            impl.ContinueTraversal(std::addressof(t_entry), std::addressof(context));
+        }
+
+        /* If we restored any pages, make the entries visible and re-form their blocks. */
+        if (cancelled) {
+            /* An invalid entry can't be cached in the TLB, so we only need to ensure the writes are visible. */
+            cpu::DataSynchronizationBarrierInnerShareableStore();
+
+            const KProcessAddress aligned_start = util::AlignDown(GetInteger(address), PageSize);
+            const KProcessAddress aligned_end   = util::AlignUp(GetInteger(end_address), PageSize);
+
+            PageLinkedList page_list;
+            this->MergeResidentPages(aligned_start, (aligned_end - aligned_start) / PageSize, std::addressof(page_list));
+            this->FinalizeUpdate(std::addressof(page_list));
+        }
+
+        return found;
+    }
+
+    void KPageTable::SweepAccessFlags(KProcessAddress address, size_t size, AccessFlagSweepCallback callback, void *arg) {
+        MESOSPHERE_ASSERT(this->IsLockedByCurrentThread());
+
+        const KProcessAddress end_address = address + size;
+
+        /* Begin traversal. */
+        auto &impl = this->GetImpl();
+        TraversalContext context;
+        TraversalEntry t_entry;
+        bool is_valid = impl.BeginTraversal(std::addressof(t_entry), std::addressof(context), address);
+
+        /* Walk the range. */
+        KProcessAddress cur_address = address;
+        bool cleared = false;
+        while (t_entry.block_size != 0) {
+            /* Blocks and contiguous runs are aged as a whole; they're only split once one of their pages is swapped out. */
+            /* NOTE: Every entry of a contiguous run must agree on its access flag, so the whole run is cleared together. */
+            if (is_valid && (context.level == KPageTableImpl::EntryLevel_L3 || (context.level == KPageTableImpl::EntryLevel_L2 && !context.is_contiguous))) {
+                PageTableEntry *pte = context.level_entries[context.level];
+                size_t num_entries  = 1;
+                if (context.is_contiguous) {
+                    pte         = reinterpret_cast<PageTableEntry *>(util::AlignDown(reinterpret_cast<uintptr_t>(pte), BlocksPerContiguousBlock * sizeof(PageTableEntry)));
+                    num_entries = BlocksPerContiguousBlock;
+                }
+
+                const KProcessAddress block_address   = util::AlignDown(GetInteger(cur_address), t_entry.block_size);
+                const KPhysicalAddress block_phys_addr = util::AlignDown(GetInteger(t_entry.phys_addr), t_entry.block_size);
+
+                /* Track every user heap page which the user can read or execute. Clean code and read-only pages are discarded, and all others are swapped. */
+                const PageTableEntry entry = *pte;
+                if (entry.IsMapped() && (entry.IsUserAccessible() || !entry.IsUserExecuteNever()) && this->IsHeapPhysicalAddress(block_phys_addr, t_entry.block_size)) {
+                    bool accessed = false;
+                    for (size_t i = 0; i < num_entries; ++i) {
+                        if (pte[i].GetAccessFlag() == PageTableEntry::AccessFlag_Accessed) {
+                            pte[i].SetAccessFlag(PageTableEntry::AccessFlag_NotAccessed);
+                            accessed = true;
+                        }
+                    }
+                    cleared |= accessed;
+
+                    /* Report each page of the block which is inside the range. */
+                    const KProcessAddress report_start = std::max(block_address, address);
+                    const KProcessAddress report_end   = std::min(block_address + t_entry.block_size, end_address);
+                    for (KProcessAddress page_address = report_start; page_address < report_end; page_address += PageSize) {
+                        callback(page_address, accessed, arg);
+                    }
+                }
+            }
+
+            /* Advance to the next entry. */
+            cur_address = util::AlignDown(GetInteger(cur_address), t_entry.block_size) + t_entry.block_size;
+            if (cur_address >= end_address) {
+                break;
+            }
+
+            is_valid = impl.ContinueTraversal(std::addressof(t_entry), std::addressof(context));
+        }
+
+        /* Invalidate the entries we cleared, so that the next access to each will fault. */
+        if (cleared) {
+            this->NoteUpdated();
+        }
+    }
+
+    bool KPageTable::RestoreAccessFlag(KProcessAddress virt_addr) {
+        MESOSPHERE_ASSERT(this->IsLockedByCurrentThread());
+
+        /* Find the entry. */
+        auto &impl = this->GetImpl();
+        TraversalContext context;
+        TraversalEntry t_entry;
+        if (!impl.BeginTraversal(std::addressof(t_entry), std::addressof(context), virt_addr) || context.level == KPageTableImpl::EntryLevel_L1) {
+            return false;
+        }
+
+        /* Check that the page is mapped. */
+        if (!context.level_entries[context.level]->IsMapped()) {
+            return false;
+        }
+
+        /* The sweeper clears every entry of a contiguous run, so every entry must be restored. */
+        PageTableEntry *pte = context.level_entries[context.level];
+        size_t num_entries  = 1;
+        if (context.is_contiguous) {
+            pte         = reinterpret_cast<PageTableEntry *>(util::AlignDown(reinterpret_cast<uintptr_t>(pte), BlocksPerContiguousBlock * sizeof(PageTableEntry)));
+            num_entries = BlocksPerContiguousBlock;
+        }
+
+        /* Set the access flag, if another thread hasn't already done so. */
+        bool restored = false;
+        for (size_t i = 0; i < num_entries; ++i) {
+            if (pte[i].GetAccessFlag() == PageTableEntry::AccessFlag_NotAccessed) {
+                pte[i].SetAccessFlag(PageTableEntry::AccessFlag_Accessed);
+                restored = true;
+            }
+        }
+
+        /* An entry with its access flag clear can't be cached in the TLB, so we only need to ensure the writes are visible. */
+        if (restored) {
+            cpu::DataSynchronizationBarrierInnerShareableStore();
+        }
+
+        return true;
+    }
+
+    bool KPageTable::RestoreAccessFlagWithoutLock(KProcessAddress virt_addr) {
+        /* NOTE: The kernel reads user memory with the scheduler lock held, so this can't take our lock. Instead, it only      */
+        /* ever sets the access flag of an entry which is still mapped, by compare-exchange, so that it never overwrites an    */
+        /* update made under our lock. A table freed by a concurrent unmap may still be walked, as it may by the hardware walk */
+        /* which faulted, but page table pages are only ever reused as page tables, where setting the flag is harmless.        */
+        KScopedInterruptDisable di;
+
+        /* Find the entry. */
+        auto &impl = this->GetImpl();
+        TraversalContext context;
+        TraversalEntry t_entry;
+        if (!impl.BeginTraversal(std::addressof(t_entry), std::addressof(context), virt_addr) || context.level == KPageTableImpl::EntryLevel_L1) {
+            return false;
+        }
+
+        /* The sweeper clears every entry of a contiguous run, so every entry must be restored. */
+        PageTableEntry *pte = context.level_entries[context.level];
+        size_t num_entries  = 1;
+        if (context.is_contiguous) {
+            pte         = reinterpret_cast<PageTableEntry *>(util::AlignDown(reinterpret_cast<uintptr_t>(pte), BlocksPerContiguousBlock * sizeof(PageTableEntry)));
+            num_entries = BlocksPerContiguousBlock;
+        }
+
+        /* Set the access flag of each entry, unless it has been unmapped or another thread has already set it. */
+        bool restored = false;
+        for (size_t i = 0; i < num_entries; ++i) {
+            util::AtomicRef<u64> entry_ref(*reinterpret_cast<u64 *>(pte + i));
+
+            u64 cur_entry = entry_ref.Load();
+            while (true) {
+                const PageTableEntry entry(cur_entry);
+                if (!entry.IsMapped()) {
+                    return false;
+                }
+                if (entry.GetAccessFlag() == PageTableEntry::AccessFlag_Accessed) {
+                    break;
+                }
+
+                /* An entry which is being promoted is about to be replaced, so the access must be retried until it has been. */
+                if (entry.IsPromoting()) {
+                    return true;
+                }
+
+                if (entry_ref.CompareExchangeStrong(cur_entry, cur_entry | static_cast<u64>(PageTableEntry::AccessFlag_Accessed))) {
+                    restored = true;
+                    break;
+                }
+            }
+        }
+
+        /* An entry with its access flag clear can't be cached in the TLB, so we only need to ensure the writes are visible. */
+        if (restored) {
+            cpu::DataSynchronizationBarrierInnerShareableStore();
+        }
+
+        return true;
+    }
+
+    PageTableEntry *KPageTable::GetHugePageCandidateEntries(KProcessAddress address) {
+        MESOSPHERE_ASSERT(this->IsLockedByCurrentThread());
+        MESOSPHERE_ASSERT(util::IsAligned(GetInteger(address), L2BlockSize));
+
+        /* The span must be mapped by a table of pages. */
+        auto &impl = this->GetImpl();
+        TraversalContext context;
+        TraversalEntry t_entry;
+        if (!impl.BeginTraversal(std::addressof(t_entry), std::addressof(context), address) || context.level != KPageTableImpl::EntryLevel_L3) {
+            return nullptr;
+        }
+
+        /* Only user read-write heap pages may be moved, as only those are guaranteed to be ours to replace. */
+        PageTableEntry *pte = context.level_entries[context.level];
+        if (!pte->IsUserAccessible() || pte->IsReadOnly() || !pte->IsUserExecuteNever()) {
+            return nullptr;
+        }
+
+        /* Every page must be resident, heap-backed, and share the first page's attributes (other than the access flag). */
+        /* Its frame must also be ours alone, as anything else referring to it would be left with the old frame. */
+        auto &mm = Kernel::GetMemoryManager();
+        const u64 entry_template = pte->GetEntryTemplateForMerge() & ~static_cast<u64>(PageTableEntry::AccessFlag_Accessed);
+        for (size_t i = 0; i < BlocksPerTable; ++i) {
+            if (!pte[i].IsMapped() || (pte[i].GetEntryTemplateForMerge() & ~static_cast<u64>(PageTableEntry::AccessFlag_Accessed)) != entry_template) {
+                return nullptr;
+            }
+            if (const KPhysicalAddress phys_addr = GetPagePhysicalAddress(pte[i]); !this->IsHeapPhysicalAddress(phys_addr) || mm.GetReferenceCount(phys_addr) != 1) {
+                return nullptr;
+            }
+            if (i > 0 && pte[i].IsHeadOrHeadAndBodyMergeDisabled()) {
+                return nullptr;
+            }
+            if (i < BlocksPerTable - 1 && pte[i].IsTailMergeDisabled()) {
+                return nullptr;
+            }
+        }
+
+        /* The memory must be heap, and not locked, e.g. by an in-progress ipc or device mapping. */
+        if (R_FAILED(this->CheckMemoryStateForHugePage(address, L2BlockSize))) {
+            return nullptr;
+        }
+
+        return pte;
+    }
+
+    KProcessAddress KPageTable::FindHugePageCandidate(KProcessAddress address, KProcessAddress end_address) {
+        KScopedLightLock lk(this->GetLock());
+
+        auto &impl = this->GetImpl();
+        for (KProcessAddress cur_address = util::AlignUp(GetInteger(address), L2BlockSize); cur_address + L2BlockSize <= end_address; /* ... */) {
+            /* Skip any region which isn't split below the block level. */
+            TraversalContext context;
+            TraversalEntry t_entry;
+            if (!impl.BeginTraversal(std::addressof(t_entry), std::addressof(context), cur_address) || context.level != KPageTableImpl::EntryLevel_L3) {
+                const size_t skip_size = (context.level == KPageTableImpl::EntryLevel_L1) ? L1BlockSize : L2BlockSize;
+                cur_address = util::AlignDown(GetInteger(cur_address), skip_size) + skip_size;
+                continue;
+            }
+
+            if (this->GetHugePageCandidateEntries(cur_address) != nullptr) {
+                return cur_address;
+            }
+
+            cur_address += L2BlockSize;
+        }
+
+        return Null<KProcessAddress>;
+    }
+
+    Result KPageTable::PromoteHugePage(KProcessAddress address, u32 allocate_option) {
+        /* NOTE: The process may write to pages while they're copied, so writes which race with the copy are detected via the access flag. */
+        /* This relies on nothing else clearing access flags concurrently, so this must only be called from the lru sweeper thread.        */
+        constexpr size_t NumPages       = L2BlockSize / PageSize;
+        constexpr size_t CopyChunkPages = BlocksPerContiguousBlock;
+        constexpr size_t MaxRecopyPages = 0x10;
+
+        auto &mm = Kernel::GetMemoryManager();
+
+        /* If the frames already form a block, the span only needs to be merged. */
+        {
+            KScopedLightLock lk(this->GetLock());
+
+            PageTableEntry *pte = this->GetHugePageCandidateEntries(address);
+            R_UNLESS(pte != nullptr, svc::ResultInvalidState());
+
+            const KPhysicalAddress phys_addr = GetPagePhysicalAddress(pte[0]);
+            if (util::IsAligned(GetInteger(phys_addr), L2BlockSize)) {
+                bool contiguous = true;
+                for (size_t i = 1; i < NumPages && contiguous; ++i) {
+                    contiguous = GetPagePhysicalAddress(pte[i]) == phys_addr + i * PageSize;
+                }
+
+                if (contiguous) {
+                    for (size_t i = 0; i < NumPages; ++i) {
+                        pte[i].SetAccessFlag(PageTableEntry::AccessFlag_Accessed);
+                    }
+                    cpu::DataSynchronizationBarrierInnerShareableStore();
+
+                    PageLinkedList page_list;
+                    this->MergeResidentPages(address, NumPages, std::addressof(page_list));
+                    this->FinalizeUpdate(std::addressof(page_list));
+
+                    R_SUCCEED();
+                }
+            }
+        }
+
+        /* Allocate the block the pages will be moved into. */
+        const KPhysicalAddress block = mm.AllocateAndOpenContinuous(NumPages, NumPages, allocate_option);
+        R_UNLESS(block != Null<KPhysicalAddress>, svc::ResultOutOfMemory());
+        ON_RESULT_FAILURE { mm.Close(block, NumPages); };
+
+        /* Clear the access flag of every page, so that we can tell which pages are touched while we copy. */
+        {
+            KScopedLightLock lk(this->GetLock());
+
+            PageTableEntry *pte = this->GetHugePageCandidateEntries(address);
+            R_UNLESS(pte != nullptr, svc::ResultInvalidState());
+
+            for (size_t i = 0; i < NumPages; ++i) {
+                pte[i].SetAccessFlag(PageTableEntry::AccessFlag_NotAccessed);
+            }
+            this->NoteUpdated();
+        }
+
+        /* Copy the pages a run at a time, so that faults on the span aren't held up for too long. */
+        for (size_t i = 0; i < NumPages; i += CopyChunkPages) {
+            KScopedLightLock lk(this->GetLock());
+
+            PageTableEntry *pte = this->GetHugePageCandidateEntries(address);
+            R_UNLESS(pte != nullptr, svc::ResultInvalidState());
+
+            for (size_t j = i; j < i + CopyChunkPages; ++j) {
+                std::memcpy(GetVoidPointer(GetHeapVirtualAddress(block + j * PageSize)), GetVoidPointer(GetHeapVirtualAddress(GetPagePhysicalAddress(pte[j]))), PageSize);
+            }
+        }
+
+        /* Move the span into the block. */
+        KScopedLightLock lk(this->GetLock());
+
+        PageTableEntry *pte = this->GetHugePageCandidateEntries(address);
+        R_UNLESS(pte != nullptr, svc::ResultInvalidState());
+
+        /* Any page which was touched during the copy may have been written after we copied it. */
+        size_t num_touched = 0;
+        for (size_t i = 0; i < NumPages; ++i) {
+            num_touched += (pte[i].GetAccessFlag() == PageTableEntry::AccessFlag_Accessed) ? 1 : 0;
+        }
+        R_UNLESS(num_touched <= MaxRecopyPages, svc::ResultBusy());
+
+        /* Allocate a page to remember the old frames in, as they can only be closed once nothing can refer to them. */
+        static_assert(NumPages * sizeof(u64) <= PageSize);
+        KPageBuffer *old_frames_page = KPageBuffer::AllocateChecked<PageSize>();
+        R_UNLESS(old_frames_page != nullptr, svc::ResultOutOfResource());
+        ON_SCOPE_EXIT { KPageBuffer::Free(old_frames_page); };
+
+        u64 *old_frames = reinterpret_cast<u64 *>(old_frames_page);
+
+        /* Every page shares the first page's attributes, so the new entries can share a template. */
+        const PageTableEntry entry_template(pte[0].GetEntryTemplateForMerge() | PageTableEntry::AccessFlag_Accessed);
+
+        {
+            /* NOTE: Holding the lock keeps out user faults, but not the kernel's userspace accesses, which restore access flags   */
+            /* without it. Those wait out entries marked as promoting rather than restoring them, possibly with the scheduler lock */
+            /* held, so we must not be preempted until every entry has been replaced.                                              */
+            KScopedInterruptDisable di;
+
+            /* Break the span, by clearing each entry's access flag and marking it as promoting. */
+            /* Pages touched since they were copied, including by the kernel since we last checked, are noted to be recopied. */
+            u64 touched[NumPages / BITSIZEOF(u64)] = {};
+            num_touched = 0;
+            for (size_t i = 0; i < NumPages; ++i) {
+                util::AtomicRef<u64> entry_ref(*reinterpret_cast<u64 *>(pte + i));
+
+                u64 cur_entry = entry_ref.Load();
+                u64 new_entry;
+                do {
+                    new_entry = (cur_entry & ~static_cast<u64>(PageTableEntry::AccessFlag_Accessed)) | PageTableEntry::ExtensionFlag_Promoting;
+                } while (!entry_ref.CompareExchangeWeak(cur_entry, new_entry));
+
+                const PageTableEntry old_entry(cur_entry);
+                if (old_entry.GetAccessFlag() == PageTableEntry::AccessFlag_Accessed) {
+                    touched[i / BITSIZEOF(u64)] |= (1ul << (i % BITSIZEOF(u64)));
+                    ++num_touched;
+                }
+                old_frames[i] = GetInteger(GetPagePhysicalAddress(old_entry));
+            }
+
+            /* If too many pages were touched to recopy them quickly, give up on the span for now, and leave it to a later pass. */
+            /* NOTE: Nothing can have changed the entries since we marked them, so they can be restored as they were.           */
+            if (num_touched > MaxRecopyPages) {
+                for (size_t i = 0; i < NumPages; ++i) {
+                    util::AtomicRef<u64> entry_ref(*reinterpret_cast<u64 *>(pte + i));
+
+                    u64 entry = entry_ref.Load() & ~static_cast<u64>(PageTableEntry::ExtensionFlag_Promoting);
+                    if ((touched[i / BITSIZEOF(u64)] & (1ul << (i % BITSIZEOF(u64)))) != 0) {
+                        entry |= PageTableEntry::AccessFlag_Accessed;
+                    }
+                    entry_ref.Store(entry);
+                }
+                cpu::DataSynchronizationBarrierInnerShareableStore();
+
+                R_THROW(svc::ResultBusy());
+            }
+
+            /* Invalidate the span, so that no core can reach the old frames through a cached translation. */
+            this->NoteUpdated();
+
+            /* Recopy the touched pages, now that nothing can write to them. */
+            for (size_t i = 0; i < NumPages; ++i) {
+                if ((touched[i / BITSIZEOF(u64)] & (1ul << (i % BITSIZEOF(u64)))) != 0) {
+                    std::memcpy(GetVoidPointer(GetHeapVirtualAddress(block + i * PageSize)), GetVoidPointer(GetHeapVirtualAddress(old_frames[i])), PageSize);
+                }
+            }
+
+            /* Ensure the copies are visible before the new frames are. */
+            cpu::DataSynchronizationBarrier();
+
+            /* Make the span refer to the block. */
+            for (size_t i = 0; i < NumPages; ++i) {
+                pte[i] = PageTableEntry(PageTableEntry::BlockTag{}, block + i * PageSize, entry_template, GetRemapSoftwareReservedBits(pte[i]), false, true);
+            }
+            this->NoteUpdated();
+        }
+
+        /* Now that nothing refers to the old frames, close them. */
+        for (size_t i = 0; i < NumPages; ++i) {
+            MESOSPHERE_ASSERT(mm.GetReferenceCount(old_frames[i]) == 1);
+            mm.Close(old_frames[i], 1);
+        }
+
+        /* Merge the span into a block. */
+        PageLinkedList page_list;
+        this->MergeResidentPages(address, NumPages, std::addressof(page_list));
+        this->FinalizeUpdate(std::addressof(page_list));
+
+        R_SUCCEED();
     }
 
     void KPageTable::Finalize() {
@@ -325,8 +1155,17 @@ namespace ams::kern::arch::arm64 {
                 bool cur_valid = impl.BeginTraversal(std::addressof(entry), std::addressof(context), this->GetAddressSpaceStart());
                 while (true) {
                     if (cur_valid) {
+                        /* Release what a swapped out page holds: its swap offset, or the pending eviction of its frame. */
+                        /* NOTE: A page waiting to be written out still holds its frame, which is closed with the others below. */
+                        if (const PageTableEntry *pte = context.level_entries[context.level]; pte->IsSwapped()) {
+                            KSwapManager::ReleaseSwapOffset(pte->GetSwapOffset());
+                        } else if (pte->IsSwapPending()) {
+                            KSwapManager::CancelEviction(entry.phys_addr);
+                        }
+
                         /* Free the actual pages, if there are any. */
-                        if (IsHeapPhysicalAddressForFinalize(entry.phys_addr)) {
+                        /* NOTE: Swapped entries hold a swap offset rather than a physical address. */
+                        if (!context.level_entries[context.level]->IsSwapped() && IsHeapPhysicalAddressForFinalize(entry.phys_addr)) {
                             if (cur_size > 0) {
                                 /* NOTE: Nintendo really does check next_entry.attr == (cur_entry.attr != 0)...but attr is always zero as of 18.0.0, and this is "probably" for the new console or debug-only anyway, */
                                 /* so we'll implement the weird logic verbatim even though it doesn't match the GetContiguousRange logic. */
@@ -520,6 +1359,16 @@ namespace ams::kern::arch::arm64 {
             MESOSPHERE_ASSERT((next_entry.block_size / PageSize) <= remaining_pages);
             MESOSPHERE_ASSERT(util::IsAligned(GetInteger(next_entry.phys_addr), next_entry.block_size));
 
+            /* A swapped page holds a swap slot rather than a frame, so release the slot. A page still being evicted keeps its */
+            /* frame, which is closed below like any other; its eviction must be cancelled so that the write's pin is dropped. */
+            /* NOTE: Pages are swapped individually, so such an entry is always a lone L3 page.                                 */
+            const bool is_swapped = context.level_entries[context.level]->IsSwapped();
+            if (is_swapped) {
+                KSwapManager::ReleaseSwapOffset(context.level_entries[context.level]->GetSwapOffset());
+            } else if (context.level_entries[context.level]->IsSwapPending()) {
+                KSwapManager::CancelEviction(next_entry.phys_addr);
+            }
+
             /* Unmap the block. */
             bool freeing_table = false;
             bool need_recalculate_virt_addr = false;
@@ -563,7 +1412,7 @@ namespace ams::kern::arch::arm64 {
             }
 
             /* Close the blocks. */
-            if (!force && IsHeapPhysicalAddress(next_entry.phys_addr)) {
+            if (!force && !is_swapped && IsHeapPhysicalAddress(next_entry.phys_addr)) {
                 const size_t block_num_pages = next_entry.block_size / PageSize;
                 if (R_FAILED(pages_to_close.AddBlock(next_entry.phys_addr, block_num_pages))) {
                     this->NoteUpdated();
@@ -942,6 +1791,7 @@ namespace ams::kern::arch::arm64 {
         ON_RESULT_FAILURE { this->MergePages(context, page_list); };
 
         /* Iterate, separating until our block size is small enough. */
+        /* NOTE: Swapped and swap-pending entries are always lone L3 pages, and so are never separated here. */
         while (entry->block_size > block_size) {
             /* If necessary, allocate a table. */
             KVirtualAddress table = Null<KVirtualAddress>;
@@ -989,6 +1839,40 @@ namespace ams::kern::arch::arm64 {
         R_SUCCEED();
     }
 
+    Result KPageTable::SeparatePageForSwap(TraversalEntry *entry, TraversalContext *context, KProcessAddress virt_addr, PageLinkedList *page_list) {
+        MESOSPHERE_ASSERT(this->IsLockedByCurrentThread());
+
+        /* Pages are swapped individually, so any block or contiguous run containing the page must be split. */
+        R_SUCCEED_IF(context->level == KPageTableImpl::EntryLevel_L3 && !context->is_contiguous);
+
+        R_RETURN(this->SeparatePagesImpl(entry, context, util::AlignDown(GetInteger(virt_addr), PageSize), PageSize, page_list, false));
+    }
+
+    void KPageTable::MergeResidentPages(KProcessAddress virt_addr, size_t num_pages, PageLinkedList *page_list) {
+        MESOSPHERE_ASSERT(this->IsLockedByCurrentThread());
+
+        /* Try to merge each contiguous run touched by the range, which will in turn merge its block if possible. */
+        /* NOTE: Merging only succeeds if the run's frames are physically contiguous, e.g. because an eviction was */
+        /* cancelled, or because the frames the pages were read into happened to be allocated together.            */
+        constexpr size_t RunSize = BlocksPerContiguousBlock * PageSize;
+
+        auto &impl = this->GetImpl();
+        const KProcessAddress end_address = virt_addr + num_pages * PageSize;
+        for (KProcessAddress cur_address = util::AlignDown(GetInteger(virt_addr), RunSize); cur_address < end_address; cur_address += RunSize) {
+            TraversalContext context;
+            TraversalEntry t_entry;
+            if (!impl.BeginTraversal(std::addressof(t_entry), std::addressof(context), cur_address) || context.level != KPageTableImpl::EntryLevel_L3 || context.is_contiguous) {
+                continue;
+            }
+
+            if (!context.level_entries[context.level]->IsMapped()) {
+                continue;
+            }
+
+            this->MergePages(std::addressof(context), page_list);
+        }
+    }
+
     Result KPageTable::ChangePermissions(KProcessAddress virt_addr, size_t num_pages, PageTableEntry entry_template, DisableMergeAttribute disable_merge_attr, bool refresh_mapping, bool flush_mapping, PageLinkedList *page_list, bool reuse_ll) {
         MESOSPHERE_ASSERT(this->IsLockedByCurrentThread());
 
@@ -1077,15 +1961,28 @@ namespace ams::kern::arch::arm64 {
                 /* Encode the merge disable flags into the software reserved bits. */
                 u8 sw_reserved_bits = PageTableEntry::EncodeSoftwareReservedBits(disable_head_merge, disable_head_body_merge, disable_tail_merge);
 
+                /* Pages are swapped individually, so a swapped or evicting entry is always a lone L3 page. */
+                const bool is_swapped = context.level_entries[context.level]->IsSwapped();
+                if (context.level_entries[context.level]->IsSwapPending()) {
+                    /* The page still has its frame, so cancel the eviction and let it take the new properties while resident. */
+                    KSwapManager::CancelEviction(next_entry.phys_addr);
+                }
+
                 /* If we should flush entries, do so. */
                 if ((apply_option & ApplyOption_FlushDataCache) != 0) {
-                    if (IsHeapPhysicalAddress(next_entry.phys_addr)) {
+                    if (!is_swapped && IsHeapPhysicalAddress(next_entry.phys_addr)) {
                         MESOSPHERE_R_ABORT_UNLESS(cpu::FlushDataCache(GetVoidPointer(GetHeapVirtualAddress(next_entry.phys_addr)), next_entry.block_size));
                     }
                 }
 
                 /* Apply the entry template. */
-                {
+                if (is_swapped) {
+                    /* A swapped page has no frame to map, so it stays swapped out. It takes its block's new properties when it is restored. */
+                    PageTableEntry swapped_entry = PageTableEntry(PageTableEntry::BlockTag{}, next_entry.phys_addr, entry_template, sw_reserved_bits, false, true);
+                    swapped_entry.SetMapped(false);
+                    swapped_entry.SetSwapped(true);
+                    *context.level_entries[context.level] = swapped_entry;
+                } else {
                     const size_t num_entries = context.is_contiguous ? BlocksPerContiguousBlock : 1;
 
                     auto * const pte = context.level_entries[context.level];
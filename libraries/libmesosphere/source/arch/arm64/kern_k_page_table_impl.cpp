@@ -231,6 +231,12 @@ namespace ams::kern::arch::arm64 {
             PageTableEntry *pte = reinterpret_cast<PageTableEntry *>(util::AlignDown(reinterpret_cast<uintptr_t>(context->level_entries[context->level]), BlocksPerTable * sizeof(PageTableEntry)));
             const KPhysicalAddress phys_addr = util::AlignDown(GetBlock(pte, context->level), GetBlockSize(static_cast<EntryLevel>(context->level + 1), false));
 
+            /* Swapped pages are tracked individually, so they must never be merged. */
+            /* NOTE: The swap bits are part of the merge template, so checking the first entry covers the rest. */
+            if (pte->IsSwapped() || pte->IsSwapPending()) {
+                return false;
+            }
+
             /* First, check that all entries are valid for us to merge. */
             const u64 entry_template = pte->GetEntryTemplateForMerge();
             for (size_t i = 0; i < BlocksPerTable; ++i) {
@@ -264,6 +270,12 @@ namespace ams::kern::arch::arm64 {
             PageTableEntry *pte = reinterpret_cast<PageTableEntry *>(util::AlignDown(reinterpret_cast<uintptr_t>(context->level_entries[context->level]), BlocksPerContiguousBlock * sizeof(PageTableEntry)));
             const KPhysicalAddress phys_addr = util::AlignDown(GetBlock(pte, context->level), GetBlockSize(context->level, true));
 
+            /* Swapped pages are tracked individually, so they must never be merged. */
+            /* NOTE: The swap bits are part of the merge template, so checking the first entry covers the rest. */
+            if (pte->IsSwapped() || pte->IsSwapPending()) {
+                return false;
+            }
+
             /* First, check that all entries are valid for us to merge. */
             const u64 entry_template = pte->GetEntryTemplateForMerge();
             for (size_t i = 0; i < BlocksPerContiguousBlock; ++i) {
@@ -39,6 +39,9 @@ namespace ams::kern {
         /* Initialize the request. */
         request->Initialize(nullptr, address, size);
 
+        /* Keep the buffers the request references resident until it's finished. */
+        R_TRY(request->HoldClientBuffers());
+
         /* Send the request. */
         R_RETURN(m_parent->OnRequest(request));
     }
@@ -54,6 +57,9 @@ namespace ams::kern {
         /* Initialize the request. */
         request->Initialize(event, address, size);
 
+        /* Keep the buffers the request references resident until it's finished. */
+        R_TRY(request->HoldClientBuffers());
+
         /* Send the request. */
         R_RETURN(m_parent->OnRequest(request));
     }
@@ -36,6 +36,10 @@ namespace ams::kern::KDumpObject {
                 MESOSPHERE_RELEASE_LOG("    State: 0x%04x Suspend: 0x%04x Dpc: 0x%x\n", thread->GetRawState(), thread->GetSuspendFlags(), thread->GetDpc());
 
                 MESOSPHERE_RELEASE_LOG("    TLS: %p (%p)\n", GetVoidPointer(thread->GetThreadLocalRegionAddress()), thread->GetThreadLocalRegionHeapAddress());
+
+                if (KSwapManager::IsWaitingForFault(thread)) {
+                    MESOSPHERE_RELEASE_LOG("    Swap Fault: %p (Offset=%016lx)\n", GetVoidPointer(thread->GetSwapVirtualAddress()), thread->GetSwapSectorOffset());
+                }
             } else {
                 MESOSPHERE_RELEASE_LOG("Thread ID=%5lu pid=%3d %-11s Pri=%2d %-11s KernelStack=%4zu/%4zu Run=%d Ideal=%d (%d) Affinity=%016lx (%016lx)\n",
                                thread->GetId(), -1, "(kernel)", thread->GetPriority(), ThreadStates[thread->GetState()],
@@ -330,7 +334,8 @@ namespace ams::kern::KDumpObject {
             {
                 #define DUMP_KSLABOBJ(__OBJECT__)                                                                                                                                                         \
                     MESOSPHERE_RELEASE_LOG(#__OBJECT__ "\n");                                                                                                                                             \
-                    MESOSPHERE_RELEASE_LOG("    Cur=%3zu Peak=%3zu Max=%3zu\n", __OBJECT__::GetSlabHeapSize() - __OBJECT__::GetNumRemaining(), __OBJECT__::GetPeakIndex(), __OBJECT__::GetSlabHeapSize())
+                    MESOSPHERE_RELEASE_LOG("    Cur=%3zu Peak=%3zu Max=%3zu\n", __OBJECT__::GetSlabHeapSize() - __OBJECT__::GetNumRemaining(), __OBJECT__::GetPeakIndex(), __OBJECT__::GetSlabHeapSize()); \
+                    MESOSPHERE_RELEASE_LOG("    Hit=%lu Miss=%lu\n", __OBJECT__::GetMagazineHitCount(), __OBJECT__::GetMagazineMissCount())
 
                 DUMP_KSLABOBJ(KEvent);
                 DUMP_KSLABOBJ(KInterruptEvent);
@@ -25,6 +25,7 @@ namespace ams::kern {
         {
             KScopedDisableDispatch dd;
             KScopedSpinLock lk(m_lock);
+            KScopedUpdate up(this);
 
             std::swap(m_table_size, saved_table_size);
         }
@@ -56,6 +57,7 @@ namespace ams::kern {
         {
             KScopedDisableDispatch dd;
             KScopedSpinLock lk(m_lock);
+            KScopedUpdate up(this);
 
             if (AMS_LIKELY(this->IsValidHandle(handle))) {
                 const auto index = handle_pack.Get<HandleIndex>();
@@ -76,6 +78,7 @@ namespace ams::kern {
         MESOSPHERE_ASSERT_THIS();
         KScopedDisableDispatch dd;
         KScopedSpinLock lk(m_lock);
+        KScopedUpdate up(this);
 
         /* Never exceed our capacity. */
         R_UNLESS(m_count < m_table_size, svc::ResultOutOfHandles());
@@ -100,6 +103,7 @@ namespace ams::kern {
         MESOSPHERE_ASSERT_THIS();
         KScopedDisableDispatch dd;
         KScopedSpinLock lk(m_lock);
+        KScopedUpdate up(this);
 
         /* Never exceed our capacity. */
         R_UNLESS(m_count < m_table_size, svc::ResultOutOfHandles());
@@ -112,6 +116,7 @@ namespace ams::kern {
         MESOSPHERE_ASSERT_THIS();
         KScopedDisableDispatch dd;
         KScopedSpinLock lk(m_lock);
+        KScopedUpdate up(this);
 
         /* Unpack the handle. */
         const auto handle_pack = GetHandleBitPack(handle);
@@ -133,6 +138,7 @@ namespace ams::kern {
         MESOSPHERE_ASSERT_THIS();
         KScopedDisableDispatch dd;
         KScopedSpinLock lk(m_lock);
+        KScopedUpdate up(this);
 
         /* Unpack the handle. */
         const auto handle_pack = GetHandleBitPack(handle);
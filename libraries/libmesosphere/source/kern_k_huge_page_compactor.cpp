@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <mesosphere.hpp>
+
+namespace ams::kern {
+
+    void KHugePageCompactor::CompactProcess(KProcess *process) {
+        /* Promotion needs a free block, so don't compete with allocations when the pool is nearly exhausted. */
+        if (Kernel::GetMemoryManager().GetFreeSize(process->GetMemoryPool()) < MinPoolFreeSize) {
+            return;
+        }
+
+        /* Find spans of the heap which are entirely resident, and move each into a block of its own. */
+        auto &page_table = process->GetPageTable();
+        auto &impl       = page_table.GetPageTableImpl();
+
+        const KProcessAddress heap_end = page_table.GetHeapRegionStart() + page_table.GetHeapRegionSize();
+
+        KProcessAddress cur_address = page_table.GetHeapRegionStart();
+        for (size_t i = 0; i < MaxPromotionsPerPass; ++i) {
+            const KProcessAddress candidate = impl.FindHugePageCandidate(cur_address, heap_end);
+            if (candidate == Null<KProcessAddress>) {
+                break;
+            }
+
+            /* If we can't allocate a block, later spans won't fare any better. */
+            if (const Result result = impl.PromoteHugePage(candidate, process->GetAllocateOption()); svc::ResultOutOfMemory::Includes(result)) {
+                break;
+            }
+
+            /* NOTE: The search is aligned up to the next span, so this skips the candidate even if it couldn't be promoted. */
+            cur_address = candidate + PageSize;
+        }
+    }
+
+}
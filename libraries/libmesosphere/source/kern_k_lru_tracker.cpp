@@ -5,32 +5,355 @@
 
 namespace ams::kern {
 
-    class KLRUTracker {
-        public:
-            static void SweepProcess(KProcess *process) {
-                auto &pt = process->GetPageTable();
-                
-                /* Lock the page table. */
-                KScopedLightLock lk(pt.GetBasePageTable().GetLock());
-
-                /* TODO: Implement KPageTable::VisitEntries to iterate over L3 entries. */
-                /* For now, this is a conceptual placeholder. */
-                
-                /*
-                pt.VisitEntries([&](KProcessAddress va, PageTableEntry &pte) {
-                    if (pte.IsMapped() && !pte.IsSwapped()) {
-                        if (pte.GetAccessFlag() == PageTableEntry::AccessFlag_Accessed) {
-                            // Reset access flag for next sweep
-                            pte.SetAccessFlag(PageTableEntry::AccessFlag_NotAccessed);
-                            // Reset coldness (stored in a sidecar or software bits)
-                        } else {
-                            // Increment coldness
-                            // If coldness > threshold, mark as swap candidate
+    namespace {
+
+        /* NOTE: Coldness is estimated with the aging variant of CLOCK. Every sweep, each tracked page's age */
+        /* is shifted right, and its top bit is set if the page was accessed since the previous sweep.      */
+        /* The lower a page's age, the longer it has gone without being accessed.                           */
+        constexpr s64 SweepInterval     = ams::svc::Tick(TimeSpan::FromSeconds(1));
+        constexpr size_t SweepChunkSize = 16_MB;
+
+        constexpr u8 AgeAccessedBit = 0x80;
+
+        /* Every few sweeps, split heap spans which have become entirely resident are re-formed into blocks. */
+        constexpr size_t SweepsPerCompaction = 4;
+
+        /* Tracked pages are packed as (page index << 8) | age, and are kept in ascending index order. */
+        /* NOTE: Heap memory may be swapped wherever it's mapped in the heap or alias region, and the process's */
+        /* code may be discarded, so each of the three regions is given a third of the index space.              */
+        constexpr size_t PageIndexBits         = BITSIZEOF(u32) - BITSIZEOF(u8);
+        constexpr size_t NumTrackedRegions     = 3;
+        constexpr size_t MaxTrackedRegionPages = (static_cast<size_t>(1) << PageIndexBits) / NumTrackedRegions;
+        constexpr size_t MaxTrackedRegionSize  = MaxTrackedRegionPages * PageSize;
+
+        constexpr ALWAYS_INLINE u32 EncodeTrackedPage(u32 index, u8 age) { return (index << BITSIZEOF(u8)) | age; }
+        constexpr ALWAYS_INLINE u32 GetTrackedPageIndex(u32 tracked) { return tracked >> BITSIZEOF(u8); }
+        constexpr ALWAYS_INLINE u8 GetTrackedPageAge(u32 tracked) { return static_cast<u8>(tracked); }
+
+        /* Each process's sidecar holds two page arrays; every sweep builds the new array from the old one. */
+        /* NOTE: Sidecars start small and grow as the process's footprint does, so that every swappable page is tracked. */
+        constexpr size_t TrackedPagesPerSidecarPage = PageSize / sizeof(u32);
+        constexpr size_t InitialTrackedPages        = 4 * TrackedPagesPerSidecarPage;
+        constexpr size_t SweepChunkPages            = SweepChunkSize / PageSize;
+
+        constexpr ALWAYS_INLINE size_t GetSidecarNumPages(size_t capacity) { return 2 * capacity / TrackedPagesPerSidecarPage; }
+
+        struct TrackedProcess {
+            u64 process_id                                   = 0;
+            KPhysicalAddress phys_addr                       = Null<KPhysicalAddress>;
+            KProcessAddress region_starts[NumTrackedRegions] = { Null<KProcessAddress>, Null<KProcessAddress>, Null<KProcessAddress> };
+            u32 *pages[2]                                    = {};
+            u32 num_pages                                    = 0;
+            u32 capacity                                     = 0;
+            u8 cur                                           = 0;
+        };
+
+        struct SweepContext {
+            KProcessAddress region_start;
+            u32 index_base;
+            const u32 *old_pages;
+            u32 old_num_pages;
+            u32 old_index;
+            u32 *new_pages;
+            u32 new_num_pages;
+            u32 capacity;
+        };
+
+        constinit KLightLock g_lru_lock;
+        constinit TrackedProcess g_tracked_processes[KLRUTracker::MaxTrackedProcesses] = {};
+        constinit u32 g_age_offsets[AgeAccessedBit] = {};
+
+        /* NOTE: Candidates are gathered here under the LRU lock, and copied out once it's released, so that the sweeper never waits on user memory. */
+        /* The candidate lock keeps the buffer for one caller at a time.                                                                              */
+        constinit KLightLock g_candidate_lock;
+        constinit u64 g_candidate_addresses[KLRUTracker::MaxCandidates] = {};
+
+        TrackedProcess *FindTrackedProcess(u64 process_id) {
+            MESOSPHERE_ASSERT(g_lru_lock.IsLockedByCurrentThread());
+
+            for (auto &tracked : g_tracked_processes) {
+                if (tracked.phys_addr != Null<KPhysicalAddress> && tracked.process_id == process_id) {
+                    return std::addressof(tracked);
+                }
+            }
+
+            return nullptr;
+        }
+
+        KPhysicalAddress AllocateSidecar(size_t capacity) {
+            return Kernel::GetMemoryManager().AllocateAndOpenContinuous(GetSidecarNumPages(capacity), 1, KMemoryManager::EncodeOption(KMemoryManager::Pool_System, KMemoryManager::Direction_FromBack));
+        }
+
+        TrackedProcess *AllocateTrackedProcess(u64 process_id) {
+            MESOSPHERE_ASSERT(g_lru_lock.IsLockedByCurrentThread());
+
+            for (auto &tracked : g_tracked_processes) {
+                if (tracked.phys_addr == Null<KPhysicalAddress>) {
+                    /* Allocate the sidecar. */
+                    const KPhysicalAddress phys_addr = AllocateSidecar(InitialTrackedPages);
+                    if (phys_addr == Null<KPhysicalAddress>) {
+                        return nullptr;
+                    }
+
+                    u32 *pages = GetPointer<u32>(KMemoryLayout::GetLinearVirtualAddress(phys_addr));
+
+                    tracked = {
+                        .process_id    = process_id,
+                        .phys_addr     = phys_addr,
+                        .region_starts = { Null<KProcessAddress>, Null<KProcessAddress>, Null<KProcessAddress> },
+                        .pages         = { pages, pages + InitialTrackedPages },
+                        .num_pages     = 0,
+                        .capacity      = InitialTrackedPages,
+                        .cur           = 0,
+                    };
+                    return std::addressof(tracked);
+                }
+            }
+
+            return nullptr;
+        }
+
+        void ReleaseTrackedProcess(TrackedProcess *tracked) {
+            MESOSPHERE_ASSERT(g_lru_lock.IsLockedByCurrentThread());
+
+            Kernel::GetMemoryManager().Close(tracked->phys_addr, GetSidecarNumPages(tracked->capacity));
+            *tracked = {};
+        }
+
+        bool GrowTrackedProcess(TrackedProcess *tracked, SweepContext &ctx, size_t min_capacity) {
+            MESOSPHERE_ASSERT(g_lru_lock.IsLockedByCurrentThread());
+
+            /* Allocate a larger sidecar. */
+            const size_t capacity            = std::max<size_t>(2 * tracked->capacity, util::AlignUp(min_capacity, TrackedPagesPerSidecarPage));
+            const KPhysicalAddress phys_addr = AllocateSidecar(capacity);
+            if (phys_addr == Null<KPhysicalAddress>) {
+                return false;
+            }
+
+            /* Move the in-progress sweep's arrays over. */
+            u32 *old_pages = GetPointer<u32>(KMemoryLayout::GetLinearVirtualAddress(phys_addr));
+            u32 *new_pages = old_pages + capacity;
+            std::memcpy(old_pages, ctx.old_pages, ctx.old_num_pages * sizeof(u32));
+            std::memcpy(new_pages, ctx.new_pages, ctx.new_num_pages * sizeof(u32));
+
+            /* Release the old sidecar, and switch to the new one. */
+            Kernel::GetMemoryManager().Close(tracked->phys_addr, GetSidecarNumPages(tracked->capacity));
+
+            tracked->phys_addr               = phys_addr;
+            tracked->pages[tracked->cur]     = old_pages;
+            tracked->pages[tracked->cur ^ 1] = new_pages;
+            tracked->capacity                = static_cast<u32>(capacity);
+
+            ctx.old_pages = old_pages;
+            ctx.new_pages = new_pages;
+            ctx.capacity  = static_cast<u32>(capacity);
+            return true;
+        }
+
+        void OnPageSwept(KProcessAddress virt_addr, bool accessed, void *arg) {
+            SweepContext &ctx = *static_cast<SweepContext *>(arg);
+
+            const u32 index = ctx.index_base + static_cast<u32>((virt_addr - ctx.region_start) / PageSize);
+
+            /* Find the page's previous age, if we were tracking it. Both arrays are in address order, so this is a merge. */
+            while (ctx.old_index < ctx.old_num_pages && GetTrackedPageIndex(ctx.old_pages[ctx.old_index]) < index) {
+                ++ctx.old_index;
+            }
+
+            const bool was_tracked = ctx.old_index < ctx.old_num_pages && GetTrackedPageIndex(ctx.old_pages[ctx.old_index]) == index;
+            const u8 old_age       = was_tracked ? GetTrackedPageAge(ctx.old_pages[ctx.old_index]) : 0;
+
+            /* Age the page, and record it. */
+            /* NOTE: The sidecar is grown before each chunk is swept, so this only drops pages if growing it failed. */
+            if (ctx.new_num_pages < ctx.capacity) {
+                ctx.new_pages[ctx.new_num_pages++] = EncodeTrackedPage(index, static_cast<u8>((old_age >> 1) | (accessed ? AgeAccessedBit : 0)));
+            }
+        }
+
+        void SweeperThreadFunction(uintptr_t arg) {
+            /* Input argument goes unused. */
+            MESOSPHERE_UNUSED(arg);
+
+            for (size_t sweep = 1; /* ... */; ++sweep) {
+                GetCurrentThread().Sleep(KHardwareTimer::GetTick() + SweepInterval);
+
+                /* Gather the processes whose memory may be swapped. */
+                u64 process_ids[KLRUTracker::MaxTrackedProcesses];
+                size_t num_processes = 0;
+                {
+                    KProcess::ListAccessor accessor;
+                    const auto end = accessor.end();
+
+                    for (auto it = accessor.begin(); it != end && num_processes < KLRUTracker::MaxTrackedProcesses; ++it) {
+                        KProcess *process = static_cast<KProcess *>(std::addressof(*it));
+
+                        const auto pool = process->GetMemoryPool();
+                        if (pool == KMemoryManager::Pool_Application || pool == KMemoryManager::Pool_Applet) {
+                            process_ids[num_processes++] = process->GetId();
                         }
                     }
-                });
-                */
+                }
+
+                /* Release the sidecars of processes which no longer exist. */
+                {
+                    KScopedLightLock lk(g_lru_lock);
+
+                    for (auto &tracked : g_tracked_processes) {
+                        if (tracked.phys_addr != Null<KPhysicalAddress> && std::find(process_ids, process_ids + num_processes, tracked.process_id) == process_ids + num_processes) {
+                            ReleaseTrackedProcess(std::addressof(tracked));
+                        }
+                    }
+                }
+
+                /* Sweep each process. */
+                for (size_t i = 0; i < num_processes; ++i) {
+                    if (KProcess *process = KProcess::GetProcessFromId(process_ids[i]); process != nullptr) {
+                        ON_SCOPE_EXIT { process->Close(); };
+
+                        KLRUTracker::SweepProcess(process);
+
+                        if ((sweep % SweepsPerCompaction) == 0) {
+                            KHugePageCompactor::CompactProcess(process);
+                        }
+                    }
+                }
+            }
+        }
+
+    }
+
+    void KLRUTracker::Initialize() {
+        /* Reserve a thread from the system limit. */
+        MESOSPHERE_ABORT_UNLESS(Kernel::GetSystemResourceLimit().Reserve(ams::svc::LimitableResource_ThreadCountMax, 1));
+
+        /* Create a new thread. */
+        KThread *new_thread = KThread::Create();
+        MESOSPHERE_ABORT_UNLESS(new_thread != nullptr);
+
+        /* Launch the new thread. */
+        MESOSPHERE_R_ABORT_UNLESS(KThread::InitializeKernelThread(new_thread, SweeperThreadFunction, 0, SweeperThreadPriority, cpu::NumCores - 1));
+
+        /* Register the new thread. */
+        KThread::Register(new_thread);
+
+        /* Run the thread. */
+        MESOSPHERE_R_ABORT_UNLESS(new_thread->Run());
+    }
+
+    void KLRUTracker::SweepProcess(KProcess *process) {
+        KScopedLightLock lk(g_lru_lock);
+
+        /* Get the process's sidecar. */
+        TrackedProcess *tracked = FindTrackedProcess(process->GetId());
+        if (tracked == nullptr) {
+            tracked = AllocateTrackedProcess(process->GetId());
+            if (tracked == nullptr) {
+                return;
             }
-    };
+        }
+
+        /* Determine the regions to sweep. */
+        auto &page_table = process->GetPageTable();
+        const KProcessAddress region_starts[NumTrackedRegions] = { page_table.GetHeapRegionStart(), page_table.GetAliasRegionStart(), page_table.GetProcessCodeRegionStart() };
+        const size_t region_sizes[NumTrackedRegions]           = { std::min(page_table.GetHeapRegionSize(), MaxTrackedRegionSize), std::min(page_table.GetAliasRegionSize(), MaxTrackedRegionSize), std::min(page_table.GetProcessCodeRegionSize(), MaxTrackedRegionSize) };
+
+        /* If the regions moved, our history no longer applies. */
+        if (!std::equal(region_starts, region_starts + NumTrackedRegions, tracked->region_starts)) {
+            std::copy(region_starts, region_starts + NumTrackedRegions, tracked->region_starts);
+            tracked->num_pages = 0;
+        }
+
+        SweepContext ctx = {
+            .region_start  = Null<KProcessAddress>,
+            .index_base    = 0,
+            .old_pages     = tracked->pages[tracked->cur],
+            .old_num_pages = tracked->num_pages,
+            .old_index     = 0,
+            .new_pages     = tracked->pages[tracked->cur ^ 1],
+            .new_num_pages = 0,
+            .capacity      = tracked->capacity,
+        };
+
+        /* Sweep each region a chunk at a time, so that we don't hold the page table lock for too long. */
+        for (size_t i = 0; i < NumTrackedRegions; ++i) {
+            ctx.region_start = region_starts[i];
+            ctx.index_base   = static_cast<u32>(i * MaxTrackedRegionPages);
+
+            for (size_t offset = 0; offset < region_sizes[i]; offset += SweepChunkSize) {
+                /* Make sure every page in the chunk has room to be recorded. */
+                /* NOTE: If the sidecar can't be grown, the sweep carries on, and the chunk's pages are tracked as space allows. */
+                if (ctx.capacity - ctx.new_num_pages < SweepChunkPages) {
+                    GrowTrackedProcess(tracked, ctx, ctx.new_num_pages + SweepChunkPages);
+                }
+
+                KScopedLightLock pt_lk(page_table.GetLock());
+
+                page_table.GetPageTableImpl().SweepAccessFlags(region_starts[i] + offset, std::min(SweepChunkSize, region_sizes[i] - offset), OnPageSwept, std::addressof(ctx));
+            }
+        }
+
+        /* Swap to the new array. */
+        tracked->cur      ^= 1;
+        tracked->num_pages = ctx.new_num_pages;
+    }
+
+    Result KLRUTracker::GetCandidates(s32 *out_count, ams::kern::svc::KUserPointer<u64 *> out_addresses, u64 process_id, s32 max_count) {
+        MESOSPHERE_ASSERT(0 < max_count && max_count <= static_cast<s32>(MaxCandidates));
+
+        KScopedLightLock candidate_lk(g_candidate_lock);
+
+        /* Gather the candidates. */
+        s32 count = 0;
+        {
+            KScopedLightLock lk(g_lru_lock);
+
+            /* If we haven't swept the process yet, we have no candidates. */
+            TrackedProcess *tracked = FindTrackedProcess(process_id);
+            if (tracked == nullptr) {
+                *out_count = 0;
+                R_SUCCEED();
+            }
+
+            u32 *pages          = tracked->pages[tracked->cur];
+            const u32 num_pages = tracked->num_pages;
+
+            /* Count the pages of each age, skipping pages accessed since the last sweep. */
+            std::memset(g_age_offsets, 0, sizeof(g_age_offsets));
+            for (u32 i = 0; i < num_pages; ++i) {
+                if (const u8 age = GetTrackedPageAge(pages[i]); age < AgeAccessedBit) {
+                    ++g_age_offsets[age];
+                }
+            }
+
+            /* Convert the counts to output offsets, coldest first. */
+            u32 total = 0;
+            for (auto &offset : g_age_offsets) {
+                const u32 age_count = offset;
+                offset = total;
+                total += age_count;
+            }
+
+            /* Place the candidates. Within an age, pages stay in address order, so that neighbours can be evicted together. */
+            /* NOTE: Candidates are marked as accessed, so that asking again before the next sweep yields the next coldest pages. */
+            /* Those which get swapped out stop being tracked at the next sweep.                                                  */
+            count = static_cast<s32>(std::min<u32>(total, max_count));
+            for (u32 i = 0; i < num_pages; ++i) {
+                if (const u8 age = GetTrackedPageAge(pages[i]); age < AgeAccessedBit) {
+                    if (const u32 pos = g_age_offsets[age]++; pos < static_cast<u32>(count)) {
+                        const u32 index = GetTrackedPageIndex(pages[i]);
+                        g_candidate_addresses[pos] = GetInteger(tracked->region_starts[index / MaxTrackedRegionPages]) + static_cast<u64>(index % MaxTrackedRegionPages) * PageSize;
+
+                        pages[i] = EncodeTrackedPage(index, AgeAccessedBit);
+                    }
+                }
+            }
+        }
+
+        /* Copy them out. */
+        R_TRY(out_addresses.CopyArrayFrom(g_candidate_addresses, count));
+
+        *out_count = count;
+        R_SUCCEED();
+    }
 
 }
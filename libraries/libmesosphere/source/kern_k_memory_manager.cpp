@@ -33,6 +33,57 @@ namespace ams::kern {
             }
         }
 
+        /* NOTE: Only the pools which hold process heaps keep cleared blocks in reserve. */
+        constexpr size_t ZeroedBlockTargetCounts[KMemoryManager::Pool_Count] = {
+            KMemoryManager::MaxZeroedBlocks,     /* Pool_Application */
+            KMemoryManager::MaxZeroedBlocks / 4, /* Pool_Applet */
+            0,                                   /* Pool_System */
+            0,                                   /* Pool_SystemNonSecure */
+        };
+
+        /* NOTE: When a swappable pool runs low, sys-swap is asked to evict pages from the processes using it. */
+        /* Allocations which fail wait a bounded time for it to make progress before giving up.                */
+        constexpr size_t ReclaimLowWatermarkPages = 32_MB / PageSize;
+        constexpr s64 ReclaimTimeout              = ams::svc::Tick(TimeSpan::FromMilliSeconds(250));
+
+        constexpr bool IsReclaimablePool(KMemoryManager::Pool pool) {
+            return pool == KMemoryManager::Pool_Application || pool == KMemoryManager::Pool_Applet;
+        }
+
+        bool WaitForReclaim(Result result, KMemoryManager::Pool pool, size_t num_pages, bool can_wait, s64 &deadline) {
+            /* Only a lack of memory in a swappable pool can be fixed by reclaiming. */
+            if (!svc::ResultOutOfMemory::Includes(result) || !IsReclaimablePool(pool)) {
+                return false;
+            }
+
+            /* If the caller can't wait, have memory reclaimed for its next attempt, and fail now. */
+            if (!can_wait) {
+                KSwapManager::RequestReclaim(pool, num_pages + ReclaimLowWatermarkPages);
+                return false;
+            }
+
+            /* All retries share a single deadline. */
+            if (deadline == 0) {
+                deadline = KHardwareTimer::GetTick() + ReclaimTimeout;
+            }
+
+            /* Ask for enough memory to satisfy us, with some headroom. */
+            KSwapManager::RequestReclaim(pool, num_pages + ReclaimLowWatermarkPages);
+            return KSwapManager::WaitForReclaim(deadline);
+        }
+
+        void FillPageGroup(const KPageGroup &pg, size_t num_zeroed_pages, u8 fill_pattern) {
+            /* Blocks taken from a reservoir are always at the start of the group, so we skip past them. */
+            for (const auto &block : pg) {
+                const size_t skip_pages = std::min(num_zeroed_pages, block.GetNumPages());
+                num_zeroed_pages -= skip_pages;
+
+                if (skip_pages < block.GetNumPages()) {
+                    std::memset(GetVoidPointer(KMemoryLayout::GetLinearVirtualAddress(block.GetAddress() + skip_pages * PageSize)), fill_pattern, (block.GetNumPages() - skip_pages) * PageSize);
+                }
+            }
+        }
+
     }
 
     void KMemoryManager::Initialize(KVirtualAddress management_region, size_t management_region_size, const u32 *min_align_shifts) {
@@ -43,6 +94,11 @@ namespace ams::kern {
         /* Reset our manager count. */
         m_num_managers = 0;
 
+        /* Reset our cached page counts. */
+        for (size_t i = 0; i < Pool_Count; ++i) {
+            m_num_cached_pages[i] = 0;
+        }
+
         /* Traverse the virtual memory layout tree, initializing each manager as appropriate. */
         while (m_num_managers != MaxManagerCount) {
             /* Locate the region that should initialize the current manager. */
@@ -178,6 +234,9 @@ namespace ams::kern {
         m_optimized_process_ids[pool] = process_id;
         m_has_optimized_process[pool] = true;
 
+        /* Allocations from the pool must now be tracked, so stop serving them from the page caches. */
+        this->DrainPageCachesLocked(pool);
+
         /* Clear the management area for the optimized process. */
         for (auto *manager = this->GetFirstManager(pool, Direction_FromFront); manager != nullptr; manager = this->GetNextManager(manager, Direction_FromFront)) {
             manager->InitializeOptimizedMemory();
@@ -215,6 +274,16 @@ namespace ams::kern {
         /* Update our alignment. */
         align_pages = std::max(align_pages, min_align_pages);
 
+        /* Take single pages from the current core's page cache, if we can. */
+        /* NOTE: Cached pages are taken from the front of the pool, so allocations which want another direction bypass the cache. */
+        if (num_pages == 1 && align_pages == 1 && dir == Direction_FromFront) {
+            if (const KPhysicalAddress page = this->AllocatePageFromCache(pool, false); page != Null<KPhysicalAddress>) {
+                /* NOTE: Nothing else can reference a cached page, so we can open its first reference without the pool lock. */
+                this->GetManager(page).OpenFirst(page, 1);
+                return page;
+            }
+        }
+
         /* Lock the pool that we're allocating from. */
         KScopedLightLock lk(m_pool_locks[pool]);
 
@@ -231,6 +300,19 @@ namespace ams::kern {
             }
         }
 
+        /* If we failed to allocate, give any cleared blocks and cached pages back to the heap and try again. */
+        if (allocated_block == Null<KPhysicalAddress> && (m_num_zeroed_blocks[pool] > 0 || this->GetCachedPages(pool) > 0)) {
+            this->ReleaseZeroedBlocksLocked(pool);
+            this->DrainPageCachesLocked(pool);
+
+            for (chosen_manager = this->GetFirstManager(pool, dir); chosen_manager != nullptr; chosen_manager = this->GetNextManager(chosen_manager, dir)) {
+                allocated_block = chosen_manager->AllocateAligned(heap_index, num_pages, align_pages);
+                if (allocated_block != Null<KPhysicalAddress>) {
+                    break;
+                }
+            }
+        }
+
         /* If we failed to allocate, quit now. */
         if (allocated_block == Null<KPhysicalAddress>) {
             return Null<KPhysicalAddress>;
@@ -247,7 +329,7 @@ namespace ams::kern {
         return allocated_block;
     }
 
-    Result KMemoryManager::AllocatePageGroupImpl(KPageGroup *out, size_t num_pages, Pool pool, Direction dir, bool unoptimized, bool random, s32 min_heap_index) {
+    Result KMemoryManager::AllocatePageGroupImpl(KPageGroup *out, size_t *out_num_zeroed_pages, size_t num_pages, Pool pool, Direction dir, bool unoptimized, bool random, s32 min_heap_index) {
         /* Check that we're allocating a correctly aligned number of pages. */
         const size_t min_align_pages = KPageHeap::GetBlockNumPages(m_min_heap_indexes[pool]);
         R_UNLESS(util::IsAligned(num_pages, min_align_pages), svc::ResultInvalidSize());
@@ -269,6 +351,36 @@ namespace ams::kern {
             out->Finalize();
         };
 
+        /* If the caller wants cleared memory, take as much of it as we can from the pool's reservoir. */
+        /* NOTE: Reservoir blocks are only usable if they satisfy the alignment the caller requires. */
+        if (out_num_zeroed_pages != nullptr) {
+            *out_num_zeroed_pages = 0;
+
+            if (KPageHeap::GetBlockNumPages(min_heap_index) <= ZeroedBlockNumPages) {
+                while (num_pages >= ZeroedBlockNumPages && m_num_zeroed_blocks[pool] > 0) {
+                    const KPhysicalAddress zeroed_block = m_zeroed_blocks[pool][m_num_zeroed_blocks[pool] - 1];
+
+                    /* Add the block to our group. */
+                    R_TRY(out->AddBlock(zeroed_block, ZeroedBlockNumPages));
+                    --m_num_zeroed_blocks[pool];
+
+                    /* Maintain the optimized memory bitmap, if we should. */
+                    if (unoptimized) {
+                        this->GetManager(zeroed_block).TrackUnoptimizedAllocation(zeroed_block, ZeroedBlockNumPages);
+                    }
+
+                    num_pages             -= ZeroedBlockNumPages;
+                    *out_num_zeroed_pages += ZeroedBlockNumPages;
+                }
+            }
+        }
+
+        /* If the heap can't hold the rest of the allocation, give it back the reservoir's blocks and the cores' cached pages. */
+        if (this->GetHeapFreePagesLocked(pool) < num_pages) {
+            this->ReleaseZeroedBlocksLocked(pool);
+            this->DrainPageCachesLocked(pool);
+        }
+
         /* Keep allocating until we've allocated all our pages. */
         for (s32 index = heap_index; index >= min_heap_index && num_pages > 0; index--) {
             const size_t pages_per_alloc = KPageHeap::GetBlockNumPages(index);
@@ -303,41 +415,105 @@ namespace ams::kern {
         R_SUCCEED();
     }
 
-    Result KMemoryManager::AllocateAndOpen(KPageGroup *out, size_t num_pages, size_t align_pages, u32 option) {
+    Result KMemoryManager::AllocateAndOpenImpl(KPageGroup *out, size_t *out_num_zeroed_pages, size_t num_pages, size_t align_pages, u32 option) {
         MESOSPHERE_ASSERT(out != nullptr);
         MESOSPHERE_ASSERT(out->GetNumPages() == 0);
 
         /* Early return if we're allocating no pages. */
+        if (out_num_zeroed_pages != nullptr) {
+            *out_num_zeroed_pages = 0;
+        }
         R_SUCCEED_IF(num_pages == 0);
 
-        /* Lock the pool that we're allocating from. */
+        /* Decode the option. */
         const auto [pool, dir] = DecodeOption(option);
-        KScopedLightLock lk(m_pool_locks[pool]);
 
         /* Choose a heap based on our alignment size request. */
         const s32 heap_index = KPageHeap::GetAlignedBlockIndex(align_pages, align_pages);
 
-        /* Allocate the page group. */
-        R_TRY(this->AllocatePageGroupImpl(out, num_pages, pool, dir, m_has_optimized_process[pool], true, heap_index));
+        /* Take single pages from the current core's page cache, if we can. */
+        /* NOTE: These allocations are randomized, so a random cached page is picked rather than the most recently freed one. */
+        if (num_pages == 1 && std::max(heap_index, m_min_heap_indexes[pool]) == 0 && dir == Direction_FromFront) {
+            if (const KPhysicalAddress page = this->AllocatePageFromCache(pool, true); page != Null<KPhysicalAddress>) {
+                /* Ensure we don't leak the page if we fail. */
+                ON_RESULT_FAILURE { this->FreePageToCache(page, pool); };
 
-        /* Open the first reference to the pages. */
-        for (const auto &block : *out) {
-            KPhysicalAddress cur_address = block.GetAddress();
-            size_t remaining_pages       = block.GetNumPages();
-            while (remaining_pages > 0) {
-                /* Get the manager for the current address. */
-                auto &manager = this->GetManager(cur_address);
+                /* Add the page to our group. */
+                R_TRY(out->AddBlock(page, 1));
+
+                /* NOTE: Nothing else can reference a cached page, so we can open its first reference without the pool lock. */
+                this->GetManager(page).OpenFirst(page, 1);
+                R_SUCCEED();
+            }
+        }
 
-                /* Process part or all of the block. */
-                const size_t cur_pages = std::min(remaining_pages, manager.GetPageOffsetToEnd(cur_address));
-                manager.OpenFirst(cur_address, cur_pages);
+        /* Allocate the page group, waiting for memory to be reclaimed if we need to. */
+        size_t reclaim_pages = 0;
+        s64 reclaim_deadline = 0;
+        while (true) {
+            Result result = ResultSuccess();
+            {
+                /* Lock the pool that we're allocating from. */
+                KScopedLightLock lk(m_pool_locks[pool]);
+
+                /* Allocate the page group. */
+                result = this->AllocatePageGroupImpl(out, out_num_zeroed_pages, num_pages, pool, dir, m_has_optimized_process[pool], true, heap_index);
+                if (R_SUCCEEDED(result)) {
+                    /* Open the first reference to the pages. */
+                    for (const auto &block : *out) {
+                        KPhysicalAddress cur_address = block.GetAddress();
+                        size_t remaining_pages       = block.GetNumPages();
+                        while (remaining_pages > 0) {
+                            /* Get the manager for the current address. */
+                            auto &manager = this->GetManager(cur_address);
+
+                            /* Process part or all of the block. */
+                            const size_t cur_pages = std::min(remaining_pages, manager.GetPageOffsetToEnd(cur_address));
+                            manager.OpenFirst(cur_address, cur_pages);
+
+                            /* Advance. */
+                            cur_address     += cur_pages * PageSize;
+                            remaining_pages -= cur_pages;
+                        }
+                    }
+
+                    /* Check whether the pool is running low. */
+                    reclaim_pages = this->GetReclaimPagesLocked(pool);
+                }
+            }
 
-                /* Advance. */
-                cur_address     += cur_pages * PageSize;
-                remaining_pages -= cur_pages;
+            /* If we failed, wait (without holding the pool lock) for memory to be reclaimed, and try again. */
+            if (R_SUCCEEDED(result)) {
+                break;
             }
+            R_UNLESS(WaitForReclaim(result, pool, num_pages, CanWaitForReclaim(option), reclaim_deadline), result);
+        }
+
+        /* If the pool is running low, have memory reclaimed before we next need it. */
+        if (reclaim_pages > 0) {
+            KSwapManager::RequestReclaim(pool, reclaim_pages);
+        }
+
+        R_SUCCEED();
+    }
+
+    Result KMemoryManager::AllocateAndOpen(KPageGroup *out, size_t num_pages, size_t align_pages, u32 option) {
+        R_RETURN(this->AllocateAndOpenImpl(out, nullptr, num_pages, align_pages, option));
+    }
+
+    Result KMemoryManager::AllocateAndOpenWithFill(KPageGroup *out, size_t num_pages, size_t align_pages, u32 option, u8 fill_pattern) {
+        /* Allocate the pages, taking already-cleared blocks if we're filling with zero. */
+        size_t num_zeroed_pages = 0;
+        R_TRY(this->AllocateAndOpenImpl(out, fill_pattern == 0 ? std::addressof(num_zeroed_pages) : nullptr, num_pages, align_pages, option));
+
+        /* Have the reservoir refilled, if we took from it. */
+        if (num_zeroed_pages > 0) {
+            KZeroedBlockWorker::Notify();
         }
 
+        /* Fill the rest of the pages. */
+        FillPageGroup(*out, num_zeroed_pages, fill_pattern);
+
         R_SUCCEED();
     }
 
@@ -348,24 +524,48 @@ namespace ams::kern {
         /* Decode the option. */
         const auto [pool, dir] = DecodeOption(option);
 
-        /* Allocate the memory. */
+        /* Allocate the memory, waiting for memory to be reclaimed if we need to. */
         bool optimized;
-        {
-            /* Lock the pool that we're allocating from. */
-            KScopedLightLock lk(m_pool_locks[pool]);
-
-            /* Check if we have an optimized process. */
-            const bool has_optimized = m_has_optimized_process[pool];
-            const bool is_optimized  = m_optimized_process_ids[pool] == process_id;
-
-            /* Always use the minimum alignment size. */
-            const s32 heap_index = 0;
+        size_t num_zeroed_pages = 0;
+        size_t reclaim_pages    = 0;
+        s64 reclaim_deadline    = 0;
+        while (true) {
+            Result result = ResultSuccess();
+            {
+                /* Lock the pool that we're allocating from. */
+                KScopedLightLock lk(m_pool_locks[pool]);
+
+                /* Check if we have an optimized process. */
+                const bool has_optimized = m_has_optimized_process[pool];
+                const bool is_optimized  = m_optimized_process_ids[pool] == process_id;
+
+                /* Always use the minimum alignment size. */
+                const s32 heap_index = 0;
+
+                /* Allocate the page group. */
+                /* NOTE: The optimized process's pages are filled as they're tracked, so it has no use for cleared blocks. */
+                const bool use_zeroed = fill_pattern == 0 && !(has_optimized && is_optimized);
+                result = this->AllocatePageGroupImpl(out, use_zeroed ? std::addressof(num_zeroed_pages) : nullptr, num_pages, pool, dir, has_optimized && !is_optimized, false, heap_index);
+
+                /* Set whether we should optimize. */
+                optimized = has_optimized && is_optimized;
+
+                /* Check whether the pool is running low. */
+                if (R_SUCCEEDED(result)) {
+                    reclaim_pages = this->GetReclaimPagesLocked(pool);
+                }
+            }
 
-            /* Allocate the page group. */
-            R_TRY(this->AllocatePageGroupImpl(out, num_pages, pool, dir, has_optimized && !is_optimized, false, heap_index));
+            /* If we failed, wait (without holding the pool lock) for memory to be reclaimed, and try again. */
+            if (R_SUCCEEDED(result)) {
+                break;
+            }
+            R_UNLESS(WaitForReclaim(result, pool, num_pages, CanWaitForReclaim(option), reclaim_deadline), result);
+        }
 
-            /* Set whether we should optimize. */
-            optimized = has_optimized && is_optimized;
+        /* If the pool is running low, have memory reclaimed before we next need it. */
+        if (reclaim_pages > 0) {
+            KSwapManager::RequestReclaim(pool, reclaim_pages);
         }
 
         /* Perform optimized memory tracking, if we should. */
@@ -423,15 +623,254 @@ namespace ams::kern {
                 }
             }
         } else {
-            /* Set all the allocated memory. */
-            for (const auto &block : *out) {
-                std::memset(GetVoidPointer(KMemoryLayout::GetLinearVirtualAddress(block.GetAddress())), fill_pattern, block.GetSize());
+            /* Have the reservoir refilled, if we took from it. */
+            if (num_zeroed_pages > 0) {
+                KZeroedBlockWorker::Notify();
             }
+
+            /* Set all the allocated memory which isn't already clear. */
+            FillPageGroup(*out, num_zeroed_pages, fill_pattern);
         }
 
         R_SUCCEED();
     }
 
+    bool KMemoryManager::RefillZeroedBlock(Pool pool) {
+        const s32 heap_index = KPageHeap::GetAlignedBlockIndex(ZeroedBlockNumPages, ZeroedBlockNumPages);
+
+        /* Take a block from the heap, unless the reservoir is full. */
+        /* NOTE: The reservoir is kept to at most half of the pool's free memory, so that it doesn't have to */
+        /* be given back to the heap whenever something allocates.                                           */
+        KPhysicalAddress block = Null<KPhysicalAddress>;
+        {
+            KScopedLightLock lk(m_pool_locks[pool]);
+
+            if (m_num_zeroed_blocks[pool] >= ZeroedBlockTargetCounts[pool] || this->GetHeapFreePagesLocked(pool) < (m_num_zeroed_blocks[pool] + 1) * ZeroedBlockNumPages) {
+                return false;
+            }
+
+            for (auto *manager = this->GetFirstManager(pool, Direction_FromFront); manager != nullptr; manager = this->GetNextManager(manager, Direction_FromFront)) {
+                if (block = manager->AllocateBlock(heap_index, true); block != Null<KPhysicalAddress>) {
+                    break;
+                }
+            }
+
+            if (block == Null<KPhysicalAddress>) {
+                return false;
+            }
+        }
+
+        /* Clear the block without holding the pool lock. */
+        for (size_t i = 0; i < ZeroedBlockNumPages; ++i) {
+            cpu::ClearPageToZero(GetVoidPointer(KMemoryLayout::GetLinearVirtualAddress(block + i * PageSize)));
+        }
+
+        /* Add the block to the reservoir, unless the pool ran short of memory while we were clearing it. */
+        {
+            KScopedLightLock lk(m_pool_locks[pool]);
+
+            if (m_num_zeroed_blocks[pool] < ZeroedBlockTargetCounts[pool] && this->GetHeapFreePagesLocked(pool) >= m_num_zeroed_blocks[pool] * ZeroedBlockNumPages) {
+                m_zeroed_blocks[pool][m_num_zeroed_blocks[pool]++] = block;
+            } else {
+                this->GetManager(block).Free(block, ZeroedBlockNumPages);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    size_t KMemoryManager::GetHeapFreePagesLocked(Pool pool) const {
+        MESOSPHERE_ASSERT(m_pool_locks[pool].IsLockedByCurrentThread());
+
+        size_t total = 0;
+        for (const auto *manager = m_pool_managers_head[pool]; manager != nullptr; manager = manager->GetNext()) {
+            total += manager->GetFreeSize() / PageSize;
+        }
+        return total;
+    }
+
+    size_t KMemoryManager::GetReclaimPagesLocked(Pool pool) const {
+        MESOSPHERE_ASSERT(m_pool_locks[pool].IsLockedByCurrentThread());
+
+        /* Only swappable pools can have memory reclaimed from them. */
+        if (!IsReclaimablePool(pool)) {
+            return 0;
+        }
+
+        /* Cleared blocks and cached pages are free memory too. */
+        const size_t free_pages = this->GetHeapFreePagesLocked(pool) + m_num_zeroed_blocks[pool] * ZeroedBlockNumPages + this->GetCachedPages(pool);
+        return free_pages < ReclaimLowWatermarkPages ? ReclaimLowWatermarkPages - free_pages : 0;
+    }
+
+    void KMemoryManager::ReleaseZeroedBlocksLocked(Pool pool) {
+        MESOSPHERE_ASSERT(m_pool_locks[pool].IsLockedByCurrentThread());
+
+        while (m_num_zeroed_blocks[pool] > 0) {
+            const KPhysicalAddress block = m_zeroed_blocks[pool][--m_num_zeroed_blocks[pool]];
+            this->GetManager(block).Free(block, ZeroedBlockNumPages);
+        }
+    }
+
+    KPhysicalAddress KMemoryManager::AllocatePageFromCache(Pool pool, bool random) {
+        /* Try to take a page from the current core's cache. */
+        /* NOTE: Allocations and frees on a core are serialized by disabling interrupts, so that its cache is only contended by draining. */
+        {
+            KScopedInterruptDisable di;
+
+            PageCache &cache = m_page_caches[GetCurrentCoreId()][pool];
+            KScopedSpinLock lk(cache.lock);
+
+            /* Pools with an optimized process track every allocation, and so can't use the cache. */
+            if (m_has_optimized_process[pool]) {
+                return Null<KPhysicalAddress>;
+            }
+
+            if (cache.count > 0) {
+                /* If we should, swap a random page to the top of the cache before taking it. */
+                if (random && cache.count > 1) {
+                    std::swap(cache.pages[cache.rng.GenerateRandom(cache.count)], cache.pages[cache.count - 1]);
+                }
+
+                --m_num_cached_pages[pool];
+                return cache.pages[--cache.count];
+            }
+        }
+
+        /* Allocate a batch of pages from the heap. */
+        KPhysicalAddress pages[PageCacheBatchSize];
+        size_t num_pages = 0;
+        size_t reclaim_pages = 0;
+        {
+            KScopedLightLock lk(m_pool_locks[pool]);
+
+            if (m_has_optimized_process[pool]) {
+                return Null<KPhysicalAddress>;
+            }
+
+            for (Impl *cur_manager = this->GetFirstManager(pool, Direction_FromFront); cur_manager != nullptr && num_pages < PageCacheBatchSize; cur_manager = this->GetNextManager(cur_manager, Direction_FromFront)) {
+                while (num_pages < PageCacheBatchSize) {
+                    const KPhysicalAddress page = cur_manager->AllocateBlock(0, random);
+                    if (page == Null<KPhysicalAddress>) {
+                        break;
+                    }
+
+                    pages[num_pages++] = page;
+                }
+            }
+
+            /* Check whether the pool is running low. */
+            reclaim_pages = this->GetReclaimPagesLocked(pool);
+        }
+
+        /* If the pool is running low, have memory reclaimed before we next need it. */
+        if (reclaim_pages > 0) {
+            KSwapManager::RequestReclaim(pool, reclaim_pages);
+        }
+
+        /* If the heap is empty, let the caller fall back to allocating normally. */
+        if (num_pages == 0) {
+            return Null<KPhysicalAddress>;
+        }
+
+        /* Keep the first page for ourselves, and cache the rest on the current core. */
+        /* NOTE: Another thread may have filled the cache meanwhile, so we move any pages which don't fit to the front of our batch. */
+        /* An optimized process may also have been created meanwhile, and drained the caches; then none of the pages fit.          */
+        size_t num_overflow = 0;
+        {
+            KScopedInterruptDisable di;
+
+            PageCache &cache = m_page_caches[GetCurrentCoreId()][pool];
+            KScopedSpinLock lk(cache.lock);
+
+            const bool can_cache = !m_has_optimized_process[pool];
+            for (size_t i = 1; i < num_pages; ++i) {
+                if (can_cache && cache.count < PageCacheCapacity) {
+                    cache.pages[cache.count++] = pages[i];
+                    ++m_num_cached_pages[pool];
+                } else {
+                    pages[1 + num_overflow++] = pages[i];
+                }
+            }
+        }
+
+        /* Give any pages which don't fit back to the heap. */
+        if (num_overflow > 0) {
+            KScopedLightLock lk(m_pool_locks[pool]);
+
+            for (size_t i = 0; i < num_overflow; ++i) {
+                this->GetManager(pages[1 + i]).Free(pages[1 + i], 1);
+            }
+        }
+
+        return pages[0];
+    }
+
+    void KMemoryManager::FreePageToCache(KPhysicalAddress address, Pool pool) {
+        /* Put the page in the current core's cache. If the cache is full, take its oldest batch of pages to free to the heap. */
+        KPhysicalAddress pages[PageCacheBatchSize];
+        size_t num_pages = 0;
+        {
+            KScopedInterruptDisable di;
+
+            PageCache &cache = m_page_caches[GetCurrentCoreId()][pool];
+            KScopedSpinLock lk(cache.lock);
+
+            if (m_has_optimized_process[pool]) {
+                pages[num_pages++] = address;
+            } else {
+                if (cache.count == PageCacheCapacity) {
+                    num_pages = PageCacheBatchSize;
+                    std::copy(cache.pages, cache.pages + num_pages, pages);
+                    std::copy(cache.pages + num_pages, cache.pages + cache.count, cache.pages);
+
+                    cache.count -= num_pages;
+                    m_num_cached_pages[pool].FetchSub(num_pages);
+                }
+
+                cache.pages[cache.count++] = address;
+                ++m_num_cached_pages[pool];
+            }
+        }
+
+        /* Free the pages we took to the heap. */
+        if (num_pages > 0) {
+            KScopedLightLock lk(m_pool_locks[pool]);
+
+            for (size_t i = 0; i < num_pages; ++i) {
+                this->GetManager(pages[i]).Free(pages[i], 1);
+            }
+        }
+    }
+
+    void KMemoryManager::DrainPageCachesLocked(Pool pool) {
+        MESOSPHERE_ASSERT(m_pool_locks[pool].IsLockedByCurrentThread());
+
+        for (size_t core_id = 0; core_id < cpu::NumCores; ++core_id) {
+            KScopedInterruptDisable di;
+
+            PageCache &cache = m_page_caches[core_id][pool];
+            KScopedSpinLock lk(cache.lock);
+
+            while (cache.count > 0) {
+                const KPhysicalAddress page = cache.pages[--cache.count];
+                this->GetManager(page).Free(page, 1);
+                --m_num_cached_pages[pool];
+            }
+        }
+    }
+
+    void KMemoryManager::ClosePage(KPhysicalAddress address) {
+        /* Close the reference to the page. */
+        /* NOTE: Reference counts are updated atomically, so the pool lock is only taken when a full cache drains a batch to the heap. */
+        auto &manager = this->GetManager(address);
+
+        /* If the page is now free, put it in the current core's cache. */
+        if (manager.CloseWithoutFree(address)) {
+            this->FreePageToCache(address, manager.GetPool());
+        }
+    }
+
     size_t KMemoryManager::Impl::Initialize(KPhysicalAddress address, size_t size, KVirtualAddress management, KVirtualAddress management_end, Pool p) {
         /* Calculate management sizes. */
         const size_t ref_count_size      = (size / PageSize) * sizeof(u16);
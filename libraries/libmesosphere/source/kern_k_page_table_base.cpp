@@ -96,6 +96,7 @@ namespace ams::kern {
         m_is_kernel                         = true;
         m_enable_aslr                       = true;
         m_enable_device_address_space_merge = false;
+        m_is_code_modified                  = false;
 
         for (auto i = 0; i < RegionType_Count; ++i) {
             m_region_starts[i] = 0;
@@ -107,12 +108,15 @@ namespace ams::kern {
         m_alias_code_region_end             = 0;
         m_code_region_start                 = 0;
         m_code_region_end                   = 0;
+        m_process_code_start                = 0;
+        m_process_code_end                  = 0;
         m_max_heap_size                     = 0;
         m_mapped_physical_memory_size       = 0;
         m_mapped_unsafe_physical_memory     = 0;
         m_mapped_insecure_memory            = 0;
         m_mapped_ipc_server_memory          = 0;
         m_alias_region_extra_size           = 0;
+        m_swap_hold_count                   = 0;
 
         m_memory_block_slab_manager         = Kernel::GetSystemSystemResource().GetMemoryBlockSlabManagerPointer();
         m_block_info_manager                = Kernel::GetSystemSystemResource().GetBlockInfoManagerPointer();
@@ -214,6 +218,9 @@ namespace ams::kern {
         m_address_space_start               = start;
         m_address_space_end                 = end;
         m_is_kernel                         = false;
+        m_is_code_modified                  = false;
+        m_process_code_start                = code_address;
+        m_process_code_end                  = code_address + code_size;
         m_memory_block_slab_manager         = system_resource->GetMemoryBlockSlabManagerPointer();
         m_block_info_manager                = system_resource->GetBlockInfoManagerPointer();
         m_resource_limit                    = resource_limit;
@@ -502,6 +509,7 @@ namespace ams::kern {
         m_mapped_unsafe_physical_memory = 0;
         m_mapped_insecure_memory        = 0;
         m_mapped_ipc_server_memory      = 0;
+        m_swap_hold_count               = 0;
 
         const bool fill_memory = KTargetSystem::IsDebugMemoryFillEnabled();
         m_heap_fill_value  = fill_memory ? MemoryFillValue_Heap  : MemoryFillValue_Zero;
@@ -772,6 +780,10 @@ namespace ams::kern {
         const size_t num_pages = size / PageSize;
         R_UNLESS(this->Contains(addr, size), svc::ResultInvalidCurrentMemory());
 
+        /* Ensure that none of the memory is swapped out while we operate on it. */
+        KScopedSwapHold swap_hold(this);
+        R_TRY(this->MakeResident(addr, size));
+
         /* Lock the table. */
         KScopedLightLock lk(m_general_lock);
 
@@ -958,6 +970,10 @@ namespace ams::kern {
     }
 
     Result KPageTableBase::MapMemory(KProcessAddress dst_address, KProcessAddress src_address, size_t size) {
+        /* Ensure that none of the memory is swapped out while we operate on it. */
+        KScopedSwapHold swap_hold(this);
+        R_TRY(this->MakeResident(src_address, size));
+
         /* Lock the table. */
         KScopedLightLock lk(m_general_lock);
 
@@ -1084,6 +1100,10 @@ namespace ams::kern {
         /* Validate the mapping request. */
         R_UNLESS(this->CanContain(dst_address, size, KMemoryState_AliasCode), svc::ResultInvalidMemoryRegion());
 
+        /* Ensure that none of the memory is swapped out while we operate on it. */
+        KScopedSwapHold swap_hold(this);
+        R_TRY(this->MakeResident(src_address, size));
+
         /* Lock the table. */
         KScopedLightLock lk(m_general_lock);
 
@@ -1249,19 +1269,14 @@ namespace ams::kern {
         KScopedResourceReservation memory_reservation(insecure_resource_limit, ams::svc::LimitableResource_PhysicalMemoryMax, size);
         R_UNLESS(memory_reservation.Succeeded(), svc::ResultOutOfMemory());
 
-        /* Allocate pages for the insecure memory. */
+        /* Allocate and clear pages for the insecure memory. */
         KPageGroup pg(m_block_info_manager);
-        R_TRY(Kernel::GetMemoryManager().AllocateAndOpen(std::addressof(pg), size / PageSize, 1, KMemoryManager::EncodeOption(insecure_pool, KMemoryManager::Direction_FromFront)));
+        R_TRY(Kernel::GetMemoryManager().AllocateAndOpenWithFill(std::addressof(pg), size / PageSize, 1, KMemoryManager::EncodeOption(insecure_pool, KMemoryManager::Direction_FromFront), m_heap_fill_value));
 
         /* Close the opened pages when we're done with them. */
         /* If the mapping succeeds, each page will gain an extra reference, otherwise they will be freed automatically. */
         ON_SCOPE_EXIT { pg.Close(); };
 
-        /* Clear all the newly allocated pages. */
-        for (const auto &it : pg) {
-            std::memset(GetVoidPointer(GetHeapVirtualAddress(it.GetAddress())), m_heap_fill_value, it.GetSize());
-        }
-
         /* Lock the table. */
         KScopedLightLock lk(m_general_lock);
 
@@ -1410,17 +1425,13 @@ namespace ams::kern {
         /* Create a page group to hold the pages we allocate. */
         KPageGroup pg(m_block_info_manager);
 
-        /* Allocate the pages. */
-        R_TRY(Kernel::GetMemoryManager().AllocateAndOpen(std::addressof(pg), num_pages, 1, m_allocate_option));
+        /* Allocate and clear the pages. */
+        /* NOTE: sys-swap must take our lock to reclaim memory from us, so we can't wait for it to do so while we hold it. */
+        R_TRY(Kernel::GetMemoryManager().AllocateAndOpenWithFill(std::addressof(pg), num_pages, 1, m_allocate_option | KMemoryManager::AllocateFlag_NoReclaimWait, m_heap_fill_value));
 
         /* Ensure that the page group is closed when we're done working with it. */
         ON_SCOPE_EXIT { pg.Close(); };
 
-        /* Clear all pages. */
-        for (const auto &it : pg) {
-            std::memset(GetVoidPointer(GetHeapVirtualAddress(it.GetAddress())), m_heap_fill_value, it.GetSize());
-        }
-
         /* Map the pages. */
         R_RETURN(this->Operate(page_list, address, num_pages, pg, properties, OperationType_MapGroup, false));
     }
@@ -1924,19 +1935,14 @@ namespace ams::kern {
         KScopedResourceReservation memory_reservation(m_resource_limit, ams::svc::LimitableResource_PhysicalMemoryMax, allocation_size);
         R_UNLESS(memory_reservation.Succeeded(), svc::ResultLimitReached());
 
-        /* Allocate pages for the heap extension. */
+        /* Allocate and clear pages for the heap extension. */
         KPageGroup pg(m_block_info_manager);
-        R_TRY(Kernel::GetMemoryManager().AllocateAndOpen(std::addressof(pg), allocation_size / PageSize, 1, m_allocate_option));
+        R_TRY(Kernel::GetMemoryManager().AllocateAndOpenWithFill(std::addressof(pg), allocation_size / PageSize, 1, m_allocate_option, m_heap_fill_value));
 
         /* Close the opened pages when we're done with them. */
         /* If the mapping succeeds, each page will gain an extra reference, otherwise they will be freed automatically. */
         ON_SCOPE_EXIT { pg.Close(); };
 
-        /* Clear all the newly allocated pages. */
-        for (const auto &it : pg) {
-            std::memset(GetVoidPointer(GetHeapVirtualAddress(it.GetAddress())), m_heap_fill_value, it.GetSize());
-        }
-
         /* Map the pages. */
         {
             /* Lock the table. */
@@ -2614,6 +2620,10 @@ namespace ams::kern {
         const size_t size = num_pages * PageSize;
         R_UNLESS(this->Contains(address, size), svc::ResultInvalidCurrentMemory());
 
+        /* Ensure that none of the memory is swapped out while we operate on it. */
+        KScopedSwapHold swap_hold(this);
+        R_TRY(this->MakeResident(address, size));
+
         /* Lock the table. */
         KScopedLightLock lk(m_general_lock);
 
@@ -2633,6 +2643,10 @@ namespace ams::kern {
         /* Check that the region is in range. */
         R_UNLESS(this->Contains(address, size), svc::ResultInvalidCurrentMemory());
 
+        /* Ensure that none of the memory is swapped out while we operate on it. */
+        KScopedSwapHold swap_hold(this);
+        R_TRY(this->MakeResident(address, size));
+
         /* Lock the table. */
         KScopedLightLock lk(m_general_lock);
 
@@ -2701,6 +2715,10 @@ namespace ams::kern {
         /* Check that the region is in range. */
         R_UNLESS(this->Contains(address, size), svc::ResultInvalidCurrentMemory());
 
+        /* Ensure that none of the memory is swapped out while we operate on it. */
+        KScopedSwapHold swap_hold(this);
+        R_TRY(this->MakeResident(address, size));
+
         /* Lock the table. */
         KScopedLightLock lk(m_general_lock);
 
@@ -2735,6 +2753,10 @@ namespace ams::kern {
         /* Lightly validate the region is in range. */
         R_UNLESS(this->Contains(address, size), svc::ResultInvalidCurrentMemory());
 
+        /* Ensure that none of the memory is swapped out while we operate on it. */
+        KScopedSwapHold swap_hold(this);
+        R_TRY(this->MakeResident(address, size));
+
         /* Lock the table. */
         KScopedLightLock lk(m_general_lock);
 
@@ -2820,6 +2842,10 @@ namespace ams::kern {
         /* Lightly validate the region is in range. */
         R_UNLESS(this->Contains(address, size), svc::ResultInvalidCurrentMemory());
 
+        /* Ensure that none of the memory is swapped out while we operate on it. */
+        KScopedSwapHold swap_hold(this);
+        R_TRY(this->MakeResident(address, size));
+
         /* Lock the table. */
         KScopedLightLock lk(m_general_lock);
 
@@ -2827,6 +2853,9 @@ namespace ams::kern {
         const bool can_write = R_SUCCEEDED(this->CheckMemoryStateContiguous(address, size, KMemoryState_None, KMemoryState_None, KMemoryPermission_NotMapped | KMemoryPermission_UserReadWrite, KMemoryPermission_UserReadWrite, KMemoryAttribute_None, KMemoryAttribute_None));
         if (!can_write) {
             R_UNLESS(this->CanReadWriteDebugMemory(address, size, false), svc::ResultInvalidCurrentMemory());
+
+            /* Code written by a debugger no longer matches what the loader mapped, so it may no longer be discarded. */
+            m_is_code_modified = true;
         }
 
         /* Get the impl. */
@@ -3070,6 +3099,10 @@ namespace ams::kern {
         const size_t num_pages = size / PageSize;
         R_UNLESS(this->Contains(address, size), svc::ResultInvalidCurrentMemory());
 
+        /* Ensure that none of the memory is swapped out while we operate on it. */
+        KScopedSwapHold swap_hold(this);
+        R_TRY(this->MakeResident(address, size));
+
         /* Lock the table. */
         KScopedLightLock lk(m_general_lock);
 
@@ -3265,7 +3298,201 @@ namespace ams::kern {
                                   KMemoryAttribute_Locked, std::addressof(pg)));
     }
 
+    void KPageTableBase::OpenSwapHold() {
+        KScopedLightLock lk(m_general_lock);
+
+        /* While the table is held, none of its pages may be evicted. */
+        ++m_swap_hold_count;
+        MESOSPHERE_ABORT_UNLESS(m_swap_hold_count > 0);
+    }
+
+    void KPageTableBase::CloseSwapHold() {
+        KScopedLightLock lk(m_general_lock);
+
+        MESOSPHERE_ABORT_UNLESS(m_swap_hold_count > 0);
+        --m_swap_hold_count;
+    }
+
+    Result KPageTableBase::MakeResident(KProcessAddress address, size_t size) {
+        /* Validate pre-conditions. */
+        MESOSPHERE_AUDIT(!this->IsLockedByCurrentThread());
+
+        /* Validate the range. */
+        R_SUCCEED_IF(size == 0);
+        R_UNLESS(this->Contains(address, size), svc::ResultInvalidCurrentMemory());
+
+        /* A page can only be faulted in for the process which owns it, as sys-swap resolves faults for the faulting thread. */
+        const bool is_current = GetCurrentProcessPointer() != nullptr && this == std::addressof(GetCurrentProcess().GetPageTable().GetBasePageTable());
+
+        while (true) {
+            /* Restore any pages which are still being evicted, and find the first page which has been swapped out. */
+            KProcessAddress swapped_address;
+            u64 swap_offset;
+            {
+                KScopedLightLock lk(m_general_lock);
+
+                R_SUCCEED_IF(!this->FindSwappedPage(std::addressof(swapped_address), std::addressof(swap_offset), address, size));
+            }
+
+            /* Another process's page can't be brought back on its behalf. */
+            R_UNLESS(is_current, svc::ResultInvalidCurrentMemory());
+
+            /* Wait for sys-swap to swap the page back in, as though we had faulted on it. */
+            GetCurrentProcess().GetSwapStatistics().OnFault(true);
+            MESOSPHERE_KTRACE_SWAP_FAULT(GetInteger(swapped_address), swap_offset);
+            KSwapManager::WaitForFault(swapped_address, swap_offset, KHardwareTimer::GetTick());
+
+            /* If our wait was cancelled because we're being terminated, stop. */
+            R_UNLESS(!GetCurrentThread().IsTerminationRequested(), svc::ResultTerminationRequested());
+        }
+    }
+
+    Result KPageTableBase::OpenResidentPage(KPhysicalAddress *out, KProcessAddress address) {
+        /* If the address isn't in the table, there's nothing to keep resident; accessing it will fail as usual. */
+        *out = Null<KPhysicalAddress>;
+        R_SUCCEED_IF(!this->Contains(address, 1));
+
+        while (true) {
+            /* Fault in the page. */
+            R_TRY(this->MakeResident(address, 1));
+
+            /* Lock the table. */
+            KScopedLightLock lk(m_general_lock);
+
+            /* If the page was evicted again before we took the lock, try again. */
+            KProcessAddress swapped_address;
+            u64 swap_offset;
+            if (this->FindSwappedPage(std::addressof(swapped_address), std::addressof(swap_offset), address, 1)) {
+                continue;
+            }
+
+            /* Open a reference to the page, so that it can't be evicted until it is closed. */
+            /* NOTE: Memory which isn't heap memory is never swapped, so needs no reference. */
+            KPhysicalAddress phys_addr;
+            if (this->GetPhysicalAddressLocked(std::addressof(phys_addr), address) && this->IsHeapPhysicalAddress(phys_addr)) {
+                *out = util::AlignDown(GetInteger(phys_addr), PageSize);
+                Kernel::GetMemoryManager().Open(*out, 1);
+            }
+
+            R_SUCCEED();
+        }
+    }
+
+    void KPageTableBase::CloseResidentPage(KPhysicalAddress phys_addr) {
+        if (phys_addr != Null<KPhysicalAddress>) {
+            Kernel::GetMemoryManager().Close(phys_addr, 1);
+        }
+    }
+
+    Result KPageTableBase::LockForSwapFaultRing(KPhysicalAddress *out, KProcessAddress address) {
+        /* NOTE: Unlike ipc user buffers, the ring stays mapped for its owner; the kernel accesses it via the linear mapping. */
+        R_TRY(this->LockMemoryAndOpen(nullptr, out, address, ams::svc::SwapFaultRingSize,
+                                      KMemoryState_FlagCanIpcUserBuffer, KMemoryState_FlagCanIpcUserBuffer,
+                                      KMemoryPermission_All, KMemoryPermission_UserReadWrite,
+                                      KMemoryAttribute_All, KMemoryAttribute_None,
+                                      KMemoryPermission_None,
+                                      KMemoryAttribute_Locked));
+
+        /* Open a reference to the page, so that it outlives its owner. */
+        Kernel::GetMemoryManager().Open(*out, 1);
+
+        R_SUCCEED();
+    }
+
+    Result KPageTableBase::UnlockForSwapFaultRing(KProcessAddress address) {
+        R_RETURN(this->UnlockMemory(address, ams::svc::SwapFaultRingSize,
+                                  KMemoryState_FlagCanIpcUserBuffer, KMemoryState_FlagCanIpcUserBuffer,
+                                  KMemoryPermission_None, KMemoryPermission_None,
+                                  KMemoryAttribute_All, KMemoryAttribute_Locked,
+                                  KMemoryPermission_None,
+                                  KMemoryAttribute_Locked, nullptr));
+    }
+
+    Result KPageTableBase::MapSwapInFrames(KProcessAddress *out_address, const KPageGroup &pg) {
+        /* NOTE: Swap-in frames are mapped as insecure memory, so that they can be mapped to a device. They're marked as */
+        /* permission locked, so that they can't be passed to UnmapInsecurePhysicalMemory, which would release a limit   */
+        /* they never reserved; and while they're mapped to a device, they can't be unmapped.                            */
+        const KProcessAddress region_start     = this->GetRegionAddress(KMemoryState_Insecure);
+        const size_t          region_num_pages = this->GetRegionSize(KMemoryState_Insecure) / PageSize;
+        const size_t          num_pages        = pg.GetNumPages();
+        R_UNLESS(num_pages < region_num_pages, svc::ResultOutOfMemory());
+
+        /* Lock the table. */
+        KScopedLightLock lk(m_general_lock);
+
+        /* Find an address to map at. */
+        const KProcessAddress addr = this->FindFreeArea(region_start, region_num_pages, num_pages, PageSize, 0, this->GetNumGuardPages());
+        R_UNLESS(addr != Null<KProcessAddress>, svc::ResultOutOfMemory());
+        MESOSPHERE_ASSERT(this->CanContain(addr, num_pages * PageSize, KMemoryState_Insecure));
+        MESOSPHERE_R_ASSERT(this->CheckMemoryState(addr, num_pages * PageSize, KMemoryState_All, KMemoryState_Free, KMemoryPermission_None, KMemoryPermission_None, KMemoryAttribute_None, KMemoryAttribute_None));
+
+        /* Create an update allocator. */
+        Result allocator_result;
+        KMemoryBlockManagerUpdateAllocator allocator(std::addressof(allocator_result), m_memory_block_slab_manager);
+        R_TRY(allocator_result);
+
+        /* We're going to perform an update, so create a helper. */
+        KScopedPageTableUpdater updater(this);
+
+        /* Map the frames. */
+        const KPageProperties properties = { KMemoryPermission_UserReadWrite, false, false, DisableMergeAttribute_DisableHead };
+        R_TRY(this->MapPageGroupImpl(updater.GetPageList(), addr, pg, properties, false));
+
+        /* Update the blocks. */
+        m_memory_block_manager.Update(std::addressof(allocator), addr, num_pages, KMemoryState_Insecure, KMemoryPermission_UserReadWrite, KMemoryAttribute_PermissionLocked, KMemoryBlockDisableMergeAttribute_Normal, KMemoryBlockDisableMergeAttribute_None);
+
+        *out_address = addr;
+        R_SUCCEED();
+    }
+
+    Result KPageTableBase::UnmapSwapInFrames(KPhysicalAddress *out_phys_addrs, KProcessAddress address, size_t num_pages) {
+        /* Lightly validate the range before doing anything else. */
+        const size_t size = num_pages * PageSize;
+        R_UNLESS(this->Contains(address, size), svc::ResultInvalidCurrentMemory());
+
+        /* Lock the table. */
+        KScopedLightLock lk(m_general_lock);
+
+        /* Check the memory state. */
+        size_t num_allocator_blocks;
+        R_TRY(this->CheckMemoryState(std::addressof(num_allocator_blocks), address, size, KMemoryState_All, KMemoryState_Insecure, KMemoryPermission_All, KMemoryPermission_UserReadWrite, KMemoryAttribute_All, KMemoryAttribute_PermissionLocked));
+
+        /* Create an update allocator. */
+        Result allocator_result;
+        KMemoryBlockManagerUpdateAllocator allocator(std::addressof(allocator_result), m_memory_block_slab_manager, num_allocator_blocks);
+        R_TRY(allocator_result);
+
+        /* If the caller is taking the frames, open a reference to each, so that they outlive the mapping. */
+        if (out_phys_addrs != nullptr) {
+            auto &impl = this->GetImpl();
+            for (size_t i = 0; i < num_pages; ++i) {
+                TraversalContext context;
+                TraversalEntry t_entry;
+                MESOSPHERE_ABORT_UNLESS(impl.BeginTraversal(std::addressof(t_entry), std::addressof(context), address + i * PageSize));
+
+                out_phys_addrs[i] = t_entry.phys_addr;
+                Kernel::GetMemoryManager().Open(out_phys_addrs[i], 1);
+            }
+        }
+
+        /* We're going to perform an update, so create a helper. */
+        KScopedPageTableUpdater updater(this);
+
+        /* Unmap the frames. */
+        const KPageProperties properties = { KMemoryPermission_None, false, false, DisableMergeAttribute_None };
+        MESOSPHERE_R_ABORT_UNLESS(this->Operate(updater.GetPageList(), address, num_pages, Null<KPhysicalAddress>, false, properties, OperationType_Unmap, false));
+
+        /* Update the blocks. */
+        m_memory_block_manager.Update(std::addressof(allocator), address, num_pages, KMemoryState_Free, KMemoryPermission_None, KMemoryAttribute_None, KMemoryBlockDisableMergeAttribute_None, KMemoryBlockDisableMergeAttribute_Normal);
+
+        R_SUCCEED();
+    }
+
     Result KPageTableBase::OpenMemoryRangeForProcessCacheOperation(MemoryRange *out, KProcessAddress address, size_t size) {
+        /* Ensure that none of the memory is swapped out while we operate on it. */
+        KScopedSwapHold swap_hold(this);
+        R_TRY(this->MakeResident(address, size));
+
         /* Lock the table. */
         KScopedLightLock lk(m_general_lock);
 
@@ -3286,6 +3513,14 @@ namespace ams::kern {
         /* Lightly validate the range before doing anything else. */
         R_UNLESS(this->Contains(src_addr, size), svc::ResultInvalidCurrentMemory());
 
+        /* Ensure that none of the memory on either side is swapped out while we copy it. */
+        /* NOTE: The destination is accessed while we hold our lock, so it must be faulted in beforehand. */
+        KPageTableBase &dst_page_table = GetCurrentProcess().GetPageTable().GetBasePageTable();
+        KScopedSwapHold src_swap_hold(this);
+        KScopedSwapHold dst_swap_hold(dst_page_table);
+        R_TRY(this->MakeResident(src_addr, size));
+        R_TRY(dst_page_table.MakeResident(dst_addr, size));
+
         /* Copy the memory. */
         {
             /* Lock the table. */
@@ -3366,6 +3601,10 @@ namespace ams::kern {
         /* Lightly validate the range before doing anything else. */
         R_UNLESS(this->Contains(src_addr, size), svc::ResultInvalidCurrentMemory());
 
+        /* Ensure that none of the memory is swapped out while we operate on it. */
+        KScopedSwapHold swap_hold(this);
+        R_TRY(this->MakeResident(src_addr, size));
+
         /* Copy the memory. */
         {
             /* Lock the table. */
@@ -3435,6 +3674,14 @@ namespace ams::kern {
         /* Lightly validate the range before doing anything else. */
         R_UNLESS(this->Contains(dst_addr, size), svc::ResultInvalidCurrentMemory());
 
+        /* Ensure that none of the memory on either side is swapped out while we copy it. */
+        /* NOTE: The source is accessed while we hold our lock, so it must be faulted in beforehand. */
+        KPageTableBase &src_page_table = GetCurrentProcess().GetPageTable().GetBasePageTable();
+        KScopedSwapHold src_swap_hold(src_page_table);
+        KScopedSwapHold dst_swap_hold(this);
+        R_TRY(src_page_table.MakeResident(src_addr, size));
+        R_TRY(this->MakeResident(dst_addr, size));
+
         /* Copy the memory. */
         {
             /* Lock the table. */
@@ -3515,6 +3762,10 @@ namespace ams::kern {
         /* Lightly validate the range before doing anything else. */
         R_UNLESS(this->Contains(dst_addr, size), svc::ResultInvalidCurrentMemory());
 
+        /* Ensure that none of the memory is swapped out while we operate on it. */
+        KScopedSwapHold swap_hold(this);
+        R_TRY(this->MakeResident(dst_addr, size));
+
         /* Copy the memory. */
         {
             /* Lock the table. */
@@ -3588,6 +3839,12 @@ namespace ams::kern {
         R_UNLESS(src_page_table.Contains(src_addr, size), svc::ResultInvalidCurrentMemory());
         R_UNLESS(dst_page_table.Contains(dst_addr, size), svc::ResultInvalidCurrentMemory());
 
+        /* Ensure that none of the memory on either side is swapped out while we copy it. */
+        KScopedSwapHold src_swap_hold(src_page_table);
+        KScopedSwapHold dst_swap_hold(dst_page_table);
+        R_TRY(src_page_table.MakeResident(src_addr, size));
+        R_TRY(dst_page_table.MakeResident(dst_addr, size));
+
         /* Copy the memory. */
         {
             /* Acquire the table locks. */
@@ -3705,6 +3962,12 @@ namespace ams::kern {
         R_UNLESS(src_page_table.Contains(src_addr, size), svc::ResultInvalidCurrentMemory());
         R_UNLESS(dst_page_table.Contains(dst_addr, size), svc::ResultInvalidCurrentMemory());
 
+        /* Ensure that none of the memory on either side is swapped out while we copy it. */
+        KScopedSwapHold src_swap_hold(src_page_table);
+        KScopedSwapHold dst_swap_hold(dst_page_table);
+        R_TRY(src_page_table.MakeResident(src_addr, size));
+        R_TRY(dst_page_table.MakeResident(dst_addr, size));
+
         /* Copy the memory. */
         {
             /* Acquire the table locks. */
@@ -4134,6 +4397,11 @@ namespace ams::kern {
         /* For convenience, alias this. */
         KPageTableBase &dst_page_table = *this;
 
+        /* Ensure that none of the client's memory is swapped out while we set up the mapping. */
+        /* NOTE: Once set up, the mapping is ipc locked, and may no longer be swapped. */
+        KScopedSwapHold swap_hold(src_page_table);
+        R_TRY(src_page_table.MakeResident(src_addr, size));
+
         /* Acquire the table locks. */
         KScopedLightLockPair lk(src_page_table.m_general_lock, dst_page_table.m_general_lock);
 
@@ -4832,18 +5100,13 @@ namespace ams::kern {
         /* Create a page group for the new memory. */
         KPageGroup pg(m_block_info_manager);
 
-        /* Allocate the new memory. */
+        /* Allocate and clear the new memory. */
         const size_t num_pages = size / PageSize;
-        R_TRY(Kernel::GetMemoryManager().AllocateAndOpen(std::addressof(pg), num_pages, 1, KMemoryManager::EncodeOption(KMemoryManager::Pool_Unsafe, KMemoryManager::Direction_FromFront)));
+        R_TRY(Kernel::GetMemoryManager().AllocateAndOpenWithFill(std::addressof(pg), num_pages, 1, KMemoryManager::EncodeOption(KMemoryManager::Pool_Unsafe, KMemoryManager::Direction_FromFront), m_heap_fill_value));
 
         /* Close the page group when we're done with it. */
         ON_SCOPE_EXIT { pg.Close(); };
 
-        /* Clear the new memory. */
-        for (const auto &block : pg) {
-            std::memset(GetVoidPointer(GetHeapVirtualAddress(block.GetAddress())), m_heap_fill_value, block.GetSize());
-        }
-
         /* Map the new memory. */
         {
             /* Lock the table. */
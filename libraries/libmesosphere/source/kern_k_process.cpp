@@ -233,6 +233,8 @@ namespace ams::kern {
         m_num_fpu_switches            = 0;
         m_num_supervisor_calls        = 0;
         m_num_ipc_messages            = 0;
+        m_swap_statistics.Initialize();
+        m_swap_fault_wait_table.Initialize();
 
         m_is_signaled                 = false;
         m_attached_object             = nullptr;
@@ -1300,6 +1302,14 @@ namespace ams::kern {
     }
 
     Result KProcess::GetProcessList(s32 *out_num_processes, ams::kern::svc::KUserPointer<u64 *> out_process_ids, s32 max_out_count) {
+        /* sys-swap looks up the list to resolve faults, so we can't wait for a fault while holding its lock. */
+        /* Fault in the output buffer beforehand, and keep it resident until we're done. */
+        auto &page_table = GetCurrentProcess().GetPageTable();
+        KPageTableBase::KScopedSwapHold swap_hold(page_table.GetBasePageTable());
+        if (max_out_count > 0) {
+            R_TRY(page_table.MakeResident(reinterpret_cast<uintptr_t>(out_process_ids.GetUnsafePointer()), max_out_count * sizeof(u64)));
+        }
+
         /* Lock the list. */
         KProcess::ListAccessor accessor;
         const auto end = accessor.end();
@@ -1141,6 +1141,7 @@ namespace ams::kern {
         } else {
             result = ResultSuccess();
         }
+        MESOSPHERE_KTRACE_IPC_REPLY(this, (client_thread != nullptr) ? client_thread->GetId() : 0, client_result.GetValue());
 
         /* If there's a client thread, update it. */
         if (client_thread != nullptr) {
@@ -1196,6 +1197,7 @@ namespace ams::kern {
             /* Add the request to the list. */
             request->Open();
             m_request_list.push_back(*request);
+            MESOSPHERE_KTRACE_IPC_SEND(this, request->GetEvent() != nullptr);
 
             /* If we were empty, signal. */
             if (was_empty) {
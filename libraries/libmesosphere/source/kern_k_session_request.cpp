@@ -17,6 +17,12 @@
 
 namespace ams::kern {
 
+    namespace ipc {
+
+        using MessageBuffer = ams::svc::ipc::MessageBuffer;
+
+    }
+
     Result KSessionRequest::SessionMappings::PushMap(KProcessAddress client, KProcessAddress server, size_t size, KMemoryState state, size_t index) {
         /* At most 15 buffers of each type (4-bit descriptor counts). */
         MESOSPHERE_ASSERT(index < NumMappings);
@@ -56,6 +62,120 @@ namespace ams::kern {
         R_RETURN(this->PushMap(client, server, size, state, m_num_send + m_num_recv + m_num_exch++));
     }
 
+    Result KSessionRequest::HoldClientBuffers() {
+        MESOSPHERE_ASSERT(m_thread == GetCurrentThreadPointer());
+        MESOSPHERE_ASSERT(m_client == nullptr);
+
+        /* Kernel threads have no memory to hold. */
+        KProcess *client = m_thread->GetOwnerProcess();
+        R_SUCCEED_IF(client == nullptr);
+
+        /* The server accesses the client's buffers from its own process, where it can't wait for them to be swapped in. */
+        /* Fault them in now, and keep the client's memory resident until the request is finalized. */
+        m_client = client;
+        m_client->Open();
+
+        auto &page_table = m_client->GetPageTable();
+        page_table.OpenSwapHold();
+
+        /* Get the message. */
+        /* NOTE: A user message buffer is page aligned and locked, and its descriptors always fit in its first page. */
+        u32 *msg_ptr;
+        size_t buffer_size;
+        if (m_address) {
+            KPhysicalAddress msg_paddr;
+            R_UNLESS(page_table.GetPhysicalAddress(std::addressof(msg_paddr), m_address), svc::ResultInvalidCurrentMemory());
+
+            msg_ptr     = GetPointer<u32>(KPageTable::GetHeapVirtualAddress(msg_paddr));
+            buffer_size = std::min(m_size, PageSize);
+        } else {
+            msg_ptr     = static_cast<ams::svc::ThreadLocalRegion *>(m_thread->GetThreadLocalRegionHeapAddress())->message_buffer;
+            buffer_size = sizeof(ams::svc::ThreadLocalRegion{}.message_buffer);
+        }
+
+        /* Parse the message. */
+        const ipc::MessageBuffer msg(msg_ptr, buffer_size);
+        const ipc::MessageBuffer::MessageHeader header(msg);
+        const ipc::MessageBuffer::SpecialHeader special_header(msg, header);
+
+        /* If the descriptors don't fit, the server will reject the message, so there's nothing to fault in. */
+        R_SUCCEED_IF(static_cast<size_t>(ipc::MessageBuffer::GetRawDataIndex(header, special_header)) * sizeof(u32) > buffer_size);
+
+        /* Fault in a buffer, leaving invalid ones for the server to reject. */
+        const auto make_resident = [&](uintptr_t address, size_t size) ALWAYS_INLINE_LAMBDA -> Result {
+            R_TRY_CATCH(page_table.MakeResident(address, size)) {
+                R_CATCH(svc::ResultInvalidCurrentMemory) { /* ... */ }
+            } R_END_TRY_CATCH;
+
+            R_SUCCEED();
+        };
+
+        /* Fault in the pointer buffers. */
+        {
+            s32 offset = ipc::MessageBuffer::GetPointerDescriptorIndex(header, special_header);
+            for (auto i = 0; i < header.GetPointerCount(); ++i) {
+                const ipc::MessageBuffer::PointerDescriptor desc(msg, offset);
+                R_TRY(make_resident(desc.GetAddress(), desc.GetSize()));
+
+                offset += ipc::MessageBuffer::PointerDescriptor::GetDataSize() / sizeof(u32);
+            }
+        }
+
+        /* Fault in the map alias buffers. */
+        {
+            s32 offset = ipc::MessageBuffer::GetMapAliasDescriptorIndex(header, special_header);
+            for (auto i = 0; i < header.GetMapAliasCount(); ++i) {
+                const ipc::MessageBuffer::MapAliasDescriptor desc(msg, offset);
+                R_TRY(make_resident(desc.GetAddress(), desc.GetSize()));
+
+                offset += ipc::MessageBuffer::MapAliasDescriptor::GetDataSize() / sizeof(u32);
+            }
+        }
+
+        /* Fault in the receive list buffers, which the server's reply is copied into. */
+        {
+            const auto recv_list_count = header.GetReceiveListCount();
+            size_t entry_count;
+            if (recv_list_count == ipc::MessageBuffer::MessageHeader::ReceiveListCountType_None || recv_list_count == ipc::MessageBuffer::MessageHeader::ReceiveListCountType_ToMessageBuffer) {
+                entry_count = 0;
+            } else if (recv_list_count == ipc::MessageBuffer::MessageHeader::ReceiveListCountType_ToSingleBuffer) {
+                entry_count = 1;
+            } else {
+                entry_count = recv_list_count - ipc::MessageBuffer::MessageHeader::ReceiveListCountType_CountOffset;
+            }
+
+            /* NOTE: The receive list follows the raw data, and so may lie beyond the first page of a user message buffer. */
+            const size_t recv_list_offset = ipc::MessageBuffer::GetReceiveListIndex(header, special_header) * sizeof(u32);
+            const size_t recv_list_size   = entry_count * ipc::MessageBuffer::ReceiveListEntry::GetDataSize();
+            R_SUCCEED_IF(recv_list_offset + recv_list_size > (m_address ? m_size : buffer_size));
+
+            for (size_t i = 0; i < entry_count; ++i) {
+                u32 data[ipc::MessageBuffer::ReceiveListEntry::GetDataSize() / sizeof(u32)];
+                if (m_address) {
+                    R_TRY(page_table.CopyMemoryFromLinearToKernel(reinterpret_cast<uintptr_t>(data), sizeof(data), m_address + recv_list_offset + i * sizeof(data),
+                                                                  KMemoryState_FlagReferenceCounted, KMemoryState_FlagReferenceCounted,
+                                                                  static_cast<KMemoryPermission>(KMemoryPermission_NotMapped | KMemoryPermission_KernelRead),
+                                                                  KMemoryAttribute_Uncached, KMemoryAttribute_None));
+                } else {
+                    __builtin_memcpy(data, reinterpret_cast<const u8 *>(msg_ptr) + recv_list_offset + i * sizeof(data), sizeof(data));
+                }
+
+                const ipc::MessageBuffer::ReceiveListEntry entry(data[0], data[1]);
+                R_TRY(make_resident(entry.GetAddress(), entry.GetSize()));
+            }
+        }
+
+        R_SUCCEED();
+    }
+
+    void KSessionRequest::ReleaseClientBuffers() {
+        MESOSPHERE_ASSERT(m_client != nullptr);
+
+        m_client->GetPageTable().CloseSwapHold();
+        m_client->Close();
+        m_client = nullptr;
+    }
+
     void KSessionRequest::SessionMappings::Finalize() {
         if (m_dynamic_mappings) {
             DynamicMappings::Free(m_dynamic_mappings);
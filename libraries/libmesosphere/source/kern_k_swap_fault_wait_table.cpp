@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <mesosphere.hpp>
+
+namespace ams::kern {
+
+    namespace {
+
+        ALWAYS_INLINE void WakeThread(KThread *thread) {
+            if (KSwapManager::IsWaitingForFault(thread)) {
+                thread->EndWait(ResultSuccess());
+            }
+        }
+
+    }
+
+    bool KSwapFaultWaitTable::Wait(KThread *thread) {
+        MESOSPHERE_ASSERT(KScheduler::IsSchedulerLockedByCurrentThread());
+
+        const KProcessAddress page_address = util::AlignDown(GetInteger(thread->GetSwapVirtualAddress()), PageSize);
+        KThread **bucket = std::addressof(m_buckets[GetBucketIndex(page_address)]);
+
+        /* If another thread is already waiting on the page, wait behind it. */
+        for (KThread *first = *bucket; first != nullptr; first = first->GetSwapWaitNext()) {
+            if (util::AlignDown(GetInteger(first->GetSwapVirtualAddress()), PageSize) == GetInteger(page_address)) {
+                thread->SetSwapWaitNext(first->GetSwapWaiters());
+                thread->SetSwapWaiters(nullptr);
+                first->SetSwapWaiters(thread);
+                return false;
+            }
+        }
+
+        /* Otherwise, we're the first, and the caller must request the page. */
+        thread->SetSwapWaitNext(*bucket);
+        thread->SetSwapWaiters(nullptr);
+        *bucket = thread;
+        return true;
+    }
+
+    KThread *KSwapFaultWaitTable::Remove(KThread *thread) {
+        MESOSPHERE_ASSERT(KScheduler::IsSchedulerLockedByCurrentThread());
+
+        const KProcessAddress page_address = util::AlignDown(GetInteger(thread->GetSwapVirtualAddress()), PageSize);
+        KThread **bucket = std::addressof(m_buckets[GetBucketIndex(page_address)]);
+
+        for (KThread *prev = nullptr, *cur = *bucket; cur != nullptr; prev = cur, cur = cur->GetSwapWaitNext()) {
+            if (cur == thread) {
+                /* If a thread is waiting behind it, the first one takes its place, along with the rest. */
+                KThread *successor = thread->GetSwapWaiters();
+                KThread *next      = thread->GetSwapWaitNext();
+                if (successor != nullptr) {
+                    successor->SetSwapWaiters(successor->GetSwapWaitNext());
+                    successor->SetSwapWaitNext(next);
+                    next = successor;
+                }
+
+                if (prev != nullptr) {
+                    prev->SetSwapWaitNext(next);
+                } else {
+                    *bucket = next;
+                }
+
+                thread->SetSwapWaitNext(nullptr);
+                thread->SetSwapWaiters(nullptr);
+                return successor;
+            }
+
+            /* If it's waiting behind another thread, just unlink it. */
+            for (KThread *waiter_prev = nullptr, *waiter = cur->GetSwapWaiters(); waiter != nullptr; waiter_prev = waiter, waiter = waiter->GetSwapWaitNext()) {
+                if (waiter == thread) {
+                    if (waiter_prev != nullptr) {
+                        waiter_prev->SetSwapWaitNext(thread->GetSwapWaitNext());
+                    } else {
+                        cur->SetSwapWaiters(thread->GetSwapWaitNext());
+                    }
+
+                    thread->SetSwapWaitNext(nullptr);
+                    return nullptr;
+                }
+            }
+        }
+
+        return nullptr;
+    }
+
+    void KSwapFaultWaitTable::WakeAll(KThread *thread) {
+        MESOSPHERE_ASSERT(KScheduler::IsSchedulerLockedByCurrentThread());
+
+        const KProcessAddress page_address = util::AlignDown(GetInteger(thread->GetSwapVirtualAddress()), PageSize);
+
+        /* Remove the thread from its bucket. */
+        KThread **bucket = std::addressof(m_buckets[GetBucketIndex(page_address)]);
+        bool found = false;
+        for (KThread *prev = nullptr, *cur = *bucket; cur != nullptr; prev = cur, cur = cur->GetSwapWaitNext()) {
+            if (cur == thread) {
+                if (prev != nullptr) {
+                    prev->SetSwapWaitNext(cur->GetSwapWaitNext());
+                } else {
+                    *bucket = cur->GetSwapWaitNext();
+                }
+                found = true;
+                break;
+            }
+
+            /* A thread waiting behind another is woken along with it, and must stay linked until then. */
+            for (KThread *waiter = cur->GetSwapWaiters(); waiter != nullptr; waiter = waiter->GetSwapWaitNext()) {
+                if (waiter == thread) {
+                    return;
+                }
+            }
+        }
+
+        /* If the thread isn't in the table, it isn't waiting on a swapped page; it was woken by an earlier resolution. */
+        if (!found) {
+            return;
+        }
+
+        /* Wake the thread, along with every thread waiting behind it. */
+        KThread *waiter = thread->GetSwapWaiters();
+        thread->SetSwapWaitNext(nullptr);
+        thread->SetSwapWaiters(nullptr);
+        WakeThread(thread);
+
+        while (waiter != nullptr) {
+            KThread *next = waiter->GetSwapWaitNext();
+            waiter->SetSwapWaitNext(nullptr);
+            WakeThread(waiter);
+
+            waiter = next;
+        }
+    }
+
+}
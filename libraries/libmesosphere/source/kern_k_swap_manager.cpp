@@ -0,0 +1,877 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <mesosphere.hpp>
+
+namespace ams::kern {
+
+    namespace {
+
+        enum EvictionState : u8 {
+            EvictionState_Free       = 0,
+            EvictionState_Queued     = 1,
+            EvictionState_InFlight   = 2,
+            EvictionState_Completing = 3,
+        };
+
+        struct EvictionEntry {
+            EvictionEntry *next         = nullptr;
+            u64 process_id              = 0;
+            KProcessAddress address     = Null<KProcessAddress>;
+            KPhysicalAddress phys_addr  = Null<KPhysicalAddress>;
+            EvictionState state         = EvictionState_Free;
+            bool clean                  = false;
+            bool cancelled              = false;
+        };
+
+        constinit KLightLock g_eviction_lock;
+        constinit EvictionEntry g_eviction_entries[KSwapManager::MaxEvictions] = {};
+        constinit size_t g_num_used_eviction_entries = 0;
+        constinit EvictionEntry *g_eviction_free_list  = nullptr;
+        constinit EvictionEntry *g_eviction_queue_head = nullptr;
+        constinit EvictionEntry *g_eviction_queue_tail = nullptr;
+
+        ALWAYS_INLINE u32 GetEvictionId(const EvictionEntry *entry) {
+            return static_cast<u32>(entry - g_eviction_entries);
+        }
+
+        EvictionEntry *AllocateEvictionEntry() {
+            MESOSPHERE_ASSERT(g_eviction_lock.IsLockedByCurrentThread());
+
+            /* Prefer a previously freed entry. */
+            if (EvictionEntry *entry = g_eviction_free_list; entry != nullptr) {
+                g_eviction_free_list = entry->next;
+                return entry;
+            }
+
+            /* Otherwise, take a never-used entry, if we have one. */
+            if (g_num_used_eviction_entries < KSwapManager::MaxEvictions) {
+                return std::addressof(g_eviction_entries[g_num_used_eviction_entries++]);
+            }
+
+            return nullptr;
+        }
+
+        void FreeEvictionEntry(EvictionEntry *entry) {
+            MESOSPHERE_ASSERT(g_eviction_lock.IsLockedByCurrentThread());
+
+            entry->state         = EvictionState_Free;
+            entry->next          = g_eviction_free_list;
+            g_eviction_free_list = entry;
+        }
+
+        void PushEvictionQueueBack(EvictionEntry *entry) {
+            MESOSPHERE_ASSERT(g_eviction_lock.IsLockedByCurrentThread());
+
+            entry->state = EvictionState_Queued;
+            entry->next  = nullptr;
+            if (g_eviction_queue_tail != nullptr) {
+                g_eviction_queue_tail->next = entry;
+            } else {
+                g_eviction_queue_head = entry;
+            }
+            g_eviction_queue_tail = entry;
+        }
+
+        void PushEvictionQueueFront(EvictionEntry *entry) {
+            MESOSPHERE_ASSERT(g_eviction_lock.IsLockedByCurrentThread());
+
+            entry->state = EvictionState_Queued;
+            entry->next  = g_eviction_queue_head;
+            g_eviction_queue_head = entry;
+            if (g_eviction_queue_tail == nullptr) {
+                g_eviction_queue_tail = entry;
+            }
+        }
+
+        struct FaultRing {
+            u64 owner_process_id       = 0;
+            KProcessAddress address    = Null<KProcessAddress>;
+            KPhysicalAddress phys_addr = Null<KPhysicalAddress>;
+        };
+
+        constexpr inline u32 FaultRingCapacity = ams::svc::SwapFaultRingCapacity;
+        static_assert(util::IsPowerOfTwo(FaultRingCapacity));
+
+        constinit KLightLock g_fault_ring_lock;
+        constinit FaultRing g_fault_request_ring_info;
+        constinit FaultRing g_fault_completion_ring_info;
+        constinit ams::svc::SwapFaultRequestRing *g_fault_request_ring       = nullptr;
+        constinit ams::svc::SwapFaultCompletionRing *g_fault_completion_ring = nullptr;
+
+        /* NOTE: The kernel keeps its own copy of the indices it produces/consumes, so that it never trusts them from userland. */
+        constinit u32 g_fault_request_tail    = 0;
+        constinit u32 g_fault_completion_head = 0;
+
+        /* NOTE: A faulting thread pushes itself onto its core's fault queue without taking a lock, and sys-swap takes each */
+        /* queue whole. The threads taken wait on the pending list, oldest first, until they're handed to sys-swap through  */
+        /* the request ring or GetSwapRequest. The pending list is guarded by the fault ring lock, so that sys-swap never   */
+        /* takes the scheduler lock to drain faults.                                                                        */
+        struct alignas(cpu::DataCacheLineSize) FaultQueue {
+            KThread *head;
+        };
+
+        constinit FaultQueue g_fault_queues[cpu::NumCores] = {};
+        constinit KThread *g_pending_fault_head = nullptr;
+        constinit KThread *g_pending_fault_tail = nullptr;
+
+        void PushFaultQueue(KThread *thread) {
+            /* A thread still queued from an earlier fault needn't be queued again; its request is read when it's taken. */
+            if (!thread->TrySetSwapQueued()) {
+                return;
+            }
+
+            /* The queue holds a reference to the thread until sys-swap takes it. */
+            thread->Open();
+
+            util::AtomicRef<KThread *> head(g_fault_queues[GetCurrentCoreId()].head);
+            KThread *cur_head = head.Load<std::memory_order_relaxed>();
+            do {
+                thread->SetSwapNext(cur_head);
+            } while (!head.CompareExchangeWeak<std::memory_order_release>(cur_head, thread));
+        }
+
+        void TakeFaultQueuesLocked() {
+            MESOSPHERE_ASSERT(g_fault_ring_lock.IsLockedByCurrentThread());
+
+            for (auto &queue : g_fault_queues) {
+                /* Take the whole queue, reversing it so that its threads are in the order they faulted. */
+                KThread *first = nullptr;
+                KThread *last  = nullptr;
+                for (KThread *thread = util::AtomicRef<KThread *>(queue.head).Exchange<std::memory_order_acquire>(nullptr); thread != nullptr; ) {
+                    KThread *next = thread->GetSwapNext();
+                    thread->SetSwapNext(first);
+                    if (last == nullptr) {
+                        last = thread;
+                    }
+                    first  = thread;
+                    thread = next;
+                }
+
+                /* Append it to the pending list. */
+                if (first != nullptr) {
+                    if (g_pending_fault_tail != nullptr) {
+                        g_pending_fault_tail->SetSwapNext(first);
+                    } else {
+                        g_pending_fault_head = first;
+                    }
+                    g_pending_fault_tail = last;
+                }
+            }
+        }
+
+        ams::svc::SwapFaultRequest PopPendingFaultLocked() {
+            MESOSPHERE_ASSERT(g_fault_ring_lock.IsLockedByCurrentThread());
+            MESOSPHERE_ASSERT(g_pending_fault_head != nullptr);
+
+            KThread *thread = g_pending_fault_head;
+            g_pending_fault_head = thread->GetSwapNext();
+            if (g_pending_fault_head == nullptr) {
+                g_pending_fault_tail = nullptr;
+            }
+            thread->SetSwapNext(nullptr);
+
+            /* Let the thread be queued again before reading its request, so that a later fault is never missed. */
+            thread->ClearSwapQueued();
+
+            const ams::svc::SwapFaultRequest request = {
+                .process_id    = thread->GetOwnerProcess()->GetId(),
+                .thread_id     = thread->GetId(),
+                .address       = GetInteger(thread->GetSwapVirtualAddress()),
+                .sector_offset = thread->GetSwapSectorOffset(),
+            };
+
+            /* Close the queue's reference to the thread; sys-swap refers to it by id. */
+            thread->Close();
+
+            return request;
+        }
+
+        class ThreadQueueImplForSwapFault final : public KThreadQueue {
+            public:
+                constexpr ThreadQueueImplForSwapFault() : KThreadQueue() { /* ... */ }
+
+                virtual void CancelWait(KThread *waiting_thread, Result wait_result, bool cancel_timer_task) override {
+                    /* Stop waiting on the page. If another thread was waiting behind us, it has to request the page itself. */
+                    if (KThread *successor = waiting_thread->GetOwnerProcess()->GetSwapFaultWaitTable().Remove(waiting_thread); successor != nullptr) {
+                        PushFaultQueue(successor);
+                        KSwapManager::SignalSwapEvent();
+                    }
+
+                    /* Invoke the base cancel wait handler. */
+                    KThreadQueue::CancelWait(waiting_thread, wait_result, cancel_timer_task);
+                }
+        };
+
+        constinit ThreadQueueImplForSwapFault g_fault_thread_queue;
+
+        /* NOTE: Offsets whose pages have been swapped back in are handed back to sys-swap, so that it can reuse their slots. */
+        constinit KLightLock g_released_offset_lock;
+        constinit u64 g_released_offsets[KSwapManager::MaxReleasedOffsets] = {};
+        constinit size_t g_released_offset_head = 0;
+        constinit size_t g_num_released_offsets = 0;
+
+        /* NOTE: Each pool has at most one outstanding reclaim request; a larger request for the pool replaces it. */
+        /* Allocations waiting on a reclaim are woken whenever sys-swap completes a batch of evictions.         */
+        constinit KLightLock g_reclaim_lock;
+        constinit KLightConditionVariable g_reclaim_cv{util::ConstantInitialize};
+        constinit size_t g_reclaim_num_pages[KMemoryManager::Pool_Count] = {};
+        constinit u64 g_reclaim_generation = 0;
+
+        /* NOTE: Each process has at most one outstanding activity request; a newer request for the process replaces it. */
+        constinit KLightLock g_activity_lock;
+        constinit ams::svc::SwapActivityRequest g_activity_requests[KSwapManager::MaxActivityRequests] = {};
+        constinit size_t g_num_activity_requests = 0;
+
+        template<typename T>
+        ALWAYS_INLINE T *GetFaultRingPointer(KPhysicalAddress phys_addr) {
+            return GetPointer<T>(KMemoryLayout::GetLinearVirtualAddress(phys_addr));
+        }
+
+        void ReleaseFaultRing(const FaultRing &ring) {
+            /* Unlock the ring, if its owner still exists. */
+            if (KProcess *process = KProcess::GetProcessFromId(ring.owner_process_id); process != nullptr) {
+                ON_SCOPE_EXIT { process->Close(); };
+
+                MESOSPHERE_R_ABORT_UNLESS(process->GetPageTable().UnlockForSwapFaultRing(ring.address));
+            }
+
+            /* Release our reference to the page. */
+            Kernel::GetMemoryManager().Close(ring.phys_addr, 1);
+        }
+
+        Result GetFaultingThread(KProcess **out_process, KThread **out_thread, u64 process_id, u64 thread_id, KProcessAddress address) {
+            /* Get the process from ID. */
+            KProcess *process = KProcess::GetProcessFromId(process_id);
+            R_UNLESS(process != nullptr, svc::ResultInvalidHandle());
+            ON_RESULT_FAILURE { process->Close(); };
+
+            /* Get the thread from ID. */
+            KThread *thread = KThread::GetThreadFromId(thread_id);
+            R_UNLESS(thread != nullptr, svc::ResultInvalidHandle());
+            ON_RESULT_FAILURE_2 { thread->Close(); };
+
+            /* Ensure the thread is owned by the process. */
+            R_UNLESS(thread->GetOwnerProcess() == process, svc::ResultInvalidHandle());
+
+            /* Ensure the fault address matches. */
+            R_UNLESS(thread->GetSwapVirtualAddress() == address, svc::ResultInvalidAddress());
+
+            *out_process = process;
+            *out_thread  = thread;
+            R_SUCCEED();
+        }
+
+        s32 ProcessFaultCompletionsLocked(u64 *out_failed_process_ids, size_t *out_num_failed) {
+            MESOSPHERE_ASSERT(g_fault_ring_lock.IsLockedByCurrentThread());
+
+            *out_num_failed = 0;
+
+            /* If we have no ring, there's nothing to do. */
+            if (g_fault_completion_ring == nullptr) {
+                return 0;
+            }
+
+            /* Determine how many completions are available. */
+            auto &header = g_fault_completion_ring->header;
+            const u32 tail      = util::AtomicRef<u32>(header.tail).Load<std::memory_order_acquire>();
+            const u32 available = std::min<u32>(tail - g_fault_completion_head, FaultRingCapacity);
+
+            /* Resolve each completion. */
+            s32 count = 0;
+            for (u32 i = 0; i < available; ++i) {
+                /* Consume the entry. */
+                const ams::svc::SwapFaultCompletion completion = g_fault_completion_ring->entries[g_fault_completion_head % FaultRingCapacity];
+                util::AtomicRef<u32>(header.head).Store<std::memory_order_release>(++g_fault_completion_head);
+
+                /* If the page couldn't be read back, note its process for termination, provided its thread really is waiting on it. */
+                if (completion.status != ams::svc::SwapFaultStatus_Resolved) {
+                    KProcess *process;
+                    KThread *thread;
+                    if (R_SUCCEEDED(GetFaultingThread(std::addressof(process), std::addressof(thread), completion.process_id, completion.thread_id, completion.address))) {
+                        thread->Close();
+                        process->Close();
+
+                        out_failed_process_ids[(*out_num_failed)++] = completion.process_id;
+                    }
+                    continue;
+                }
+
+                /* Map the page and wake the thread. */
+                /* NOTE: A bad completion only affects its own entry; it shouldn't keep the rest of the batch from being resolved. */
+                if (R_SUCCEEDED(KSwapManager::ResolveFault(completion.process_id, completion.thread_id, completion.address, completion.buffer))) {
+                    ++count;
+                }
+            }
+
+            return count;
+        }
+
+        void TerminateFailedFaultProcesses(const u64 *process_ids, size_t num_processes) {
+            /* Terminate any process with a page which couldn't be read back, as its faulting thread can never resume. */
+            /* NOTE: Termination waits for the process's threads to exit, so this must be called without holding the ring lock. */
+            MESOSPHERE_ASSERT(!g_fault_ring_lock.IsLockedByCurrentThread());
+
+            for (size_t i = 0; i < num_processes; ++i) {
+                if (KProcess *process = KProcess::GetProcessFromId(process_ids[i]); process != nullptr) {
+                    ON_SCOPE_EXIT { process->Close(); };
+
+                    /* NOTE: A process which is already being terminated needs nothing more from us. */
+                    const Result terminate_result = process->Terminate();
+                    MESOSPHERE_UNUSED(terminate_result);
+                }
+            }
+        }
+
+        void PublishFaultRequestsLocked() {
+            MESOSPHERE_ASSERT(g_fault_ring_lock.IsLockedByCurrentThread());
+
+            /* If we have no ring, requests are taken through GetSwapRequest instead. */
+            if (g_fault_request_ring == nullptr) {
+                return;
+            }
+
+            /* Hand as many pending requests to sys-swap as the ring has space for. */
+            TakeFaultQueuesLocked();
+
+            auto &header = g_fault_request_ring->header;
+            const u32 head = util::AtomicRef<u32>(header.head).Load<std::memory_order_acquire>();
+            while (g_pending_fault_head != nullptr && static_cast<u32>(g_fault_request_tail - head) < FaultRingCapacity) {
+                g_fault_request_ring->entries[g_fault_request_tail++ % FaultRingCapacity] = PopPendingFaultLocked();
+            }
+            util::AtomicRef<u32>(header.tail).Store<std::memory_order_release>(g_fault_request_tail);
+        }
+
+        template<typename F>
+        void CancelEvictionImpl(F matches) {
+            KPhysicalAddress unpin_phys_addr = Null<KPhysicalAddress>;
+            {
+                KScopedLightLock lk(g_eviction_lock);
+
+                /* If the eviction hasn't been handed to sys-swap yet, we can just drop it. */
+                for (EvictionEntry *prev = nullptr, *cur = g_eviction_queue_head; cur != nullptr; prev = cur, cur = cur->next) {
+                    if (matches(*cur)) {
+                        if (prev != nullptr) {
+                            prev->next = cur->next;
+                        } else {
+                            g_eviction_queue_head = cur->next;
+                        }
+                        if (g_eviction_queue_tail == cur) {
+                            g_eviction_queue_tail = prev;
+                        }
+
+                        unpin_phys_addr = cur->phys_addr;
+                        FreeEvictionEntry(cur);
+                        break;
+                    }
+                }
+
+                /* Otherwise, the write is in flight; mark it so that its completion leaves the page table alone. */
+                if (unpin_phys_addr == Null<KPhysicalAddress>) {
+                    for (size_t i = 0; i < g_num_used_eviction_entries; ++i) {
+                        EvictionEntry &entry = g_eviction_entries[i];
+                        if ((entry.state == EvictionState_InFlight || entry.state == EvictionState_Completing) && !entry.cancelled && matches(entry)) {
+                            entry.cancelled = true;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            /* Release the pin on a dropped eviction. */
+            if (unpin_phys_addr != Null<KPhysicalAddress>) {
+                Kernel::GetMemoryManager().Close(unpin_phys_addr, 1);
+            }
+        }
+
+    }
+
+    Result KSwapManager::EnqueueEviction(u64 process_id, KProcessAddress address, KPhysicalAddress phys_addr, bool clean) {
+        KScopedLightLock lk(g_eviction_lock);
+
+        /* Allocate an entry for the eviction. */
+        EvictionEntry *entry = AllocateEvictionEntry();
+        R_UNLESS(entry != nullptr, svc::ResultOutOfResource());
+
+        /* Pin the page, so that it stays alive until the write has completed. */
+        Kernel::GetMemoryManager().Open(phys_addr, 1);
+
+        /* Set up and queue the entry. */
+        entry->process_id    = process_id;
+        entry->address       = address;
+        entry->phys_addr     = phys_addr;
+        entry->clean         = clean;
+        entry->cancelled     = false;
+        PushEvictionQueueBack(entry);
+
+        R_SUCCEED();
+    }
+
+    void KSwapManager::CancelEviction(u64 process_id, KProcessAddress address) {
+        CancelEvictionImpl([&](const EvictionEntry &entry) ALWAYS_INLINE_LAMBDA { return entry.process_id == process_id && entry.address == address; });
+    }
+
+    void KSwapManager::CancelEviction(KPhysicalAddress phys_addr) {
+        /* NOTE: A frame is pinned by at most one eviction which hasn't been cancelled, so the frame identifies it. */
+        CancelEvictionImpl([&](const EvictionEntry &entry) ALWAYS_INLINE_LAMBDA { return entry.phys_addr == phys_addr; });
+    }
+
+    void KSwapManager::SignalSwapEvent() {
+        if (g_SwapEvent != nullptr) {
+            g_SwapEvent->Signal();
+        }
+    }
+
+    s32 KSwapManager::BeginEvictions(ams::svc::SwapEvictionInfo *out_infos, KPhysicalAddress *out_phys_addrs, s32 max_count) {
+        KScopedLightLock lk(g_eviction_lock);
+
+        s32 count = 0;
+        while (count < max_count && g_eviction_queue_head != nullptr) {
+            /* Dequeue the next eviction. */
+            EvictionEntry *entry = g_eviction_queue_head;
+            g_eviction_queue_head = entry->next;
+            if (g_eviction_queue_head == nullptr) {
+                g_eviction_queue_tail = nullptr;
+            }
+
+            /* Mark it as in flight, and report it. */
+            entry->next  = nullptr;
+            entry->state = EvictionState_InFlight;
+
+            out_infos[count] = {
+                .process_id = entry->process_id,
+                .address    = GetInteger(entry->address),
+                .reserved   = 0,
+                .id         = GetEvictionId(entry),
+                .flags      = entry->clean ? ams::svc::SwapEvictionFlag_Clean : ams::svc::SwapEvictionFlag_None,
+            };
+            out_phys_addrs[count] = entry->phys_addr;
+
+            ++count;
+        }
+
+        return count;
+    }
+
+    void KSwapManager::AbortEvictions(const ams::svc::SwapEvictionInfo *infos, s32 count) {
+        KScopedLightLock lk(g_eviction_lock);
+
+        /* Requeue the evictions at the front of the queue, preserving their order. */
+        for (s32 i = count - 1; i >= 0; --i) {
+            EvictionEntry *entry = std::addressof(g_eviction_entries[infos[i].id]);
+            if (entry->state == EvictionState_InFlight) {
+                PushEvictionQueueFront(entry);
+            }
+        }
+    }
+
+    Result KSwapManager::CompleteEviction(u32 id, ams::svc::SwapEvictionStatus status, size_t stored_size, u64 sector_offset) {
+        /* Claim the eviction. */
+        EvictionEntry *entry;
+        {
+            KScopedLightLock lk(g_eviction_lock);
+
+            R_UNLESS(id < g_num_used_eviction_entries, svc::ResultInvalidId());
+
+            entry = std::addressof(g_eviction_entries[id]);
+            R_UNLESS(entry->state == EvictionState_InFlight, svc::ResultInvalidState());
+
+            /* Only a clean page may be dropped without being written. */
+            R_UNLESS(status != ams::svc::SwapEvictionStatus_Discarded || entry->clean, svc::ResultInvalidState());
+
+            entry->state = EvictionState_Completing;
+        }
+
+        /* A page kept in sys-swap's compressed tier is recorded as such, so that its faults are served from memory. */
+        /* A discarded page has no sectors, so its offset only identifies it; its faults reload it.                */
+        const bool written = status != ams::svc::SwapEvictionStatus_Failed;
+
+        u64 swap_offset;
+        switch (status) {
+            case ams::svc::SwapEvictionStatus_Compressed: swap_offset = sector_offset | ams::svc::SwapOffsetCompressedFlag; break;
+            case ams::svc::SwapEvictionStatus_Discarded:  swap_offset = sector_offset | ams::svc::SwapOffsetDiscardedFlag;  break;
+            default:                                      swap_offset = sector_offset;                                       break;
+        }
+
+        /* Finalize the page table entry, if the owner process still exists. */
+        /* NOTE: sys-swap placed the page before knowing whether it would be recorded, so hand back an offset nothing refers to. */
+        bool recorded = false;
+        if (KProcess *process = KProcess::GetProcessFromId(entry->process_id); process != nullptr) {
+            ON_SCOPE_EXIT { process->Close(); };
+
+            recorded = process->GetPageTable().GetPageTableImpl().CompleteSwapEviction(id, entry->address, entry->phys_addr, swap_offset, written);
+
+            if (written) {
+                process->GetSwapStatistics().OnPageOut(stored_size);
+            }
+        }
+
+        if (written && !recorded) {
+            ReleaseSwapOffset(swap_offset);
+        }
+
+        /* Release the pin. */
+        Kernel::GetMemoryManager().Close(entry->phys_addr, 1);
+
+        /* Free the entry. */
+        {
+            KScopedLightLock lk(g_eviction_lock);
+            FreeEvictionEntry(entry);
+        }
+
+        R_SUCCEED();
+    }
+
+    bool KSwapManager::IsEvictionCancelled(u32 id) {
+        KScopedLightLock lk(g_eviction_lock);
+
+        MESOSPHERE_ASSERT(id < g_num_used_eviction_entries);
+        return g_eviction_entries[id].cancelled;
+    }
+
+    Result KSwapManager::RegisterFaultRings(KProcessAddress request_ring, KProcessAddress completion_ring) {
+        KProcess &process = GetCurrentProcess();
+        auto &page_table  = process.GetPageTable();
+
+        /* Lock the new rings. */
+        KPhysicalAddress request_phys_addr;
+        R_TRY(page_table.LockForSwapFaultRing(std::addressof(request_phys_addr), request_ring));
+        ON_RESULT_FAILURE { ReleaseFaultRing({ process.GetId(), request_ring, request_phys_addr }); };
+
+        KPhysicalAddress completion_phys_addr;
+        R_TRY(page_table.LockForSwapFaultRing(std::addressof(completion_phys_addr), completion_ring));
+
+        auto * const requests    = GetFaultRingPointer<ams::svc::SwapFaultRequestRing>(request_phys_addr);
+        auto * const completions = GetFaultRingPointer<ams::svc::SwapFaultCompletionRing>(completion_phys_addr);
+
+        /* Install the new rings. */
+        FaultRing old_request_ring, old_completion_ring;
+        u64 failed_process_ids[FaultRingCapacity];
+        size_t num_failed = 0;
+        {
+            KScopedLightLock lk(g_fault_ring_lock);
+
+            /* Resolve anything that was completed on the old ring. */
+            ProcessFaultCompletionsLocked(failed_process_ids, std::addressof(num_failed));
+
+            /* Carry over any requests which haven't been consumed yet, so that their threads aren't stranded. */
+            u32 num_carried = 0;
+            if (g_fault_request_ring != nullptr) {
+                const u32 head    = util::AtomicRef<u32>(g_fault_request_ring->header.head).Load<std::memory_order_acquire>();
+                const u32 pending = std::min<u32>(g_fault_request_tail - head, FaultRingCapacity);
+                for (u32 i = 0; i < pending; ++i) {
+                    requests->entries[num_carried++] = g_fault_request_ring->entries[(g_fault_request_tail - pending + i) % FaultRingCapacity];
+                }
+            }
+
+            /* Initialize the ring headers. */
+            requests->header    = { .head = 0, .tail = num_carried, .capacity = FaultRingCapacity, .reserved = {} };
+            completions->header = { .head = 0, .tail = 0,           .capacity = FaultRingCapacity, .reserved = {} };
+            cpu::DataMemoryBarrierInnerShareable();
+
+            /* Swap in the new rings. */
+            old_request_ring    = g_fault_request_ring_info;
+            old_completion_ring = g_fault_completion_ring_info;
+
+            g_fault_request_ring_info    = { process.GetId(), request_ring, request_phys_addr };
+            g_fault_completion_ring_info = { process.GetId(), completion_ring, completion_phys_addr };
+            g_fault_request_ring         = requests;
+            g_fault_completion_ring      = completions;
+            g_fault_request_tail         = num_carried;
+            g_fault_completion_head      = 0;
+        }
+
+        /* Release the old rings. */
+        if (old_request_ring.phys_addr != Null<KPhysicalAddress>) {
+            ReleaseFaultRing(old_request_ring);
+        }
+        if (old_completion_ring.phys_addr != Null<KPhysicalAddress>) {
+            ReleaseFaultRing(old_completion_ring);
+        }
+
+        /* Terminate any process with a page which the old ring reported couldn't be read back. */
+        TerminateFailedFaultProcesses(failed_process_ids, num_failed);
+
+        R_SUCCEED();
+    }
+
+    void KSwapManager::WaitForFault(KProcessAddress address, u64 swap_offset, s64 fault_tick) {
+        KThread &cur_thread = GetCurrentThread();
+
+        KScopedSchedulerLock sl;
+
+        /* If we're being terminated, don't wait. */
+        if (cur_thread.IsTerminationRequested()) {
+            return;
+        }
+
+        cur_thread.SetSwapVirtualAddress(address);
+        cur_thread.SetSwapSectorOffset(swap_offset);
+        cur_thread.SetSwapFaultTick(fault_tick);
+
+        /* If another thread is already waiting on the page, wait behind it; its request will wake us too. */
+        /* Otherwise, queue our request for sys-swap. */
+        if (cur_thread.GetOwnerProcess()->GetSwapFaultWaitTable().Wait(std::addressof(cur_thread))) {
+            PushFaultQueue(std::addressof(cur_thread));
+            SignalSwapEvent();
+        }
+
+        /* Wait for the page. */
+        cur_thread.BeginWait(std::addressof(g_fault_thread_queue));
+    }
+
+    bool KSwapManager::IsWaitingForFault(const KThread *thread) {
+        return thread->GetState() == KThread::ThreadState_Waiting && thread->GetWaitQueue() == std::addressof(g_fault_thread_queue);
+    }
+
+    Result KSwapManager::TakeFaultRequest(u64 *out_process_id, u64 *out_thread_id, KProcessAddress *out_address) {
+        KScopedLightLock lk(g_fault_ring_lock);
+
+        /* Take the oldest request which hasn't been handed to sys-swap. */
+        TakeFaultQueuesLocked();
+        R_UNLESS(g_pending_fault_head != nullptr, svc::ResultNotFound());
+
+        const auto request = PopPendingFaultLocked();
+        *out_process_id = request.process_id;
+        *out_thread_id  = request.thread_id;
+        *out_address    = request.address;
+        R_SUCCEED();
+    }
+
+    Result KSwapManager::ResolveFault(u64 process_id, u64 thread_id, KProcessAddress address, KProcessAddress buffer) {
+        /* Take the frame the page was read into, if there is one. */
+        KPhysicalAddress phys_addr = Null<KPhysicalAddress>;
+        if (buffer != Null<KProcessAddress>) {
+            R_TRY(GetCurrentProcess().GetPageTable().UnmapSwapInFrames(std::addressof(phys_addr), buffer, 1));
+        }
+
+        /* Close the frame, if we don't end up mapping it. */
+        ON_SCOPE_EXIT {
+            if (phys_addr != Null<KPhysicalAddress>) {
+                Kernel::GetMemoryManager().Close(phys_addr, 1);
+            }
+        };
+
+        /* Get the faulting process and thread. */
+        KProcess *process;
+        KThread *thread;
+        R_TRY(GetFaultingThread(std::addressof(process), std::addressof(thread), process_id, thread_id, address));
+        ON_SCOPE_EXIT { thread->Close(); process->Close(); };
+
+        /* Mark as resident and wake. */
+        R_TRY(process->GetPageTable().GetPageTableImpl().MarkAsResidentAndWake(address, std::addressof(phys_addr), thread));
+
+        process->GetSwapStatistics().OnFaultResolved(KHardwareTimer::GetTick() - thread->GetSwapFaultTick(), 1);
+        MESOSPHERE_KTRACE_SWAP_FAULT_RESOLVED(process_id, thread_id, GetInteger(address), 1);
+        R_SUCCEED();
+    }
+
+    Result KSwapManager::ResolveFaultRange(size_t *out_num_installed, u64 process_id, u64 thread_id, KProcessAddress address, u64 sector_offset, KProcessAddress buffer, size_t num_pages) {
+        MESOSPHERE_ASSERT(0 < num_pages && num_pages <= ams::svc::SwapInMaxPages);
+
+        /* Take the frames the pages were read into. */
+        KPhysicalAddress phys_addrs[ams::svc::SwapInMaxPages];
+        R_TRY(GetCurrentProcess().GetPageTable().UnmapSwapInFrames(phys_addrs, buffer, num_pages));
+
+        /* Close any frames which we don't end up mapping. */
+        ON_SCOPE_EXIT {
+            for (size_t i = 0; i < num_pages; ++i) {
+                if (phys_addrs[i] != Null<KPhysicalAddress>) {
+                    Kernel::GetMemoryManager().Close(phys_addrs[i], 1);
+                }
+            }
+        };
+
+        /* Get the faulting process and thread. */
+        KProcess *process;
+        KThread *thread;
+        R_TRY(GetFaultingThread(std::addressof(process), std::addressof(thread), process_id, thread_id, address));
+        ON_SCOPE_EXIT { thread->Close(); process->Close(); };
+
+        /* Map the faulting page and its neighbours in one pass, and wake the thread. */
+        *out_num_installed = process->GetPageTable().GetPageTableImpl().MarkRangeAsResidentAndWake(address, sector_offset, phys_addrs, num_pages, thread);
+
+        process->GetSwapStatistics().OnFaultResolved(KHardwareTimer::GetTick() - thread->GetSwapFaultTick(), *out_num_installed);
+        MESOSPHERE_KTRACE_SWAP_FAULT_RESOLVED(process_id, thread_id, GetInteger(address), *out_num_installed);
+        R_SUCCEED();
+    }
+
+    s32 KSwapManager::ProcessFaultCompletions() {
+        u64 failed_process_ids[FaultRingCapacity];
+        size_t num_failed = 0;
+        s32 count;
+        {
+            KScopedLightLock lk(g_fault_ring_lock);
+
+            /* Resolve the completed faults. */
+            count = ProcessFaultCompletionsLocked(failed_process_ids, std::addressof(num_failed));
+
+            /* Hand sys-swap any faults which have been queued since, now that it has made space on the ring. */
+            PublishFaultRequestsLocked();
+        }
+
+        /* Terminate any process with a page which couldn't be read back. */
+        TerminateFailedFaultProcesses(failed_process_ids, num_failed);
+
+        return count;
+    }
+
+    void KSwapManager::ReleaseSwapOffset(u64 swap_offset) {
+        /* A discarded page has no slot to release. */
+        if ((swap_offset & ams::svc::SwapOffsetDiscardedFlag) != 0) {
+            return;
+        }
+
+        KScopedLightLock lk(g_released_offset_lock);
+
+        /* If sys-swap has fallen too far behind, drop the offset. Its slot leaks, but no data is lost. */
+        if (g_num_released_offsets == MaxReleasedOffsets) {
+            return;
+        }
+
+        g_released_offsets[(g_released_offset_head + g_num_released_offsets++) % MaxReleasedOffsets] = swap_offset;
+    }
+
+    s32 KSwapManager::TakeReleasedSwapOffsets(u64 *out_offsets, s32 max_count) {
+        KScopedLightLock lk(g_released_offset_lock);
+
+        s32 count = 0;
+        while (count < max_count && g_num_released_offsets > 0) {
+            out_offsets[count++]   = g_released_offsets[g_released_offset_head];
+            g_released_offset_head = (g_released_offset_head + 1) % MaxReleasedOffsets;
+            --g_num_released_offsets;
+        }
+
+        return count;
+    }
+
+    void KSwapManager::RequestReclaim(KMemoryManager::Pool pool, size_t num_pages) {
+        {
+            KScopedLightLock lk(g_reclaim_lock);
+
+            g_reclaim_num_pages[pool] = std::max(g_reclaim_num_pages[pool], num_pages);
+        }
+
+        SignalSwapEvent();
+    }
+
+    bool KSwapManager::WaitForReclaim(s64 timeout) {
+        /* If sys-swap isn't running, nothing will ever be reclaimed; sys-swap itself mustn't wait on its own progress. */
+        if (g_SwapEvent == nullptr || g_SwapEvent->GetOwner() == GetCurrentProcessPointer()) {
+            return false;
+        }
+
+        KScopedLightLock lk(g_reclaim_lock);
+
+        /* Wait for sys-swap to free some memory, or for the timeout to pass. */
+        const u64 generation = g_reclaim_generation;
+        while (g_reclaim_generation == generation) {
+            if (KHardwareTimer::GetTick() >= timeout) {
+                return false;
+            }
+
+            g_reclaim_cv.Wait(std::addressof(g_reclaim_lock), timeout);
+        }
+
+        return true;
+    }
+
+    Result KSwapManager::TakeReclaimRequest(ams::svc::SwapReclaimRequest *out) {
+        /* Take the request of a pool which needs memory. */
+        KMemoryManager::Pool pool = KMemoryManager::Pool_Count;
+        size_t num_pages = 0;
+        {
+            KScopedLightLock lk(g_reclaim_lock);
+
+            for (size_t i = 0; i < KMemoryManager::Pool_Count; ++i) {
+                if (g_reclaim_num_pages[i] > 0) {
+                    pool      = static_cast<KMemoryManager::Pool>(i);
+                    num_pages = g_reclaim_num_pages[i];
+
+                    g_reclaim_num_pages[i] = 0;
+                    break;
+                }
+            }
+        }
+        R_UNLESS(num_pages > 0, svc::ResultNotFound());
+
+        /* Tell sys-swap which processes have memory in the pool. */
+        *out = {};
+        out->num_pages = static_cast<u32>(std::min<size_t>(num_pages, std::numeric_limits<u32>::max()));
+        {
+            KProcess::ListAccessor accessor;
+            const auto end = accessor.end();
+
+            for (auto it = accessor.begin(); it != end && out->num_processes < ams::svc::SwapReclaimMaxProcesses; ++it) {
+                KProcess *process = static_cast<KProcess *>(std::addressof(*it));
+
+                if (process->GetMemoryPool() == pool) {
+                    out->process_ids[out->num_processes++] = process->GetId();
+                }
+            }
+        }
+
+        R_SUCCEED();
+    }
+
+    void KSwapManager::NotifyReclaimProgress() {
+        KScopedLightLock lk(g_reclaim_lock);
+
+        ++g_reclaim_generation;
+        g_reclaim_cv.Broadcast();
+    }
+
+    void KSwapManager::NotifyProcessActivity(u64 process_id, KMemoryManager::Pool pool, ams::svc::ProcessActivity activity) {
+        /* Only applets are frozen, and only if sys-swap is running. */
+        if (pool != KMemoryManager::Pool_Applet || g_SwapEvent == nullptr) {
+            return;
+        }
+
+        const auto kind = activity == ams::svc::ProcessActivity_Paused ? ams::svc::SwapActivityKind_Freeze : ams::svc::SwapActivityKind_Thaw;
+        {
+            KScopedLightLock lk(g_activity_lock);
+
+            /* Replace any outstanding request for the process. */
+            size_t index = 0;
+            while (index < g_num_activity_requests && g_activity_requests[index].process_id != process_id) {
+                ++index;
+            }
+
+            /* If the queue is full, drop the oldest request; a missed freeze or thaw only costs performance. */
+            if (index == KSwapManager::MaxActivityRequests) {
+                std::memmove(g_activity_requests, g_activity_requests + 1, (KSwapManager::MaxActivityRequests - 1) * sizeof(g_activity_requests[0]));
+                --index;
+            } else if (index == g_num_activity_requests) {
+                ++g_num_activity_requests;
+            }
+
+            g_activity_requests[index] = { .process_id = process_id, .kind = kind, .reserved = 0 };
+        }
+
+        SignalSwapEvent();
+    }
+
+    Result KSwapManager::TakeActivityRequest(ams::svc::SwapActivityRequest *out) {
+        KScopedLightLock lk(g_activity_lock);
+
+        /* Take the oldest request. */
+        R_UNLESS(g_num_activity_requests > 0, svc::ResultNotFound());
+
+        *out = g_activity_requests[0];
+        std::memmove(g_activity_requests, g_activity_requests + 1, (--g_num_activity_requests) * sizeof(g_activity_requests[0]));
+        R_SUCCEED();
+    }
+
+}
@@ -268,6 +268,12 @@ namespace ams::kern {
         m_resource_limit_release_hint   = false;
         m_cpu_time                      = 0;
 
+        /* We aren't waiting on a swapped page. */
+        m_swap_next                     = nullptr;
+        m_swap_wait_next                = nullptr;
+        m_swap_waiters                  = nullptr;
+        m_swap_queued                   = false;
+
         /* Setup our kernel stack. */
         if (type != ThreadType_Main) {
             InitializeKernelStack(reinterpret_cast<uintptr_t>(kern_stack_top));
@@ -1505,6 +1511,14 @@ namespace ams::kern {
     }
 
     Result KThread::GetThreadList(s32 *out_num_threads, ams::kern::svc::KUserPointer<u64 *> out_thread_ids, s32 max_out_count) {
+        /* sys-swap looks up the list to resolve faults, so we can't wait for a fault while holding its lock. */
+        /* Fault in the output buffer beforehand, and keep it resident until we're done. */
+        auto &page_table = GetCurrentProcess().GetPageTable();
+        KPageTableBase::KScopedSwapHold swap_hold(page_table.GetBasePageTable());
+        if (max_out_count > 0) {
+            R_TRY(page_table.MakeResident(reinterpret_cast<uintptr_t>(out_thread_ids.GetUnsafePointer()), max_out_count * sizeof(u64)));
+        }
+
         /* Lock the list. */
         KThread::ListAccessor accessor;
         const auto end = accessor.end();
@@ -22,52 +22,61 @@ namespace ams::kern {
 
     namespace {
 
-        constinit KSpinLock g_ktrace_lock;
         constinit KVirtualAddress g_ktrace_buffer_address = Null<KVirtualAddress>;
         constinit size_t g_ktrace_buffer_size = 0;
         constinit u64 g_type_filter = 0;
 
-        struct KTraceHeader {
-            u32 magic;
-            u32 offset;
-            u32 index;
-            u32 count;
-
-            static constexpr u32 Magic = util::FourCC<'K','T','R','0'>::Code;
-        };
+        using KTraceHeader     = ams::svc::KernelTraceHeader;
+        using KTraceRingHeader = ams::svc::KernelTraceRingHeader;
+        using KTraceRecord     = ams::svc::KernelTraceRecord;
         static_assert(util::is_pod<KTraceHeader>::value);
-
-        struct KTraceRecord {
-            u8 core_id;
-            u8 type;
-            u16 process_id;
-            u32 thread_id;
-            u64 tick;
-            u64 data[6];
-        };
+        static_assert(util::is_pod<KTraceRingHeader>::value);
         static_assert(util::is_pod<KTraceRecord>::value);
-        static_assert(sizeof(KTraceRecord) == 0x40);
+        static_assert(sizeof(KTraceRingHeader) == sizeof(KTraceRecord));
 
         ALWAYS_INLINE bool IsTypeFiltered(u8 type) {
             return (g_type_filter & (UINT64_C(1) << (type & (BITSIZEOF(u64) - 1)))) != 0;
         }
 
+        ALWAYS_INLINE KTraceHeader *GetHeader() {
+            return GetPointer<KTraceHeader>(g_ktrace_buffer_address);
+        }
+
+        ALWAYS_INLINE KTraceRingHeader *GetRing(s32 core_id) {
+            const KTraceHeader *header = GetHeader();
+            return GetPointer<KTraceRingHeader>(g_ktrace_buffer_address + header->ring_offset + core_id * header->ring_size);
+        }
+
+        ALWAYS_INLINE KTraceRecord *GetRecord(KTraceRingHeader *ring, u64 index) {
+            return reinterpret_cast<KTraceRecord *>(ring + 1) + (index % ring->count);
+        }
+
     }
 
     void KTrace::Initialize(KVirtualAddress address, size_t size) {
         /* Only perform tracing when on development hardware. */
         if (KTargetSystem::IsDebugMode()) {
-            const size_t offset = util::AlignUp(sizeof(KTraceHeader), sizeof(KTraceRecord));
-            if (offset < size) {
+            /* Split the buffer into one ring per core, each holding a header followed by its records. */
+            const size_t offset    = util::AlignUp(sizeof(KTraceHeader), sizeof(KTraceRecord));
+            const size_t ring_size = (offset < size) ? util::AlignDown((size - offset) / cpu::NumCores, sizeof(KTraceRecord)) : 0;
+            if (ring_size > sizeof(KTraceRingHeader)) {
                 /* Clear the trace buffer. */
                 std::memset(GetVoidPointer(address), 0, size);
 
                 /* Initialize the KTrace header. */
                 KTraceHeader *header = GetPointer<KTraceHeader>(address);
-                header->magic  = KTraceHeader::Magic;
-                header->offset = offset;
-                header->index  = 0;
-                header->count  = (size - offset) / sizeof(KTraceRecord);
+                header->magic       = KTraceHeader::Magic;
+                header->num_rings   = cpu::NumCores;
+                header->ring_offset = offset;
+                header->ring_size   = ring_size;
+
+                /* Initialize each core's ring. */
+                for (size_t core_id = 0; core_id < cpu::NumCores; ++core_id) {
+                    KTraceRingHeader *ring = GetPointer<KTraceRingHeader>(address + offset + core_id * ring_size);
+                    ring->head    = 0;
+                    ring->count   = (ring_size - sizeof(KTraceRingHeader)) / sizeof(KTraceRecord);
+                    ring->core_id = core_id;
+                }
 
                 /* Set the global data. */
                 g_ktrace_buffer_address = address;
@@ -80,19 +89,10 @@ namespace ams::kern {
     }
 
     void KTrace::Start() {
+        /* NOTE: The rings are not reset, so that a reader streaming from the buffer keeps its place across a pause.   */
+        /* Records pushed before the pause remain, and are told apart by their ticks. Reset advances the generation, */
+        /* so that a reader discards them even from a ring whose core hasn't pushed since.                          */
         if (g_ktrace_buffer_address != Null<KVirtualAddress>) {
-            /* Get exclusive access to the trace buffer. */
-            KScopedInterruptDisable di;
-            KScopedSpinLock lk(g_ktrace_lock);
-
-            /* Reset the header. */
-            KTraceHeader *header = GetPointer<KTraceHeader>(g_ktrace_buffer_address);
-            header->index = 0;
-
-            /* Reset the records. */
-            KTraceRecord *records = GetPointer<KTraceRecord>(g_ktrace_buffer_address + header->offset);
-            std::memset(records, 0, sizeof(*records) * header->count);
-
             /* Note that we're active. */
             s_is_active = true;
         }
@@ -100,19 +100,21 @@ namespace ams::kern {
 
     void KTrace::Stop() {
         if (g_ktrace_buffer_address != Null<KVirtualAddress>) {
-            /* Get exclusive access to the trace buffer. */
-            KScopedInterruptDisable di;
-            KScopedSpinLock lk(g_ktrace_lock);
-
             /* Note that we're paused. */
             s_is_active = false;
         }
     }
 
+    void KTrace::Reset() {
+        if (g_ktrace_buffer_address != Null<KVirtualAddress>) {
+            /* Request that every core reset its ring; until it does, its ring's generation marks its records as stale. */
+            util::AtomicRef<u32>(GetHeader()->generation).FetchAdd(1);
+        }
+    }
+
     void KTrace::PushRecord(u8 type, u64 param0, u64 param1, u64 param2, u64 param3, u64 param4, u64 param5) {
-        /* Get exclusive access to the trace buffer. */
+        /* Get exclusive access to our core's ring; only this core writes to it, so disabling interrupts suffices. */
         KScopedInterruptDisable di;
-        KScopedSpinLock lk(g_ktrace_lock);
 
         /* Check whether we should push the record to the trace buffer. */
         if (s_is_active && IsTypeFiltered(type)) {
@@ -120,16 +122,23 @@ namespace ams::kern {
             KThread &cur_thread   = GetCurrentThread();
             KProcess *cur_process = GetCurrentProcessPointer();
 
-            /* Get the current record index from the header. */
-            KTraceHeader *header = GetPointer<KTraceHeader>(g_ktrace_buffer_address);
-            u32 index = header->index;
+            /* Get the current core's ring. */
+            const s32 core_id      = GetCurrentCoreId();
+            KTraceRingHeader *ring = GetRing(core_id);
+
+            /* If a reset was requested since our last push, reset our ring before pushing to it. */
+            /* NOTE: The generation is published after the head, so that a reader which sees it never sees the stale head. */
+            if (const u32 generation = util::AtomicRef<u32>(GetHeader()->generation).Load<std::memory_order_relaxed>(); AMS_UNLIKELY(generation != ring->generation)) {
+                util::AtomicRef<u64>(ring->head).Store<std::memory_order_release>(0);
+                util::AtomicRef<u32>(ring->generation).Store<std::memory_order_release>(generation);
+            }
 
-            /* Get the current record. */
-            KTraceRecord *record = GetPointer<KTraceRecord>(g_ktrace_buffer_address + header->offset + index * sizeof(KTraceRecord));
+            /* Get the index of the next record in our ring. */
+            const u64 index = ring->head;
 
             /* Set the record's data. */
-            *record = {
-                .core_id    = static_cast<u8>(GetCurrentCoreId()),
+            *GetRecord(ring, index) = {
+                .core_id    = static_cast<u8>(core_id),
                 .type       = type,
                 .process_id = static_cast<u16>(cur_process != nullptr ? cur_process->GetId() : ~0),
                 .thread_id  = static_cast<u32>(cur_thread.GetId()),
@@ -137,13 +146,8 @@ namespace ams::kern {
                 .data       = { param0, param1, param2, param3, param4, param5 },
             };
 
-            /* Advance the current index. */
-            if ((++index) >= header->count) {
-                index = 0;
-            }
-
-            /* Set the next index. */
-            header->index = index;
+            /* Publish the record to readers. */
+            util::AtomicRef<u64>(ring->head).Store<std::memory_order_release>(index + 1);
         }
     }
 
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <mesosphere.hpp>
+
+namespace ams::kern {
+
+    namespace {
+
+        /* NOTE: Freed memory can also let a reservoir be refilled, so the worker checks periodically as well. */
+        constexpr s64 RefillInterval = ams::svc::Tick(TimeSpan::FromMilliSeconds(100));
+
+        constinit KLightLock g_worker_lock;
+        constinit KLightConditionVariable g_worker_cv{util::ConstantInitialize};
+        constinit bool g_refill_requested = false;
+
+        void WorkerThreadFunction(uintptr_t arg) {
+            /* Input argument goes unused. */
+            MESOSPHERE_UNUSED(arg);
+
+            auto &mm = Kernel::GetMemoryManager();
+            while (true) {
+                /* Clear blocks until every reservoir is full, or its pool has no memory to spare. */
+                for (size_t i = 0; i < KMemoryManager::Pool_Count; ++i) {
+                    while (mm.RefillZeroedBlock(static_cast<KMemoryManager::Pool>(i))) {
+                        /* ... */
+                    }
+                }
+
+                /* Wait until an allocation takes from a reservoir. */
+                KScopedLightLock lk(g_worker_lock);
+
+                if (!g_refill_requested) {
+                    g_worker_cv.Wait(std::addressof(g_worker_lock), KHardwareTimer::GetTick() + RefillInterval);
+                }
+                g_refill_requested = false;
+            }
+        }
+
+    }
+
+    void KZeroedBlockWorker::Initialize() {
+        /* Reserve a thread from the system limit. */
+        MESOSPHERE_ABORT_UNLESS(Kernel::GetSystemResourceLimit().Reserve(ams::svc::LimitableResource_ThreadCountMax, 1));
+
+        /* Create a new thread. */
+        KThread *new_thread = KThread::Create();
+        MESOSPHERE_ABORT_UNLESS(new_thread != nullptr);
+
+        /* Launch the new thread. */
+        /* NOTE: Applications don't run on the last core, so it is the one most often idle. */
+        MESOSPHERE_R_ABORT_UNLESS(KThread::InitializeKernelThread(new_thread, WorkerThreadFunction, 0, WorkerThreadPriority, cpu::NumCores - 1));
+
+        /* Register the new thread. */
+        KThread::Register(new_thread);
+
+        /* Run the thread. */
+        MESOSPHERE_R_ABORT_UNLESS(new_thread->Run());
+    }
+
+    void KZeroedBlockWorker::Notify() {
+        KScopedLightLock lk(g_worker_lock);
+
+        g_refill_requested = true;
+        g_worker_cv.Broadcast();
+    }
+
+}
@@ -120,6 +120,12 @@ namespace ams::kern {
             Kernel::GetWorkerTaskManager(KWorkerTaskManager::WorkerType_ExitThread).Initialize(KWorkerTaskManager::ExitWorkerPriority);
             Kernel::GetWorkerTaskManager(KWorkerTaskManager::WorkerType_ExitProcess).Initialize(KWorkerTaskManager::ExitWorkerPriority);
 
+            /* Start sweeping process working sets, so that swap has eviction candidates. */
+            KLRUTracker::Initialize();
+
+            /* Start clearing memory in the background, so that large heap allocations don't have to. */
+            KZeroedBlockWorker::Initialize();
+
             /* Setup so that we may sleep later, and reserve memory for secure applets. */
             KSystemControl::InitializePhase2();
 
@@ -73,6 +73,9 @@ namespace ams::kern::svc {
             /* Set the activity. */
             R_TRY(process->SetActivity(process_activity));
 
+            /* Let sys-swap know that the process has moved to or from the background. */
+            KSwapManager::NotifyProcessActivity(process->GetId(), process->GetMemoryPool(), process_activity);
+
             R_SUCCEED();
         }
 
@@ -74,6 +74,10 @@ namespace ams::kern::svc {
                 timeout = timeout_ns;
             }
 
+            /* The value is accessed with the scheduler locked, where we can't wait for it to be swapped in, so keep it resident. */
+            KPageTableBase::KScopedResidentPage resident_value(GetCurrentProcess().GetPageTable().GetBasePageTable());
+            R_TRY(resident_value.Open(address));
+
             R_RETURN(GetCurrentProcess().WaitAddressArbiter(address, arb_type, value, timeout));
         }
 
@@ -83,6 +87,10 @@ namespace ams::kern::svc {
             R_UNLESS(util::IsAligned(address, sizeof(int32_t)), svc::ResultInvalidAddress());
             R_UNLESS(IsValidSignalType(signal_type),            svc::ResultInvalidEnumValue());
 
+            /* The value is accessed with the scheduler locked, where we can't wait for it to be swapped in, so keep it resident. */
+            KPageTableBase::KScopedResidentPage resident_value(GetCurrentProcess().GetPageTable().GetBasePageTable());
+            R_TRY(resident_value.Open(address));
+
             R_RETURN(GetCurrentProcess().SignalAddressArbiter(address, signal_type, value, count));
         }
 
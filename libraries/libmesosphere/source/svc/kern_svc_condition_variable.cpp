@@ -46,11 +46,24 @@ namespace ams::kern::svc {
                 timeout = timeout_ns;
             }
 
+            /* The tag and key are accessed with the scheduler locked, where we can't wait for them to be swapped in, so keep them resident. */
+            /* NOTE: The tag must stay resident for as long as we wait, as whoever signals us will acquire the mutex on our behalf. */
+            auto &page_table = GetCurrentProcess().GetPageTable().GetBasePageTable();
+            KPageTableBase::KScopedResidentPage resident_tag(page_table);
+            KPageTableBase::KScopedResidentPage resident_key(page_table);
+            R_TRY(resident_tag.Open(address));
+            R_TRY(resident_key.Open(util::AlignDown(cv_key, sizeof(u32))));
+
             /* Wait on the condition variable. */
             R_RETURN(GetCurrentProcess().WaitConditionVariable(address, util::AlignDown(cv_key, sizeof(u32)), tag, timeout));
         }
 
         void SignalProcessWideKey(uintptr_t cv_key, int32_t count) {
+            /* The key is accessed with the scheduler locked, where we can't wait for it to be swapped in, so keep it resident. */
+            /* NOTE: Failing to fault it in means we're being terminated, so it doesn't matter whether the signal is delivered. */
+            KPageTableBase::KScopedResidentPage resident_key(GetCurrentProcess().GetPageTable().GetBasePageTable());
+            static_cast<void>(resident_key.Open(util::AlignDown(cv_key, sizeof(u32))));
+
             /* Signal the condition variable. */
             return GetCurrentProcess().SignalConditionVariable(util::AlignDown(cv_key, sizeof(u32)), count);
         }
@@ -361,6 +361,16 @@ namespace ams::kern::svc {
                         }
                     }
                     break;
+                case ams::svc::InfoType_MesosphereSwapStatistics:
+                    {
+                        /* Get the process from its handle. */
+                        KScopedAutoObject process = GetCurrentProcess().GetHandleTable().GetObject<KProcess>(handle);
+                        R_UNLESS(process.IsNotNull(), svc::ResultInvalidHandle());
+
+                        /* Get the statistic. */
+                        R_TRY(process->GetSwapStatistics().GetInfo(out, info_subtype));
+                    }
+                    break;
                 case ams::svc::InfoType_MesosphereCurrentProcess:
                     {
                         /* Verify the input handle is invalid. */
@@ -133,6 +133,12 @@ namespace ams::kern::svc {
                             MESOSPHERE_KTRACE_RESUME();
                         }
                         break;
+                    case ams::svc::KernelTraceState_EnabledAndReset:
+                        {
+                            MESOSPHERE_KTRACE_RESET();
+                            MESOSPHERE_KTRACE_RESUME();
+                        }
+                        break;
                     case ams::svc::KernelTraceState_Disabled:
                         {
                             MESOSPHERE_KTRACE_PAUSE();
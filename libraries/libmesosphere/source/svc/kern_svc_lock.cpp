@@ -30,6 +30,10 @@ namespace ams::kern::svc {
             R_UNLESS(!IsKernelAddress(address),             svc::ResultInvalidCurrentMemory());
             R_UNLESS(util::IsAligned(address, sizeof(u32)), svc::ResultInvalidAddress());
 
+            /* The tag is accessed with the scheduler locked, where we can't wait for it to be swapped in, so keep it resident. */
+            KPageTableBase::KScopedResidentPage resident_tag(GetCurrentProcess().GetPageTable().GetBasePageTable());
+            R_TRY(resident_tag.Open(address));
+
             R_RETURN(KConditionVariable::WaitForAddress(thread_handle, address, tag));
         }
 
@@ -38,6 +42,10 @@ namespace ams::kern::svc {
             R_UNLESS(!IsKernelAddress(address),             svc::ResultInvalidCurrentMemory());
             R_UNLESS(util::IsAligned(address, sizeof(u32)), svc::ResultInvalidAddress());
 
+            /* The tag is accessed with the scheduler locked, where we can't wait for it to be swapped in, so keep it resident. */
+            KPageTableBase::KScopedResidentPage resident_tag(GetCurrentProcess().GetPageTable().GetBasePageTable());
+            R_TRY(resident_tag.Open(address));
+
             R_RETURN(KConditionVariable::SignalToAddress(address));
         }
 
@@ -32,6 +32,11 @@ namespace ams::kern::svc {
             }
         }
 
+        constexpr bool IsValidSwapSectorOffset(u64 sector_offset) {
+            /* A placed page's offset starts on a page boundary, and leaves room for the swap offset flags. */
+            return util::IsAligned(sector_offset, ams::svc::SwapSectorsPerPage) && sector_offset < ams::svc::SwapOffsetDiscardedFlag;
+        }
+
         Result SetMemoryPermission(uintptr_t address, size_t size, ams::svc::MemoryPermission perm) {
             /* Validate address / size. */
             R_UNLESS(util::IsAligned(address, PageSize), svc::ResultInvalidAddress());
@@ -122,66 +127,459 @@ namespace ams::kern::svc {
         }
 
         Result GetSwapRequest(uint64_t *out_process_id, uint64_t *out_thread_id, ams::svc::Address *out_vaddr) {
-            KScopedSchedulerLock sl;
+            /* Take the next fault from the swap manager's queues. */
+            KProcessAddress address;
+            R_TRY(KSwapManager::TakeFaultRequest(out_process_id, out_thread_id, std::addressof(address)));
 
-            /* Dequeue the next thread. */
-            KThread *thread = g_SwapRequestListHead;
-            R_UNLESS(thread != nullptr, svc::ResultNotFound());
+            *out_vaddr = GetInteger(address);
+            R_SUCCEED();
+        }
+
+        Result MarkAsResidentAndWake(uint64_t process_id, uint64_t thread_id, uintptr_t vaddr, uintptr_t buffer) {
+            /* Validate the buffer. */
+            R_UNLESS(util::IsAligned(buffer, PageSize), svc::ResultInvalidAddress());
+
+            R_RETURN(KSwapManager::ResolveFault(process_id, thread_id, vaddr, buffer));
+        }
 
-            g_SwapRequestListHead = thread->GetSwapNext();
-            if (g_SwapRequestListHead == nullptr) {
-                g_SwapRequestListTail = nullptr;
+        Result RegisterSwapEvent(ams::svc::Handle event_handle) {
+            /* Get the event from its handle. */
+            KScopedAutoObject event = GetCurrentProcess().GetHandleTable().GetObject<KEvent>(event_handle);
+            R_UNLESS(event.IsNotNull(), svc::ResultInvalidHandle());
+
+            /* Set the global swap event. */
+            if (g_SwapEvent != nullptr) {
+                g_SwapEvent->Close();
             }
-            thread->SetSwapNext(nullptr);
+            g_SwapEvent = event.ReleasePointerUnsafe();
+
+            R_SUCCEED();
+        }
+
+        Result RegisterSwapFaultRings(uintptr_t request_ring, uintptr_t completion_ring) {
+            /* Validate the rings. */
+            R_UNLESS(util::IsAligned(request_ring, PageSize),    svc::ResultInvalidAddress());
+            R_UNLESS(util::IsAligned(completion_ring, PageSize), svc::ResultInvalidAddress());
+            R_UNLESS(request_ring != completion_ring,            svc::ResultInvalidCombination());
+
+            R_RETURN(KSwapManager::RegisterFaultRings(request_ring, completion_ring));
+        }
+
+        Result CompleteSwapFaults(int32_t *out_num_completed) {
+            *out_num_completed = KSwapManager::ProcessFaultCompletions();
+            R_SUCCEED();
+        }
 
-            /* Fill in the request info. */
-            *out_process_id = thread->GetOwnerProcess()->GetId();
-            *out_thread_id  = thread->GetId();
-			auto temp_addr = thread->GetSwapVirtualAddress();
-            *out_vaddr = ams::svc::Address(*reinterpret_cast<const u64*>(&temp_addr));
+        Result GetSwapCandidates(int32_t *out_num_candidates, KUserPointer<uint64_t *> out_addresses, uint64_t process_id, int32_t max_count) {
+            /* Validate the count. */
+            R_UNLESS(0 < max_count && max_count <= static_cast<int32_t>(KLRUTracker::MaxCandidates), svc::ResultOutOfRange());
 
-            /* Close the queue's reference to the thread. */
-            thread->Close();
+            R_RETURN(KLRUTracker::GetCandidates(out_num_candidates, out_addresses, process_id, max_count));
+        }
+
+        Result GetSwapReadaheadSize(int32_t *out_num_pages, uint64_t process_id, uintptr_t address, int32_t max_pages) {
+            /* Validate the count. */
+            R_UNLESS(0 < max_pages && max_pages <= static_cast<int32_t>(ams::svc::SwapReadaheadMaxPages), svc::ResultOutOfRange());
 
+            /* Get the process from its id. */
+            KProcess *process = KProcess::GetProcessFromId(process_id);
+            R_UNLESS(process != nullptr, svc::ResultInvalidProcessId());
+            ON_SCOPE_EXIT { process->Close(); };
+
+            /* Measure the run of swapped pages which can be read together with the one at the address. */
+            *out_num_pages = static_cast<int32_t>(process->GetPageTable().GetPageTableImpl().GetSwappedRunLength(address, max_pages));
             R_SUCCEED();
         }
 
-        Result MarkAsResidentAndWake(uint64_t process_id, uint64_t thread_id, ams::svc::Address vaddr, ams::svc::PhysicalAddress paddr) {
-            /* Get the process from ID. */
+        Result CompleteSwapFaultRange(int32_t *out_num_installed, KUserPointer<const ams::svc::SwapFaultRequest *> request, uintptr_t buffer, int32_t num_pages) {
+            /* Validate the arguments. */
+            R_UNLESS(0 < num_pages && num_pages <= static_cast<int32_t>(ams::svc::SwapInMaxPages), svc::ResultOutOfRange());
+            R_UNLESS(util::IsAligned(buffer, PageSize),                                             svc::ResultInvalidAddress());
+
+            /* Copy in the fault being completed. */
+            ams::svc::SwapFaultRequest fault;
+            R_TRY(request.CopyTo(std::addressof(fault)));
+
+            /* Map the pages and wake the faulting thread. */
+            size_t num_installed;
+            R_TRY(KSwapManager::ResolveFaultRange(std::addressof(num_installed), fault.process_id, fault.thread_id, fault.address, fault.sector_offset, buffer, num_pages));
+
+            *out_num_installed = static_cast<int32_t>(num_installed);
+            R_SUCCEED();
+        }
+
+        Result MapSwapInFrames(uintptr_t *out_address, uint64_t process_id, int32_t num_pages) {
+            /* Validate the count. */
+            R_UNLESS(0 < num_pages && num_pages <= static_cast<int32_t>(ams::svc::SwapInMaxPages), svc::ResultOutOfRange());
+
+            /* Get the process from its id. */
             KProcess *process = KProcess::GetProcessFromId(process_id);
-            R_UNLESS(process != nullptr, svc::ResultInvalidHandle());
+            R_UNLESS(process != nullptr, svc::ResultInvalidProcessId());
             ON_SCOPE_EXIT { process->Close(); };
 
-            /* Get the thread from ID. */
-            KThread *thread = KThread::GetThreadFromId(thread_id);
-            R_UNLESS(thread != nullptr, svc::ResultInvalidHandle());
-            ON_SCOPE_EXIT { thread->Close(); };
+            /* Allocate the frames from the process's pool, so that they can be mapped into it as they are. */
+            /* NOTE: The frames aren't cleared, as sys-swap overwrites them entirely before completing the fault. */
+            /* NOTE: Only sys-swap calls this, and it can't reclaim memory while it waits for it to be reclaimed. */
+            auto &page_table = GetCurrentProcess().GetPageTable();
+            KPageGroup pg(page_table.GetBlockInfoManager());
+            R_TRY(Kernel::GetMemoryManager().AllocateAndOpen(std::addressof(pg), num_pages, 1, process->GetAllocateOption() | KMemoryManager::AllocateFlag_NoReclaimWait));
 
-            /* Ensure the thread is owned by the process. */
-            R_UNLESS(thread->GetOwnerProcess() == process, svc::ResultInvalidHandle());
+            /* Close the opened frames when we're done with them. */
+            /* If the mapping succeeds, each frame will gain an extra reference, otherwise they will be freed automatically. */
+            ON_SCOPE_EXIT { pg.Close(); };
 
-            /* Ensure the fault address matches. */
-            R_UNLESS(thread->GetSwapVirtualAddress() == vaddr, svc::ResultInvalidAddress());
+            /* Map the frames into our process. */
+            KProcessAddress address;
+            R_TRY(page_table.MapSwapInFrames(std::addressof(address), pg));
 
-            /* Mark as resident and wake. */
-			auto temp_vaddr = vaddr;
-            R_RETURN(process->GetPageTable().GetPageTableImpl().MarkAsResidentAndWake(KProcessAddress(*reinterpret_cast<const u64*>(&temp_vaddr)), KPhysicalAddress(paddr), thread));
+            *out_address = GetInteger(address);
+            R_SUCCEED();
         }
 
-        Result RegisterSwapEvent(ams::svc::Handle event_handle) {
-            /* Get the event from its handle. */
-            KScopedAutoObject event = GetCurrentProcess().GetHandleTable().GetObject<KEvent>(event_handle);
-            R_UNLESS(event.IsNotNull(), svc::ResultInvalidHandle());
+        Result UnmapSwapInFrames(uintptr_t address, int32_t num_pages) {
+            /* Validate the arguments. */
+            R_UNLESS(0 < num_pages && num_pages <= static_cast<int32_t>(ams::svc::SwapInMaxPages), svc::ResultOutOfRange());
+            R_UNLESS(util::IsAligned(address, PageSize),                                            svc::ResultInvalidAddress());
 
-            /* Set the global swap event. */
-            if (g_SwapEvent != nullptr) {
-                g_SwapEvent->Close();
+            /* Unmap the frames, freeing them. */
+            R_RETURN(GetCurrentProcess().GetPageTable().UnmapSwapInFrames(nullptr, address, num_pages));
+        }
+
+        Result GetReleasedSwapOffsets(int32_t *out_num_offsets, KUserPointer<uint64_t *> out_offsets, int32_t max_count) {
+            /* Validate the count. */
+            R_UNLESS(0 < max_count && max_count <= static_cast<int32_t>(KSwapManager::MaxReleasedOffsets), svc::ResultOutOfRange());
+
+            /* Hand out offsets in small batches, to bound our stack usage. */
+            constexpr s32 MaxBatchCount = 0x40;
+
+            s32 count = 0;
+            while (count < max_count) {
+                u64 offsets[MaxBatchCount];
+                const s32 batch_count = KSwapManager::TakeReleasedSwapOffsets(offsets, std::min<s32>(MaxBatchCount, max_count - count));
+                if (batch_count == 0) {
+                    break;
+                }
+
+                /* NOTE: If the copy fails, the offsets are lost and their slots leak; this only happens if sys-swap passes a bad buffer. */
+                for (s32 i = 0; i < batch_count; ++i) {
+                    R_TRY(out_offsets.CopyArrayElementFrom(std::addressof(offsets[i]), count + i));
+                }
+
+                count += batch_count;
+            }
+
+            *out_num_offsets = count;
+            R_SUCCEED();
+        }
+
+        constexpr inline size_t NumSwappableRegions = 3;
+
+        void GetSwappableRegions(KProcessAddress *out_starts, KProcessAddress *out_ends, KProcessPageTable &page_table) {
+            /* Only the heap, alias and process code regions may be swapped, so only they need to be searched. */
+            /* NOTE: The regions are searched in address order, so that the caller can resume after the last page we report. */
+            out_starts[0] = page_table.GetHeapRegionStart();
+            out_starts[1] = page_table.GetAliasRegionStart();
+            out_starts[2] = page_table.GetProcessCodeRegionStart();
+            out_ends[0]   = out_starts[0] + page_table.GetHeapRegionSize();
+            out_ends[1]   = out_starts[1] + page_table.GetAliasRegionSize();
+            out_ends[2]   = out_starts[2] + page_table.GetProcessCodeRegionSize();
+            for (size_t i = 1; i < NumSwappableRegions; ++i) {
+                for (size_t j = i; j > 0 && out_starts[j] < out_starts[j - 1]; --j) {
+                    std::swap(out_starts[j], out_starts[j - 1]);
+                    std::swap(out_ends[j], out_ends[j - 1]);
+                }
+            }
+        }
+
+        Result GetSwappedPages(int32_t *out_num_pages, KUserPointer<ams::svc::SwapPageInfo *> out_infos, uint64_t process_id, uintptr_t address, int32_t max_count) {
+            /* Validate the count. */
+            R_UNLESS(0 < max_count && max_count <= static_cast<int32_t>(ams::svc::SwapRestoreMaxPages), svc::ResultOutOfRange());
+
+            /* Get the process from its id. */
+            KProcess *process = KProcess::GetProcessFromId(process_id);
+            R_UNLESS(process != nullptr, svc::ResultInvalidProcessId());
+            ON_SCOPE_EXIT { process->Close(); };
+
+            auto &page_table = process->GetPageTable();
+            KProcessAddress region_starts[NumSwappableRegions], region_ends[NumSwappableRegions];
+            GetSwappableRegions(region_starts, region_ends, page_table);
+
+            /* Find the swapped pages. */
+            ams::svc::SwapPageInfo infos[ams::svc::SwapRestoreMaxPages];
+            s32 count = 0;
+            for (size_t i = 0; i < NumSwappableRegions && count < max_count; ++i) {
+                const KProcessAddress start = std::max<uintptr_t>(util::AlignDown(address, PageSize), GetInteger(region_starts[i]));
+                if (start < region_ends[i]) {
+                    count += static_cast<s32>(page_table.GetPageTableImpl().GetSwappedPages(infos + count, start, region_ends[i], max_count - count));
+                }
+            }
+
+            /* Copy them out. */
+            for (s32 i = 0; i < count; ++i) {
+                R_TRY(out_infos.CopyArrayElementFrom(std::addressof(infos[i]), i));
+            }
+
+            *out_num_pages = count;
+            R_SUCCEED();
+        }
+
+        Result GetResidentSwapPages(int32_t *out_num_pages, KUserPointer<uint64_t *> out_addresses, uint64_t process_id, uintptr_t address, int32_t max_count) {
+            /* Validate the count. */
+            R_UNLESS(0 < max_count && max_count <= static_cast<int32_t>(ams::svc::SwapFreezeMaxPages), svc::ResultOutOfRange());
+
+            /* Get the process from its id. */
+            KProcess *process = KProcess::GetProcessFromId(process_id);
+            R_UNLESS(process != nullptr, svc::ResultInvalidProcessId());
+            ON_SCOPE_EXIT { process->Close(); };
+
+            auto &page_table = process->GetPageTable();
+            KProcessAddress region_starts[NumSwappableRegions], region_ends[NumSwappableRegions];
+            GetSwappableRegions(region_starts, region_ends, page_table);
+
+            /* Find the resident pages. */
+            u64 addresses[ams::svc::SwapFreezeMaxPages];
+            s32 count = 0;
+            for (size_t i = 0; i < NumSwappableRegions && count < max_count; ++i) {
+                const KProcessAddress start = std::max<uintptr_t>(util::AlignDown(address, PageSize), GetInteger(region_starts[i]));
+                if (start < region_ends[i]) {
+                    count += static_cast<s32>(page_table.GetPageTableImpl().GetResidentPages(addresses + count, start, region_ends[i], max_count - count));
+                }
+            }
+
+            /* Copy them out. */
+            for (s32 i = 0; i < count; ++i) {
+                R_TRY(out_addresses.CopyArrayElementFrom(std::addressof(addresses[i]), i));
             }
-            g_SwapEvent = event.ReleasePointerUnsafe();
 
+            *out_num_pages = count;
             R_SUCCEED();
         }
 
+        Result RestoreSwappedPages(int32_t *out_num_restored, uint64_t process_id, KUserPointer<const ams::svc::SwapPageInfo *> infos, uintptr_t buffer, int32_t num_pages) {
+            /* Validate arguments. */
+            R_UNLESS(0 < num_pages && num_pages <= static_cast<int32_t>(ams::svc::SwapRestoreMaxPages), svc::ResultOutOfRange());
+            R_UNLESS(util::IsAligned(buffer, PageSize),                                                 svc::ResultInvalidAddress());
+
+            /* Get the process from its id. */
+            KProcess *process = KProcess::GetProcessFromId(process_id);
+            R_UNLESS(process != nullptr, svc::ResultInvalidProcessId());
+            ON_SCOPE_EXIT { process->Close(); };
+
+            auto &page_table = process->GetPageTable();
+
+            /* Copy in and validate the pages. */
+            ams::svc::SwapPageInfo page_infos[ams::svc::SwapRestoreMaxPages];
+            for (s32 i = 0; i < num_pages; ++i) {
+                R_TRY(infos.CopyArrayElementTo(std::addressof(page_infos[i]), i));
+
+                R_UNLESS(util::IsAligned(page_infos[i].address, PageSize),                svc::ResultInvalidAddress());
+                R_UNLESS(page_table.IsInSwappableRegion(page_infos[i].address, PageSize), svc::ResultInvalidMemoryRegion());
+            }
+
+            /* Allocate frames for the whole batch from the process's pool. */
+            /* NOTE: If the pool is exhausted, nothing is restored, so that the caller can back off and retry later.  */
+            /* We mustn't wait for reclaim here, as the caller is the thread which would have to service the request. */
+            KPageGroup pg(page_table.GetBlockInfoManager());
+            R_TRY(Kernel::GetMemoryManager().AllocateAndOpen(std::addressof(pg), num_pages, 1, process->GetAllocateOption() | KMemoryManager::AllocateFlag_NoReclaimWait));
+
+            KPhysicalAddress phys_addrs[ams::svc::SwapRestoreMaxPages];
+            {
+                s32 i = 0;
+                for (const auto &block : pg) {
+                    for (size_t j = 0; j < block.GetNumPages(); ++j) {
+                        phys_addrs[i++] = block.GetAddress() + j * PageSize;
+                    }
+                }
+            }
+
+            /* Close any frames which we don't end up mapping. */
+            ON_SCOPE_EXIT {
+                for (s32 i = 0; i < num_pages; ++i) {
+                    if (phys_addrs[i] != Null<KPhysicalAddress>) {
+                        Kernel::GetMemoryManager().Close(phys_addrs[i], 1);
+                    }
+                }
+            };
+
+            /* Copy in the page contents. */
+            for (s32 i = 0; i < num_pages; ++i) {
+                R_UNLESS(UserspaceAccess::CopyMemoryFromUser(GetVoidPointer(KMemoryLayout::GetLinearVirtualAddress(phys_addrs[i])), reinterpret_cast<const void *>(buffer + i * PageSize), PageSize), svc::ResultInvalidCurrentMemory());
+            }
+
+            /* Map the pages which are still swapped out. */
+            *out_num_restored = static_cast<int32_t>(page_table.GetPageTableImpl().RestoreSwappedPages(page_infos, phys_addrs, num_pages));
+            R_SUCCEED();
+        }
+
+        Result EvictSwapPages(int32_t *out_num_evicted, uint64_t process_id, uintptr_t address, size_t size) {
+            /* Validate address / size. */
+            R_UNLESS(util::IsAligned(address, PageSize),                                  svc::ResultInvalidAddress());
+            R_UNLESS(util::IsAligned(size,    PageSize),                                  svc::ResultInvalidSize());
+            R_UNLESS(size > 0,                                                            svc::ResultInvalidSize());
+            R_UNLESS((address < address + size),                                          svc::ResultInvalidCurrentMemory());
+            R_UNLESS(size / PageSize <= static_cast<size_t>(KSwapManager::MaxEvictions), svc::ResultOutOfRange());
+
+            /* Get the process from its id. */
+            KProcess *process = KProcess::GetProcessFromId(process_id);
+            R_UNLESS(process != nullptr, svc::ResultInvalidProcessId());
+            ON_SCOPE_EXIT { process->Close(); };
+
+            /* Only Application or Applet pool memory may be swapped. */
+            const auto pool = process->GetMemoryPool();
+            R_UNLESS(pool == KMemoryManager::Pool_Application || pool == KMemoryManager::Pool_Applet, svc::ResultInvalidState());
+
+            /* Evict the pages. */
+            size_t num_evicted;
+            R_TRY(process->GetPageTable().GetPageTableImpl().EvictSwapPages(std::addressof(num_evicted), process_id, address, size / PageSize));
+
+            /* Let sys-swap know that there are pages to write. */
+            KSwapManager::SignalSwapEvent();
+
+            *out_num_evicted = static_cast<int32_t>(num_evicted);
+            R_SUCCEED();
+        }
+
+        Result GetSwapEvictions(int32_t *out_num_evictions, KUserPointer<ams::svc::SwapEvictionInfo *> out_infos, uintptr_t buffer, int32_t max_count) {
+            /* Validate arguments. */
+            R_UNLESS(0 < max_count && max_count <= static_cast<int32_t>(KSwapManager::MaxEvictions), svc::ResultOutOfRange());
+            R_UNLESS(util::IsAligned(buffer, PageSize),                                              svc::ResultInvalidAddress());
+
+            /* Hand out evictions in small batches, to bound our stack usage. */
+            constexpr s32 MaxBatchCount = 0x10;
+
+            s32 count = 0;
+            while (count < max_count) {
+                ams::svc::SwapEvictionInfo infos[MaxBatchCount];
+                KPhysicalAddress phys_addrs[MaxBatchCount];
+
+                const s32 batch_count = KSwapManager::BeginEvictions(infos, phys_addrs, std::min<s32>(MaxBatchCount, max_count - count));
+                if (batch_count == 0) {
+                    break;
+                }
+
+                /* Copy out the page contents and eviction info. */
+                Result result = ResultSuccess();
+                for (s32 i = 0; i < batch_count; ++i) {
+                    if (!UserspaceAccess::CopyMemoryToUser(reinterpret_cast<void *>(buffer + (count + i) * PageSize), GetVoidPointer(KMemoryLayout::GetLinearVirtualAddress(phys_addrs[i])), PageSize)) {
+                        result = svc::ResultInvalidCurrentMemory();
+                        break;
+                    }
+
+                    if (result = out_infos.CopyArrayElementFrom(std::addressof(infos[i]), count + i); R_FAILED(result)) {
+                        break;
+                    }
+                }
+
+                /* If we failed, give the batch back to the queue. */
+                if (R_FAILED(result)) {
+                    KSwapManager::AbortEvictions(infos, batch_count);
+
+                    /* Evictions from previous batches are already owned by the caller, so only report failure if we have none. */
+                    R_UNLESS(count > 0, result);
+                    break;
+                }
+
+                count += batch_count;
+            }
+
+            *out_num_evictions = count;
+            R_SUCCEED();
+        }
+
+        Result CompleteSwapEvictions(KUserPointer<const ams::svc::SwapEvictionCompletion *> completions, int32_t num_completions) {
+            /* Validate arguments. */
+            R_UNLESS(0 < num_completions && num_completions <= static_cast<int32_t>(KSwapManager::MaxEvictions), svc::ResultOutOfRange());
+
+            /* Complete each eviction. */
+            for (s32 i = 0; i < num_completions; ++i) {
+                ams::svc::SwapEvictionCompletion completion;
+                R_TRY(completions.CopyArrayElementTo(std::addressof(completion), i));
+
+                switch (completion.status) {
+                    case ams::svc::SwapEvictionStatus_Written:
+                    case ams::svc::SwapEvictionStatus_Failed:
+                    case ams::svc::SwapEvictionStatus_Compressed:
+                    case ams::svc::SwapEvictionStatus_Discarded:
+                        break;
+                    default:
+                        R_THROW(svc::ResultInvalidEnumValue());
+                }
+                R_UNLESS(completion.stored_size <= ams::svc::SwapPageSize, svc::ResultInvalidSize());
+                R_UNLESS(IsValidSwapSectorOffset(completion.sector_offset), svc::ResultOutOfRange());
+
+                R_TRY(KSwapManager::CompleteEviction(completion.id, completion.status, completion.stored_size, completion.sector_offset));
+            }
+
+            /* Wake any allocations which were waiting for memory to be reclaimed. */
+            KSwapManager::NotifyReclaimProgress();
+
+            R_SUCCEED();
+        }
+
+        Result RelocateSwappedPages(uint64_t *out_relocated_mask, KUserPointer<const ams::svc::SwapRelocation *> relocations, int32_t num_relocations) {
+            /* Validate arguments. */
+            static_assert(ams::svc::SwapRelocateMaxPages <= BITSIZEOF(u64));
+            R_UNLESS(0 < num_relocations && num_relocations <= static_cast<int32_t>(ams::svc::SwapRelocateMaxPages), svc::ResultOutOfRange());
+
+            /* Move each page, reporting which were moved. */
+            /* NOTE: Relocations are grouped by process, so we keep hold of the last process we looked up. */
+            KProcess *process = nullptr;
+            ON_SCOPE_EXIT { if (process != nullptr) { process->Close(); } };
+
+            u64 relocated_mask = 0;
+            for (s32 i = 0; i < num_relocations; ++i) {
+                ams::svc::SwapRelocation relocation;
+                R_TRY(relocations.CopyArrayElementTo(std::addressof(relocation), i));
+
+                R_UNLESS(util::IsAligned(relocation.address, PageSize),  svc::ResultInvalidAddress());
+                R_UNLESS(IsValidSwapSectorOffset(relocation.new_offset), svc::ResultOutOfRange());
+
+                if (process == nullptr || process->GetId() != relocation.process_id) {
+                    if (process != nullptr) {
+                        process->Close();
+                    }
+
+                    /* A process which has exited has released all of its pages. */
+                    if (process = KProcess::GetProcessFromId(relocation.process_id); process == nullptr) {
+                        continue;
+                    }
+                }
+
+                if (process->GetPageTable().GetPageTableImpl().RelocateSwappedPage(relocation.address, relocation.old_offset, relocation.new_offset)) {
+                    relocated_mask |= (static_cast<u64>(1) << i);
+                }
+            }
+
+            *out_relocated_mask = relocated_mask;
+            R_SUCCEED();
+        }
+
+        Result GetSwapReclaimRequest(KUserPointer<ams::svc::SwapReclaimRequest *> out_request) {
+            /* Take the pending request. */
+            ams::svc::SwapReclaimRequest request;
+            R_TRY(KSwapManager::TakeReclaimRequest(std::addressof(request)));
+
+            /* Copy the request out. */
+            R_RETURN(out_request.CopyFrom(std::addressof(request)));
+        }
+
+        Result GetSwapActivityRequest(KUserPointer<ams::svc::SwapActivityRequest *> out_request) {
+            /* Take the oldest pending request. */
+            ams::svc::SwapActivityRequest request;
+            R_TRY(KSwapManager::TakeActivityRequest(std::addressof(request)));
+
+            /* Copy the request out. */
+            R_RETURN(out_request.CopyFrom(std::addressof(request)));
+        }
+
+    }
+
+    namespace impl {
+
+        Result MakeUserMemoryResident(const void *address, size_t size) {
+            R_RETURN(GetCurrentProcess().GetPageTable().MakeResident(reinterpret_cast<uintptr_t>(address), size));
+        }
+
     }
 
     /* =============================    64 ABI    ============================= */
@@ -228,12 +626,12 @@ namespace ams::kern::svc {
         R_RETURN(GetSwapRequest(out_process_id, out_thread_id, out_vaddr));
     }
 
-    Result MarkAsResidentAndWake64(uint64_t process_id, uint64_t thread_id, ams::svc::Address vaddr, ams::svc::PhysicalAddress paddr) {
-        R_RETURN(MarkAsResidentAndWake(process_id, thread_id, vaddr, paddr));
+    Result MarkAsResidentAndWake64(uint64_t process_id, uint64_t thread_id, ams::svc::Address vaddr, ams::svc::Address buffer) {
+        R_RETURN(MarkAsResidentAndWake(process_id, thread_id, vaddr, buffer));
     }
 
-    Result MarkAsResidentAndWake64From32(uint64_t process_id, uint64_t thread_id, ams::svc::Address vaddr, ams::svc::PhysicalAddress paddr) {
-        R_RETURN(MarkAsResidentAndWake(process_id, thread_id, vaddr, paddr));
+    Result MarkAsResidentAndWake64From32(uint64_t process_id, uint64_t thread_id, ams::svc::Address vaddr, ams::svc::Address buffer) {
+        R_RETURN(MarkAsResidentAndWake(process_id, thread_id, vaddr, buffer));
     }
 
     Result RegisterSwapEvent64(ams::svc::Handle event_handle) {
@@ -244,4 +642,142 @@ namespace ams::kern::svc {
         R_RETURN(RegisterSwapEvent(event_handle));
     }
 
+    Result EvictSwapPages64(int32_t *out_num_evicted, uint64_t process_id, ams::svc::Address address, ams::svc::Size size) {
+        R_RETURN(EvictSwapPages(out_num_evicted, process_id, address, size));
+    }
+
+    Result EvictSwapPages64From32(int32_t *out_num_evicted, uint64_t process_id, ams::svc::Address address, ams::svc::Size size) {
+        R_RETURN(EvictSwapPages(out_num_evicted, process_id, address, size));
+    }
+
+    Result GetSwapEvictions64(int32_t *out_num_evictions, KUserPointer<ams::svc::SwapEvictionInfo *> out_infos, ams::svc::Address buffer, int32_t max_count) {
+        R_RETURN(GetSwapEvictions(out_num_evictions, out_infos, buffer, max_count));
+    }
+
+    Result GetSwapEvictions64From32(int32_t *out_num_evictions, KUserPointer<ams::svc::SwapEvictionInfo *> out_infos, ams::svc::Address buffer, int32_t max_count) {
+        R_RETURN(GetSwapEvictions(out_num_evictions, out_infos, buffer, max_count));
+    }
+
+    Result CompleteSwapEvictions64(KUserPointer<const ams::svc::SwapEvictionCompletion *> completions, int32_t num_completions) {
+        R_RETURN(CompleteSwapEvictions(completions, num_completions));
+    }
+
+    Result CompleteSwapEvictions64From32(KUserPointer<const ams::svc::SwapEvictionCompletion *> completions, int32_t num_completions) {
+        R_RETURN(CompleteSwapEvictions(completions, num_completions));
+    }
+
+    Result RegisterSwapFaultRings64(ams::svc::Address request_ring, ams::svc::Address completion_ring) {
+        R_RETURN(RegisterSwapFaultRings(request_ring, completion_ring));
+    }
+
+    Result RegisterSwapFaultRings64From32(ams::svc::Address request_ring, ams::svc::Address completion_ring) {
+        R_RETURN(RegisterSwapFaultRings(request_ring, completion_ring));
+    }
+
+    Result CompleteSwapFaults64(int32_t *out_num_completed) {
+        R_RETURN(CompleteSwapFaults(out_num_completed));
+    }
+
+    Result CompleteSwapFaults64From32(int32_t *out_num_completed) {
+        R_RETURN(CompleteSwapFaults(out_num_completed));
+    }
+
+    Result GetSwapCandidates64(int32_t *out_num_candidates, KUserPointer<uint64_t *> out_addresses, uint64_t process_id, int32_t max_count) {
+        R_RETURN(GetSwapCandidates(out_num_candidates, out_addresses, process_id, max_count));
+    }
+
+    Result GetSwapCandidates64From32(int32_t *out_num_candidates, KUserPointer<uint64_t *> out_addresses, uint64_t process_id, int32_t max_count) {
+        R_RETURN(GetSwapCandidates(out_num_candidates, out_addresses, process_id, max_count));
+    }
+
+    Result GetSwapReadaheadSize64(int32_t *out_num_pages, uint64_t process_id, ams::svc::Address address, int32_t max_pages) {
+        R_RETURN(GetSwapReadaheadSize(out_num_pages, process_id, address, max_pages));
+    }
+
+    Result GetSwapReadaheadSize64From32(int32_t *out_num_pages, uint64_t process_id, ams::svc::Address address, int32_t max_pages) {
+        R_RETURN(GetSwapReadaheadSize(out_num_pages, process_id, address, max_pages));
+    }
+
+    Result CompleteSwapFaultRange64(int32_t *out_num_installed, KUserPointer<const ams::svc::SwapFaultRequest *> request, ams::svc::Address buffer, int32_t num_pages) {
+        R_RETURN(CompleteSwapFaultRange(out_num_installed, request, buffer, num_pages));
+    }
+
+    Result CompleteSwapFaultRange64From32(int32_t *out_num_installed, KUserPointer<const ams::svc::SwapFaultRequest *> request, ams::svc::Address buffer, int32_t num_pages) {
+        R_RETURN(CompleteSwapFaultRange(out_num_installed, request, buffer, num_pages));
+    }
+
+    Result GetReleasedSwapOffsets64(int32_t *out_num_offsets, KUserPointer<uint64_t *> out_offsets, int32_t max_count) {
+        R_RETURN(GetReleasedSwapOffsets(out_num_offsets, out_offsets, max_count));
+    }
+
+    Result GetReleasedSwapOffsets64From32(int32_t *out_num_offsets, KUserPointer<uint64_t *> out_offsets, int32_t max_count) {
+        R_RETURN(GetReleasedSwapOffsets(out_num_offsets, out_offsets, max_count));
+    }
+
+    Result GetSwappedPages64(int32_t *out_num_pages, KUserPointer<ams::svc::SwapPageInfo *> out_infos, uint64_t process_id, ams::svc::Address address, int32_t max_count) {
+        R_RETURN(GetSwappedPages(out_num_pages, out_infos, process_id, address, max_count));
+    }
+
+    Result GetSwappedPages64From32(int32_t *out_num_pages, KUserPointer<ams::svc::SwapPageInfo *> out_infos, uint64_t process_id, ams::svc::Address address, int32_t max_count) {
+        R_RETURN(GetSwappedPages(out_num_pages, out_infos, process_id, address, max_count));
+    }
+
+    Result RestoreSwappedPages64(int32_t *out_num_restored, uint64_t process_id, KUserPointer<const ams::svc::SwapPageInfo *> infos, ams::svc::Address buffer, int32_t num_pages) {
+        R_RETURN(RestoreSwappedPages(out_num_restored, process_id, infos, buffer, num_pages));
+    }
+
+    Result RestoreSwappedPages64From32(int32_t *out_num_restored, uint64_t process_id, KUserPointer<const ams::svc::SwapPageInfo *> infos, ams::svc::Address buffer, int32_t num_pages) {
+        R_RETURN(RestoreSwappedPages(out_num_restored, process_id, infos, buffer, num_pages));
+    }
+
+    Result GetSwapReclaimRequest64(KUserPointer<ams::svc::SwapReclaimRequest *> out_request) {
+        R_RETURN(GetSwapReclaimRequest(out_request));
+    }
+
+    Result GetSwapReclaimRequest64From32(KUserPointer<ams::svc::SwapReclaimRequest *> out_request) {
+        R_RETURN(GetSwapReclaimRequest(out_request));
+    }
+
+    Result GetSwapActivityRequest64(KUserPointer<ams::svc::SwapActivityRequest *> out_request) {
+        R_RETURN(GetSwapActivityRequest(out_request));
+    }
+
+    Result GetSwapActivityRequest64From32(KUserPointer<ams::svc::SwapActivityRequest *> out_request) {
+        R_RETURN(GetSwapActivityRequest(out_request));
+    }
+
+    Result GetResidentSwapPages64(int32_t *out_num_pages, KUserPointer<uint64_t *> out_addresses, uint64_t process_id, ams::svc::Address address, int32_t max_count) {
+        R_RETURN(GetResidentSwapPages(out_num_pages, out_addresses, process_id, address, max_count));
+    }
+
+    Result GetResidentSwapPages64From32(int32_t *out_num_pages, KUserPointer<uint64_t *> out_addresses, uint64_t process_id, ams::svc::Address address, int32_t max_count) {
+        R_RETURN(GetResidentSwapPages(out_num_pages, out_addresses, process_id, address, max_count));
+    }
+
+    Result RelocateSwappedPages64(uint64_t *out_relocated_mask, KUserPointer<const ams::svc::SwapRelocation *> relocations, int32_t num_relocations) {
+        R_RETURN(RelocateSwappedPages(out_relocated_mask, relocations, num_relocations));
+    }
+
+    Result RelocateSwappedPages64From32(uint64_t *out_relocated_mask, KUserPointer<const ams::svc::SwapRelocation *> relocations, int32_t num_relocations) {
+        R_RETURN(RelocateSwappedPages(out_relocated_mask, relocations, num_relocations));
+    }
+
+    Result MapSwapInFrames64(ams::svc::Address *out_address, uint64_t process_id, int32_t num_pages) {
+        static_assert(sizeof(*out_address) == sizeof(uintptr_t));
+        R_RETURN(MapSwapInFrames(reinterpret_cast<uintptr_t *>(out_address), process_id, num_pages));
+    }
+
+    Result MapSwapInFrames64From32(ams::svc::Address *out_address, uint64_t process_id, int32_t num_pages) {
+        static_assert(sizeof(*out_address) == sizeof(uintptr_t));
+        R_RETURN(MapSwapInFrames(reinterpret_cast<uintptr_t *>(out_address), process_id, num_pages));
+    }
+
+    Result UnmapSwapInFrames64(ams::svc::Address address, int32_t num_pages) {
+        R_RETURN(UnmapSwapInFrames(address, num_pages));
+    }
+
+    Result UnmapSwapInFrames64From32(ams::svc::Address address, int32_t num_pages) {
+        R_RETURN(UnmapSwapInFrames(address, num_pages));
+    }
+
 }
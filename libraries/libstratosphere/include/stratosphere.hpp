@@ -107,6 +107,7 @@
 #include <stratosphere/fs.hpp>
 #include <stratosphere/fssrv.hpp>
 #include <stratosphere/fssystem.hpp>
+#include <stratosphere/swap.hpp>
 
 /* External modules that we're including. */
 #include <stratosphere/rapidjson.hpp>
\ No newline at end of file
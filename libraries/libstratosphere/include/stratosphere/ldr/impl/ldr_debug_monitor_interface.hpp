@@ -24,6 +24,8 @@
     AMS_SF_METHOD_INFO(C, H,     0, Result, SetProgramArgument,               (ncm::ProgramId program_id, const sf::InPointerBuffer &args),                                    (program_id, args),            hos::Version_11_0_0                     ) \
     AMS_SF_METHOD_INFO(C, H,     1, Result, FlushArguments,                   (),                                                                                              ())                                                                      \
     AMS_SF_METHOD_INFO(C, H,     2, Result, GetProcessModuleInfo,             (sf::Out<u32> count, const sf::OutPointerArray<ldr::ModuleInfo> &out, os::ProcessId process_id), (count, out, process_id))                                                \
-    AMS_SF_METHOD_INFO(C, H, 65000, void,   AtmosphereHasLaunchedBootProgram, (sf::Out<bool> out, ncm::ProgramId program_id),                                                  (out, program_id))
+    AMS_SF_METHOD_INFO(C, H, 65000, void,   AtmosphereHasLaunchedBootProgram, (sf::Out<bool> out, ncm::ProgramId program_id),                                                  (out, program_id))                                                       \
+    AMS_SF_METHOD_INFO(C, H, 65001, Result, AtmosphereGetReloadableModuleInfo, (sf::Out<u32> count, const sf::OutPointerArray<ldr::ModuleInfo> &out, os::ProcessId process_id), (count, out, process_id))                                               \
+    AMS_SF_METHOD_INFO(C, H, 65002, Result, AtmosphereReadModulePages,        (const sf::OutNonSecureBuffer &out, os::ProcessId process_id, u64 address),                     (out, process_id, address))
 
 AMS_SF_DEFINE_INTERFACE(ams::ldr::impl, IDebugMonitorInterface, AMS_LDR_I_DEBUG_MONITOR_INTERFACE_INTERFACE_INFO, 0xEE195D22)
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <vapours.hpp>
+#include <stratosphere/os/os_common_types.hpp>
+#include <stratosphere/ldr/ldr_types.hpp>
+
+namespace ams::ldr {
+
+    /* Debug Monitor API. */
+    Result InitializeForDebugMonitor();
+    Result FinalizeForDebugMonitor();
+
+    /* Atmosphere extension API. */
+    Result GetReloadableModuleInfo(s32 *out_count, ModuleInfo *out, size_t max_out_count, os::ProcessId process_id);
+    Result ReadModulePages(void *dst, size_t size, os::ProcessId process_id, u64 address);
+
+}
@@ -20,7 +20,7 @@
 
 namespace ams::patcher {
 
-    /* Helper for applying to code binaries. */
-    void LocateAndApplyIpsPatchesToModule(const char *mount_name, const char *patch_dir, size_t protected_size, size_t offset, const ro::ModuleId *module_id, u8 *mapped_module, size_t mapped_size);
+    /* Helper for applying to code binaries. Returns whether any patch was applied. */
+    bool LocateAndApplyIpsPatchesToModule(const char *mount_name, const char *patch_dir, size_t protected_size, size_t offset, const ro::ModuleId *module_id, u8 *mapped_module, size_t mapped_size);
 
 }
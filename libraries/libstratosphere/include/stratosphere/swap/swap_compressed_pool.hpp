@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <vapours.hpp>
+#include <vapours/svc/svc_types_swap.hpp>
+#include <stratosphere/os/os_memory_heap_common.hpp>
+
+namespace ams::swap {
+
+    /* NOTE: The compressed pool sits in front of the swap partition. Pages are LZ4-compressed into an arena which is used */
+    /* as a log. A page is identified by a key which the pool hands out, rather than by sectors; when the arena fills up, */
+    /* the store appends the oldest pages to the partition, and has the kernel move them there.                           */
+    class CompressedPool {
+        NON_COPYABLE(CompressedPool);
+        NON_MOVEABLE(CompressedPool);
+        public:
+            static constexpr size_t ArenaSize         = 8_MB;
+            static constexpr size_t MaxEntries        = 0x4000;
+            static constexpr size_t MaxCompressedSize = 3 * ams::svc::SwapPageSize / 4;
+        private:
+            static constexpr size_t IndexSize  = 2 * MaxEntries;
+            static constexpr u16 InvalidEntry  = std::numeric_limits<u16>::max();
+            static_assert(util::IsPowerOfTwo(IndexSize));
+            static_assert(MaxEntries < InvalidEntry);
+
+            struct Entry {
+                u64 key;
+                u64 process_id;
+                u64 address;
+                u64 arena_end;
+                u32 arena_offset;
+                u16 size;
+                bool live;
+            };
+        private:
+            alignas(os::MemoryPageSize) u8 m_arena[ArenaSize];
+            u8 m_compressed[MaxCompressedSize];
+            Entry m_entries[MaxEntries];
+            u16 m_index[IndexSize];
+            u32 m_entry_head;
+            u32 m_entry_tail;
+            u64 m_arena_head;
+            u64 m_arena_tail;
+        public:
+            CompressedPool() : m_entries(), m_index(), m_entry_head(), m_entry_tail(), m_arena_head(), m_arena_tail() { /* ... */ }
+
+            void Initialize();
+
+            bool HasRoom();
+
+            bool Store(u64 *out_key, size_t *out_size, u64 process_id, u64 address, const void *page);
+            bool Load(void *dst, u64 key);
+            bool IsOwnedBy(u64 key, u64 process_id, u64 address) const;
+            void Discard(u64 key);
+
+            s32 PeekOldest(ams::svc::SwapRelocation *out_relocations, void *out_pages, s32 max_count);
+        private:
+            size_t FindIndexSlot(u64 key) const;
+            void RemoveIndexSlot(size_t slot);
+
+            u64 GetArenaStart(size_t size) const;
+            void RetireDeadEntries();
+    };
+
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <vapours.hpp>
+#include <stratosphere/os.hpp>
+#include <stratosphere/fs/fs_istorage.hpp>
+#include <stratosphere/fs/fs_priority.hpp>
+
+namespace ams::swap {
+
+    /* NOTE: The scheduler passes every access to its storage through a single thread, in order of the fs priority of the  */
+    /* threads which made them, and makes each at that priority, so that the fs sysmodule arbitrates it the same way.      */
+    /* Accesses below PriorityRaw_Normal are split into chunks, so that an access of higher priority never waits for more  */
+    /* than a chunk. An access which is kept waiting past its deadline goes first, so that background writes never starve. */
+    class IoScheduler : public fs::IStorage {
+        NON_COPYABLE(IoScheduler);
+        NON_MOVEABLE(IoScheduler);
+        public:
+            static constexpr size_t ChunkSize       = 256_KB;
+            static constexpr size_t ThreadStackSize = 0x4000;
+        private:
+            enum Operation {
+                Operation_Read,
+                Operation_Write,
+            };
+
+            struct Request : public util::IntrusiveListBaseNode<Request> {
+                Operation operation;
+                fs::PriorityRaw priority;
+                os::Tick deadline;
+                s64 offset;
+                u8 *buffer;
+                size_t size;
+                Result result;
+                bool done;
+            };
+
+            using RequestList = util::IntrusiveListBaseTraits<Request>::ListType;
+        private:
+            fs::IStorage *m_base;
+            os::SdkMutex m_mutex;
+            os::SdkConditionVariable m_request_cv;
+            os::SdkConditionVariable m_done_cv;
+            RequestList m_requests;
+            os::ThreadType m_thread;
+            bool m_stop;
+            alignas(os::ThreadStackAlignment) u8 m_thread_stack[ThreadStackSize];
+        public:
+            IoScheduler() : m_base(), m_mutex(), m_request_cv(), m_done_cv(), m_requests(), m_stop() { /* ... */ }
+
+            Result Initialize(fs::IStorage *base, s32 thread_priority);
+            void Finalize();
+
+            virtual Result Read(s64 offset, void *buffer, size_t size) override {
+                R_RETURN(this->Submit(Operation_Read, offset, buffer, size));
+            }
+
+            virtual Result Write(s64 offset, const void *buffer, size_t size) override {
+                R_RETURN(this->Submit(Operation_Write, offset, const_cast<void *>(buffer), size));
+            }
+
+            virtual Result Flush() override {
+                R_RETURN(m_base->Flush());
+            }
+
+            virtual Result GetSize(s64 *out) override {
+                R_RETURN(m_base->GetSize(out));
+            }
+
+            virtual Result SetSize(s64 size) override {
+                AMS_UNUSED(size);
+                R_THROW(fs::ResultUnsupportedOperation());
+            }
+
+            virtual Result OperateRange(void *dst, size_t dst_size, fs::OperationId op_id, s64 offset, s64 size, const void *src, size_t src_size) override {
+                R_RETURN(m_base->OperateRange(dst, dst_size, op_id, offset, size, src, src_size));
+            }
+        private:
+            static void ThreadEntry(void *arg) { static_cast<IoScheduler *>(arg)->ThreadBody(); }
+
+            void ThreadBody();
+
+            Result Submit(Operation operation, s64 offset, void *buffer, size_t size);
+            Request *SelectRequest(os::Tick now);
+    };
+
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <vapours.hpp>
+#include <vapours/svc/svc_types_swap.hpp>
+#include <stratosphere/os/os_memory_heap_common.hpp>
+#include <stratosphere/fs/fs_istorage.hpp>
+
+namespace ams::swap {
+
+    /* NOTE: The swap partition begins with a page-sized header, followed by the free-slot bitmap and the slot info table. */
+    /* Page slots follow, starting on a segment boundary. Swap offsets are sector offsets from the start of the partition. */
+    struct PartitionHeader {
+        char magic[0x10];
+        u32 version;
+        u32 num_slots;
+        u32 bitmap_sector;
+        u32 bitmap_num_sectors;
+        u32 slot_info_sector;
+        u32 slot_info_num_sectors;
+        u32 data_sector;
+        u32 crc;
+        u8 reserved[0x1D0];
+    };
+    static_assert(sizeof(PartitionHeader) == ams::svc::SwapSectorSize);
+
+    /* NOTE: A slot's generation advances every time it is freed, and seeds the CRC of its contents. */
+    /* Data left over from an earlier use of the slot (or an earlier boot) therefore never verifies. */
+    struct SlotInfo {
+        u32 generation;
+        u32 crc;
+    };
+    static_assert(sizeof(SlotInfo) == 0x8);
+
+    struct PartitionStatistics {
+        u64 num_pages_read;
+        u64 num_pages_written;
+        u64 num_metadata_sectors_written;
+        u64 num_verification_failures;
+    };
+
+    /* NOTE: The partition is accessed through an fs::IStorage, so that it can be backed by anything from the sd card to a host file. */
+    /* Slots are grouped into segments the size of an sd card erase block, and are only ever handed out in order from the head    */
+    /* segment, so that every write is appended to a log. A segment is reused once nothing in it is live; segment cleaning moves  */
+    /* the pages still live in a mostly-empty segment to the head, so that it can be.                                             */
+    class SwapPartition {
+        NON_COPYABLE(SwapPartition);
+        NON_MOVEABLE(SwapPartition);
+        public:
+            static constexpr u32 Version            = 2;
+            static constexpr size_t MaxSlots        = 0x40000;
+            static constexpr size_t SegmentSize     = 4_MB;
+            static constexpr u32 SlotsPerSegment    = SegmentSize / ams::svc::SwapPageSize;
+            static constexpr size_t MaxSegments     = MaxSlots / SlotsPerSegment;
+        private:
+            static constexpr size_t NumBitmapWords       = MaxSlots / BITSIZEOF(u64);
+            static constexpr size_t BitmapWordsPerSector = ams::svc::SwapSectorSize / sizeof(u64);
+            static constexpr size_t SlotInfosPerSector   = ams::svc::SwapSectorSize / sizeof(SlotInfo);
+            static constexpr size_t NumBitmapSectors     = NumBitmapWords / BitmapWordsPerSector;
+            static constexpr size_t NumSlotInfoSectors   = MaxSlots / SlotInfosPerSector;
+            static_assert(util::IsAligned(MaxSlots, SlotsPerSegment));
+            static_assert(SlotsPerSegment <= std::numeric_limits<u16>::max());
+
+            /* NOTE: Cleaning needs somewhere to move live pages to before it frees anything, so some segments are kept for it. */
+            static constexpr u32 NumReservedSegments = 1;
+            static constexpr u32 MinFreeSegments     = 4;
+            static constexpr u32 MaxLiveSlotsToClean = SlotsPerSegment - SlotsPerSegment / 8;
+            static constexpr u32 InvalidSegment      = std::numeric_limits<u32>::max();
+
+            /* NOTE: Each allocated slot records the page it holds, so that a page can be moved without asking the kernel where it is. */
+            static constexpr size_t OwnerAddressBits = 36;
+        private:
+            alignas(os::MemoryPageSize) SlotInfo m_slot_infos[MaxSlots];
+            alignas(os::MemoryPageSize) u64 m_bitmap[NumBitmapWords];
+            alignas(os::MemoryPageSize) PartitionHeader m_header;
+            u64 m_owners[MaxSlots];
+            u16 m_segment_live_slots[MaxSegments];
+            u64 m_dirty_bitmap_sectors[util::DivideUp(NumBitmapSectors, BITSIZEOF(u64))];
+            u64 m_dirty_slot_info_sectors[util::DivideUp(NumSlotInfoSectors, BITSIZEOF(u64))];
+            PartitionStatistics m_statistics;
+            fs::IStorage *m_storage;
+            u32 m_num_segments;
+            u32 m_num_free_segments;
+            u32 m_head_segment;
+            u32 m_head_num_slots;
+        public:
+            SwapPartition() : m_header(), m_segment_live_slots(), m_dirty_bitmap_sectors(), m_dirty_slot_info_sectors(), m_statistics(), m_storage(), m_num_segments(), m_num_free_segments(), m_head_segment(InvalidSegment), m_head_num_slots() { /* ... */ }
+
+            static Result Create(fs::IStorage *storage);
+
+            Result Mount(fs::IStorage *storage);
+
+            u32 GetNumSlots() const { return m_header.num_slots; }
+            const PartitionStatistics &GetStatistics() const { return m_statistics; }
+
+            u32 AllocateRun(u64 *out_sector_offset, u32 max_count, bool for_cleaning = false);
+            void Free(u64 sector_offset);
+            void FreeRun(u64 sector_offset, u32 count);
+
+            void SetOwner(u64 sector_offset, u64 process_id, u64 address);
+            bool IsOwnedBy(u64 sector_offset, u64 process_id, u64 address) const;
+            bool GetOwner(u64 *out_process_id, u64 *out_address, u64 sector_offset) const;
+
+            bool IsFull() const { return m_num_free_segments <= NumReservedSegments && (m_head_segment == InvalidSegment || m_head_num_slots == SlotsPerSegment); }
+            bool NeedsCleaning() const { return m_num_free_segments < MinFreeSegments; }
+            bool SelectSegmentToClean(u32 *out_segment) const;
+            s32 GetLiveSlots(u64 *out_sector_offsets, u32 segment, u32 *inout_index, s32 max_count) const;
+
+            Result ReadPages(void *dst, u64 sector_offset, size_t num_pages);
+            Result WritePages(u64 sector_offset, const void *src, size_t num_pages);
+
+            Result Flush();
+        private:
+            static constexpr u64 PackOwner(u64 process_id, u64 address) { return (process_id << OwnerAddressBits) | (address / ams::svc::SwapPageSize); }
+
+            u64 GetSectorOffset(u32 slot) const { return m_header.data_sector + static_cast<u64>(slot) * ams::svc::SwapSectorsPerPage; }
+            bool GetSlot(u32 *out, u64 sector_offset) const;
+            bool IsAllocated(u32 slot) const { return (m_bitmap[slot / BITSIZEOF(u64)] & (static_cast<u64>(1) << (slot % BITSIZEOF(u64)))) != 0; }
+
+            bool OpenSegment(bool for_cleaning);
+            void MarkRun(u32 slot, u32 count, bool used);
+
+            Result ReadSectors(void *dst, u64 sector, size_t num_sectors);
+            Result WriteSectors(u64 sector, const void *src, size_t num_sectors);
+            Result FlushDirtySectors(u64 *dirty, u32 sector, const void *src, size_t num_sectors);
+    };
+
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <vapours.hpp>
+#include <vapours/svc/svc_types_swap.hpp>
+
+namespace ams::swap {
+
+    /* NOTE: The readahead tracker follows each process's faults, so that sequential access can be read ahead. */
+    /* It also remembers the pages read ahead in the current batch, as other threads may fault on them too.  */
+    class ReadaheadTracker {
+        NON_COPYABLE(ReadaheadTracker);
+        NON_MOVEABLE(ReadaheadTracker);
+        public:
+            static constexpr size_t NumStreams     = 8;
+            static constexpr s32 MaxReadaheadPages = ams::svc::SwapReadaheadMaxPages;
+        private:
+            struct Stream {
+                u64 process_id;
+                u64 next_address;
+                u64 range_address;
+                s32 range_num_pages;
+            };
+        private:
+            Stream m_streams[NumStreams];
+            size_t m_next_stream;
+            s32 m_readahead_pages;
+        public:
+            ReadaheadTracker() : m_streams(), m_next_stream(), m_readahead_pages(1) { /* ... */ }
+
+            void Initialize(s32 readahead_pages);
+
+            void BeginBatch();
+
+            bool IsPageRead(u64 process_id, u64 page_address) const;
+            s32 GetReadaheadPages(u64 process_id, u64 page_address, u64 swap_offset) const;
+            void OnPagesRead(u64 process_id, u64 page_address, s32 num_pages);
+        private:
+            const Stream *FindStream(u64 process_id) const;
+            Stream *AcquireStream(u64 process_id);
+    };
+
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <vapours.hpp>
+#include <vapours/svc/svc_types_swap.hpp>
+#include <stratosphere/os/os_memory_heap_common.hpp>
+#include <stratosphere/os/os_sdk_mutex.hpp>
+
+namespace ams::swap {
+
+    class CompressedPool;
+    class SwapPartition;
+
+    /* NOTE: The store is the swap partition with the compressed pool in front of it. Swap offsets with               */
+    /* ams::svc::SwapOffsetCompressedFlag set were kept in the pool when they were evicted. Every page written to the */
+    /* partition is appended to its log, whether it was just evicted, moved out of the pool, or moved by cleaning;    */
+    /* pages which are moved are handed to the relocate function, so that the kernel records their new offsets.       */
+    /* Only one thread may use the store, except that ReadCurrentPages may be called from any other at the same time; */
+    /* the mutex is only held while the store is modified, or read from another thread, and never across a write.     */
+    class SwapStore {
+        NON_COPYABLE(SwapStore);
+        NON_MOVEABLE(SwapStore);
+        public:
+            static constexpr s32 MaxBatchPages = 0x100;
+
+            using RelocateFunction = Result (*)(u64 *out_relocated_mask, const ams::svc::SwapRelocation *relocations, s32 num_relocations);
+        private:
+            static constexpr s32 MaxMovePages = ams::svc::SwapRelocateMaxPages;
+        private:
+            SwapPartition *m_partition;
+            CompressedPool *m_pool;
+            RelocateFunction m_relocate;
+            os::SdkMutex m_mutex;
+            bool m_cleaning;
+            u32 m_clean_segment;
+            u32 m_clean_index;
+            u16 m_order[MaxBatchPages];
+            u64 m_sector_offsets[MaxMovePages];
+            ams::svc::SwapRelocation m_relocations[MaxMovePages];
+            alignas(os::MemoryPageSize) u8 m_move_buffer[MaxMovePages * ams::svc::SwapPageSize];
+        public:
+            SwapStore() : m_partition(), m_pool(), m_relocate(), m_mutex(), m_cleaning(), m_clean_segment(), m_clean_index() { /* ... */ }
+
+            void Initialize(SwapPartition *partition, CompressedPool *pool, RelocateFunction relocate);
+
+            void WriteBatch(ams::svc::SwapEvictionCompletion *out_completions, const ams::svc::SwapEvictionInfo *infos, void *pages, s32 count);
+            Result ReadPages(void *dst, u64 swap_offset, s32 num_pages);
+            Result ReadCurrentPages(void *dst, u64 swap_offset, u64 process_id, u64 address, s32 num_pages);
+            void Release(const u64 *swap_offsets, s32 count);
+
+            bool IsFull() const;
+
+            Result Clean();
+            Result Flush();
+        private:
+            bool PoolHasRoom();
+            Result WriteBackPool();
+            Result MovePages(s32 count, bool for_cleaning);
+            void ReleaseOffset(u64 swap_offset);
+    };
+
+}
@@ -32,6 +32,27 @@ Result ldrPmAtmosphereHasLaunchedBootProgram(bool *out, u64 program_id) {
     return _ldrAtmosphereHasLaunchedBootProgram(ldrPmGetServiceSession(), out, program_id);
 }
 
+Result ldrDmntAtmosphereGetReloadableModuleInfo(u64 pid, LoaderModuleInfo *out_module_infos, size_t max_out_modules, s32 *num_out) {
+    u32 tmp = 0;
+    Result rc = serviceDispatchInOut(ldrDmntGetServiceSession(), 65001, pid, tmp,
+        .buffer_attrs = { SfBufferAttr_Out | SfBufferAttr_HipcPointer },
+        .buffers = { { out_module_infos, max_out_modules * sizeof(*out_module_infos) } },
+    );
+    if (R_SUCCEEDED(rc) && num_out) *num_out = tmp;
+    return rc;
+}
+
+Result ldrDmntAtmosphereReadModulePages(u64 pid, u64 address, void *dst, size_t size) {
+    const struct {
+        u64 pid;
+        u64 address;
+    } in = { pid, address };
+    return serviceDispatchIn(ldrDmntGetServiceSession(), 65002, in,
+        .buffer_attrs = { SfBufferAttr_Out | SfBufferAttr_HipcMapAlias | SfBufferAttr_HipcMapTransferAllowsNonSecure },
+        .buffers = { { dst, size } },
+    );
+}
+
 Result ldrPmAtmosphereGetProgramInfo(LoaderProgramInfo *out_program_info, CfgOverrideStatus *out_status, const NcmProgramLocation *loc, const LoaderProgramAttributes *attr) {
     const struct {
         LoaderProgramAttributes attr;
@@ -18,6 +18,8 @@ typedef struct {
 
 Result ldrPmAtmosphereHasLaunchedBootProgram(bool *out, u64 program_id);
 Result ldrDmntAtmosphereHasLaunchedBootProgram(bool *out, u64 program_id);
+Result ldrDmntAtmosphereGetReloadableModuleInfo(u64 pid, LoaderModuleInfo *out_module_infos, size_t max_out_modules, s32 *num_out);
+Result ldrDmntAtmosphereReadModulePages(u64 pid, u64 address, void *dst, size_t size);
 
 Result ldrPmAtmosphereGetProgramInfo(LoaderProgramInfo *out, CfgOverrideStatus *out_status, const NcmProgramLocation *loc, const LoaderProgramAttributes *attr);
 Result ldrPmAtmospherePinProgram(u64 *out, const NcmProgramLocation *loc, const CfgOverrideStatus *status);
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "ldr_ams.os.horizon.h"
+
+namespace ams::ldr {
+
+    Result InitializeForDebugMonitor() {
+        R_RETURN(::ldrDmntInitialize());
+    }
+
+    Result FinalizeForDebugMonitor() {
+        ::ldrDmntExit();
+        R_SUCCEED();
+    }
+
+    Result GetReloadableModuleInfo(s32 *out_count, ModuleInfo *out, size_t max_out_count, os::ProcessId process_id) {
+        static_assert(sizeof(*out) == sizeof(::LoaderModuleInfo));
+        R_RETURN(::ldrDmntAtmosphereGetReloadableModuleInfo(static_cast<u64>(process_id), reinterpret_cast<::LoaderModuleInfo *>(out), max_out_count, out_count));
+    }
+
+    Result ReadModulePages(void *dst, size_t size, os::ProcessId process_id, u64 address) {
+        R_RETURN(::ldrDmntAtmosphereReadModulePages(static_cast<u64>(process_id), address, dst, size));
+    }
+
+}
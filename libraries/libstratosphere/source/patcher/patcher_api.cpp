@@ -214,10 +214,13 @@ namespace ams::patcher {
 
     }
 
-    void LocateAndApplyIpsPatchesToModule(const char *mount_name, const char *patch_dir_name, size_t protected_size, size_t offset, const ro::ModuleId *module_id, u8 *mapped_module, size_t mapped_size) {
+    bool LocateAndApplyIpsPatchesToModule(const char *mount_name, const char *patch_dir_name, size_t protected_size, size_t offset, const ro::ModuleId *module_id, u8 *mapped_module, size_t mapped_size) {
         /* Ensure only one thread tries to apply patches at a time. */
         std::scoped_lock lk(g_apply_patch_lock);
 
+        /* Track whether we applied anything. */
+        bool applied = false;
+
         /* Inspect all patches from /atmosphere/<patch_dir>/<*>/<*>.ips */
         char path[fs::EntryNameLengthMax + 1];
         util::SNPrintf(path, sizeof(path), "%s:/atmosphere/%s", mount_name, patch_dir_name);
@@ -226,7 +229,7 @@ namespace ams::patcher {
         /* Open the patch directory. */
         fs::DirectoryHandle patches_dir;
         if (R_FAILED(fs::OpenDirectory(std::addressof(patches_dir), path, fs::OpenDirectoryMode_Directory))) {
-            return;
+            return applied;
         }
         ON_SCOPE_EXIT { fs::CloseDirectory(patches_dir); };
 
@@ -276,12 +279,16 @@ namespace ams::patcher {
                 if (R_SUCCEEDED(fs::ReadFile(file, 0, header, sizeof(header)))) {
                     if (std::memcmp(header, IpsHeadMagic, sizeof(header)) == 0) {
                         ApplyIpsPatch(mapped_module, mapped_size, protected_size, offset, false, file);
+                        applied = true;
                     } else if (std::memcmp(header, Ips32HeadMagic, sizeof(header)) == 0) {
                         ApplyIpsPatch(mapped_module, mapped_size, protected_size, offset, true, file);
+                        applied = true;
                     }
                 }
             }
         }
+
+        return applied;
     }
 
 }
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+
+namespace ams::swap {
+
+    namespace {
+
+        constexpr size_t GetHomeSlot(u64 key, size_t index_size) {
+            /* Keys are handed out in sequence, so consecutive pages land in consecutive slots. */
+            return static_cast<size_t>(key / ams::svc::SwapSectorsPerPage) & (index_size - 1);
+        }
+
+        constexpr u64 MakeKey(u32 sequence) {
+            /* NOTE: Keys are spaced like sector offsets, and wrap before they reach the swap offset flags. The pool never */
+            /* holds more than MaxEntries pages, so a key is never handed out again while its page is still held.         */
+            return (static_cast<u64>(sequence) * ams::svc::SwapSectorsPerPage) % ams::svc::SwapOffsetDiscardedFlag;
+        }
+
+    }
+
+    void CompressedPool::Initialize() {
+        std::fill(std::begin(m_index), std::end(m_index), InvalidEntry);
+    }
+
+    bool CompressedPool::HasRoom() {
+        /* Release the space of pages which have been dropped, up to the oldest page we still hold. */
+        this->RetireDeadEntries();
+
+        /* Check that there's room for a page which compresses as poorly as we allow. */
+        return m_entry_head - m_entry_tail < MaxEntries && this->GetArenaStart(MaxCompressedSize) + MaxCompressedSize - m_arena_tail <= ArenaSize;
+    }
+
+    bool CompressedPool::Store(u64 *out_key, size_t *out_size, u64 process_id, u64 address, const void *page) {
+        /* Compress the page. Pages which don't compress well enough go straight to the partition. */
+        const int size = util::CompressLZ4(m_compressed, sizeof(m_compressed), page, ams::svc::SwapPageSize);
+        if (size <= 0) {
+            return false;
+        }
+
+        /* Check that we have room for the page. If not, it's the store's job to move older pages out first. */
+        /* NOTE: Compressed pages never straddle the end of the arena; any space left there is skipped. */
+        this->RetireDeadEntries();
+
+        const u64 start = this->GetArenaStart(size);
+        if (m_entry_head - m_entry_tail >= MaxEntries || start + size - m_arena_tail > ArenaSize) {
+            return false;
+        }
+
+        /* Append the page under a new key. */
+        const u64 key         = MakeKey(m_entry_head);
+        const size_t slot     = this->FindIndexSlot(key);
+        const u32 entry_index = m_entry_head % MaxEntries;
+        AMS_ASSERT(m_index[slot] == InvalidEntry);
+
+        m_entries[entry_index] = {
+            .key          = key,
+            .process_id   = process_id,
+            .address      = address,
+            .arena_end    = start + size,
+            .arena_offset = static_cast<u32>(start % ArenaSize),
+            .size         = static_cast<u16>(size),
+            .live         = true,
+        };
+        std::memcpy(m_arena + start % ArenaSize, m_compressed, size);
+
+        m_index[slot] = static_cast<u16>(entry_index);
+        m_arena_head  = start + size;
+        ++m_entry_head;
+
+        *out_key  = key;
+        *out_size = size;
+        return true;
+    }
+
+    bool CompressedPool::Load(void *dst, u64 key) {
+        /* Find the page. If it isn't here, it has been moved out to the partition. */
+        const size_t slot = this->FindIndexSlot(key);
+        if (m_index[slot] == InvalidEntry) {
+            return false;
+        }
+
+        /* Decompress the page. */
+        /* NOTE: The entry stays in the pool until the kernel releases the page's swap offset, as the fault may not be resolved. */
+        const Entry &entry = m_entries[m_index[slot]];
+        AMS_ABORT_UNLESS(util::DecompressLZ4(dst, ams::svc::SwapPageSize, m_arena + entry.arena_offset, entry.size) == static_cast<int>(ams::svc::SwapPageSize));
+
+        return true;
+    }
+
+    bool CompressedPool::IsOwnedBy(u64 key, u64 process_id, u64 address) const {
+        const size_t slot = this->FindIndexSlot(key);
+        return m_index[slot] != InvalidEntry && m_entries[m_index[slot]].process_id == process_id && m_entries[m_index[slot]].address == address;
+    }
+
+    void CompressedPool::Discard(u64 key) {
+        /* Drop the page, if we still hold it. Its space is released once it reaches the end of the log. */
+        if (const size_t slot = this->FindIndexSlot(key); m_index[slot] != InvalidEntry) {
+            m_entries[m_index[slot]].live = false;
+            this->RemoveIndexSlot(slot);
+        }
+    }
+
+    s32 CompressedPool::PeekOldest(ams::svc::SwapRelocation *out_relocations, void *out_pages, s32 max_count) {
+        /* Decompress the oldest pages we still hold, so that they can be moved out together. */
+        /* NOTE: The pages stay here until the caller discards them, so that they're never lost if they can't be moved. */
+        s32 count = 0;
+        for (u32 i = m_entry_tail; i != m_entry_head && count < max_count; ++i) {
+            const Entry &entry = m_entries[i % MaxEntries];
+            if (!entry.live) {
+                continue;
+            }
+
+            u8 *page = static_cast<u8 *>(out_pages) + count * ams::svc::SwapPageSize;
+            AMS_ABORT_UNLESS(util::DecompressLZ4(page, ams::svc::SwapPageSize, m_arena + entry.arena_offset, entry.size) == static_cast<int>(ams::svc::SwapPageSize));
+
+            out_relocations[count++] = {
+                .process_id = entry.process_id,
+                .address    = entry.address,
+                .old_offset = entry.key | ams::svc::SwapOffsetCompressedFlag,
+                .new_offset = 0,
+            };
+        }
+
+        return count;
+    }
+
+    size_t CompressedPool::FindIndexSlot(u64 key) const {
+        /* Probe linearly from the page's home slot, until we find either the page or an empty slot. */
+        /* NOTE: The index is twice the size of the entry table, so there is always an empty slot. */
+        size_t slot = GetHomeSlot(key, IndexSize);
+        while (m_index[slot] != InvalidEntry && m_entries[m_index[slot]].key != key) {
+            slot = (slot + 1) & (IndexSize - 1);
+        }
+
+        return slot;
+    }
+
+    void CompressedPool::RemoveIndexSlot(size_t slot) {
+        /* Shift back any entries which were displaced past the slot, so that probing never stops early. */
+        size_t hole = slot;
+        for (size_t cur = (slot + 1) & (IndexSize - 1); m_index[cur] != InvalidEntry; cur = (cur + 1) & (IndexSize - 1)) {
+            const size_t home = GetHomeSlot(m_entries[m_index[cur]].key, IndexSize);
+            if (((cur - home) & (IndexSize - 1)) >= ((cur - hole) & (IndexSize - 1))) {
+                m_index[hole] = m_index[cur];
+                hole = cur;
+            }
+        }
+
+        m_index[hole] = InvalidEntry;
+    }
+
+    u64 CompressedPool::GetArenaStart(size_t size) const {
+        const u64 pos = m_arena_head % ArenaSize;
+        return (pos + size > ArenaSize) ? m_arena_head + (ArenaSize - pos) : m_arena_head;
+    }
+
+    void CompressedPool::RetireDeadEntries() {
+        /* Release the space of the oldest entries, for as long as they've been dropped. */
+        while (m_entry_tail != m_entry_head && !m_entries[m_entry_tail % MaxEntries].live) {
+            m_arena_tail = m_entries[m_entry_tail % MaxEntries].arena_end;
+            ++m_entry_tail;
+        }
+    }
+
+}
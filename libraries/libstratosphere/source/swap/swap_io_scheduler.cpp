@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+
+namespace ams::swap {
+
+    namespace {
+
+        constexpr TimeSpan GetDeadline(fs::PriorityRaw priority) {
+            switch (priority) {
+                case fs::PriorityRaw_Realtime:   return TimeSpan::FromMilliSeconds(2);
+                case fs::PriorityRaw_Normal:     return TimeSpan::FromMilliSeconds(20);
+                case fs::PriorityRaw_Low:        return TimeSpan::FromMilliSeconds(200);
+                case fs::PriorityRaw_Background: return TimeSpan::FromSeconds(1);
+                AMS_UNREACHABLE_DEFAULT_CASE();
+            }
+        }
+
+        constexpr bool IsChunked(fs::PriorityRaw priority) {
+            return priority == fs::PriorityRaw_Low || priority == fs::PriorityRaw_Background;
+        }
+
+    }
+
+    Result IoScheduler::Initialize(fs::IStorage *base, s32 thread_priority) {
+        m_base = base;
+        m_stop = false;
+
+        /* Create and start the thread which makes the accesses. */
+        R_TRY(os::CreateThread(std::addressof(m_thread), ThreadEntry, this, m_thread_stack, sizeof(m_thread_stack), thread_priority));
+        os::SetThreadNamePointer(std::addressof(m_thread), "swap.IoScheduler");
+        os::StartThread(std::addressof(m_thread));
+
+        R_SUCCEED();
+    }
+
+    void IoScheduler::Finalize() {
+        /* Have the thread exit once it has served every pending access. */
+        {
+            std::scoped_lock lk(m_mutex);
+            m_stop = true;
+            m_request_cv.Signal();
+        }
+
+        os::WaitThread(std::addressof(m_thread));
+        os::DestroyThread(std::addressof(m_thread));
+    }
+
+    Result IoScheduler::Submit(Operation operation, s64 offset, void *buffer, size_t size) {
+        R_SUCCEED_IF(size == 0);
+
+        /* Describe the access, and the deadline by which it should be served. */
+        Request request;
+        request.operation = operation;
+        request.priority  = fs::GetPriorityRawOnCurrentThread();
+        request.deadline  = os::GetSystemTick() + os::ConvertToTick(GetDeadline(request.priority));
+        request.offset    = offset;
+        request.buffer    = static_cast<u8 *>(buffer);
+        request.size      = size;
+        request.result    = ResultSuccess();
+        request.done      = false;
+
+        /* Queue it, and wait for the thread to serve it. */
+        std::scoped_lock lk(m_mutex);
+
+        m_requests.push_back(request);
+        m_request_cv.Signal();
+
+        while (!request.done) {
+            m_done_cv.Wait(m_mutex);
+        }
+
+        R_RETURN(request.result);
+    }
+
+    IoScheduler::Request *IoScheduler::SelectRequest(os::Tick now) {
+        /* Take the access of highest priority, unless one has been kept waiting past its deadline, in which case take the one which has been overdue longest. */
+        /* NOTE: Accesses of the same priority are served in the order they were made, as a later one only replaces the selection if it is strictly preferred. */
+        Request *selected = nullptr;
+        for (auto &request : m_requests) {
+            if (selected == nullptr) {
+                selected = std::addressof(request);
+                continue;
+            }
+
+            const bool is_overdue       = request.deadline <= now;
+            const bool selected_overdue = selected->deadline <= now;
+            if (is_overdue != selected_overdue) {
+                if (is_overdue) {
+                    selected = std::addressof(request);
+                }
+            } else if (is_overdue ? (request.deadline < selected->deadline) : (request.priority < selected->priority)) {
+                selected = std::addressof(request);
+            }
+        }
+
+        return selected;
+    }
+
+    void IoScheduler::ThreadBody() {
+        std::scoped_lock lk(m_mutex);
+
+        while (true) {
+            /* Wait for an access to serve. */
+            while (m_requests.empty() && !m_stop) {
+                m_request_cv.Wait(m_mutex);
+            }
+            if (m_requests.empty()) {
+                break;
+            }
+
+            /* Select the access to serve next, and how much of it to serve before choosing again. */
+            Request *request = this->SelectRequest(os::GetSystemTick());
+            const size_t size = IsChunked(request->priority) ? std::min(request->size, ChunkSize) : request->size;
+
+            /* Make the access, letting other threads queue theirs meanwhile. */
+            /* NOTE: The access is made at the priority of the thread which queued it, so that fs arbitrates it against other accesses to the device at that priority. */
+            Result result;
+            {
+                m_mutex.Unlock();
+                ON_SCOPE_EXIT { m_mutex.Lock(); };
+
+                fs::SetPriorityRawOnCurrentThread(request->priority);
+
+                if (request->operation == Operation_Read) {
+                    result = m_base->Read(request->offset, request->buffer, size);
+                } else {
+                    result = m_base->Write(request->offset, request->buffer, size);
+                }
+            }
+
+            /* Once the whole access has been made, or part of it has failed, wake the thread which made it. */
+            request->offset += size;
+            request->buffer += size;
+            request->size   -= size;
+            if (R_FAILED(result) || request->size == 0) {
+                m_requests.erase(m_requests.iterator_to(*request));
+
+                request->result = result;
+                request->done   = true;
+                m_done_cv.Broadcast();
+            }
+        }
+    }
+
+}
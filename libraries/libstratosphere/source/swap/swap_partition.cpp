@@ -0,0 +1,445 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+
+namespace ams::swap {
+
+    namespace {
+
+        constexpr const char Magic[] = "SWAP_MAGIC";
+
+        constexpr u32 Crc32cPolynomial = 0x82F63B78;
+
+        constexpr auto Crc32cTable = [] {
+            std::array<u32, 0x100> table = {};
+            for (u32 i = 0; i < table.size(); ++i) {
+                u32 crc = i;
+                for (size_t bit = 0; bit < BITSIZEOF(u8); ++bit) {
+                    crc = (crc & 1) ? ((crc >> 1) ^ Crc32cPolynomial) : (crc >> 1);
+                }
+                table[i] = crc;
+            }
+            return table;
+        }();
+
+        u32 CalculateCrc32c(u32 seed, const void *data, size_t size) {
+            const u8 *cur = static_cast<const u8 *>(data);
+
+            u32 crc = ~seed;
+            for (size_t i = 0; i < size; ++i) {
+                crc = Crc32cTable[(crc ^ cur[i]) & 0xFF] ^ (crc >> BITSIZEOF(u8));
+            }
+            return ~crc;
+        }
+
+        u32 CalculateHeaderCrc(const PartitionHeader &header) {
+            PartitionHeader tmp = header;
+            tmp.crc = 0;
+            return CalculateCrc32c(0, std::addressof(tmp), sizeof(tmp));
+        }
+
+        constexpr u32 SegmentNumSectors = SwapPartition::SegmentSize / ams::svc::SwapSectorSize;
+
+        bool ComputeLayout(PartitionHeader *out, u32 partition_num_sectors) {
+            /* The header occupies the first page. */
+            const u32 bitmap_sector = ams::svc::SwapSectorsPerPage;
+
+            /* Shrink the number of slots until they fit alongside their metadata. */
+            /* NOTE: Slots are only ever made up of whole segments, which start on erase block boundaries if the partition does. */
+            u64 num_slots = util::AlignDown(std::min<u64>(SwapPartition::MaxSlots, partition_num_sectors / ams::svc::SwapSectorsPerPage), SwapPartition::SlotsPerSegment);
+            while (num_slots > 0) {
+                const u32 bitmap_num_sectors    = util::DivideUp(util::DivideUp(num_slots, BITSIZEOF(u64)), ams::svc::SwapSectorSize / sizeof(u64));
+                const u32 slot_info_num_sectors = util::DivideUp(num_slots, ams::svc::SwapSectorSize / sizeof(SlotInfo));
+                const u32 slot_info_sector      = bitmap_sector + bitmap_num_sectors;
+                const u32 data_sector           = util::AlignUp(slot_info_sector + slot_info_num_sectors, SegmentNumSectors);
+
+                if (data_sector + num_slots * ams::svc::SwapSectorsPerPage <= partition_num_sectors) {
+                    *out = {
+                        .magic                 = {},
+                        .version               = SwapPartition::Version,
+                        .num_slots             = static_cast<u32>(num_slots),
+                        .bitmap_sector         = bitmap_sector,
+                        .bitmap_num_sectors    = bitmap_num_sectors,
+                        .slot_info_sector      = slot_info_sector,
+                        .slot_info_num_sectors = slot_info_num_sectors,
+                        .data_sector           = data_sector,
+                        .crc                   = 0,
+                        .reserved              = {},
+                    };
+                    std::memcpy(out->magic, Magic, sizeof(Magic) - 1);
+                    return true;
+                }
+
+                num_slots = data_sector < partition_num_sectors ? util::AlignDown(std::min<u64>(num_slots - SwapPartition::SlotsPerSegment, (partition_num_sectors - data_sector) / ams::svc::SwapSectorsPerPage), SwapPartition::SlotsPerSegment) : 0;
+            }
+
+            return false;
+        }
+
+        constexpr bool IsSameLayout(const PartitionHeader &lhs, const PartitionHeader &rhs) {
+            return lhs.num_slots             == rhs.num_slots             &&
+                   lhs.bitmap_sector         == rhs.bitmap_sector         &&
+                   lhs.bitmap_num_sectors    == rhs.bitmap_num_sectors    &&
+                   lhs.slot_info_sector      == rhs.slot_info_sector      &&
+                   lhs.slot_info_num_sectors == rhs.slot_info_num_sectors &&
+                   lhs.data_sector           == rhs.data_sector;
+        }
+
+        constexpr ALWAYS_INLINE void SetDirty(u64 *dirty, size_t index) {
+            dirty[index / BITSIZEOF(u64)] |= (static_cast<u64>(1) << (index % BITSIZEOF(u64)));
+        }
+
+        constexpr ALWAYS_INLINE bool IsDirty(const u64 *dirty, size_t index) {
+            return (dirty[index / BITSIZEOF(u64)] & (static_cast<u64>(1) << (index % BITSIZEOF(u64)))) != 0;
+        }
+
+    }
+
+    Result SwapPartition::Create(fs::IStorage *storage) {
+        /* Mark the storage as ours, with a header which matches no layout, so that the first mount formats it. */
+        alignas(os::MemoryPageSize) PartitionHeader header = {};
+        std::memcpy(header.magic, Magic, sizeof(Magic) - 1);
+
+        R_TRY(storage->Write(0, std::addressof(header), sizeof(header)));
+        R_RETURN(storage->Flush());
+    }
+
+    Result SwapPartition::Mount(fs::IStorage *storage) {
+        m_storage = storage;
+
+        /* Determine the partition's size. */
+        s64 storage_size;
+        R_TRY(m_storage->GetSize(std::addressof(storage_size)));
+
+        const u32 partition_num_sectors = static_cast<u32>(std::min<s64>(storage_size / ams::svc::SwapSectorSize, std::numeric_limits<u32>::max()));
+
+        /* Read the header. The partition must have been created with our magic, so that we never overwrite anything else. */
+        R_TRY(this->ReadSectors(std::addressof(m_header), 0, 1));
+        R_UNLESS(std::memcmp(m_header.magic, Magic, sizeof(Magic) - 1) == 0, fs::ResultDataCorrupted());
+
+        /* Determine the layout for the partition's size. */
+        PartitionHeader layout;
+        R_UNLESS(ComputeLayout(std::addressof(layout), partition_num_sectors), svc::ResultOutOfResource());
+
+        /* If the partition was already formatted with this layout, carry the slot generations over. */
+        const bool formatted = m_header.version == Version && m_header.crc == CalculateHeaderCrc(m_header) && IsSameLayout(m_header, layout);
+        if (formatted) {
+            R_TRY(this->ReadSectors(m_slot_infos, layout.slot_info_sector, layout.slot_info_num_sectors));
+        } else {
+            std::memset(m_slot_infos, 0, sizeof(m_slot_infos));
+        }
+
+        /* Nothing written during an earlier boot is still referenced, so every slot starts out free, with a new generation. */
+        for (u32 i = 0; i < layout.num_slots; ++i) {
+            m_slot_infos[i] = { .generation = m_slot_infos[i].generation + 1, .crc = 0 };
+        }
+
+        /* Slots past the end of the partition are permanently in use. */
+        const size_t num_groups = util::DivideUp(layout.num_slots, BITSIZEOF(u64));
+        for (size_t i = 0; i < NumBitmapWords; ++i) {
+            m_bitmap[i] = (i < num_groups) ? 0 : ~static_cast<u64>(0);
+        }
+        if (const size_t tail = layout.num_slots % BITSIZEOF(u64); tail != 0) {
+            m_bitmap[num_groups - 1] = ~static_cast<u64>(0) << tail;
+        }
+
+        m_header = layout;
+        m_header.crc = CalculateHeaderCrc(m_header);
+
+        /* Every segment starts out free, with no head; the first allocation opens one. */
+        std::memset(m_owners, 0, sizeof(m_owners));
+        std::memset(m_segment_live_slots, 0, sizeof(m_segment_live_slots));
+        m_num_segments      = layout.num_slots / SlotsPerSegment;
+        m_num_free_segments = m_num_segments;
+        m_head_segment      = InvalidSegment;
+        m_head_num_slots    = 0;
+
+        /* Write out the formatted metadata. */
+        R_TRY(this->WriteSectors(0, std::addressof(m_header), 1));
+        R_TRY(this->WriteSectors(m_header.bitmap_sector, m_bitmap, m_header.bitmap_num_sectors));
+        R_TRY(this->WriteSectors(m_header.slot_info_sector, m_slot_infos, m_header.slot_info_num_sectors));
+
+        std::memset(m_dirty_bitmap_sectors, 0, sizeof(m_dirty_bitmap_sectors));
+        std::memset(m_dirty_slot_info_sectors, 0, sizeof(m_dirty_slot_info_sectors));
+        R_SUCCEED();
+    }
+
+    u32 SwapPartition::AllocateRun(u64 *out_sector_offset, u32 max_count, bool for_cleaning) {
+        AMS_ASSERT(max_count > 0);
+
+        /* Once the head segment is full, move on to the next free one. */
+        if (m_head_segment == InvalidSegment || m_head_num_slots == SlotsPerSegment) {
+            if (!this->OpenSegment(for_cleaning)) {
+                return 0;
+            }
+        }
+
+        /* Hand out the head's next slots. The run stops at the end of the segment, so that the caller's write never spans two. */
+        const u32 slot  = m_head_segment * SlotsPerSegment + m_head_num_slots;
+        const u32 count = std::min<u32>(max_count, SlotsPerSegment - m_head_num_slots);
+
+        this->MarkRun(slot, count, true);
+        m_segment_live_slots[m_head_segment] += count;
+        m_head_num_slots += count;
+
+        *out_sector_offset = this->GetSectorOffset(slot);
+        return count;
+    }
+
+    void SwapPartition::Free(u64 sector_offset) {
+        /* Ignore anything which isn't an allocated slot. */
+        u32 slot;
+        if (!this->GetSlot(std::addressof(slot), sector_offset) || !this->IsAllocated(slot)) {
+            return;
+        }
+
+        /* Advance the slot's generation, so that its old contents never verify. */
+        m_slot_infos[slot] = { .generation = m_slot_infos[slot].generation + 1, .crc = 0 };
+        SetDirty(m_dirty_slot_info_sectors, slot / SlotInfosPerSector);
+
+        this->MarkRun(slot, 1, false);
+        m_owners[slot] = 0;
+
+        /* Once nothing in a segment is live, it can be written again; the head is freed once it's full, by OpenSegment. */
+        const u32 segment = slot / SlotsPerSegment;
+        if (--m_segment_live_slots[segment] == 0 && segment != m_head_segment) {
+            ++m_num_free_segments;
+        }
+    }
+
+    void SwapPartition::FreeRun(u64 sector_offset, u32 count) {
+        for (u32 i = 0; i < count; ++i) {
+            this->Free(sector_offset + i * ams::svc::SwapSectorsPerPage);
+        }
+
+        /* If these were the last slots handed out, give them back to the head, so that the log has no hole. */
+        if (u32 slot; count > 0 && this->GetSlot(std::addressof(slot), sector_offset) && slot / SlotsPerSegment == m_head_segment && slot % SlotsPerSegment + count == m_head_num_slots) {
+            m_head_num_slots = slot % SlotsPerSegment;
+        }
+    }
+
+    void SwapPartition::SetOwner(u64 sector_offset, u64 process_id, u64 address) {
+        if (u32 slot; this->GetSlot(std::addressof(slot), sector_offset) && this->IsAllocated(slot)) {
+            m_owners[slot] = PackOwner(process_id, address);
+        }
+    }
+
+    bool SwapPartition::IsOwnedBy(u64 sector_offset, u64 process_id, u64 address) const {
+        u32 slot;
+        return this->GetSlot(std::addressof(slot), sector_offset) && this->IsAllocated(slot) && m_owners[slot] == PackOwner(process_id, address);
+    }
+
+    bool SwapPartition::GetOwner(u64 *out_process_id, u64 *out_address, u64 sector_offset) const {
+        u32 slot;
+        if (!this->GetSlot(std::addressof(slot), sector_offset) || !this->IsAllocated(slot) || m_owners[slot] == 0) {
+            return false;
+        }
+
+        *out_process_id = m_owners[slot] >> OwnerAddressBits;
+        *out_address    = (m_owners[slot] & ((static_cast<u64>(1) << OwnerAddressBits) - 1)) * ams::svc::SwapPageSize;
+        return true;
+    }
+
+    bool SwapPartition::SelectSegmentToClean(u32 *out_segment) const {
+        /* Pick the segment with the fewest live slots, as it frees the most space for the fewest writes. */
+        /* NOTE: Segments which are almost entirely live are left alone, as cleaning them would cost more writes than it saves. */
+        u32 best = InvalidSegment;
+        for (u32 segment = 0; segment < m_num_segments; ++segment) {
+            const u32 num_live = m_segment_live_slots[segment];
+            if (segment == m_head_segment || num_live == 0 || num_live > MaxLiveSlotsToClean) {
+                continue;
+            }
+
+            if (best == InvalidSegment || num_live < m_segment_live_slots[best]) {
+                best = segment;
+            }
+        }
+
+        if (best == InvalidSegment) {
+            return false;
+        }
+
+        *out_segment = best;
+        return true;
+    }
+
+    s32 SwapPartition::GetLiveSlots(u64 *out_sector_offsets, u32 segment, u32 *inout_index, s32 max_count) const {
+        AMS_ASSERT(segment < m_num_segments);
+
+        /* Collect the segment's allocated slots, starting from where the caller left off. */
+        s32 count = 0;
+        u32 index = *inout_index;
+        while (index < SlotsPerSegment && count < max_count) {
+            const u32 slot = segment * SlotsPerSegment + index++;
+            if (this->IsAllocated(slot)) {
+                out_sector_offsets[count++] = this->GetSectorOffset(slot);
+            }
+        }
+
+        *inout_index = index;
+        return count;
+    }
+
+    Result SwapPartition::ReadPages(void *dst, u64 sector_offset, size_t num_pages) {
+        /* Validate the slots. */
+        u32 first_slot;
+        R_UNLESS(this->GetSlot(std::addressof(first_slot), sector_offset),   svc::ResultOutOfRange());
+        R_UNLESS(first_slot + num_pages <= m_header.num_slots,               svc::ResultOutOfRange());
+
+        /* Read the pages. */
+        R_TRY(this->ReadSectors(dst, sector_offset, num_pages * ams::svc::SwapSectorsPerPage));
+        m_statistics.num_pages_read += num_pages;
+
+        /* Verify each page against the CRC recorded when it was written. */
+        for (size_t i = 0; i < num_pages; ++i) {
+            const SlotInfo &info = m_slot_infos[first_slot + i];
+            if (CalculateCrc32c(info.generation, static_cast<const u8 *>(dst) + i * ams::svc::SwapPageSize, ams::svc::SwapPageSize) != info.crc) {
+                ++m_statistics.num_verification_failures;
+                R_THROW(fs::ResultDataCorrupted());
+            }
+        }
+
+        R_SUCCEED();
+    }
+
+    Result SwapPartition::WritePages(u64 sector_offset, const void *src, size_t num_pages) {
+        /* Validate the slots. */
+        u32 first_slot;
+        R_UNLESS(this->GetSlot(std::addressof(first_slot), sector_offset),   svc::ResultOutOfRange());
+        R_UNLESS(first_slot + num_pages <= m_header.num_slots,               svc::ResultOutOfRange());
+
+        /* Write the pages. */
+        R_TRY(this->WriteSectors(sector_offset, src, num_pages * ams::svc::SwapSectorsPerPage));
+        m_statistics.num_pages_written += num_pages;
+
+        /* Record each page's CRC, so that it can be verified when it is read back. */
+        for (size_t i = 0; i < num_pages; ++i) {
+            SlotInfo &info = m_slot_infos[first_slot + i];
+            info.crc = CalculateCrc32c(info.generation, static_cast<const u8 *>(src) + i * ams::svc::SwapPageSize, ams::svc::SwapPageSize);
+            SetDirty(m_dirty_slot_info_sectors, (first_slot + i) / SlotInfosPerSector);
+        }
+
+        R_SUCCEED();
+    }
+
+    Result SwapPartition::Flush() {
+        /* Write out the metadata sectors which have changed. */
+        R_TRY(this->FlushDirtySectors(m_dirty_bitmap_sectors, m_header.bitmap_sector, m_bitmap, m_header.bitmap_num_sectors));
+        R_TRY(this->FlushDirtySectors(m_dirty_slot_info_sectors, m_header.slot_info_sector, m_slot_infos, m_header.slot_info_num_sectors));
+
+        R_SUCCEED();
+    }
+
+    bool SwapPartition::GetSlot(u32 *out, u64 sector_offset) const {
+        /* Check that the offset refers to the start of a slot. */
+        if (sector_offset < m_header.data_sector || !util::IsAligned(sector_offset - m_header.data_sector, ams::svc::SwapSectorsPerPage)) {
+            return false;
+        }
+
+        const u64 slot = (sector_offset - m_header.data_sector) / ams::svc::SwapSectorsPerPage;
+        if (slot >= m_header.num_slots) {
+            return false;
+        }
+
+        *out = static_cast<u32>(slot);
+        return true;
+    }
+
+    bool SwapPartition::OpenSegment(bool for_cleaning) {
+        /* Close the head. If everything written to it has since been freed, it's free itself. */
+        const u32 prev = m_head_segment;
+        if (prev != InvalidSegment && m_segment_live_slots[prev] == 0) {
+            ++m_num_free_segments;
+        }
+        m_head_segment = InvalidSegment;
+
+        /* Only cleaning may take the reserved segments. */
+        if (m_num_free_segments <= (for_cleaning ? 0 : NumReservedSegments)) {
+            return false;
+        }
+
+        /* Take the next free segment after the previous head, so that writes sweep the whole partition and wear it evenly. */
+        const u32 start = (prev != InvalidSegment) ? prev : m_num_segments - 1;
+        for (u32 i = 1; i <= m_num_segments; ++i) {
+            const u32 segment = (start + i) % m_num_segments;
+            if (m_segment_live_slots[segment] == 0) {
+                m_head_segment   = segment;
+                m_head_num_slots = 0;
+                --m_num_free_segments;
+                return true;
+            }
+        }
+
+        AMS_ABORT("Free segment count is inconsistent");
+    }
+
+    void SwapPartition::MarkRun(u32 slot, u32 count, bool used) {
+        while (count > 0) {
+            /* Update the bits in the current group. */
+            const size_t group = slot / BITSIZEOF(u64);
+            const u32 bit      = slot % BITSIZEOF(u64);
+            const u32 num_bits = std::min<u32>(count, BITSIZEOF(u64) - bit);
+            const u64 mask     = (num_bits == BITSIZEOF(u64) ? ~static_cast<u64>(0) : ((static_cast<u64>(1) << num_bits) - 1)) << bit;
+
+            if (used) {
+                m_bitmap[group] |= mask;
+            } else {
+                m_bitmap[group] &= ~mask;
+            }
+
+            SetDirty(m_dirty_bitmap_sectors, group / BitmapWordsPerSector);
+
+            slot  += num_bits;
+            count -= num_bits;
+        }
+    }
+
+    Result SwapPartition::ReadSectors(void *dst, u64 sector, size_t num_sectors) {
+        R_RETURN(m_storage->Read(static_cast<s64>(sector * ams::svc::SwapSectorSize), dst, num_sectors * ams::svc::SwapSectorSize));
+    }
+
+    Result SwapPartition::WriteSectors(u64 sector, const void *src, size_t num_sectors) {
+        R_RETURN(m_storage->Write(static_cast<s64>(sector * ams::svc::SwapSectorSize), src, num_sectors * ams::svc::SwapSectorSize));
+    }
+
+    Result SwapPartition::FlushDirtySectors(u64 *dirty, u32 sector, const void *src, size_t num_sectors) {
+        /* Write each run of dirty sectors with a single command. */
+        size_t cur = 0;
+        while (cur < num_sectors) {
+            if (!IsDirty(dirty, cur)) {
+                ++cur;
+                continue;
+            }
+
+            size_t count = 1;
+            while (cur + count < num_sectors && IsDirty(dirty, cur + count)) {
+                ++count;
+            }
+
+            R_TRY(this->WriteSectors(sector + cur, static_cast<const u8 *>(src) + cur * ams::svc::SwapSectorSize, count));
+            m_statistics.num_metadata_sectors_written += count;
+
+            for (size_t i = cur; i < cur + count; ++i) {
+                dirty[i / BITSIZEOF(u64)] &= ~(static_cast<u64>(1) << (i % BITSIZEOF(u64)));
+            }
+
+            cur += count;
+        }
+
+        R_SUCCEED();
+    }
+
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+
+namespace ams::swap {
+
+    void ReadaheadTracker::Initialize(s32 readahead_pages) {
+        m_readahead_pages = std::clamp<s32>(readahead_pages, 1, MaxReadaheadPages);
+    }
+
+    void ReadaheadTracker::BeginBatch() {
+        /* Pages read ahead by an earlier batch may have been swapped out again since, so forget them. */
+        for (auto &stream : m_streams) {
+            stream.range_num_pages = 0;
+        }
+    }
+
+    bool ReadaheadTracker::IsPageRead(u64 process_id, u64 page_address) const {
+        /* Check whether the page lies in the range most recently read ahead for the process. */
+        const Stream *stream = this->FindStream(process_id);
+        if (stream == nullptr || stream->range_num_pages == 0) {
+            return false;
+        }
+
+        return stream->range_address <= page_address && page_address < stream->range_address + stream->range_num_pages * ams::svc::SwapPageSize;
+    }
+
+    s32 ReadaheadTracker::GetReadaheadPages(u64 process_id, u64 page_address, u64 swap_offset) const {
+        /* Compressed pages are served from memory, and so aren't worth reading ahead. */
+        if (m_readahead_pages <= 1 || (swap_offset & ams::svc::SwapOffsetCompressedFlag) != 0) {
+            return 1;
+        }
+
+        /* Only read ahead when the process is faulting sequentially. */
+        const Stream *stream = this->FindStream(process_id);
+        return (stream != nullptr && stream->next_address == page_address) ? m_readahead_pages : 1;
+    }
+
+    void ReadaheadTracker::OnPagesRead(u64 process_id, u64 page_address, s32 num_pages) {
+        AMS_ASSERT(0 < num_pages && num_pages <= MaxReadaheadPages);
+
+        Stream *stream = this->AcquireStream(process_id);
+        stream->next_address = page_address + num_pages * ams::svc::SwapPageSize;
+
+        /* Remember any range read ahead, in case other threads faulted on it too. */
+        if (num_pages > 1) {
+            stream->range_address   = page_address;
+            stream->range_num_pages = num_pages;
+        }
+    }
+
+    const ReadaheadTracker::Stream *ReadaheadTracker::FindStream(u64 process_id) const {
+        for (const auto &stream : m_streams) {
+            if (stream.process_id == process_id) {
+                return std::addressof(stream);
+            }
+        }
+
+        return nullptr;
+    }
+
+    ReadaheadTracker::Stream *ReadaheadTracker::AcquireStream(u64 process_id) {
+        /* Find the process's stream, if it has one. */
+        for (auto &stream : m_streams) {
+            if (stream.process_id == process_id) {
+                return std::addressof(stream);
+            }
+        }
+
+        /* Otherwise, replace the least recently started stream. */
+        Stream *stream = std::addressof(m_streams[m_next_stream]);
+        m_next_stream = (m_next_stream + 1) % NumStreams;
+
+        *stream = {};
+        stream->process_id = process_id;
+        return stream;
+    }
+
+}
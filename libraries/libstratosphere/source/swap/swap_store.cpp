@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+
+namespace ams::swap {
+
+    void SwapStore::Initialize(SwapPartition *partition, CompressedPool *pool, RelocateFunction relocate) {
+        m_partition = partition;
+        m_pool      = pool;
+        m_relocate  = relocate;
+    }
+
+    void SwapStore::WriteBatch(ams::svc::SwapEvictionCompletion *out_completions, const ams::svc::SwapEvictionInfo *infos, void *pages, s32 count) {
+        AMS_ASSERT(0 <= count && count <= MaxBatchPages);
+
+        u8 *buffer = static_cast<u8 *>(pages);
+
+        /* Keep every page which compresses well in the compressed pool, moving its oldest pages out to make room as needed. */
+        /* Pack the rest at the front of the buffer, in order, so that they can be written together.                          */
+        s32 num_completed = 0;
+        s32 num_writes    = 0;
+        bool can_write_back = true;
+        for (s32 i = 0; i < count; ++i) {
+            /* NOTE: If the pool's pages can't be moved out, the pages which don't fit are simply written instead. */
+            if (can_write_back && !this->PoolHasRoom()) {
+                can_write_back = R_SUCCEEDED(this->WriteBackPool());
+            }
+
+            u64 key;
+            size_t size;
+            bool stored;
+            {
+                std::scoped_lock lk(m_mutex);
+                stored = m_pool->Store(std::addressof(key), std::addressof(size), infos[i].process_id, infos[i].address, buffer + i * ams::svc::SwapPageSize);
+            }
+
+            if (stored) {
+                out_completions[num_completed++] = { .id = infos[i].id, .status = ams::svc::SwapEvictionStatus_Compressed, .stored_size = static_cast<u32>(size), .reserved = 0, .sector_offset = key };
+            } else {
+                if (num_writes != i) {
+                    std::memcpy(buffer + num_writes * ams::svc::SwapPageSize, buffer + i * ams::svc::SwapPageSize, ams::svc::SwapPageSize);
+                }
+                m_order[num_writes++] = static_cast<u16>(i);
+            }
+        }
+
+        /* Append the rest to the log, with a single command for each run of slots. */
+        /* NOTE: A run only ends early at the end of a segment, so the batch is written almost entirely sequentially. */
+        s32 cur = 0;
+        while (cur < num_writes) {
+            u64 sector_offset = 0;
+            u32 num_slots;
+            {
+                std::scoped_lock lk(m_mutex);
+                num_slots = m_partition->AllocateRun(std::addressof(sector_offset), num_writes - cur);
+            }
+
+            /* NOTE: Nothing refers to the slots until their completions are posted, so they can be written without the lock. */
+            Result result = svc::ResultOutOfResource();
+            if (num_slots > 0) {
+                result = m_partition->WritePages(sector_offset, buffer + cur * ams::svc::SwapPageSize, num_slots);
+            }
+
+            /* Record the outcome for every page in the run. If the partition is full, every remaining page fails. */
+            std::scoped_lock lk(m_mutex);
+            if (num_slots > 0 && R_FAILED(result)) {
+                m_partition->FreeRun(sector_offset, num_slots);
+            }
+
+            const s32 num_pages = (num_slots > 0) ? static_cast<s32>(num_slots) : (num_writes - cur);
+            for (s32 i = 0; i < num_pages; ++i) {
+                const auto &info = infos[m_order[cur + i]];
+                if (R_SUCCEEDED(result)) {
+                    const u64 page_offset = sector_offset + i * ams::svc::SwapSectorsPerPage;
+                    m_partition->SetOwner(page_offset, info.process_id, info.address);
+                    out_completions[num_completed++] = { .id = info.id, .status = ams::svc::SwapEvictionStatus_Written, .stored_size = static_cast<u32>(ams::svc::SwapPageSize), .reserved = 0, .sector_offset = page_offset };
+                } else {
+                    out_completions[num_completed++] = { .id = info.id, .status = ams::svc::SwapEvictionStatus_Failed, .stored_size = 0, .reserved = 0, .sector_offset = 0 };
+                }
+            }
+
+            cur += num_pages;
+        }
+    }
+
+    Result SwapStore::ReadPages(void *dst, u64 swap_offset, s32 num_pages) {
+        /* Read the pages, from the compressed pool if the page is held there. */
+        if ((swap_offset & ams::svc::SwapOffsetCompressedFlag) != 0) {
+            AMS_ASSERT(num_pages == 1);
+            R_UNLESS(m_pool->Load(dst, swap_offset & ~ams::svc::SwapOffsetCompressedFlag), svc::ResultNotFound());
+        } else {
+            R_TRY(m_partition->ReadPages(dst, swap_offset, num_pages));
+        }
+
+        R_SUCCEED();
+    }
+
+    Result SwapStore::ReadCurrentPages(void *dst, u64 swap_offset, u64 process_id, u64 address, s32 num_pages) {
+        std::scoped_lock lk(m_mutex);
+
+        /* Check that the pages still live where the offset says; they may have been moved since the offset was read. */
+        /* NOTE: Holding the lock until they've been read keeps them from being moved again, and their slots rewritten, meanwhile. */
+        if ((swap_offset & ams::svc::SwapOffsetCompressedFlag) != 0) {
+            R_UNLESS(m_pool->IsOwnedBy(swap_offset & ~ams::svc::SwapOffsetCompressedFlag, process_id, address), svc::ResultNotFound());
+        } else {
+            for (s32 i = 0; i < num_pages; ++i) {
+                R_UNLESS(m_partition->IsOwnedBy(swap_offset + i * ams::svc::SwapSectorsPerPage, process_id, address + i * ams::svc::SwapPageSize), svc::ResultNotFound());
+            }
+        }
+
+        R_RETURN(this->ReadPages(dst, swap_offset, num_pages));
+    }
+
+    void SwapStore::Release(const u64 *swap_offsets, s32 count) {
+        /* Free the pages' slots, or the copies held in the compressed pool. */
+        std::scoped_lock lk(m_mutex);
+        for (s32 i = 0; i < count; ++i) {
+            this->ReleaseOffset(swap_offsets[i]);
+        }
+    }
+
+    bool SwapStore::IsFull() const {
+        /* NOTE: The compressed pool can only make room by moving pages out to the partition, so only the partition's space counts. */
+        return m_partition->IsFull();
+    }
+
+    Result SwapStore::Clean() {
+        /* Once free segments run low, pick the segment to clean, and keep at it until every page has been moved out of it. */
+        if (!m_cleaning) {
+            if (!m_partition->NeedsCleaning() || !m_partition->SelectSegmentToClean(std::addressof(m_clean_segment))) {
+                R_SUCCEED();
+            }
+
+            m_clean_index = 0;
+            m_cleaning    = true;
+        }
+
+        /* Take the segment's next live pages. */
+        const s32 count = m_partition->GetLiveSlots(m_sector_offsets, m_clean_segment, std::addressof(m_clean_index), MaxMovePages);
+        if (m_clean_index == SwapPartition::SlotsPerSegment) {
+            m_cleaning = false;
+        }
+
+        /* Read them, a run of neighbouring slots at a time. */
+        /* NOTE: A page which fails verification is left where it is; its fault would fail the same way wherever it lived. */
+        s32 num_pages = 0;
+        s32 cur = 0;
+        while (cur < count) {
+            s32 run_pages = 1;
+            while (cur + run_pages < count && m_sector_offsets[cur + run_pages] == m_sector_offsets[cur] + run_pages * ams::svc::SwapSectorsPerPage) {
+                ++run_pages;
+            }
+
+            u8 *run_buffer = m_move_buffer + num_pages * ams::svc::SwapPageSize;
+            const bool run_read = R_SUCCEEDED(m_partition->ReadPages(run_buffer, m_sector_offsets[cur], run_pages));
+
+            for (s32 i = 0; i < run_pages; ++i) {
+                const u64 sector_offset = m_sector_offsets[cur + i];
+                u8 *page = m_move_buffer + num_pages * ams::svc::SwapPageSize;
+
+                /* Pack the page after the ones before it. If its run failed to read, read it on its own, to find out whether it's bad. */
+                if (run_read) {
+                    if (page != run_buffer + i * ams::svc::SwapPageSize) {
+                        std::memmove(page, run_buffer + i * ams::svc::SwapPageSize, ams::svc::SwapPageSize);
+                    }
+                } else if (R_FAILED(m_partition->ReadPages(page, sector_offset, 1))) {
+                    continue;
+                }
+
+                u64 process_id, address;
+                if (!m_partition->GetOwner(std::addressof(process_id), std::addressof(address), sector_offset)) {
+                    continue;
+                }
+
+                m_relocations[num_pages++] = { .process_id = process_id, .address = address, .old_offset = sector_offset, .new_offset = 0 };
+            }
+
+            cur += run_pages;
+        }
+
+        /* Append them to the head of the log. */
+        if (num_pages > 0) {
+            R_TRY(this->MovePages(num_pages, true));
+            R_TRY(m_partition->Flush());
+        }
+
+        R_SUCCEED();
+    }
+
+    Result SwapStore::Flush() {
+        R_RETURN(m_partition->Flush());
+    }
+
+    Result SwapStore::WriteBackPool() {
+        /* Move the pool's oldest pages out to the partition together, so that they're written with a single command. */
+        s32 count;
+        {
+            std::scoped_lock lk(m_mutex);
+            count = m_pool->PeekOldest(m_relocations, m_move_buffer, MaxMovePages);
+        }
+        R_UNLESS(count > 0, svc::ResultOutOfResource());
+
+        R_RETURN(this->MovePages(count, false));
+    }
+
+    Result SwapStore::MovePages(s32 count, bool for_cleaning) {
+        AMS_ASSERT(0 < count && count <= MaxMovePages);
+
+        /* Append the pages in the move buffer to the log. */
+        s32 num_placed = 0;
+        ON_RESULT_FAILURE {
+            std::scoped_lock lk(m_mutex);
+            for (s32 i = 0; i < num_placed; ++i) {
+                m_partition->Free(m_relocations[i].new_offset);
+            }
+        };
+
+        while (num_placed < count) {
+            u64 sector_offset;
+            u32 num_slots;
+            {
+                std::scoped_lock lk(m_mutex);
+                num_slots = m_partition->AllocateRun(std::addressof(sector_offset), count - num_placed, for_cleaning);
+            }
+            R_UNLESS(num_slots > 0, svc::ResultOutOfResource());
+
+            if (const auto result = m_partition->WritePages(sector_offset, m_move_buffer + num_placed * ams::svc::SwapPageSize, num_slots); R_FAILED(result)) {
+                std::scoped_lock lk(m_mutex);
+                m_partition->FreeRun(sector_offset, num_slots);
+                R_THROW(result);
+            }
+
+            for (u32 i = 0; i < num_slots; ++i) {
+                m_relocations[num_placed++].new_offset = sector_offset + i * ams::svc::SwapSectorsPerPage;
+            }
+        }
+
+        /* Have the kernel point the pages at their new slots. */
+        u64 relocated_mask;
+        R_TRY(m_relocate(std::addressof(relocated_mask), m_relocations, count));
+
+        std::scoped_lock lk(m_mutex);
+        for (s32 i = 0; i < count; ++i) {
+            const auto &relocation = m_relocations[i];
+            if ((relocated_mask & (static_cast<u64>(1) << i)) != 0) {
+                /* The page now lives in its new slot, so its old copy can go. */
+                m_partition->SetOwner(relocation.new_offset, relocation.process_id, relocation.address);
+                this->ReleaseOffset(relocation.old_offset);
+            } else {
+                /* The page was swapped back in while we were moving it; the kernel releases its old offset itself. */
+                m_partition->Free(relocation.new_offset);
+            }
+        }
+
+        R_SUCCEED();
+    }
+
+    bool SwapStore::PoolHasRoom() {
+        std::scoped_lock lk(m_mutex);
+        return m_pool->HasRoom();
+    }
+
+    void SwapStore::ReleaseOffset(u64 swap_offset) {
+        /* Discarded pages have nothing to release. */
+        if ((swap_offset & ams::svc::SwapOffsetDiscardedFlag) != 0) {
+            return;
+        }
+
+        if ((swap_offset & ams::svc::SwapOffsetCompressedFlag) != 0) {
+            m_pool->Discard(swap_offset & ~ams::svc::SwapOffsetCompressedFlag);
+        } else {
+            m_partition->Free(swap_offset);
+        }
+    }
+
+}
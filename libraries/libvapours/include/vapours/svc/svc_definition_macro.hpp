@@ -145,8 +145,25 @@
     HANDLER(0x90, Result,  MapInsecurePhysicalMemory,      INPUT(::ams::svc::Address, address), INPUT(::ams::svc::Size, size))                                                                                                                                                                                         \
     HANDLER(0x91, Result,  UnmapInsecurePhysicalMemory,    INPUT(::ams::svc::Address, address), INPUT(::ams::svc::Size, size))                                                                                                                                                                                         \
     HANDLER(0x92, Result,  GetSwapRequest,                 OUTPUT(uint64_t, out_process_id), OUTPUT(uint64_t, out_thread_id), OUTPUT(::ams::svc::Address, out_vaddr))                                                                                                                                                  \
-    HANDLER(0x93, Result,  MarkAsResidentAndWake,          INPUT(uint64_t, process_id), INPUT(uint64_t, thread_id), INPUT(::ams::svc::Address, vaddr), INPUT(::ams::svc::PhysicalAddress, paddr))                                                                                                                      \
+    HANDLER(0x93, Result,  MarkAsResidentAndWake,          INPUT(uint64_t, process_id), INPUT(uint64_t, thread_id), INPUT(::ams::svc::Address, vaddr), INPUT(::ams::svc::Address, buffer))                                                                                                                             \
     HANDLER(0x94, Result,  RegisterSwapEvent,              INPUT(::ams::svc::Handle, event_handle))                                                                                                                                                                                                                    \
+    HANDLER(0x95, Result,  EvictSwapPages,                 OUTPUT(int32_t, out_num_evicted), INPUT(uint64_t, process_id), INPUT(::ams::svc::Address, address), INPUT(::ams::svc::Size, size))                                                                                                                          \
+    HANDLER(0x96, Result,  GetSwapEvictions,               OUTPUT(int32_t, out_num_evictions), OUTPTR(::ams::svc::SwapEvictionInfo, out_infos), INPUT(::ams::svc::Address, buffer), INPUT(int32_t, max_count))                                                                                                         \
+    HANDLER(0x97, Result,  CompleteSwapEvictions,          INPTR(::ams::svc::SwapEvictionCompletion, completions), INPUT(int32_t, num_completions))                                                                                                                                                                    \
+    HANDLER(0x98, Result,  RegisterSwapFaultRings,         INPUT(::ams::svc::Address, request_ring), INPUT(::ams::svc::Address, completion_ring))                                                                                                                                                                      \
+    HANDLER(0x99, Result,  CompleteSwapFaults,             OUTPUT(int32_t, out_num_completed))                                                                                                                                                                                                                         \
+    HANDLER(0x9A, Result,  GetSwapCandidates,              OUTPUT(int32_t, out_num_candidates), OUTPTR(uint64_t, out_addresses), INPUT(uint64_t, process_id), INPUT(int32_t, max_count))                                                                                                                               \
+    HANDLER(0x9B, Result,  GetSwapReadaheadSize,           OUTPUT(int32_t, out_num_pages), INPUT(uint64_t, process_id), INPUT(::ams::svc::Address, address), INPUT(int32_t, max_pages))                                                                                                                                \
+    HANDLER(0x9C, Result,  CompleteSwapFaultRange,         OUTPUT(int32_t, out_num_installed), INPTR(::ams::svc::SwapFaultRequest, request), INPUT(::ams::svc::Address, buffer), INPUT(int32_t, num_pages))                                                                                                            \
+    HANDLER(0x9D, Result,  GetReleasedSwapOffsets,         OUTPUT(int32_t, out_num_offsets), OUTPTR(uint64_t, out_offsets), INPUT(int32_t, max_count))                                                                                                                                                                 \
+    HANDLER(0x9E, Result,  GetSwappedPages,                OUTPUT(int32_t, out_num_pages), OUTPTR(::ams::svc::SwapPageInfo, out_infos), INPUT(uint64_t, process_id), INPUT(::ams::svc::Address, address), INPUT(int32_t, max_count))                                                                                   \
+    HANDLER(0x9F, Result,  RestoreSwappedPages,            OUTPUT(int32_t, out_num_restored), INPUT(uint64_t, process_id), INPTR(::ams::svc::SwapPageInfo, infos), INPUT(::ams::svc::Address, buffer), INPUT(int32_t, num_pages))                                                                                      \
+    HANDLER(0xA0, Result,  GetSwapReclaimRequest,          OUTPTR(::ams::svc::SwapReclaimRequest, out_request))                                                                                                                                                                                                        \
+    HANDLER(0xA1, Result,  GetSwapActivityRequest,         OUTPTR(::ams::svc::SwapActivityRequest, out_request))                                                                                                                                                                                                       \
+    HANDLER(0xA2, Result,  GetResidentSwapPages,           OUTPUT(int32_t, out_num_pages), OUTPTR(uint64_t, out_addresses), INPUT(uint64_t, process_id), INPUT(::ams::svc::Address, address), INPUT(int32_t, max_count))                                                                                               \
+    HANDLER(0xA3, Result,  RelocateSwappedPages,           OUTPUT(uint64_t, out_relocated_mask), INPTR(::ams::svc::SwapRelocation, relocations), INPUT(int32_t, num_relocations))                                                                                                                                      \
+    HANDLER(0xA4, Result,  MapSwapInFrames,                OUTPUT(::ams::svc::Address, out_address), INPUT(uint64_t, process_id), INPUT(int32_t, num_pages))                                                                                                                                                           \
+    HANDLER(0xA5, Result,  UnmapSwapInFrames,              INPUT(::ams::svc::Address, address), INPUT(int32_t, num_pages))                                                                                                                                                                                             \
                                                                                                                                                                                                                                                                                                                        \
     HANDLER(0x2E, Result,  LegacyGetFutureThreadInfo,      OUTPUT(::ams::svc::NAMESPACE::LastThreadContext, out_context), OUTPUT(::ams::svc::Address, out_tls_address), OUTPUT(uint32_t, out_flags), INPUT(int64_t, ns))                                                                                               \
     HANDLER(0x55, Result,  LegacyQueryIoMapping,           OUTPUT(::ams::svc::Address, out_address), INPUT(::ams::svc::PhysicalAddress, physical_address), INPUT(::ams::svc::Size, size))                                                                                                                              \
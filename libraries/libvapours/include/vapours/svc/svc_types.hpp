@@ -23,4 +23,6 @@
 #include <vapours/svc/svc_types_dd.hpp>
 #include <vapours/svc/svc_types_dmnt.hpp>
 #include <vapours/svc/svc_types_priv.hpp>
+#include <vapours/svc/svc_types_swap.hpp>
+#include <vapours/svc/svc_types_trace.hpp>
 #include <vapours/svc/svc_select_io_pool_type.hpp>
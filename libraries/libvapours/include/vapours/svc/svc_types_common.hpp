@@ -196,6 +196,7 @@ namespace ams::svc {
 
         InfoType_MesosphereMeta                 = 65000,
         InfoType_MesosphereCurrentProcess       = 65001,
+        InfoType_MesosphereSwapStatistics       = 65002,
     };
 
     enum TickCountInfo : u64 {
@@ -533,8 +534,9 @@ namespace ams::svc {
     };
 
     enum KernelTraceState : u32 {
-        KernelTraceState_Disabled = 0,
-        KernelTraceState_Enabled  = 1,
+        KernelTraceState_Disabled        = 0,
+        KernelTraceState_Enabled         = 1,
+        KernelTraceState_EnabledAndReset = 2,
     };
 
     enum BreakPointType : u32 {
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <vapours/common.hpp>
+
+namespace ams::svc {
+
+    /* NOTE: Swap structures are shared between the kernel and sys-swap, and have identical layout for all ABIs. */
+
+    constexpr inline size_t SwapSectorSize     = 0x200;
+    constexpr inline size_t SwapPageSize       = 0x1000;
+    constexpr inline size_t SwapSectorsPerPage = SwapPageSize / SwapSectorSize;
+
+    /* NOTE: A page's swap offset is the sector offset sys-swap wrote it to, chosen when the write completes. A page kept */
+    /* in sys-swap's compressed tier instead has the compressed flag set, and its offset only identifies it in the tier. */
+    constexpr inline u64 SwapOffsetCompressedFlag = UINT64_C(1) << 35;
+
+    /* NOTE: A discarded page was dropped without being written, as it can be read back from the module it was loaded from. */
+    /* It has no sectors, so its offset with this flag set only serves to identify it.                                      */
+    constexpr inline u64 SwapOffsetDiscardedFlag = UINT64_C(1) << 34;
+
+    enum SwapEvictionStatus : u32 {
+        SwapEvictionStatus_Written    = 0,
+        SwapEvictionStatus_Failed     = 1,
+        SwapEvictionStatus_Compressed = 2,
+        SwapEvictionStatus_Discarded  = 3,
+    };
+
+    /* NOTE: A clean eviction is a page of static code or read-only data which is unchanged since it was loaded, */
+    /* so sys-swap may discard it instead of writing it, if it knows where the page was loaded from.            */
+    enum SwapEvictionFlag : u32 {
+        SwapEvictionFlag_None  = 0,
+        SwapEvictionFlag_Clean = (1u << 0),
+    };
+
+    struct SwapEvictionInfo {
+        u64 process_id;
+        u64 address;
+        u64 reserved;
+        u32 id;
+        u32 flags;
+    };
+    static_assert(sizeof(SwapEvictionInfo) == 0x20);
+
+    /* NOTE: stored_size is the number of bytes sys-swap stored for the page: its compressed size, if it was compressed. */
+    /* sector_offset is where the page was placed, without any flags; the kernel adds the flag for the status itself.  */
+    struct SwapEvictionCompletion {
+        u32 id;
+        SwapEvictionStatus status;
+        u32 stored_size;
+        u32 reserved;
+        u64 sector_offset;
+    };
+    static_assert(sizeof(SwapEvictionCompletion) == 0x18);
+
+    /* NOTE: Fault rings are single-producer/single-consumer rings occupying one page each. */
+    /* head and tail are free-running indices; an entry's slot is its index modulo capacity. */
+    constexpr inline size_t SwapFaultRingSize     = 0x1000;
+    constexpr inline size_t SwapFaultRingCapacity = 0x40;
+
+    struct SwapFaultRingHeader {
+        u32 head;
+        u32 tail;
+        u32 capacity;
+        u32 reserved[5];
+    };
+    static_assert(sizeof(SwapFaultRingHeader) == 0x20);
+
+    struct SwapFaultRequest {
+        u64 process_id;
+        u64 thread_id;
+        u64 address;
+        u64 sector_offset;
+    };
+    static_assert(sizeof(SwapFaultRequest) == 0x20);
+
+    /* NOTE: A fault whose page sys-swap can't read back fails, and the kernel terminates the faulting process, */
+    /* as its thread could otherwise never be resumed.                                                          */
+    enum SwapFaultStatus : u32 {
+        SwapFaultStatus_Resolved = 0,
+        SwapFaultStatus_Failed   = 1,
+    };
+
+    /* NOTE: buffer is the address of the swap-in frame the page was read into, or zero if the page is already */
+    /* resident, and only the thread needs waking. It is always zero for a failed fault.                       */
+    struct SwapFaultCompletion {
+        u64 process_id;
+        u64 thread_id;
+        u64 address;
+        u64 buffer;
+        SwapFaultStatus status;
+        u32 reserved;
+    };
+    static_assert(sizeof(SwapFaultCompletion) == 0x28);
+
+    struct SwapFaultRequestRing {
+        SwapFaultRingHeader header;
+        SwapFaultRequest entries[SwapFaultRingCapacity];
+    };
+    static_assert(sizeof(SwapFaultRequestRing) <= SwapFaultRingSize);
+
+    struct SwapFaultCompletionRing {
+        SwapFaultRingHeader header;
+        SwapFaultCompletion entries[SwapFaultRingCapacity];
+    };
+    static_assert(sizeof(SwapFaultCompletionRing) <= SwapFaultRingSize);
+
+    /* NOTE: A fault may be resolved together with the swapped pages which follow it, when their sectors are contiguous. */
+    constexpr inline size_t SwapReadaheadMaxPages = 0x20;
+
+    /* NOTE: sys-swap reads pages into swap-in frames, which the kernel allocates from the faulting process's pool and  */
+    /* maps into sys-swap where a device can access them. Completing a fault moves the frame into the faulting process. */
+    constexpr inline size_t SwapInMaxPages = SwapReadaheadMaxPages;
+
+    /* NOTE: Swap statistics are read with GetInfo(InfoType_MesosphereSwapStatistics) on a process handle. */
+    /* Bucket 0 of the fault latency histogram counts faults resolved within a microsecond; bucket N > 0   */
+    /* counts those which took [2^(N-1), 2^N) microseconds. The last bucket also counts anything slower.  */
+    constexpr inline size_t SwapFaultLatencyBucketCount = 24;
+
+    enum SwapStatisticsInfo : u64 {
+        SwapStatisticsInfo_Faults                = 0,
+        SwapStatisticsInfo_MajorFaults           = 1,
+        SwapStatisticsInfo_PagesIn               = 2,
+        SwapStatisticsInfo_PagesOut              = 3,
+        SwapStatisticsInfo_BytesWritten          = 4,
+
+        SwapStatisticsInfo_FaultLatencyHistogram = 0x100,
+    };
+
+    /* NOTE: To revert swap, sys-swap lists a process's swapped pages, reads them back, and hands the contents */
+    /* to the kernel, which copies them into frames from the process's pool and maps them in one pass.       */
+    constexpr inline size_t SwapRestoreMaxPages = 0x20;
+
+    struct SwapPageInfo {
+        u64 address;
+        u64 swap_offset;
+    };
+    static_assert(sizeof(SwapPageInfo) == 0x10);
+
+    /* NOTE: sys-swap writes pages to its partition as a log, so it moves the pages which are still live out of old */
+    /* segments before reusing them. The kernel only moves a page which is still swapped out at its old offset.    */
+    constexpr inline size_t SwapRelocateMaxPages = 0x40;
+
+    struct SwapRelocation {
+        u64 process_id;
+        u64 address;
+        u64 old_offset;
+        u64 new_offset;
+    };
+    static_assert(sizeof(SwapRelocation) == 0x20);
+
+    /* NOTE: When the application or applet pool runs low, the kernel asks sys-swap to evict cold pages from */
+    /* the processes whose memory is in that pool, and has the allocation wait a bounded time for them.      */
+    constexpr inline size_t SwapReclaimMaxProcesses = 8;
+
+    struct SwapReclaimRequest {
+        u32 num_pages;
+        u32 num_processes;
+        u64 process_ids[SwapReclaimMaxProcesses];
+    };
+    static_assert(sizeof(SwapReclaimRequest) == 0x48);
+
+    /* NOTE: When an applet process is paused it's in the background, so sys-swap may swap out its entire working set */
+    /* ("freeze" it), and read that set back in bulk ("thaw" it) once the process is made runnable again.            */
+    constexpr inline size_t SwapFreezeMaxPages = 0x100;
+
+    enum SwapActivityKind : u32 {
+        SwapActivityKind_Freeze = 0,
+        SwapActivityKind_Thaw   = 1,
+    };
+
+    struct SwapActivityRequest {
+        u64 process_id;
+        SwapActivityKind kind;
+        u32 reserved;
+    };
+    static_assert(sizeof(SwapActivityRequest) == 0x10);
+
+}
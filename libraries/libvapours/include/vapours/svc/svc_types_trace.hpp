@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <vapours/svc/svc_types_common.hpp>
+
+namespace ams::svc {
+
+    /* NOTE: Kernel trace structures are laid out in the buffer mapped by the KernelTraceBuffer memory region capability, */
+    /* and have identical layout for all ABIs. The buffer starts with a header, followed by one ring per core.            */
+
+    enum KernelTraceRecordType : u8 {
+        KernelTraceRecordType_ThreadSwitch       =  1,
+
+        KernelTraceRecordType_SvcEntry0          =  3,
+        KernelTraceRecordType_SvcEntry1          =  4,
+        KernelTraceRecordType_SvcExit0           =  5,
+        KernelTraceRecordType_SvcExit1           =  6,
+        KernelTraceRecordType_Interrupt          =  7,
+
+        KernelTraceRecordType_ScheduleUpdate     = 11,
+
+        KernelTraceRecordType_CoreMigration      = 14,
+
+        KernelTraceRecordType_IpcSend            = 16,
+        KernelTraceRecordType_IpcReply           = 17,
+        KernelTraceRecordType_PageFault          = 18,
+        KernelTraceRecordType_SwapFault          = 19,
+        KernelTraceRecordType_SwapFaultResolved  = 20,
+    };
+
+    /* NOTE: generation is advanced by KernelTraceState_EnabledAndReset. */
+    struct KernelTraceHeader {
+        u32 magic;
+        u32 num_rings;
+        u32 ring_offset;
+        u32 ring_size;
+        u32 generation;
+        u32 reserved[3];
+
+        static constexpr u32 Magic = util::FourCC<'K','T','R','1'>::Code;
+    };
+    static_assert(sizeof(KernelTraceHeader) == 0x20);
+
+    /* NOTE: Each ring is written only by its own core, with interrupts disabled, so that no lock is needed.             */
+    /* After a reset, each core sets its ring's head back to zero on its next push, and only then stores the header's    */
+    /* generation to the ring's, with release ordering. A ring whose generation (loaded with acquire ordering) differs   */
+    /* from the header's holds only records from before the reset, and the reader treats it as empty.                    */
+    /* head is the free-running index of the next record, stored with release ordering once that record is written.      */
+    /* A record's slot is its index modulo count. To stream, a reader keeps its own tail, and loads head with acquire    */
+    /* ordering. If head - tail exceeds count, the records in between were overwritten and the reader resumes at         */
+    /* head - count. After copying the records in [tail, head), the reader loads head again as new_head; any copied      */
+    /* record whose index is not above new_head - count may have been overwritten while it was copied, and is discarded. */
+    /* If head is ever below tail, the ring was reset, and the reader resumes at zero.                                   */
+    struct KernelTraceRingHeader {
+        u64 head;
+        u32 count;
+        u32 core_id;
+        u32 generation;
+        u32 reserved0;
+        u64 reserved[5];
+    };
+    static_assert(sizeof(KernelTraceRingHeader) == 0x40);
+
+    struct KernelTraceRecord {
+        u8 core_id;
+        u8 type;
+        u16 process_id;
+        u32 thread_id;
+        u64 tick;
+        u64 data[6];
+    };
+    static_assert(sizeof(KernelTraceRecord) == 0x40);
+
+}
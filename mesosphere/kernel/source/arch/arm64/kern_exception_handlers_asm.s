@@ -423,6 +423,12 @@ _ZN3ams4kern4arch5arm6430EL1SynchronousExceptionHandlerEv:
     cmp     x1, x0
     b.hs    2f
 
+    /* Access flag faults may have been caused by the working set sweeper, and so are resolved by HandleException. */
+    mrs     x0, esr_el1
+    and     x0, x0, #0x3C
+    cmp     x0, #0x8
+    b.eq    2f
+
     /* We aborted trying to access userspace memory. */
     /* All functions that access user memory return a boolean for whether they succeeded. */
     /* With that in mind, we can simply restore the stack pointer and return false directly. */
@@ -112,9 +112,7 @@ namespace ams::kern {
     KThread &Kernel::GetIdleThread(s32 core_id) { return g_idle_threads.m_arr[core_id]; }
 
     /* Swap signaling objects. */
-    KThread *g_SwapRequestListHead = nullptr;
-    KThread *g_SwapRequestListTail = nullptr;
-    KEvent  *g_SwapEvent           = nullptr;
+    KEvent *g_SwapEvent = nullptr;
 
     __attribute__((constructor)) void ConfigureKTargetSystem() {
         KSystemControl::ConfigureKTargetSystem();
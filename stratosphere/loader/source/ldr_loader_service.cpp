@@ -118,6 +118,16 @@ namespace ams::ldr {
         R_RETURN(ldr::GetProcessModuleInfo(out_count, out, max_out_count, process_id));
     }
 
+    Result LoaderService::GetReloadableModuleInfo(u32 *out_count, ModuleInfo *out, size_t max_out_count, os::ProcessId process_id) {
+        *out_count = 0;
+        std::memset(out, 0, max_out_count * sizeof(*out));
+        R_RETURN(ldr::GetReloadableModuleInfo(out_count, out, max_out_count, process_id));
+    }
+
+    Result LoaderService::ReadModulePages(void *dst, size_t size, os::ProcessId process_id, u64 address) {
+        R_RETURN(ldr::ReadModulePages(dst, size, process_id, address));
+    }
+
     Result LoaderService::RegisterExternalCode(os::NativeHandle *out, ncm::ProgramId program_id) {
         R_RETURN(fssystem::CreateExternalCode(out, program_id));
     }
@@ -82,12 +82,24 @@ namespace ams::ldr {
             Result AtmospherePinProgram(sf::Out<PinId> out_id, const ncm::ProgramLocation &loc, const cfg::OverrideStatus &override_status) {
                 R_RETURN(this->PinProgram(out_id.GetPointer(), loc, override_status));
             }
+
+            Result AtmosphereGetReloadableModuleInfo(sf::Out<u32> count, const sf::OutPointerArray<ModuleInfo> &out, os::ProcessId process_id) {
+                R_UNLESS(out.GetSize() <= std::numeric_limits<s32>::max(), ldr::ResultInvalidSize());
+
+                R_RETURN(this->GetReloadableModuleInfo(count.GetPointer(), out.GetPointer(), out.GetSize(), process_id));
+            }
+
+            Result AtmosphereReadModulePages(const sf::OutNonSecureBuffer &out, os::ProcessId process_id, u64 address) {
+                R_RETURN(this->ReadModulePages(out.GetPointer(), out.GetSize(), process_id, address));
+            }
         private:
             Result CreateProcess(os::NativeHandle *out, PinId pin_id, u32 flags, os::NativeHandle resource_limit, const ProgramAttributes &attrs);
             Result GetProgramInfo(ProgramInfo *out, cfg::OverrideStatus *out_status, const ncm::ProgramLocation &loc, const ProgramAttributes &attrs);
             Result PinProgram(PinId *out, const ncm::ProgramLocation &loc, const cfg::OverrideStatus &status);
             Result SetProgramArgument(ncm::ProgramId program_id, const void *argument, size_t size);
             Result GetProcessModuleInfo(u32 *out_count, ModuleInfo *out, size_t max_out_count, os::ProcessId process_id);
+            Result GetReloadableModuleInfo(u32 *out_count, ModuleInfo *out, size_t max_out_count, os::ProcessId process_id);
+            Result ReadModulePages(void *dst, size_t size, os::ProcessId process_id, u64 address);
             Result RegisterExternalCode(os::NativeHandle *out, ncm::ProgramId program_id);
             void   UnregisterExternalCode(ncm::ProgramId program_id);
             void   HasLaunchedBootProgram(bool *out, ncm::ProgramId program_id);
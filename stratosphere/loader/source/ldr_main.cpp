@@ -68,7 +68,7 @@ namespace ams {
             constexpr size_t          ShellMaxSessions = 3;
 
             constexpr sm::ServiceName DebugMonitorServiceName = sm::ServiceName::Encode("ldr:dmnt");
-            constexpr size_t          DebugMonitorMaxSessions = 3;
+            constexpr size_t          DebugMonitorMaxSessions = 4;
 
             constinit sf::UnmanagedServiceObject<impl::IProcessManagerInterface, LoaderService> g_pm_service;
             constinit sf::UnmanagedServiceObject<impl::IShellInterface, LoaderService> g_shell_service;
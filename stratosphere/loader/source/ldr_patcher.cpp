@@ -112,22 +112,24 @@ namespace ams::ldr {
     }
 
     /* Apply IPS patches. */
-    void LocateAndApplyIpsPatchesToModule(const u8 *module_id_data, uintptr_t mapped_nso, size_t mapped_size) {
+    bool LocateAndApplyIpsPatchesToModule(const u8 *module_id_data, uintptr_t mapped_nso, size_t mapped_size) {
         if (!EnsureSdCardMounted()) {
-            return;
+            return false;
         }
 
         ro::ModuleId module_id;
         std::memcpy(std::addressof(module_id.data), module_id_data, sizeof(module_id.data));
-        ams::patcher::LocateAndApplyIpsPatchesToModule(LoaderSdMountName, NsoPatchesDirectory, NsoPatchesProtectedSize, NsoPatchesProtectedOffset, std::addressof(module_id), reinterpret_cast<u8 *>(mapped_nso), mapped_size);
+        return ams::patcher::LocateAndApplyIpsPatchesToModule(LoaderSdMountName, NsoPatchesDirectory, NsoPatchesProtectedSize, NsoPatchesProtectedOffset, std::addressof(module_id), reinterpret_cast<u8 *>(mapped_nso), mapped_size);
     }
 
     /* Apply embedded patches. */
-    void ApplyEmbeddedPatchesToModule(const u8 *module_id_data, uintptr_t mapped_nso, size_t mapped_size) {
+    bool ApplyEmbeddedPatchesToModule(const u8 *module_id_data, uintptr_t mapped_nso, size_t mapped_size) {
         /* Make module id. */
         ro::ModuleId module_id;
         std::memcpy(std::addressof(module_id.data), module_id_data, sizeof(module_id.data));
 
+        bool applied = false;
+
         if (IsUsb30ForceEnabled()) {
             for (const auto &patch : Usb30ForceEnablePatches) {
                 if (std::memcmp(std::addressof(patch.module_id), std::addressof(module_id), sizeof(module_id)) == 0) {
@@ -135,11 +137,14 @@ namespace ams::ldr {
                         const auto &entry = patch.entries[i];
                         if (entry.offset + entry.size <= mapped_size) {
                             std::memcpy(reinterpret_cast<void *>(mapped_nso + entry.offset), entry.data, entry.size);
+                            applied = true;
                         }
                     }
                 }
             }
         }
+
+        return applied;
     }
 
 }
\ No newline at end of file
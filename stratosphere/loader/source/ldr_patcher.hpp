@@ -18,10 +18,10 @@
 
 namespace ams::ldr {
 
-    /* Apply IPS patches. */
-    void LocateAndApplyIpsPatchesToModule(const u8 *module_id_data, uintptr_t mapped_nso, size_t mapped_size);
+    /* Apply IPS patches. Returns whether any patch was applied. */
+    bool LocateAndApplyIpsPatchesToModule(const u8 *module_id_data, uintptr_t mapped_nso, size_t mapped_size);
 
-    /* Apply embedded patches. */
-    void ApplyEmbeddedPatchesToModule(const u8 *module_id_data, uintptr_t mapped_nso, size_t mapped_size);
+    /* Apply embedded patches. Returns whether any patch was applied. */
+    bool ApplyEmbeddedPatchesToModule(const u8 *module_id_data, uintptr_t mapped_nso, size_t mapped_size);
 
 }
\ No newline at end of file
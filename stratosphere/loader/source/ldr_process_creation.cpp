@@ -90,12 +90,22 @@ namespace ams::ldr {
             return NsoPaths[idx];
         }
 
+        constexpr bool IsBrowserCoreDllNso(size_t idx) {
+            return Nso_Wkc0 <= idx && idx <= Nso_Wkc9;
+        }
+
+        constexpr bool IsReloadableStorage(const ncm::ProgramLocation &loc) {
+            const auto storage_id = static_cast<ncm::StorageId>(loc.storage_id);
+            return storage_id != ncm::StorageId::None && storage_id != ncm::StorageId::Host;
+        }
+
         struct ProcessInfo {
             os::NativeHandle process_handle;
             uintptr_t args_address;
             size_t    args_size;
             uintptr_t nso_address[Nso_Count];
             size_t    nso_size[Nso_Count];
+            bool      nso_patched[Nso_Count];
         };
 
         struct AutoLoadModuleInfo {
@@ -520,6 +530,7 @@ namespace ams::ldr {
             out->args_size = 0;
             std::memset(out->nso_address, 0, sizeof(out->nso_address));
             std::memset(out->nso_size, 0, sizeof(out->nso_size));
+            std::memset(out->nso_patched, 0, sizeof(out->nso_patched));
 
             size_t total_size = 0;
             bool argument_allocated = false;
@@ -648,7 +659,7 @@ namespace ams::ldr {
             R_SUCCEED();
         }
 
-        Result LoadAutoLoadModule(os::NativeHandle process_handle, fs::FileHandle file, const NsoHeader *nso_header, uintptr_t nso_address, size_t nso_size) {
+        Result LoadAutoLoadModule(bool *out_patched, os::NativeHandle process_handle, fs::FileHandle file, const NsoHeader *nso_header, uintptr_t nso_address, size_t nso_size) {
             /* Map and read data from file. */
             {
                 /* Map the process memory. */
@@ -676,10 +687,13 @@ namespace ams::ldr {
                 std::memset(reinterpret_cast<void *>(map_address + rw_end),   0, nso_header->bss_size);
 
                 /* Apply embedded patches. */
-                ApplyEmbeddedPatchesToModule(nso_header->module_id, map_address, nso_size);
+                const bool applied_embedded = ApplyEmbeddedPatchesToModule(nso_header->module_id, map_address, nso_size);
 
                 /* Apply IPS patches. */
-                LocateAndApplyIpsPatchesToModule(nso_header->module_id, map_address, nso_size);
+                const bool applied_ips = LocateAndApplyIpsPatchesToModule(nso_header->module_id, map_address, nso_size);
+
+                /* A patched module no longer matches its file. */
+                *out_patched = applied_embedded || applied_ips;
             }
 
             /* Set permissions. */
@@ -700,7 +714,7 @@ namespace ams::ldr {
             R_SUCCEED();
         }
 
-        Result LoadAutoLoadModules(const ProcessInfo *process_info, const NsoHeader *nso_headers, const AutoLoadModuleInfo *ali, const ArgumentStore::Entry *argument) {
+        Result LoadAutoLoadModules(ProcessInfo *process_info, const NsoHeader *nso_headers, const AutoLoadModuleInfo *ali, const ArgumentStore::Entry *argument) {
             /* Load each NSO. */
             for (size_t i = 0; i < Nso_Count; i++) {
                 if (ali->has_nso[i]) {
@@ -708,7 +722,7 @@ namespace ams::ldr {
                     R_TRY(fs::OpenFile(std::addressof(file), GetNsoPath(i), fs::OpenMode_Read));
                     ON_SCOPE_EXIT { fs::CloseFile(file); };
 
-                    R_TRY(LoadAutoLoadModule(process_info->process_handle, file, nso_headers + i, process_info->nso_address[i], process_info->nso_size[i]));
+                    R_TRY(LoadAutoLoadModule(std::addressof(process_info->nso_patched[i]), process_info->process_handle, file, nso_headers + i, process_info->nso_address[i], process_info->nso_size[i]));
                 }
             }
 
@@ -755,6 +769,231 @@ namespace ams::ldr {
             R_RETURN(LoadAutoLoadModules(out, nso_headers, ali, argument));
         }
 
+        /* Module reloading. */
+        /* NOTE: Only the pages being read back are kept; a compressed segment is decoded from its start, through a window */
+        /* large enough for any LZ4 match, so that the segment never needs to be held in memory as a whole. The position   */
+        /* decoding stopped at is remembered, so that reads which move forward through a segment resume from there.        */
+        constexpr size_t ReloadInputBufferSize = 16_KB;
+        constexpr size_t Lz4WindowSize         = 64_KB;
+
+        struct Lz4DecodeCursor {
+            u8 header_hash[crypto::Sha256Generator::HashSize];
+            u32 segment_file_offset;
+            s64 file_offset;
+            size_t file_remaining;
+            size_t input_pos;
+            size_t input_size;
+            size_t out_pos;
+            bool is_valid;
+        };
+
+        alignas(os::MemoryPageSize) constinit u8 g_reload_input_buffer[ReloadInputBufferSize];
+        alignas(os::MemoryPageSize) constinit u8 g_reload_window[Lz4WindowSize];
+
+        constinit Lz4DecodeCursor g_reload_cursor = {};
+
+        class Lz4SegmentReader {
+            NON_COPYABLE(Lz4SegmentReader);
+            NON_MOVEABLE(Lz4SegmentReader);
+            private:
+                Lz4DecodeCursor *m_cursor;
+                fs::FileHandle m_file;
+                s64 m_file_offset;
+                size_t m_file_remaining;
+                size_t m_input_pos;
+                size_t m_input_size;
+                size_t m_out_pos;
+                size_t m_out_size;
+                u8 *m_dst;
+                size_t m_dst_start;
+                size_t m_dst_end;
+            public:
+                Lz4SegmentReader(Lz4DecodeCursor *cursor, fs::FileHandle file, size_t segment_size, u8 *dst, size_t dst_start, size_t dst_end)
+                    : m_cursor(cursor), m_file(file), m_file_offset(cursor->file_offset), m_file_remaining(cursor->file_remaining), m_input_pos(cursor->input_pos), m_input_size(cursor->input_size),
+                      m_out_pos(cursor->out_pos), m_out_size(segment_size), m_dst(dst), m_dst_start(dst_start), m_dst_end(dst_end)
+                {
+                    /* ... */
+                }
+
+                Result Read() {
+                    /* If we fail, the window no longer matches the cursor, so the next read must start over. */
+                    m_cursor->is_valid = false;
+
+                    /* Copy out whatever part of the requested range is still in the window. */
+                    this->CopyFromWindow();
+
+                    /* Decode sequences until the requested range has been produced. */
+                    /* NOTE: We always stop between sequences, so that the next read can resume decoding from here. */
+                    while (m_out_pos < m_dst_end) {
+                        u8 token;
+                        R_TRY(this->ReadByte(std::addressof(token)));
+
+                        /* Copy the sequence's literals. */
+                        size_t literal_size = token >> 4;
+                        if (literal_size == 0xF) {
+                            R_TRY(this->ReadExtendedSize(std::addressof(literal_size)));
+                        }
+                        R_TRY(this->CopyLiterals(literal_size));
+
+                        /* The last sequence has no match. */
+                        if (m_out_pos >= m_out_size) {
+                            break;
+                        }
+
+                        /* Copy the sequence's match. */
+                        u8 offset_bytes[2];
+                        R_TRY(this->ReadByte(offset_bytes + 0));
+                        R_TRY(this->ReadByte(offset_bytes + 1));
+                        const size_t offset = static_cast<size_t>(offset_bytes[0]) | (static_cast<size_t>(offset_bytes[1]) << 8);
+                        R_UNLESS(offset != 0 && offset <= m_out_pos, ldr::ResultInvalidNso());
+
+                        size_t match_size = token & 0xF;
+                        if (match_size == 0xF) {
+                            R_TRY(this->ReadExtendedSize(std::addressof(match_size)));
+                        }
+                        R_TRY(this->CopyMatch(offset, match_size + 4));
+                    }
+
+                    /* Remember where we stopped. */
+                    m_cursor->file_offset    = m_file_offset;
+                    m_cursor->file_remaining = m_file_remaining;
+                    m_cursor->input_pos      = m_input_pos;
+                    m_cursor->input_size     = m_input_size;
+                    m_cursor->out_pos        = m_out_pos;
+                    m_cursor->is_valid       = true;
+                    R_SUCCEED();
+                }
+            private:
+                void CopyFromWindow() {
+                    /* NOTE: The caller only resumes decoding when the start of the requested range is still in the window. */
+                    size_t cur_pos   = m_dst_start;
+                    const size_t end = std::min(m_out_pos, m_dst_end);
+                    while (cur_pos < end) {
+                        const size_t window_pos = cur_pos % Lz4WindowSize;
+                        const size_t cur_size   = std::min(end - cur_pos, Lz4WindowSize - window_pos);
+                        std::memcpy(m_dst + (cur_pos - m_dst_start), g_reload_window + window_pos, cur_size);
+
+                        cur_pos += cur_size;
+                    }
+                }
+
+                Result FillInput() {
+                    R_UNLESS(m_file_remaining > 0, ldr::ResultInvalidNso());
+
+                    const size_t read_size = std::min(m_file_remaining, ReloadInputBufferSize);
+                    R_TRY(fs::ReadFile(m_file, m_file_offset, g_reload_input_buffer, read_size));
+
+                    m_file_offset    += read_size;
+                    m_file_remaining -= read_size;
+                    m_input_pos       = 0;
+                    m_input_size      = read_size;
+                    R_SUCCEED();
+                }
+
+                Result ReadByte(u8 *out) {
+                    if (m_input_pos == m_input_size) {
+                        R_TRY(this->FillInput());
+                    }
+
+                    *out = g_reload_input_buffer[m_input_pos++];
+                    R_SUCCEED();
+                }
+
+                Result ReadExtendedSize(size_t *size) {
+                    u8 byte;
+                    do {
+                        R_TRY(this->ReadByte(std::addressof(byte)));
+                        *size += byte;
+                    } while (byte == 0xFF);
+
+                    R_SUCCEED();
+                }
+
+                void Output(const u8 *src, size_t size) {
+                    /* Keep the data in the window, and copy out whatever falls inside the requested range. */
+                    while (size > 0) {
+                        const size_t window_pos = m_out_pos % Lz4WindowSize;
+                        const size_t cur_size   = std::min(size, Lz4WindowSize - window_pos);
+                        std::memmove(g_reload_window + window_pos, src, cur_size);
+
+                        const size_t copy_start = std::max(m_out_pos, m_dst_start);
+                        const size_t copy_end   = std::min(m_out_pos + cur_size, m_dst_end);
+                        if (copy_start < copy_end) {
+                            std::memcpy(m_dst + (copy_start - m_dst_start), g_reload_window + window_pos + (copy_start - m_out_pos), copy_end - copy_start);
+                        }
+
+                        m_out_pos += cur_size;
+                        src       += cur_size;
+                        size      -= cur_size;
+                    }
+                }
+
+                Result CopyLiterals(size_t size) {
+                    R_UNLESS(size <= m_out_size - m_out_pos, ldr::ResultInvalidNso());
+
+                    while (size > 0) {
+                        if (m_input_pos == m_input_size) {
+                            R_TRY(this->FillInput());
+                        }
+
+                        const size_t cur_size = std::min(size, m_input_size - m_input_pos);
+                        this->Output(g_reload_input_buffer + m_input_pos, cur_size);
+
+                        m_input_pos += cur_size;
+                        size        -= cur_size;
+                    }
+
+                    R_SUCCEED();
+                }
+
+                Result CopyMatch(size_t offset, size_t size) {
+                    R_UNLESS(size <= m_out_size - m_out_pos, ldr::ResultInvalidNso());
+
+                    /* A match may overlap the data it produces, so copy no more than offset bytes at a time. */
+                    while (size > 0) {
+                        const size_t src_pos  = (m_out_pos - offset) % Lz4WindowSize;
+                        const size_t cur_size = std::min({ size, offset, Lz4WindowSize - src_pos });
+                        this->Output(g_reload_window + src_pos, cur_size);
+
+                        size -= cur_size;
+                    }
+
+                    R_SUCCEED();
+                }
+        };
+
+        Result ReadModuleSegment(u8 *dst, size_t dst_offset, size_t dst_size, fs::FileHandle file, const u8 *header_hash, const NsoHeader::SegmentInfo *segment, size_t file_size, bool is_compressed) {
+            /* Determine the part of the segment which was requested. */
+            const size_t start = std::max<size_t>(dst_offset, segment->dst_offset);
+            const size_t end   = std::min<size_t>(dst_offset + dst_size, static_cast<size_t>(segment->dst_offset) + segment->size);
+            R_SUCCEED_IF(start >= end);
+
+            u8 *out = dst + (start - dst_offset);
+            if (is_compressed) {
+                /* Resume decoding where we last stopped, if that was in this segment and the start of the range is still in the window. */
+                const size_t segment_start = start - segment->dst_offset;
+                const bool can_resume = g_reload_cursor.is_valid && g_reload_cursor.segment_file_offset == segment->file_offset &&
+                                        crypto::IsSameBytes(g_reload_cursor.header_hash, header_hash, sizeof(g_reload_cursor.header_hash)) &&
+                                        segment_start + Lz4WindowSize >= g_reload_cursor.out_pos;
+
+                /* Otherwise, decode the segment from its start. */
+                if (!can_resume) {
+                    std::memcpy(g_reload_cursor.header_hash, header_hash, sizeof(g_reload_cursor.header_hash));
+                    g_reload_cursor.segment_file_offset = segment->file_offset;
+                    g_reload_cursor.file_offset         = segment->file_offset;
+                    g_reload_cursor.file_remaining      = file_size;
+                    g_reload_cursor.input_pos           = 0;
+                    g_reload_cursor.input_size          = 0;
+                    g_reload_cursor.out_pos             = 0;
+                }
+
+                Lz4SegmentReader reader(std::addressof(g_reload_cursor), file, segment->size, out, segment_start, end - segment->dst_offset);
+                R_RETURN(reader.Read());
+            } else {
+                R_RETURN(fs::ReadFile(file, segment->file_offset + (start - segment->dst_offset), out, end - start));
+            }
+        }
+
     }
 
     /* Process Creation API. */
@@ -792,6 +1031,9 @@ namespace ams::ldr {
             R_TRY(ValidateMeta(std::addressof(bdll_meta), loc, mount.GetCodeVerificationData()));
         }
 
+        /* Note whether the program's code is external, as it can't be read again once the process is created. */
+        const bool is_external_code = fssystem::GetExternalCodeFileSystem(loc.program_id) != nullptr;
+
         /* Load, validate NSO headers. */
         AutoLoadModuleInfo auto_load_info = {};
         R_TRY(LoadAutoLoadHeaders(g_nso_headers, std::addressof(auto_load_info), meta.acid->flags));
@@ -808,12 +1050,21 @@ namespace ams::ldr {
 
             /* Register new process. */
             const auto as_type = GetAddressSpaceType(std::addressof(meta));
-            RoManager::GetInstance().RegisterProcess(pin_id, process_id, meta.aci->program_id, as_type == Npdm::AddressSpaceType_64Bit || as_type == Npdm::AddressSpaceType_64BitDeprecated);
+            RoManager::GetInstance().RegisterProcess(pin_id, process_id, meta.aci->program_id, as_type == Npdm::AddressSpaceType_64Bit || as_type == Npdm::AddressSpaceType_64BitDeprecated, attrs);
 
             /* Register all NSOs. */
+            /* NOTE: Unpatched modules which we can open again are recorded as reloadable, so that sys-swap may discard their code. */
+            const bool can_reload = !is_external_code && IsReloadableStorage(loc);
             for (size_t i = 0; i < Nso_Count; i++) {
                 if (auto_load_info.has_nso[i]) {
-                    RoManager::GetInstance().AddNso(pin_id, g_nso_headers[i].module_id, info.nso_address[i], info.nso_size[i]);
+                    if (can_reload && !IsBrowserCoreDllNso(i) && !info.nso_patched[i]) {
+                        u8 header_hash[crypto::Sha256Generator::HashSize];
+                        crypto::GenerateSha256(header_hash, sizeof(header_hash), g_nso_headers + i, sizeof(g_nso_headers[i]));
+
+                        RoManager::GetInstance().AddReloadableNso(pin_id, g_nso_headers[i].module_id, info.nso_address[i], info.nso_size[i], i, header_hash);
+                    } else {
+                        RoManager::GetInstance().AddNso(pin_id, g_nso_headers[i].module_id, info.nso_address[i], info.nso_size[i]);
+                    }
                 }
             }
         }
@@ -874,4 +1125,47 @@ namespace ams::ldr {
         R_SUCCEED();
     }
 
+    Result GetReloadableModuleInfo(u32 *out_count, ldr::ModuleInfo *out, size_t max_out_count, os::ProcessId process_id) {
+        R_UNLESS(RoManager::GetInstance().GetReloadableModuleInfo(out_count, out, max_out_count, process_id), ldr::ResultNotPinned());
+        R_SUCCEED();
+    }
+
+    Result ReadModulePages(void *dst, size_t size, os::ProcessId process_id, u64 address) {
+        /* Validate the range. */
+        R_UNLESS(util::IsAligned(address, os::MemoryPageSize), ldr::ResultInvalidAddress());
+        R_UNLESS(util::IsAligned(size, os::MemoryPageSize),    ldr::ResultInvalidSize());
+        R_UNLESS(size > 0,                                     ldr::ResultInvalidSize());
+
+        /* Find the module containing the pages. */
+        RoManager::ReloadableModule module;
+        R_UNLESS(RoManager::GetInstance().GetReloadableModule(std::addressof(module), process_id, address), ldr::ResultNotPinned());
+
+        const size_t offset = address - module.module_info.address;
+        R_UNLESS(size <= module.module_info.size - offset, ldr::ResultInvalidSize());
+
+        /* Mount the code the module was loaded from, and open its file. */
+        ScopedCodeMountForCode mount(module.program_location, module.override_status, module.attrs);
+        R_TRY(mount.GetResult());
+
+        fs::FileHandle file;
+        R_TRY(fs::OpenFile(std::addressof(file), GetNsoPath(module.nso_index), fs::OpenMode_Read));
+        ON_SCOPE_EXIT { fs::CloseFile(file); };
+
+        /* Ensure the file is still the one the module was loaded from. */
+        NsoHeader nso_header;
+        R_TRY(fs::ReadFile(file, 0, std::addressof(nso_header), sizeof(nso_header)));
+
+        u8 header_hash[crypto::Sha256Generator::HashSize];
+        crypto::GenerateSha256(header_hash, sizeof(header_hash), std::addressof(nso_header), sizeof(nso_header));
+        R_UNLESS(crypto::IsSameBytes(header_hash, module.header_hash, sizeof(header_hash)), ldr::ResultInvalidNso());
+
+        /* Read the text and read-only data. Everything else in a discardable page was zero-filled when it was loaded. */
+        u8 *out = static_cast<u8 *>(dst);
+        std::memset(out, 0, size);
+        R_TRY(ReadModuleSegment(out, offset, size, file, header_hash, std::addressof(nso_header.segments[NsoHeader::Segment_Text]), nso_header.text_compressed_size, (nso_header.flags & NsoHeader::Flag_CompressedText) != 0));
+        R_TRY(ReadModuleSegment(out, offset, size, file, header_hash, std::addressof(nso_header.segments[NsoHeader::Segment_Ro]),   nso_header.ro_compressed_size,   (nso_header.flags & NsoHeader::Flag_CompressedRo)   != 0));
+
+        R_SUCCEED();
+    }
+
 }
@@ -29,4 +29,7 @@ namespace ams::ldr {
 
     Result GetProgramLocationAndOverrideStatusFromPinId(ncm::ProgramLocation *out, cfg::OverrideStatus *out_status, PinId pin_id);
 
+    Result GetReloadableModuleInfo(u32 *out_count, ldr::ModuleInfo *out, size_t max_out_count, os::ProcessId process_id);
+    Result ReadModulePages(void *dst, size_t size, os::ProcessId process_id, u64 address);
+
 }
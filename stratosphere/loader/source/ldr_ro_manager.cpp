@@ -58,7 +58,7 @@ namespace ams::ldr {
         return true;
     }
 
-    void RoManager::RegisterProcess(PinId pin_id, os::ProcessId process_id, ncm::ProgramId program_id, bool is_64_bit_address_space) {
+    void RoManager::RegisterProcess(PinId pin_id, os::ProcessId process_id, ncm::ProgramId program_id, bool is_64_bit_address_space, const ldr::ProgramAttributes &attrs) {
         /* Find the process. */
         auto *found = this->FindProcessInfo(pin_id);
         if (found == nullptr) {
@@ -68,6 +68,7 @@ namespace ams::ldr {
         /* Set the process id and program id. */
         found->process_id = process_id;
         found->program_id = program_id;
+        found->attrs      = attrs;
         AMS_UNUSED(is_64_bit_address_space);
     }
 
@@ -101,6 +102,30 @@ namespace ams::ldr {
         std::memcpy(info->module_info.module_id, module_id, sizeof(info->module_info.module_id));
         info->module_info.address = address;
         info->module_info.size    = size;
+        info->is_reloadable       = false;
+        info->in_use              = true;
+    }
+
+    void RoManager::AddReloadableNso(PinId pin_id, const u8 *module_id, u64 address, u64 size, u32 nso_index, const u8 *header_hash) {
+        /* Find the process. */
+        auto *found = this->FindProcessInfo(pin_id);
+        if (found == nullptr) {
+            return;
+        }
+
+        /* Allocate an nso. */
+        auto *info = this->AllocateNsoInfo(found);
+        if (info == nullptr) {
+            return;
+        }
+
+        /* Copy the information into the nso info, along with what's needed to read it back. */
+        std::memcpy(info->module_info.module_id, module_id, sizeof(info->module_info.module_id));
+        std::memcpy(info->header_hash, header_hash, sizeof(info->header_hash));
+        info->module_info.address = address;
+        info->module_info.size    = size;
+        info->nso_index           = static_cast<u8>(nso_index);
+        info->is_reloadable       = true;
         info->in_use              = true;
     }
 
@@ -128,6 +153,57 @@ namespace ams::ldr {
         return true;
     }
 
+    bool RoManager::GetReloadableModuleInfo(u32 *out_count, ModuleInfo *out, size_t max_out_count, os::ProcessId process_id) {
+        /* Find the process. */
+        auto *found = this->FindProcessInfo(process_id);
+        if (found == nullptr) {
+            return false;
+        }
+
+        /* Copy reloadable nso module infos. */
+        size_t count = 0;
+        for (auto i = 0; i < NsoCount && count < max_out_count; ++i) {
+            /* Skip nsos which can't be read back. */
+            if (!found->nso_infos[i].in_use || !found->nso_infos[i].is_reloadable) {
+                continue;
+            }
+
+            /* Copy out the module info. */
+            out[count++] = found->nso_infos[i].module_info;
+        }
+
+        /* Set the output count. */
+        *out_count = count;
+        return true;
+    }
+
+    bool RoManager::GetReloadableModule(ReloadableModule *out, os::ProcessId process_id, u64 address) {
+        /* Find the process. */
+        auto *found = this->FindProcessInfo(process_id);
+        if (found == nullptr) {
+            return false;
+        }
+
+        /* Find the reloadable nso containing the address. */
+        for (auto i = 0; i < NsoCount; ++i) {
+            const auto &nso = found->nso_infos[i];
+            if (!nso.in_use || !nso.is_reloadable || !(nso.module_info.address <= address && address - nso.module_info.address < nso.module_info.size)) {
+                continue;
+            }
+
+            /* Set the output. */
+            out->program_location = found->program_location;
+            out->override_status  = found->override_status;
+            out->attrs            = found->attrs;
+            out->module_info      = nso.module_info;
+            out->nso_index        = nso.nso_index;
+            std::memcpy(out->header_hash, nso.header_hash, sizeof(out->header_hash));
+            return true;
+        }
+
+        return false;
+    }
+
     RoManager::ProcessInfo *RoManager::AllocateProcessInfo() {
         for (auto i = 0; i < ProcessCount; ++i) {
             if (!m_processes[i].in_use) {
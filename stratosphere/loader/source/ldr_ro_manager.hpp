@@ -24,10 +24,24 @@ namespace ams::ldr {
             static constexpr PinId InvalidPinId = {};
             static constexpr int ProcessCount = 0x40;
             static constexpr int NsoCount     = 0x20;
+
+            /* NOTE: A reloadable module's code and read-only data can be read back from the file it was loaded from, */
+            /* provided the file's header still matches the one it was loaded with.                                  */
+            struct ReloadableModule {
+                ncm::ProgramLocation program_location;
+                cfg::OverrideStatus override_status;
+                ldr::ProgramAttributes attrs;
+                ldr::ModuleInfo module_info;
+                u32 nso_index;
+                u8 header_hash[crypto::Sha256Generator::HashSize];
+            };
         private:
             struct NsoInfo {
                 bool in_use;
+                bool is_reloadable;
+                u8 nso_index;
                 ldr::ModuleInfo module_info;
+                u8 header_hash[crypto::Sha256Generator::HashSize];
             };
 
             struct ProcessInfo {
@@ -37,6 +51,7 @@ namespace ams::ldr {
                 ncm::ProgramId program_id;
                 cfg::OverrideStatus override_status;
                 ncm::ProgramLocation program_location;
+                ldr::ProgramAttributes attrs;
                 NsoInfo nso_infos[NsoCount];
             };
         private:
@@ -46,13 +61,16 @@ namespace ams::ldr {
             bool Allocate(PinId *out, const ncm::ProgramLocation &loc, const cfg::OverrideStatus &status);
             bool Free(PinId pin_id);
 
-            void RegisterProcess(PinId pin_id, os::ProcessId process_id, ncm::ProgramId program_id, bool is_64_bit_address_space);
+            void RegisterProcess(PinId pin_id, os::ProcessId process_id, ncm::ProgramId program_id, bool is_64_bit_address_space, const ldr::ProgramAttributes &attrs);
 
             bool GetProgramLocationAndStatus(ncm::ProgramLocation *out, cfg::OverrideStatus *out_status, PinId pin_id);
 
             void AddNso(PinId pin_id, const u8 *module_id, u64 address, u64 size);
+            void AddReloadableNso(PinId pin_id, const u8 *module_id, u64 address, u64 size, u32 nso_index, const u8 *header_hash);
 
             bool GetProcessModuleInfo(u32 *out_count, ModuleInfo *out, size_t max_out_count, os::ProcessId process_id);
+            bool GetReloadableModuleInfo(u32 *out_count, ModuleInfo *out, size_t max_out_count, os::ProcessId process_id);
+            bool GetReloadableModule(ReloadableModule *out, os::ProcessId process_id, u64 address);
         private:
             ProcessInfo *AllocateProcessInfo();
             ProcessInfo *FindProcessInfo(PinId pin_id);
@@ -2,16 +2,57 @@
  * sys-swap: Virtualized System Memory (Swap) Daemon
  */
 #include <stratosphere.hpp>
+#include "swap_code_source.hpp"
+#include "swap_eviction_manager.hpp"
+#include "swap_fault_manager.hpp"
+#include "swap_freeze_manager.hpp"
+#include "swap_revert_manager.hpp"
+#include "swap_svc.hpp"
 
 namespace ams {
 
+    namespace swap {
+
+        namespace {
+
+            constinit u8 g_fs_heap_memory[16_KB];
+            lmem::HeapHandle g_fs_heap_handle;
+
+            void *AllocateForFs(size_t size) {
+                return lmem::AllocateFromExpHeap(g_fs_heap_handle, size);
+            }
+
+            void DeallocateForFs(void *p, size_t size) {
+                AMS_UNUSED(size);
+                return lmem::FreeToExpHeap(g_fs_heap_handle, p);
+            }
+
+            void InitializeFsHeap() {
+                g_fs_heap_handle = lmem::CreateExpHeap(g_fs_heap_memory, sizeof(g_fs_heap_memory), lmem::CreateOption_ThreadSafe);
+            }
+
+        }
+
+    }
+
     namespace init {
         void InitializeSystemModule() {
-            /* Initialize SDMMC for raw access. */
-            sdmmc::Initialize(sdmmc::Port_SdCard0);
+            /* Initialize heap. */
+            swap::InitializeFsHeap();
+
+            /* Initialize our connection to sm. */
+            R_ABORT_UNLESS(sm::Initialize());
+
+            /* Initialize fs, through which we access the swap file. */
+            fs::InitializeForSystem();
+            fs::SetAllocator(swap::AllocateForFs, swap::DeallocateForFs);
+            fs::SetEnabledAutoAbort(false);
+
+            /* Initialize pm:info, which hid needs to tell whether the hid sysmodule has launched. */
+            R_ABORT_UNLESS(pminfoInitialize());
         }
         void FinalizeSystemModule() {
-            sdmmc::Finalize(sdmmc::Port_SdCard0);
+            pminfoExit();
         }
         void Startup() { /* ... */ }
     }
@@ -21,103 +62,169 @@ namespace ams {
         AMS_ABORT("Exit called by sys-swap");
     }
 
-    /* Dummy structure for swap requests. */
-    struct SwapRequest {
-        u64 process_id;
-        uptr vaddr;
-        u64 sector_offset;
-        os::NativeHandle thread_handle;
-    };
-
-    bool IsSdCardIdle() {
-        /* Tegra X1 SDMMC4 Present State Register. */
-        volatile u32 *SDMMC4_PSTR = reinterpret_cast<volatile u32 *>(0x700B0624);
-        /* Check bit 0 (Command Inhibit) and bit 1 (Data Inhibit). Both must be 0 for idle. */
-        return (*SDMMC4_PSTR & 0x00000003) == 0;
-    }
+    namespace {
 
-    bool IsTargetProcess(u64 program_id) {
-        /* Filter specifically for Applet Manager (010000000000002B). */
-        return program_id == 0x010000000000002BULL;
-    }
+        /* NOTE: Swap lives in a file on the sd card, so that every access to the card goes through the fs sysmodule. */
+        constexpr const char SWAP_DIRECTORY_PATH[] = "sdmc:/atmosphere/swap";
+        constexpr const char SWAP_FILE_PATH[]      = "sdmc:/atmosphere/swap/swap.bin";
+        constexpr s64 SWAP_FILE_SIZE               = 1_GB + 4_MB;
 
-    bool IsHighSpeedClockLocked() {
-        /* Tegra X1 SDMMC4 Clock Control Register. */
-        volatile u32 *SDMMC4_CLK = reinterpret_cast<volatile u32 *>(0x700B062C);
-        /* Ensure divisor is set for high-speed (e.g., 200MHz/SDR104). */
-        return (*SDMMC4_CLK & 0x0000FF00) != 0; 
-    }
+        /* The sd card is only mounted once fs has initialized it, which may be after we launch. */
+        constexpr TimeSpan SD_CARD_RETRY_INTERVAL = TimeSpan::FromMilliSeconds(100);
+
+        /* Number of pages to read in at once when a process faults sequentially. */
+        constexpr s32 SWAP_READAHEAD_PAGES = 8;
 
-    bool ValidateSwapPartition() {
-        /* Read sector 0 of the swap partition. */
-        alignas(0x10) u8 sector[512];
-        /* Assume swap partition is at a fixed sector offset for now. */
-        constexpr u64 SWAP_PARTITION_START = 0x8000000; 
-        if (R_FAILED(sdmmc::Read(sector, 512, sdmmc::Port_SdCard0, SWAP_PARTITION_START, 1))) {
-            return false;
+        /* Emergency kill switch: holding L + R + Down for three seconds pages everything back in and disables swap. */
+        constexpr u64 KILL_SWITCH_KEYS        = HidNpadButton_L | HidNpadButton_R | HidNpadButton_Down;
+        constexpr TimeSpan KILL_SWITCH_PERIOD = TimeSpan::FromSeconds(3);
+
+        swap::IoScheduler g_io_scheduler;
+        swap::SwapPartition g_partition;
+        swap::CompressedPool g_compressed_pool;
+        swap::SwapStore g_store;
+        swap::CodeSource g_code_source;
+        swap::EvictionManager g_eviction_manager;
+        swap::FaultManager g_fault_manager;
+        swap::FreezeManager g_freeze_manager;
+        swap::RevertManager g_revert_manager;
+
+        Result RelocateSwappedPages(u64 *out_relocated_mask, const ams::svc::SwapRelocation *relocations, s32 num_relocations) {
+            R_RETURN(::svcRelocateSwappedPages(out_relocated_mask, relocations, num_relocations));
+        }
+
+        Result OpenSwapFile(fs::FileHandle *out) {
+            /* Create the swap file if it doesn't exist yet, and mark it as ours. */
+            /* NOTE: Mounting refuses any file that wasn't created with our magic, so that we never overwrite anything else. */
+            fs::DirectoryEntryType entry_type;
+            if (R_FAILED(fs::GetEntryType(std::addressof(entry_type), SWAP_FILE_PATH))) {
+                R_TRY(fs::EnsureDirectory(SWAP_DIRECTORY_PATH));
+                R_TRY(fs::CreateFile(SWAP_FILE_PATH, SWAP_FILE_SIZE));
+
+                fs::FileHandle file;
+                R_TRY(fs::OpenFile(std::addressof(file), SWAP_FILE_PATH, fs::OpenMode_ReadWrite));
+                ON_SCOPE_EXIT { fs::CloseFile(file); };
+
+                fs::FileHandleStorage storage(file);
+                R_TRY(swap::SwapPartition::Create(std::addressof(storage)));
+            }
+
+            R_RETURN(fs::OpenFile(out, SWAP_FILE_PATH, fs::OpenMode_ReadWrite));
+        }
+
+        bool IsKillSwitchHeld() {
+            /* NOTE: hid is unavailable until its sysmodule launches, so the switch can't be held before then. */
+            u64 keys_held = 0;
+            if (R_FAILED(hid::GetKeysHeld(std::addressof(keys_held)))) {
+                return false;
+            }
+
+            return (keys_held & KILL_SWITCH_KEYS) == KILL_SWITCH_KEYS;
         }
 
-        /* Check for magic string "SWAP_MAGIC". */
-        return std::memcmp(sector, "SWAP_MAGIC", 10) == 0;
     }
 
     void Main() {
         os::SetThreadNamePointer(os::GetCurrentThread(), "sys-swap.Main");
 
-        /* 1. Initialize SD card and lock clock. */
-        R_ABORT_UNLESS(sdmmc::Activate(sdmmc::Port_SdCard0));
+        /* 1. Mount the sd card, once fs has made it available. */
+        while (R_FAILED(fs::MountSdCard("sdmc"))) {
+            os::SleepThread(SD_CARD_RETRY_INTERVAL);
+        }
 
-        /* 2. Validate Swap Partition Safety. */
-        if (!ValidateSwapPartition()) {
-            MESOSPHERE_LOG("sys-swap: Invalid partition! Missing SWAP_MAGIC. Refusing to start.\n");
+        /* 2. Open and mount the swap file. */
+        fs::FileHandle swap_file;
+        if (const auto result = OpenSwapFile(std::addressof(swap_file)); R_FAILED(result)) {
+            AMS_LOG("sys-swap: Failed to open swap file (2%03d-%04d). Refusing to start.\n", result.GetModule(), result.GetDescription());
             return;
         }
 
-        /* 3. Main loop. */
-        bool g_SwapEnabled = true;
-        s64 kill_switch_counter = 0;
+        /* NOTE: Every access goes through the I/O scheduler, which serves the fault thread's reads ahead of our writes. */
+        const s32 main_thread_priority = os::GetThreadPriority(os::GetCurrentThread());
+        fs::SetPriorityRawOnCurrentThread(fs::PriorityRaw_Background);
+
+        fs::FileHandleStorage partition_storage(swap_file, true);
+        R_ABORT_UNLESS(g_io_scheduler.Initialize(std::addressof(partition_storage), main_thread_priority - 2));
+        if (const auto result = g_partition.Mount(std::addressof(g_io_scheduler)); R_FAILED(result)) {
+            AMS_LOG("sys-swap: Invalid swap file (2%03d-%04d). Refusing to start.\n", result.GetModule(), result.GetDescription());
+            return;
+        }
+
+        /* 3. Set up write-back to the compressed pool and the partition. */
+        g_compressed_pool.Initialize();
+        g_store.Initialize(std::addressof(g_partition), std::addressof(g_compressed_pool), RelocateSwappedPages);
+        g_eviction_manager.Initialize(std::addressof(g_store), std::addressof(g_code_source));
+        g_revert_manager.Initialize(std::addressof(g_store), std::addressof(g_code_source));
+        g_freeze_manager.Initialize(std::addressof(g_eviction_manager), std::addressof(g_store), std::addressof(g_code_source));
+
+        /* 4. Register for notifications from the kernel, and start serving faults. */
+        /* NOTE: The fault thread waits on the kernel's event, and signals the work event to wake us for everything else. */
+        os::SystemEvent swap_event(os::EventClearMode_AutoClear, true);
+        os::Event work_event(os::EventClearMode_AutoClear);
+        R_ABORT_UNLESS(::svcRegisterSwapEvent(swap_event.GetWritableHandle()));
+        R_ABORT_UNLESS(g_fault_manager.Initialize(std::addressof(g_store), std::addressof(g_code_source), SWAP_READAHEAD_PAGES, std::addressof(swap_event), std::addressof(work_event), main_thread_priority - 1));
+
+        /* 5. Main loop. */
+        bool swap_enabled = true;
+        os::Tick kill_switch_start_tick(0);
 
         while (true) {
-            /* Emergency Kill Switch: L + R + Down for 3 seconds. */
-            // u64 buttons = hid::GetButtonsHeld();
-            u64 buttons = 0; // Mock
-            if ((buttons & (0x40 | 0x80 | 0x01)) == (0x40 | 0x80 | 0x01)) {
-                if (++kill_switch_counter > 300) { // 300 * 10ms = 3s
-                    g_SwapEnabled = false;
-                    /* TODO: Trigger EmergencyRevertSwap() via SVC. */
+            /* Once the kill switch has been held long enough, stop swapping and page everything back in. */
+            if (swap_enabled && IsKillSwitchHeld()) {
+                const os::Tick now = os::GetSystemTick();
+                if (kill_switch_start_tick == os::Tick(0)) {
+                    kill_switch_start_tick = now;
+                } else if ((now - kill_switch_start_tick).ToTimeSpan() >= KILL_SWITCH_PERIOD) {
+                    AMS_LOG("sys-swap: Kill switch triggered. Disabling swap.\n");
+
+                    swap_enabled = false;
+                    g_eviction_manager.Disable();
+                    if (const auto result = g_revert_manager.Begin(); R_FAILED(result)) {
+                        AMS_LOG("sys-swap: Failed to begin reverting swap (2%03d-%04d).\n", result.GetModule(), result.GetDescription());
+                    }
                 }
             } else {
-                kill_switch_counter = 0;
+                kill_switch_start_tick = os::Tick(0);
             }
 
-            if (g_SwapEnabled) {
-                /* Sleep/Wake Handshake. */
-                /* TODO: Integrate with psc (Power State Controller) module. */
-                // if (entering_sleep) { FlushDirtyPages(); sdmmc::Deactivate(); paused = true; }
-                // if (exiting_sleep) { sdmmc::Activate(); paused = false; }
+            /* 1. Evict pages from the processes of pools which are running out of memory. */
+            if (const auto result = g_eviction_manager.ProcessReclaimRequests(); R_FAILED(result)) {
+                AMS_LOG("sys-swap: Failed to reclaim memory (2%03d-%04d).\n", result.GetModule(), result.GetDescription());
+            }
 
-                /* Proactive Monitoring: Detect game launch via pm. */
-                // if (pm::IsApplicationStarting()) { EvictLibraryAppletMemory(); }
+            /* 2. Write back pages queued for eviction, so that the kernel can free them. */
+            if (const auto result = g_eviction_manager.ProcessEvictions(); R_FAILED(result)) {
+                AMS_LOG("sys-swap: Failed to process evictions (2%03d-%04d).\n", result.GetModule(), result.GetDescription());
+            }
 
-                /* 2. Process Swap Requests. */
-                SwapRequest request;
-                bool has_request = false; // Mock
+            /* 3. Swap out the working sets of applets moved to the background, and read them back in when they return. */
+            if (const auto result = g_freeze_manager.ProcessActivityRequests(); R_FAILED(result)) {
+                AMS_LOG("sys-swap: Failed to process activity requests (2%03d-%04d).\n", result.GetModule(), result.GetDescription());
+            }
+            if (const auto result = g_freeze_manager.Step(); R_FAILED(result)) {
+                AMS_LOG("sys-swap: Failed to freeze or thaw process (2%03d-%04d).\n", result.GetModule(), result.GetDescription());
+            }
 
-                if (has_request && IsTargetProcess(request.process_id)) {
-                    /* Hardware Gatekeeper: Ensure SD bus is idle and clock is high-speed. */
-                    while (!IsSdCardIdle() || !IsHighSpeedClockLocked()) {
-                        os::SleepThread(TimeSpan::FromMilliseconds(5));
-                    }
+            /* 4. Free the slots of pages which have been swapped back in. */
+            if (const auto result = g_eviction_manager.ReclaimReleasedSlots(); R_FAILED(result)) {
+                AMS_LOG("sys-swap: Failed to reclaim swap slots (2%03d-%04d).\n", result.GetModule(), result.GetDescription());
+            }
 
-                    /* 3. Perform Raw I/O on the Swap Partition. */
-                    // sdmmc::Read(sdmmc::Port_SdCard0, request.sector_offset, 8, buffer);
-                    
-                    /* 4. Atomic Re-map and Resume via SVC. */
-                    // SvcMarkAsResidentAndWake(request.process_id, request.vaddr, resident_pa, request.thread_handle);
-                }
+            /* 5. If free segments are running low, move the live pages out of the emptiest segment, so that it can be rewritten. */
+            if (const auto result = g_store.Clean(); R_FAILED(result)) {
+                AMS_LOG("sys-swap: Failed to clean swap partition (2%03d-%04d).\n", result.GetModule(), result.GetDescription());
+            }
+
+            /* 6. If reverting, restore the next batch of swapped pages. */
+            if (const auto result = g_revert_manager.Step(); R_FAILED(result)) {
+                AMS_LOG("sys-swap: Failed to revert swapped pages (2%03d-%04d).\n", result.GetModule(), result.GetDescription());
+            }
+
+            /* Wait for the kernel to signal new work, polling the kill switch periodically. */
+            /* NOTE: While reverting, freezing or thawing, we go straight on to the next batch, since any new work is handled first anyway. */
+            if (!g_revert_manager.IsActive() && !g_freeze_manager.IsActive()) {
+                work_event.TimedWait(TimeSpan::FromMilliSeconds(10));
             }
-            
-            os::SleepThread(TimeSpan::FromMilliseconds(10));
         }
     }
 }
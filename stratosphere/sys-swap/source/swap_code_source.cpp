@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "swap_code_source.hpp"
+
+namespace ams::swap {
+
+    bool CodeSource::IsReloadable(u64 process_id, u64 address) {
+        std::scoped_lock lk(m_mutex);
+        return this->FindModule(process_id, address) != nullptr;
+    }
+
+    Result CodeSource::ReadPages(void *dst, u64 process_id, u64 address, s32 num_pages) {
+        std::scoped_lock lk(m_mutex);
+
+        /* Read the pages a module at a time, since a run of discarded pages may span neighbouring modules. */
+        u8 *out = static_cast<u8 *>(dst);
+        size_t remaining = static_cast<size_t>(num_pages) * ams::svc::SwapPageSize;
+        while (remaining > 0) {
+            const auto *module = this->FindModule(process_id, address);
+            R_UNLESS(module != nullptr, ldr::ResultNotPinned());
+
+            const size_t cur_size = std::min<size_t>(remaining, module->address + module->size - address);
+            R_TRY(ldr::ReadModulePages(out, cur_size, os::ProcessId{process_id}, address));
+
+            out       += cur_size;
+            address   += cur_size;
+            remaining -= cur_size;
+        }
+
+        R_SUCCEED();
+    }
+
+    Result CodeSource::EnsureInitialized() {
+        R_SUCCEED_IF(m_initialized);
+
+        R_TRY(ldr::InitializeForDebugMonitor());
+
+        m_initialized = true;
+        R_SUCCEED();
+    }
+
+    Result CodeSource::GetProcessModules(const ProcessModules **out, u64 process_id) {
+        /* Check whether we already know the process's modules. */
+        /* NOTE: Process ids aren't reused, and a process's modules don't change once it's been created. */
+        for (s32 i = 0; i < m_num_processes; ++i) {
+            if (m_processes[i].process_id == process_id) {
+                m_processes[i].last_used = ++m_use_counter;
+                *out = std::addressof(m_processes[i]);
+                R_SUCCEED();
+            }
+        }
+
+        R_TRY(this->EnsureInitialized());
+
+        /* Take a free entry, or the least recently used one. */
+        ProcessModules *entry;
+        if (m_num_processes < MaxProcesses) {
+            entry = std::addressof(m_processes[m_num_processes++]);
+        } else {
+            entry = std::addressof(m_processes[0]);
+            for (s32 i = 1; i < MaxProcesses; ++i) {
+                if (m_processes[i].last_used < entry->last_used) {
+                    entry = std::addressof(m_processes[i]);
+                }
+            }
+        }
+
+        /* Ask the loader for the process's modules. Processes it didn't load have none. */
+        s32 num_modules = 0;
+        if (const auto result = ldr::GetReloadableModuleInfo(std::addressof(num_modules), entry->modules, MaxModules, os::ProcessId{process_id}); R_FAILED(result)) {
+            /* Don't remember any other failure, as it may be transient. */
+            if (!ldr::ResultNotPinned::Includes(result)) {
+                entry->process_id  = os::InvalidProcessId.value;
+                entry->num_modules = 0;
+                R_THROW(result);
+            }
+
+            num_modules = 0;
+        }
+
+        entry->process_id  = process_id;
+        entry->last_used   = ++m_use_counter;
+        entry->num_modules = num_modules;
+
+        *out = entry;
+        R_SUCCEED();
+    }
+
+    const ldr::ModuleInfo *CodeSource::FindModule(u64 process_id, u64 address) {
+        const ProcessModules *modules;
+        if (R_FAILED(this->GetProcessModules(std::addressof(modules), process_id))) {
+            return nullptr;
+        }
+
+        for (s32 i = 0; i < modules->num_modules; ++i) {
+            const auto &module = modules->modules[i];
+            if (module.address <= address && address - module.address < module.size) {
+                return std::addressof(module);
+            }
+        }
+
+        return nullptr;
+    }
+
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::swap {
+
+    /* NOTE: Clean code pages of modules the loader can read back are discarded instead of being written to swap,  */
+    /* and are read back from the loader when they're faulted on. We only connect to the loader when first needed, */
+    /* and cache the reloadable modules of the processes we've most recently looked up. Faults are read back on    */
+    /* their own thread, so the cache is guarded by a mutex.                                                       */
+    class CodeSource {
+        NON_COPYABLE(CodeSource);
+        NON_MOVEABLE(CodeSource);
+        public:
+            static constexpr s32 MaxProcesses = 8;
+            static constexpr s32 MaxModules   = 0x20;
+        private:
+            struct ProcessModules {
+                u64 process_id;
+                u64 last_used;
+                s32 num_modules;
+                ldr::ModuleInfo modules[MaxModules];
+            };
+        private:
+            ProcessModules m_processes[MaxProcesses];
+            s32 m_num_processes;
+            u64 m_use_counter;
+            bool m_initialized;
+            os::SdkMutex m_mutex;
+        public:
+            CodeSource() : m_processes(), m_num_processes(), m_use_counter(), m_initialized(), m_mutex() { /* ... */ }
+
+            bool IsReloadable(u64 process_id, u64 address);
+            Result ReadPages(void *dst, u64 process_id, u64 address, s32 num_pages);
+        private:
+            Result EnsureInitialized();
+            Result GetProcessModules(const ProcessModules **out, u64 process_id);
+            const ldr::ModuleInfo *FindModule(u64 process_id, u64 address);
+    };
+
+}
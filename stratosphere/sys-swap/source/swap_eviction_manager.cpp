@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "swap_eviction_manager.hpp"
+#include "swap_svc.hpp"
+
+namespace ams::swap {
+
+    void EvictionManager::Initialize(SwapStore *store, CodeSource *code_source) {
+        m_store       = store;
+        m_code_source = code_source;
+    }
+
+    Result EvictionManager::Evict(s32 *out_num_evicted, u64 process_id, uintptr_t address, size_t size) {
+        /* Once swap has been disabled, nothing more is evicted. */
+        if (!m_enabled) {
+            *out_num_evicted = 0;
+            R_SUCCEED();
+        }
+
+        /* Don't evict pages we'd have nowhere to write. */
+        R_UNLESS(!m_store->IsFull(), svc::ResultOutOfResource());
+
+        /* Ask the kernel to queue the pages for write-back. */
+        /* NOTE: Pages are only placed once they're written, so that everything written lands in sequence at the head of the log. */
+        s32 num_evicted = 0;
+        R_TRY(::svcEvictSwapPages(std::addressof(num_evicted), process_id, address, size));
+
+        *out_num_evicted = num_evicted;
+        R_SUCCEED();
+    }
+
+    Result EvictionManager::EvictColdPages(s32 *out_num_evicted, u64 process_id, s32 max_pages) {
+        /* Ask the kernel for the process's coldest pages. */
+        s32 num_candidates = 0;
+        R_TRY(::svcGetSwapCandidates(std::addressof(num_candidates), m_candidates, process_id, std::min(max_pages, MaxBatchPages)));
+
+        /* Evict the candidates, a run of neighbouring pages at a time. */
+        s32 total_evicted = 0;
+        s32 cur = 0;
+        while (cur < num_candidates) {
+            s32 num_pages = 1;
+            while (cur + num_pages < num_candidates && m_candidates[cur + num_pages] == m_candidates[cur] + num_pages * ams::svc::SwapPageSize) {
+                ++num_pages;
+            }
+
+            /* NOTE: A candidate may have been touched since the last sweep; the kernel skips pages it can no longer evict. */
+            s32 num_evicted = 0;
+            if (R_SUCCEEDED(this->Evict(std::addressof(num_evicted), process_id, m_candidates[cur], num_pages * ams::svc::SwapPageSize))) {
+                total_evicted += num_evicted;
+            }
+
+            cur += num_pages;
+        }
+
+        *out_num_evicted = total_evicted;
+        R_SUCCEED();
+    }
+
+    Result EvictionManager::ProcessEvictions() {
+        while (true) {
+            /* Take as many pending evictions from the kernel as we can buffer. */
+            s32 count = 0;
+            R_TRY(::svcGetSwapEvictions(std::addressof(count), m_infos, reinterpret_cast<u64>(m_buffer), MaxBatchPages));
+
+            if (count == 0) {
+                break;
+            }
+
+            /* Discard the pages which can be read back from the modules they were loaded from. */
+            const s32 num_discarded = this->DiscardCleanPages(count);
+
+            /* Write the rest, and tell the kernel which are now durable. Failed pages are restored to their process. */
+            m_store->WriteBatch(m_completions + num_discarded, m_infos, m_buffer, count - num_discarded);
+            R_ABORT_UNLESS(::svcCompleteSwapEvictions(m_completions, count));
+
+            /* Persist the slots' new CRCs. */
+            /* NOTE: Swap contents don't survive a reboot, so a failure here only costs us verification of an earlier boot's data. */
+            if (const auto result = m_store->Flush(); R_FAILED(result)) {
+                AMS_LOG("sys-swap: Failed to flush partition metadata (2%03d-%04d).\n", result.GetModule(), result.GetDescription());
+            }
+
+            /* If the kernel had fewer evictions than we asked for, the queue is empty. */
+            if (count < MaxBatchPages) {
+                break;
+            }
+        }
+
+        R_SUCCEED();
+    }
+
+    s32 EvictionManager::DiscardCleanPages(s32 count) {
+        /* Complete discarded pages at the front of the completions, and move the pages left to write to the front of the batch. */
+        s32 num_discarded = 0;
+        for (s32 i = 0; i < count; ++i) {
+            const auto &info = m_infos[i];
+
+            /* NOTE: The kernel only marks a page clean if it's unmodified code, so it only remains to check that the loader can read it back. */
+            if ((info.flags & ams::svc::SwapEvictionFlag_Clean) != 0 && m_code_source->IsReloadable(info.process_id, info.address)) {
+                /* NOTE: The page has no slot, so it's identified by its address, which keeps neighbouring pages' offsets contiguous. */
+                m_completions[num_discarded++] = {
+                    .id            = info.id,
+                    .status        = ams::svc::SwapEvictionStatus_Discarded,
+                    .stored_size   = 0,
+                    .reserved      = 0,
+                    .sector_offset = util::AlignDown(info.address, ams::svc::SwapPageSize) / ams::svc::SwapSectorSize,
+                };
+                continue;
+            }
+
+            if (const s32 dst = i - num_discarded; dst != i) {
+                m_infos[dst] = info;
+                std::memcpy(m_buffer + dst * ams::svc::SwapPageSize, m_buffer + i * ams::svc::SwapPageSize, ams::svc::SwapPageSize);
+            }
+        }
+
+        return num_discarded;
+    }
+
+    Result EvictionManager::ProcessReclaimRequests() {
+        while (true) {
+            /* Take the next pool which the kernel needs memory for. */
+            ams::svc::SwapReclaimRequest request;
+            R_TRY_CATCH(::svcGetSwapReclaimRequest(std::addressof(request))) {
+                R_CATCH(svc::ResultNotFound) { break; }
+            } R_END_TRY_CATCH;
+
+            /* Evict the coldest pages of the pool's processes, writing them back as we go so that the kernel can free them. */
+            /* NOTE: Once swap has been disabled, requests are still taken, but nothing is evicted for them. */
+            s32 remaining = static_cast<s32>(std::min<u32>(request.num_pages, std::numeric_limits<s32>::max()));
+            for (u32 i = 0; i < request.num_processes && remaining > 0 && m_enabled; ++i) {
+                while (remaining > 0) {
+                    s32 num_evicted = 0;
+                    if (R_FAILED(this->EvictColdPages(std::addressof(num_evicted), request.process_ids[i], remaining)) || num_evicted == 0) {
+                        break;
+                    }
+
+                    R_TRY(this->ProcessEvictions());
+                    remaining -= num_evicted;
+                }
+            }
+        }
+
+        R_SUCCEED();
+    }
+
+    Result EvictionManager::ReclaimReleasedSlots() {
+        while (true) {
+            /* Take the offsets of pages which the kernel has swapped back in. */
+            s32 count = 0;
+            R_TRY(::svcGetReleasedSwapOffsets(std::addressof(count), m_released_offsets, MaxBatchPages));
+
+            /* Free their slots, along with any copies still held in the compressed pool. */
+            m_store->Release(m_released_offsets, count);
+
+            /* If the kernel had fewer offsets than we asked for, we've taken them all. */
+            if (count < MaxBatchPages) {
+                break;
+            }
+        }
+
+        R_RETURN(m_store->Flush());
+    }
+
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+#include "swap_code_source.hpp"
+
+namespace ams::swap {
+
+    class EvictionManager {
+        NON_COPYABLE(EvictionManager);
+        NON_MOVEABLE(EvictionManager);
+        public:
+            static constexpr s32 MaxBatchPages = SwapStore::MaxBatchPages;
+        private:
+            SwapStore *m_store;
+            CodeSource *m_code_source;
+            bool m_enabled;
+            u64 m_candidates[MaxBatchPages];
+            u64 m_released_offsets[MaxBatchPages];
+            ams::svc::SwapEvictionInfo m_infos[MaxBatchPages];
+            ams::svc::SwapEvictionCompletion m_completions[MaxBatchPages];
+            alignas(os::MemoryPageSize) u8 m_buffer[MaxBatchPages * ams::svc::SwapPageSize];
+        public:
+            EvictionManager() : m_store(), m_code_source(), m_enabled(true) { /* ... */ }
+
+            void Initialize(SwapStore *store, CodeSource *code_source);
+
+            void Disable() { m_enabled = false; }
+            bool IsEnabled() const { return m_enabled; }
+
+            Result Evict(s32 *out_num_evicted, u64 process_id, uintptr_t address, size_t size);
+            Result EvictColdPages(s32 *out_num_evicted, u64 process_id, s32 max_pages);
+            Result ProcessEvictions();
+            Result ProcessReclaimRequests();
+            Result ReclaimReleasedSlots();
+        private:
+            s32 DiscardCleanPages(s32 count);
+    };
+
+}
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "swap_fault_manager.hpp"
+#include "swap_svc.hpp"
+
+namespace ams::swap {
+
+    Result FaultManager::Initialize(SwapStore *store, CodeSource *code_source, s32 readahead_pages, os::SystemEvent *swap_event, os::Event *work_event, s32 thread_priority) {
+        m_store       = store;
+        m_code_source = code_source;
+        m_swap_event  = swap_event;
+        m_work_event  = work_event;
+        m_readahead.Initialize(readahead_pages);
+
+        /* Share our rings with the kernel. */
+        R_TRY(::svcRegisterSwapFaultRings(reinterpret_cast<u64>(m_request_ring_storage), reinterpret_cast<u64>(m_completion_ring_storage)));
+
+        /* Start serving faults. */
+        R_TRY(os::CreateThread(std::addressof(m_thread), ThreadEntry, this, m_thread_stack, sizeof(m_thread_stack), thread_priority));
+        os::SetThreadNamePointer(std::addressof(m_thread), "sys-swap.Fault");
+        os::StartThread(std::addressof(m_thread));
+
+        R_SUCCEED();
+    }
+
+    void FaultManager::ThreadBody() {
+        /* Our reads block the faulting threads, so they go ahead of everything else. */
+        fs::SetPriorityRawOnCurrentThread(fs::PriorityRaw_Realtime);
+
+        while (true) {
+            /* The kernel signals the same event for everything it needs from us, so pass it on to the engine thread. */
+            m_swap_event->Wait();
+            m_work_event->Signal();
+
+            if (const auto result = this->ProcessFaults(); R_FAILED(result)) {
+                AMS_LOG("sys-swap: Failed to process faults (2%03d-%04d).\n", result.GetModule(), result.GetDescription());
+            }
+        }
+    }
+
+    Result FaultManager::ProcessFaults() {
+        while (true) {
+            /* Have the kernel map the pages read by the previous batch and wake their threads in one call. */
+            /* NOTE: This is also what has the kernel post the faults it has queued since onto the ring.     */
+            s32 num_completed;
+            R_TRY(::svcCompleteSwapFaults(std::addressof(num_completed)));
+
+            /* Take every request the kernel has posted. */
+            const s32 count = this->TakeRequests();
+            if (count == 0) {
+                break;
+            }
+
+            /* Forget pages read ahead by the previous batch. */
+            m_readahead.BeginBatch();
+
+            /* Read in each page, and either post its completion or map it along with its neighbours. */
+            for (s32 i = 0; i < count; ++i) {
+                this->ResolveFaultWithRetry(m_requests[i]);
+            }
+        }
+
+        R_SUCCEED();
+    }
+
+    s32 FaultManager::TakeRequests() {
+        auto *ring = this->GetRequestRing();
+
+        /* Determine how many requests are pending. */
+        const u32 head  = ring->header.head;
+        const u32 tail  = util::AtomicRef<u32>(ring->header.tail).Load<std::memory_order_acquire>();
+        const u32 count = std::min<u32>(tail - head, RingCapacity);
+
+        /* Copy them out, and hand their slots back to the kernel. */
+        for (u32 i = 0; i < count; ++i) {
+            m_requests[i] = ring->entries[(head + i) % RingCapacity];
+        }
+        util::AtomicRef<u32>(ring->header.head).Store<std::memory_order_release>(head + count);
+
+        return static_cast<s32>(count);
+    }
+
+    void FaultManager::ResolveFaultWithRetry(const ams::svc::SwapFaultRequest &request) {
+        /* Retry the read a few times, as the failure may be transient. */
+        Result result = ResultSuccess();
+        for (s32 attempt = 0; attempt < MaxResolveAttempts; ++attempt) {
+            result = this->ResolveFault(request);
+            if (R_SUCCEEDED(result)) {
+                return;
+            }
+
+            AMS_LOG("sys-swap: Failed to read page %016lx for process %lu (2%03d-%04d), attempt %d.\n", request.address, request.process_id, result.GetModule(), result.GetDescription(), attempt + 1);
+        }
+
+        /* The page can't be read back, so have the kernel terminate the process rather than leave its thread waiting forever. */
+        this->PostCompletion({
+            .process_id = request.process_id,
+            .thread_id  = request.thread_id,
+            .address    = request.address,
+            .buffer     = 0,
+            .status     = ams::svc::SwapFaultStatus_Failed,
+        });
+    }
+
+    Result FaultManager::ResolveFault(const ams::svc::SwapFaultRequest &request) {
+        const u64 page_address = util::AlignDown(request.address, ams::svc::SwapPageSize);
+
+        /* If the page was read ahead for another thread in this batch, it's already mapped; its thread just needs waking. */
+        if (m_readahead.IsPageRead(request.process_id, page_address)) {
+            this->PostCompletion({
+                .process_id = request.process_id,
+                .thread_id  = request.thread_id,
+                .address    = request.address,
+                .buffer     = 0,
+                .status     = ams::svc::SwapFaultStatus_Resolved,
+            });
+            R_SUCCEED();
+        }
+
+        /* If the process is faulting sequentially, read ahead as many of the following pages as have contiguous sectors. */
+        u64 swap_offset = request.sector_offset;
+        s32 num_pages   = 1;
+        if (const s32 readahead_pages = m_readahead.GetReadaheadPages(request.process_id, page_address, swap_offset); readahead_pages > 1) {
+            R_TRY(::svcGetSwapReadaheadSize(std::addressof(num_pages), request.process_id, request.address, readahead_pages));
+            num_pages = std::max<s32>(num_pages, 1);
+        }
+
+        /* Read the pages. */
+        u64 buffer;
+        R_TRY_CATCH(this->ReadPages(std::addressof(buffer), request.process_id, page_address, swap_offset, num_pages)) {
+            R_CATCH(svc::ResultNotFound) {
+                /* The page was moved to a new slot after the fault was raised, so find out where it lives now. */
+                s32 num_swapped = 0;
+                ams::svc::SwapPageInfo info;
+                R_TRY(::svcGetSwappedPages(std::addressof(num_swapped), std::addressof(info), request.process_id, page_address, 1));
+
+                /* If it isn't swapped out any more, it was restored in the meantime, and its thread just needs waking. */
+                if (num_swapped == 0 || info.address != page_address) {
+                    this->PostCompletion({
+                        .process_id = request.process_id,
+                        .thread_id  = request.thread_id,
+                        .address    = request.address,
+                        .buffer     = 0,
+                        .status     = ams::svc::SwapFaultStatus_Resolved,
+                    });
+                    R_SUCCEED();
+                }
+
+                swap_offset = info.swap_offset;
+                num_pages   = 1;
+                R_TRY(this->ReadPages(std::addressof(buffer), request.process_id, page_address, swap_offset, num_pages));
+            }
+        } R_END_TRY_CATCH;
+
+        if (num_pages == 1) {
+            /* A single page goes through the completion ring, so that the whole batch is resolved by one call. */
+            this->PostCompletion({
+                .process_id = request.process_id,
+                .thread_id  = request.thread_id,
+                .address    = request.address,
+                .buffer     = buffer,
+                .status     = ams::svc::SwapFaultStatus_Resolved,
+            });
+        } else {
+            /* Otherwise, have the kernel map the whole range at once. */
+            const ams::svc::SwapFaultRequest fault = {
+                .process_id    = request.process_id,
+                .thread_id     = request.thread_id,
+                .address       = request.address,
+                .sector_offset = swap_offset,
+            };
+
+            s32 num_installed;
+            R_TRY(::svcCompleteSwapFaultRange(std::addressof(num_installed), std::addressof(fault), buffer, num_pages));
+        }
+
+        m_readahead.OnPagesRead(request.process_id, page_address, num_pages);
+        R_SUCCEED();
+    }
+
+    Result FaultManager::ReadPages(u64 *out_buffer, u64 process_id, u64 address, u64 swap_offset, s32 num_pages) {
+        /* Have the kernel allocate frames for the pages from the process's pool, and map them for us to read into. */
+        /* NOTE: The frames are moved into the faulting process when the fault is completed, so the read lands in its final page. */
+        u64 buffer;
+        R_TRY(::svcMapSwapInFrames(std::addressof(buffer), process_id, num_pages));
+        ON_RESULT_FAILURE { R_ABORT_UNLESS(::svcUnmapSwapInFrames(buffer, num_pages)); };
+
+        /* Discarded pages are read back from the modules they were loaded from; any others, from the store. */
+        /* NOTE: A run of pages read ahead is always either entirely discarded or entirely stored, since their offsets are contiguous. */
+        if ((swap_offset & ams::svc::SwapOffsetDiscardedFlag) != 0) {
+            R_TRY(m_code_source->ReadPages(reinterpret_cast<void *>(buffer), process_id, address, num_pages));
+        } else {
+            R_TRY(m_store->ReadCurrentPages(reinterpret_cast<void *>(buffer), swap_offset, process_id, address, num_pages));
+        }
+
+        *out_buffer = buffer;
+        R_SUCCEED();
+    }
+
+    void FaultManager::PostCompletion(const ams::svc::SwapFaultCompletion &completion) {
+        auto *ring = this->GetCompletionRing();
+
+        /* We complete every batch before taking another, so the completion ring can't fill up. */
+        const u32 tail = ring->header.tail;
+        AMS_ABORT_UNLESS(tail - util::AtomicRef<u32>(ring->header.head).Load<std::memory_order_acquire>() < RingCapacity);
+
+        ring->entries[tail % RingCapacity] = completion;
+        util::AtomicRef<u32>(ring->header.tail).Store<std::memory_order_release>(tail + 1);
+    }
+
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+#include "swap_code_source.hpp"
+
+namespace ams::swap {
+
+    /* NOTE: Faults are served on their own thread, so that a faulting thread never waits for the engine thread to finish */
+    /* writing back evicted pages; the thread's fs priority lets its reads go ahead of those writes in the I/O scheduler. */
+    class FaultManager {
+        NON_COPYABLE(FaultManager);
+        NON_MOVEABLE(FaultManager);
+        public:
+            static constexpr u32 RingCapacity       = ams::svc::SwapFaultRingCapacity;
+            static constexpr s32 MaxReadaheadPages  = ReadaheadTracker::MaxReadaheadPages;
+            static constexpr size_t ThreadStackSize = 0x4000;
+            static constexpr s32 MaxResolveAttempts = 3;
+        private:
+            alignas(os::MemoryPageSize) u8 m_request_ring_storage[ams::svc::SwapFaultRingSize];
+            alignas(os::MemoryPageSize) u8 m_completion_ring_storage[ams::svc::SwapFaultRingSize];
+            ams::svc::SwapFaultRequest m_requests[RingCapacity];
+            ReadaheadTracker m_readahead;
+            SwapStore *m_store;
+            CodeSource *m_code_source;
+            os::SystemEvent *m_swap_event;
+            os::Event *m_work_event;
+            os::ThreadType m_thread;
+            alignas(os::ThreadStackAlignment) u8 m_thread_stack[ThreadStackSize];
+        public:
+            FaultManager() : m_readahead(), m_store(), m_code_source(), m_swap_event(), m_work_event() { /* ... */ }
+
+            Result Initialize(SwapStore *store, CodeSource *code_source, s32 readahead_pages, os::SystemEvent *swap_event, os::Event *work_event, s32 thread_priority);
+        private:
+            static void ThreadEntry(void *arg) { static_cast<FaultManager *>(arg)->ThreadBody(); }
+
+            void ThreadBody();
+
+            Result ProcessFaults();
+            ams::svc::SwapFaultRequestRing *GetRequestRing() { return reinterpret_cast<ams::svc::SwapFaultRequestRing *>(m_request_ring_storage); }
+            ams::svc::SwapFaultCompletionRing *GetCompletionRing() { return reinterpret_cast<ams::svc::SwapFaultCompletionRing *>(m_completion_ring_storage); }
+
+            s32 TakeRequests();
+            void ResolveFaultWithRetry(const ams::svc::SwapFaultRequest &request);
+            Result ResolveFault(const ams::svc::SwapFaultRequest &request);
+            Result ReadPages(u64 *out_buffer, u64 process_id, u64 address, u64 swap_offset, s32 num_pages);
+            void PostCompletion(const ams::svc::SwapFaultCompletion &completion);
+    };
+
+}
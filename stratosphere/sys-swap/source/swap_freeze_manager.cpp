@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "swap_freeze_manager.hpp"
+#include "swap_page_reader.hpp"
+#include "swap_svc.hpp"
+
+namespace ams::swap {
+
+    void FreezeManager::Initialize(EvictionManager *eviction_manager, SwapStore *store, CodeSource *code_source) {
+        m_eviction_manager = eviction_manager;
+        m_store            = store;
+        m_code_source      = code_source;
+    }
+
+    bool FreezeManager::IsActive() const {
+        for (const auto &process : m_processes) {
+            if (process.state == State_Freezing || process.state == State_Thawing) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    Result FreezeManager::ProcessActivityRequests() {
+        while (true) {
+            /* Take the next applet which has moved to or from the background. */
+            ams::svc::SwapActivityRequest request;
+            R_TRY_CATCH(::svcGetSwapActivityRequest(std::addressof(request))) {
+                R_CATCH(svc::ResultNotFound) { break; }
+            } R_END_TRY_CATCH;
+
+            switch (request.kind) {
+                case ams::svc::SwapActivityKind_Freeze: this->BeginFreeze(request.process_id); break;
+                case ams::svc::SwapActivityKind_Thaw:   this->BeginThaw(request.process_id);   break;
+                default: break;
+            }
+        }
+
+        R_SUCCEED();
+    }
+
+    Result FreezeManager::Step() {
+        /* Thawing comes first, since the user is waiting on the applet. */
+        for (auto &process : m_processes) {
+            if (process.state == State_Thawing) {
+                R_RETURN(this->StepThaw(std::addressof(process)));
+            }
+        }
+
+        for (auto &process : m_processes) {
+            if (process.state == State_Freezing) {
+                R_RETURN(this->StepFreeze(std::addressof(process)));
+            }
+        }
+
+        R_SUCCEED();
+    }
+
+    void FreezeManager::BeginFreeze(u64 process_id) {
+        /* Once swap has been disabled, nothing more is frozen. */
+        if (!m_eviction_manager->IsEnabled()) {
+            return;
+        }
+
+        /* Reuse the process's record if it has one, or else take a free one, or else forget the oldest freeze. */
+        FrozenProcess *process = this->FindProcess(process_id);
+        if (process == nullptr) {
+            process = std::addressof(m_processes[0]);
+            for (auto &candidate : m_processes) {
+                if (candidate.state == State_Free) {
+                    process = std::addressof(candidate);
+                    break;
+                }
+
+                if (candidate.last_frozen < process->last_frozen) {
+                    process = std::addressof(candidate);
+                }
+            }
+        }
+
+        process->process_id       = process_id;
+        process->address          = 0;
+        process->last_frozen      = ++m_freeze_counter;
+        process->num_frozen_pages = 0;
+        process->num_thawed_pages = 0;
+        process->num_runs         = 0;
+        process->run_index        = 0;
+        process->state            = State_Freezing;
+    }
+
+    void FreezeManager::BeginThaw(u64 process_id) {
+        /* If we never froze the process, its pages will be faulted back in as they're needed. */
+        FrozenProcess *process = this->FindProcess(process_id);
+        if (process == nullptr) {
+            return;
+        }
+
+        /* NOTE: If the process is still being frozen, only the runs recorded so far are thawed. */
+        if (process->num_runs == 0) {
+            this->Release(process);
+            return;
+        }
+
+        process->address   = process->runs[0].address;
+        process->run_index = 0;
+        process->state     = State_Thawing;
+    }
+
+    Result FreezeManager::StepFreeze(FrozenProcess *process) {
+        /* If swap has been disabled since the freeze began, leave the rest of the process resident. */
+        if (!m_eviction_manager->IsEnabled()) {
+            process->state = State_Frozen;
+            R_SUCCEED();
+        }
+
+        /* Find the next batch of resident pages. */
+        s32 count = 0;
+        if (const auto result = ::svcGetResidentSwapPages(std::addressof(count), m_addresses, process->process_id, process->address, MaxFreezeBatch); R_FAILED(result)) {
+            /* The process may have exited since it was paused. */
+            if (svc::ResultInvalidProcessId::Includes(result)) {
+                this->Release(process);
+                R_SUCCEED();
+            }
+
+            R_THROW(result);
+        }
+
+        if (count == 0) {
+            AMS_LOG("sys-swap: Froze process %lu, swapping out %zu pages.\n", process->process_id, process->num_frozen_pages);
+            process->state = State_Frozen;
+            R_SUCCEED();
+        }
+
+        process->address = m_addresses[count - 1] + ams::svc::SwapPageSize;
+
+        /* Record and evict the pages, a run of neighbouring pages at a time, so that each run is written sequentially. */
+        s32 cur = 0;
+        while (cur < count && process->state == State_Freezing) {
+            s32 num_pages = 1;
+            while (cur + num_pages < count && m_addresses[cur + num_pages] == m_addresses[cur] + num_pages * ams::svc::SwapPageSize) {
+                ++num_pages;
+            }
+
+            this->RecordRun(process, m_addresses[cur], num_pages);
+
+            /* The kernel stops at the first page it can't evict, so step over such pages and carry on with the rest of the run. */
+            u64 address = m_addresses[cur];
+            const u64 end_address = address + num_pages * ams::svc::SwapPageSize;
+            while (address < end_address) {
+                s32 num_evicted = 0;
+                if (const auto result = m_eviction_manager->Evict(std::addressof(num_evicted), process->process_id, address, end_address - address); R_FAILED(result)) {
+                    /* If the partition is full, the rest of the process stays resident. */
+                    if (svc::ResultOutOfResource::Includes(result)) {
+                        AMS_LOG("sys-swap: Swap is full. Froze process %lu, swapping out %zu pages.\n", process->process_id, process->num_frozen_pages);
+                        process->state = State_Frozen;
+                        break;
+                    }
+                }
+
+                process->num_frozen_pages += num_evicted;
+                address += std::max<s32>(num_evicted, 1) * ams::svc::SwapPageSize;
+            }
+
+            cur += num_pages;
+        }
+
+        /* Write the batch back, so that the kernel can free its memory. */
+        R_RETURN(m_eviction_manager->ProcessEvictions());
+    }
+
+    Result FreezeManager::StepThaw(FrozenProcess *process) {
+        /* Find the next batch of swapped pages. */
+        s32 count = 0;
+        if (const auto result = ::svcGetSwappedPages(std::addressof(count), m_infos, process->process_id, process->address, MaxThawBatch); R_FAILED(result)) {
+            /* The process may have exited since it was resumed. */
+            if (svc::ResultInvalidProcessId::Includes(result)) {
+                this->Release(process);
+                R_SUCCEED();
+            }
+
+            R_THROW(result);
+        }
+
+        /* Keep only the pages which were resident when the process was frozen; the rest were already cold. */
+        /* NOTE: Both the pages and the runs are in address order, so a single pass matches them up. */
+        s32 num_pages = 0;
+        for (s32 i = 0; i < count; ++i) {
+            const u64 address = m_infos[i].address;
+            while (process->run_index < process->num_runs && address >= process->runs[process->run_index].address + process->runs[process->run_index].num_pages * ams::svc::SwapPageSize) {
+                ++process->run_index;
+            }
+
+            if (process->run_index == process->num_runs) {
+                break;
+            }
+
+            if (address >= process->runs[process->run_index].address) {
+                m_infos[num_pages++] = m_infos[i];
+            }
+        }
+
+        /* Resume after the batch next time, skipping ahead to the next run if it's further on. */
+        if (count > 0 && process->run_index < process->num_runs) {
+            process->address = std::max<u64>(m_infos[count - 1].address + ams::svc::SwapPageSize, process->runs[process->run_index].address);
+        } else {
+            process->run_index = process->num_runs;
+        }
+
+        /* Read the pages back, and have the kernel map them. Pages faulted in while we were reading are skipped. */
+        if (num_pages > 0) {
+            R_TRY(ReadSwappedPages(m_buffer, process->process_id, m_infos, num_pages, m_store, m_code_source));
+
+            s32 num_restored = 0;
+            if (const auto result = ::svcRestoreSwappedPages(std::addressof(num_restored), process->process_id, m_infos, reinterpret_cast<u64>(m_buffer), num_pages); R_FAILED(result)) {
+                /* If the process's pool can't hold its memory, leave the remaining pages to be faulted in. */
+                if (svc::ResultOutOfMemory::Includes(result) || svc::ResultInvalidProcessId::Includes(result)) {
+                    this->Release(process);
+                }
+
+                R_THROW(result);
+            }
+
+            process->num_thawed_pages += num_restored;
+        }
+
+        if (process->run_index == process->num_runs) {
+            AMS_LOG("sys-swap: Thawed process %lu, restoring %zu of %zu pages.\n", process->process_id, process->num_thawed_pages, process->num_frozen_pages);
+            this->Release(process);
+        }
+
+        R_SUCCEED();
+    }
+
+    FreezeManager::FrozenProcess *FreezeManager::FindProcess(u64 process_id) {
+        for (auto &process : m_processes) {
+            if (process.state != State_Free && process.process_id == process_id) {
+                return std::addressof(process);
+            }
+        }
+
+        return nullptr;
+    }
+
+    void FreezeManager::RecordRun(FrozenProcess *process, u64 address, s32 num_pages) {
+        /* Extend the last run if this one follows on from it. */
+        if (process->num_runs > 0) {
+            auto &last = process->runs[process->num_runs - 1];
+            if (last.address + last.num_pages * ams::svc::SwapPageSize == address) {
+                last.num_pages += num_pages;
+                return;
+            }
+        }
+
+        /* NOTE: If the resident set is too fragmented to record, the pages we can't record are faulted in as needed instead. */
+        if (process->num_runs < MaxRuns) {
+            process->runs[process->num_runs++] = { .address = address, .num_pages = static_cast<u64>(num_pages) };
+        }
+    }
+
+    void FreezeManager::Release(FrozenProcess *process) {
+        process->state      = State_Free;
+        process->process_id = 0;
+        process->num_runs   = 0;
+    }
+
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+#include "swap_code_source.hpp"
+#include "swap_eviction_manager.hpp"
+
+namespace ams::swap {
+
+    /* NOTE: When an applet is paused in the background, its whole resident set is swapped out ("frozen") a batch per     */
+    /* step, and recorded as runs of pages. When it's made runnable again, the pages of those runs which are still        */
+    /* swapped out are read back in bulk ("thawed"), so that the applet doesn't have to fault its working set back in.    */
+    class FreezeManager {
+        NON_COPYABLE(FreezeManager);
+        NON_MOVEABLE(FreezeManager);
+        public:
+            static constexpr s32 MaxProcesses   = 4;
+            static constexpr s32 MaxRuns        = 0x400;
+            static constexpr s32 MaxFreezeBatch = static_cast<s32>(ams::svc::SwapFreezeMaxPages);
+            static constexpr s32 MaxThawBatch   = static_cast<s32>(ams::svc::SwapRestoreMaxPages);
+        private:
+            enum State : u8 {
+                State_Free     = 0,
+                State_Freezing = 1,
+                State_Frozen   = 2,
+                State_Thawing  = 3,
+            };
+
+            struct Run {
+                u64 address;
+                u64 num_pages;
+            };
+
+            struct FrozenProcess {
+                u64 process_id;
+                u64 address;
+                u64 last_frozen;
+                size_t num_frozen_pages;
+                size_t num_thawed_pages;
+                s32 num_runs;
+                s32 run_index;
+                State state;
+                Run runs[MaxRuns];
+            };
+        private:
+            EvictionManager *m_eviction_manager;
+            SwapStore *m_store;
+            CodeSource *m_code_source;
+            u64 m_freeze_counter;
+            FrozenProcess m_processes[MaxProcesses];
+            u64 m_addresses[MaxFreezeBatch];
+            ams::svc::SwapPageInfo m_infos[MaxThawBatch];
+            alignas(os::MemoryPageSize) u8 m_buffer[MaxThawBatch][ams::svc::SwapPageSize];
+        public:
+            FreezeManager() : m_eviction_manager(), m_store(), m_code_source(), m_freeze_counter(), m_processes() { /* ... */ }
+
+            void Initialize(EvictionManager *eviction_manager, SwapStore *store, CodeSource *code_source);
+
+            bool IsActive() const;
+
+            Result ProcessActivityRequests();
+            Result Step();
+        private:
+            void BeginFreeze(u64 process_id);
+            void BeginThaw(u64 process_id);
+
+            Result StepFreeze(FrozenProcess *process);
+            Result StepThaw(FrozenProcess *process);
+
+            FrozenProcess *FindProcess(u64 process_id);
+            void RecordRun(FrozenProcess *process, u64 address, s32 num_pages);
+            void Release(FrozenProcess *process);
+    };
+
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "swap_page_reader.hpp"
+
+namespace ams::swap {
+
+    Result ReadSwappedPages(void *dst, u64 process_id, ams::svc::SwapPageInfo *infos, s32 count, SwapStore *store, CodeSource *code_source) {
+        std::sort(infos, infos + count, [](const ams::svc::SwapPageInfo &lhs, const ams::svc::SwapPageInfo &rhs) { return lhs.swap_offset < rhs.swap_offset; });
+
+        u8 *out = static_cast<u8 *>(dst);
+        s32 cur = 0;
+        while (cur < count) {
+            /* Pages held in the compressed pool are loaded individually. */
+            /* NOTE: Discarded pages are read back by address, so their run must be contiguous in the process too. */
+            const bool discarded = (infos[cur].swap_offset & ams::svc::SwapOffsetDiscardedFlag) != 0;
+            s32 num_pages = 1;
+            if ((infos[cur].swap_offset & ams::svc::SwapOffsetCompressedFlag) == 0) {
+                while (cur + num_pages < count && infos[cur + num_pages].swap_offset == infos[cur].swap_offset + num_pages * ams::svc::SwapSectorsPerPage) {
+                    if (discarded && infos[cur + num_pages].address != infos[cur].address + num_pages * ams::svc::SwapPageSize) {
+                        break;
+                    }
+                    ++num_pages;
+                }
+            }
+
+            if (discarded) {
+                R_TRY(code_source->ReadPages(out + cur * ams::svc::SwapPageSize, process_id, infos[cur].address, num_pages));
+            } else {
+                R_TRY(store->ReadPages(out + cur * ams::svc::SwapPageSize, infos[cur].swap_offset, num_pages));
+            }
+            cur += num_pages;
+        }
+
+        R_SUCCEED();
+    }
+
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+#include "swap_code_source.hpp"
+
+namespace ams::swap {
+
+    /* NOTE: Reads back swapped pages into consecutive pages of dst, from the store or, if they were discarded, from the */
+    /* loader. The pages are first sorted by offset, so that pages which were evicted together are read in one transfer. */
+    Result ReadSwappedPages(void *dst, u64 process_id, ams::svc::SwapPageInfo *infos, s32 count, SwapStore *store, CodeSource *code_source);
+
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "swap_revert_manager.hpp"
+#include "swap_page_reader.hpp"
+#include "swap_svc.hpp"
+
+namespace ams::swap {
+
+    void RevertManager::Initialize(SwapStore *store, CodeSource *code_source) {
+        m_store       = store;
+        m_code_source = code_source;
+    }
+
+    Result RevertManager::Begin() {
+        /* If we're already reverting, there's nothing to do. */
+        R_SUCCEED_IF(m_active);
+
+        m_num_restored = 0;
+        R_TRY(this->BeginPass());
+
+        AMS_LOG("sys-swap: Reverting swap for %d processes.\n", m_num_processes);
+        m_active = true;
+        R_SUCCEED();
+    }
+
+    Result RevertManager::Step() {
+        R_SUCCEED_IF(!m_active);
+
+        /* If we've visited every process, either we're done or pages were swapped out behind us. */
+        if (m_process_index == m_num_processes) {
+            if (m_num_restored_in_pass == 0) {
+                AMS_LOG("sys-swap: Reverted swap, restoring %zu pages.\n", m_num_restored);
+                m_active = false;
+                R_SUCCEED();
+            }
+
+            R_TRY(this->BeginPass());
+        }
+
+        /* Find the next batch of swapped pages. */
+        const u64 process_id = m_process_ids[m_process_index];
+
+        s32 count = 0;
+        if (const auto result = ::svcGetSwappedPages(std::addressof(count), m_infos, process_id, m_address, MaxBatchPages); R_FAILED(result)) {
+            /* The process may have exited since we listed it. */
+            if (svc::ResultInvalidProcessId::Includes(result)) {
+                this->AdvanceProcess();
+                R_SUCCEED();
+            }
+
+            R_THROW(result);
+        }
+
+        if (count == 0) {
+            this->AdvanceProcess();
+            R_SUCCEED();
+        }
+
+        /* Resume after the batch next time, even if we fail to restore it; its pages can still be faulted in. */
+        m_address = m_infos[count - 1].address + ams::svc::SwapPageSize;
+
+        /* Read the pages. */
+        R_TRY(ReadSwappedPages(m_buffer, process_id, m_infos, count, m_store, m_code_source));
+
+        /* Have the kernel map the whole batch. Pages faulted in while we were reading are skipped. */
+        s32 num_restored = 0;
+        if (const auto result = ::svcRestoreSwappedPages(std::addressof(num_restored), process_id, m_infos, reinterpret_cast<u64>(m_buffer), count); R_FAILED(result)) {
+            /* If the process's pool can't hold its memory, give up; the remaining pages stay swapped. */
+            if (svc::ResultOutOfMemory::Includes(result)) {
+                AMS_LOG("sys-swap: Out of memory reverting process %lu. Stopping after restoring %zu pages.\n", process_id, m_num_restored);
+                m_active = false;
+            }
+
+            R_THROW(result);
+        }
+
+        m_num_restored_for_process += num_restored;
+        m_num_restored_in_pass     += num_restored;
+        m_num_restored             += num_restored;
+        R_SUCCEED();
+    }
+
+    Result RevertManager::BeginPass() {
+        R_TRY(svc::GetProcessList(std::addressof(m_num_processes), m_process_ids, MaxProcesses));
+
+        m_process_index            = 0;
+        m_address                  = 0;
+        m_num_restored_for_process = 0;
+        m_num_restored_in_pass     = 0;
+        R_SUCCEED();
+    }
+
+    void RevertManager::AdvanceProcess() {
+        if (m_num_restored_for_process > 0) {
+            AMS_LOG("sys-swap: Restored %zu pages of process %lu (%zu in total).\n", m_num_restored_for_process, m_process_ids[m_process_index], m_num_restored);
+        }
+
+        ++m_process_index;
+        m_address                  = 0;
+        m_num_restored_for_process = 0;
+    }
+
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+#include "swap_code_source.hpp"
+
+namespace ams::swap {
+
+    /* NOTE: Reverting reads every swapped page of every process back in, a batch per step, so that faults */
+    /* keep being serviced in between. Passes are repeated until one restores nothing, since pages whose    */
+    /* write-back was in flight may only become swapped after their process has been scanned.               */
+    class RevertManager {
+        NON_COPYABLE(RevertManager);
+        NON_MOVEABLE(RevertManager);
+        public:
+            static constexpr s32 MaxBatchPages = ams::svc::SwapRestoreMaxPages;
+            static constexpr s32 MaxProcesses  = 0x50;
+        private:
+            SwapStore *m_store;
+            CodeSource *m_code_source;
+            u64 m_process_ids[MaxProcesses];
+            s32 m_num_processes;
+            s32 m_process_index;
+            u64 m_address;
+            size_t m_num_restored_for_process;
+            size_t m_num_restored_in_pass;
+            size_t m_num_restored;
+            bool m_active;
+            ams::svc::SwapPageInfo m_infos[MaxBatchPages];
+            alignas(os::MemoryPageSize) u8 m_buffer[MaxBatchPages][ams::svc::SwapPageSize];
+        public:
+            RevertManager() : m_store(), m_code_source(), m_num_processes(), m_process_index(), m_address(), m_num_restored_for_process(), m_num_restored_in_pass(), m_num_restored(), m_active() { /* ... */ }
+
+            void Initialize(SwapStore *store, CodeSource *code_source);
+
+            bool IsActive() const { return m_active; }
+
+            Result Begin();
+            Result Step();
+        private:
+            Result BeginPass();
+            void AdvanceProcess();
+    };
+
+}
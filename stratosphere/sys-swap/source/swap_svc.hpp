@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+/* Swap supervisor calls, which are implemented by our kernel but not by libnx. */
+extern "C" {
+
+    ::Result svcGetSwapRequest(u64 *out_process_id, u64 *out_thread_id, u64 *out_vaddr);
+    ::Result svcMarkAsResidentAndWake(u64 process_id, u64 thread_id, u64 vaddr, u64 buffer);
+    ::Result svcRegisterSwapEvent(::Handle event_handle);
+
+    ::Result svcEvictSwapPages(s32 *out_num_evicted, u64 process_id, u64 address, u64 size);
+    ::Result svcGetSwapEvictions(s32 *out_num_evictions, ams::svc::SwapEvictionInfo *out_infos, u64 buffer, s32 max_count);
+    ::Result svcCompleteSwapEvictions(const ams::svc::SwapEvictionCompletion *completions, s32 num_completions);
+
+    ::Result svcRegisterSwapFaultRings(u64 request_ring, u64 completion_ring);
+    ::Result svcCompleteSwapFaults(s32 *out_num_completed);
+
+    ::Result svcGetSwapCandidates(s32 *out_num_candidates, u64 *out_addresses, u64 process_id, s32 max_count);
+
+    ::Result svcGetSwapReadaheadSize(s32 *out_num_pages, u64 process_id, u64 address, s32 max_pages);
+    ::Result svcCompleteSwapFaultRange(s32 *out_num_installed, const ams::svc::SwapFaultRequest *request, u64 buffer, s32 num_pages);
+    ::Result svcGetReleasedSwapOffsets(s32 *out_num_offsets, u64 *out_offsets, s32 max_count);
+
+    ::Result svcGetSwappedPages(s32 *out_num_pages, ams::svc::SwapPageInfo *out_infos, u64 process_id, u64 address, s32 max_count);
+    ::Result svcRestoreSwappedPages(s32 *out_num_restored, u64 process_id, const ams::svc::SwapPageInfo *infos, u64 buffer, s32 num_pages);
+
+    ::Result svcGetSwapReclaimRequest(ams::svc::SwapReclaimRequest *out_request);
+    ::Result svcGetSwapActivityRequest(ams::svc::SwapActivityRequest *out_request);
+    ::Result svcGetResidentSwapPages(s32 *out_num_pages, u64 *out_addresses, u64 process_id, u64 address, s32 max_count);
+
+    ::Result svcRelocateSwappedPages(u64 *out_relocated_mask, const ams::svc::SwapRelocation *relocations, s32 num_relocations);
+
+    ::Result svcMapSwapInFrames(u64 *out_address, u64 process_id, s32 num_pages);
+    ::Result svcUnmapSwapInFrames(u64 address, s32 num_pages);
+
+}
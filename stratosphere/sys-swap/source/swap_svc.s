@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Result svcGetSwapRequest(u64 *out_process_id, u64 *out_thread_id, u64 *out_vaddr) */
+.section    .text.svcGetSwapRequest, "ax", %progbits
+.global     svcGetSwapRequest
+.type       svcGetSwapRequest, %function
+.balign 0x10
+svcGetSwapRequest:
+    stp     x0, x1, [sp, #-0x10]!
+    str     x2, [sp, #-0x10]!
+    svc     #0x92
+    ldr     x4, [sp], #0x10
+    ldp     x5, x6, [sp], #0x10
+    str     x1, [x5]
+    str     x2, [x6]
+    str     x3, [x4]
+    ret
+
+/* Result svcMarkAsResidentAndWake(u64 process_id, u64 thread_id, u64 vaddr, u64 buffer) */
+.section    .text.svcMarkAsResidentAndWake, "ax", %progbits
+.global     svcMarkAsResidentAndWake
+.type       svcMarkAsResidentAndWake, %function
+.balign 0x10
+svcMarkAsResidentAndWake:
+    svc     #0x93
+    ret
+
+/* Result svcRegisterSwapEvent(Handle event_handle) */
+.section    .text.svcRegisterSwapEvent, "ax", %progbits
+.global     svcRegisterSwapEvent
+.type       svcRegisterSwapEvent, %function
+.balign 0x10
+svcRegisterSwapEvent:
+    svc     #0x94
+    ret
+
+/* Result svcEvictSwapPages(s32 *out_num_evicted, u64 process_id, u64 address, u64 size) */
+.section    .text.svcEvictSwapPages, "ax", %progbits
+.global     svcEvictSwapPages
+.type       svcEvictSwapPages, %function
+.balign 0x10
+svcEvictSwapPages:
+    str     x0, [sp, #-0x10]!
+    svc     #0x95
+    ldr     x2, [sp], #0x10
+    str     w1, [x2]
+    ret
+
+/* Result svcGetSwapEvictions(s32 *out_num_evictions, ams::svc::SwapEvictionInfo *out_infos, u64 buffer, s32 max_count) */
+.section    .text.svcGetSwapEvictions, "ax", %progbits
+.global     svcGetSwapEvictions
+.type       svcGetSwapEvictions, %function
+.balign 0x10
+svcGetSwapEvictions:
+    str     x0, [sp, #-0x10]!
+    svc     #0x96
+    ldr     x2, [sp], #0x10
+    str     w1, [x2]
+    ret
+
+/* Result svcCompleteSwapEvictions(const ams::svc::SwapEvictionCompletion *completions, s32 num_completions) */
+.section    .text.svcCompleteSwapEvictions, "ax", %progbits
+.global     svcCompleteSwapEvictions
+.type       svcCompleteSwapEvictions, %function
+.balign 0x10
+svcCompleteSwapEvictions:
+    svc     #0x97
+    ret
+
+/* Result svcRegisterSwapFaultRings(u64 request_ring, u64 completion_ring) */
+.section    .text.svcRegisterSwapFaultRings, "ax", %progbits
+.global     svcRegisterSwapFaultRings
+.type       svcRegisterSwapFaultRings, %function
+.balign 0x10
+svcRegisterSwapFaultRings:
+    svc     #0x98
+    ret
+
+/* Result svcCompleteSwapFaults(s32 *out_num_completed) */
+.section    .text.svcCompleteSwapFaults, "ax", %progbits
+.global     svcCompleteSwapFaults
+.type       svcCompleteSwapFaults, %function
+.balign 0x10
+svcCompleteSwapFaults:
+    str     x0, [sp, #-0x10]!
+    svc     #0x99
+    ldr     x2, [sp], #0x10
+    str     w1, [x2]
+    ret
+
+/* Result svcGetSwapCandidates(s32 *out_num_candidates, u64 *out_addresses, u64 process_id, s32 max_count) */
+.section    .text.svcGetSwapCandidates, "ax", %progbits
+.global     svcGetSwapCandidates
+.type       svcGetSwapCandidates, %function
+.balign 0x10
+svcGetSwapCandidates:
+    str     x0, [sp, #-0x10]!
+    svc     #0x9A
+    ldr     x2, [sp], #0x10
+    str     w1, [x2]
+    ret
+
+/* Result svcGetSwapReadaheadSize(s32 *out_num_pages, u64 process_id, u64 address, s32 max_pages) */
+.section    .text.svcGetSwapReadaheadSize, "ax", %progbits
+.global     svcGetSwapReadaheadSize
+.type       svcGetSwapReadaheadSize, %function
+.balign 0x10
+svcGetSwapReadaheadSize:
+    str     x0, [sp, #-0x10]!
+    svc     #0x9B
+    ldr     x2, [sp], #0x10
+    str     w1, [x2]
+    ret
+
+/* Result svcCompleteSwapFaultRange(s32 *out_num_installed, const ams::svc::SwapFaultRequest *request, u64 buffer, s32 num_pages) */
+.section    .text.svcCompleteSwapFaultRange, "ax", %progbits
+.global     svcCompleteSwapFaultRange
+.type       svcCompleteSwapFaultRange, %function
+.balign 0x10
+svcCompleteSwapFaultRange:
+    str     x0, [sp, #-0x10]!
+    svc     #0x9C
+    ldr     x2, [sp], #0x10
+    str     w1, [x2]
+    ret
+
+/* Result svcGetReleasedSwapOffsets(s32 *out_num_offsets, u64 *out_offsets, s32 max_count) */
+.section    .text.svcGetReleasedSwapOffsets, "ax", %progbits
+.global     svcGetReleasedSwapOffsets
+.type       svcGetReleasedSwapOffsets, %function
+.balign 0x10
+svcGetReleasedSwapOffsets:
+    str     x0, [sp, #-0x10]!
+    svc     #0x9D
+    ldr     x2, [sp], #0x10
+    str     w1, [x2]
+    ret
+
+/* Result svcGetSwappedPages(s32 *out_num_pages, ams::svc::SwapPageInfo *out_infos, u64 process_id, u64 address, s32 max_count) */
+.section    .text.svcGetSwappedPages, "ax", %progbits
+.global     svcGetSwappedPages
+.type       svcGetSwappedPages, %function
+.balign 0x10
+svcGetSwappedPages:
+    str     x0, [sp, #-0x10]!
+    svc     #0x9E
+    ldr     x2, [sp], #0x10
+    str     w1, [x2]
+    ret
+
+/* Result svcRestoreSwappedPages(s32 *out_num_restored, u64 process_id, const ams::svc::SwapPageInfo *infos, u64 buffer, s32 num_pages) */
+.section    .text.svcRestoreSwappedPages, "ax", %progbits
+.global     svcRestoreSwappedPages
+.type       svcRestoreSwappedPages, %function
+.balign 0x10
+svcRestoreSwappedPages:
+    str     x0, [sp, #-0x10]!
+    svc     #0x9F
+    ldr     x2, [sp], #0x10
+    str     w1, [x2]
+    ret
+
+/* Result svcGetSwapReclaimRequest(ams::svc::SwapReclaimRequest *out_request) */
+.section    .text.svcGetSwapReclaimRequest, "ax", %progbits
+.global     svcGetSwapReclaimRequest
+.type       svcGetSwapReclaimRequest, %function
+.balign 0x10
+svcGetSwapReclaimRequest:
+    svc     #0xA0
+    ret
+
+/* Result svcGetSwapActivityRequest(ams::svc::SwapActivityRequest *out_request) */
+.section    .text.svcGetSwapActivityRequest, "ax", %progbits
+.global     svcGetSwapActivityRequest
+.type       svcGetSwapActivityRequest, %function
+.balign 0x10
+svcGetSwapActivityRequest:
+    svc     #0xA1
+    ret
+
+/* Result svcGetResidentSwapPages(s32 *out_num_pages, u64 *out_addresses, u64 process_id, u64 address, s32 max_count) */
+.section    .text.svcGetResidentSwapPages, "ax", %progbits
+.global     svcGetResidentSwapPages
+.type       svcGetResidentSwapPages, %function
+.balign 0x10
+svcGetResidentSwapPages:
+    str     x0, [sp, #-0x10]!
+    svc     #0xA2
+    ldr     x2, [sp], #0x10
+    str     w1, [x2]
+    ret
+
+/* Result svcRelocateSwappedPages(u64 *out_relocated_mask, const ams::svc::SwapRelocation *relocations, s32 num_relocations) */
+.section    .text.svcRelocateSwappedPages, "ax", %progbits
+.global     svcRelocateSwappedPages
+.type       svcRelocateSwappedPages, %function
+.balign 0x10
+svcRelocateSwappedPages:
+    str     x0, [sp, #-0x10]!
+    svc     #0xA3
+    ldr     x2, [sp], #0x10
+    str     x1, [x2]
+    ret
+
+/* Result svcMapSwapInFrames(u64 *out_address, u64 process_id, s32 num_pages) */
+.section    .text.svcMapSwapInFrames, "ax", %progbits
+.global     svcMapSwapInFrames
+.type       svcMapSwapInFrames, %function
+.balign 0x10
+svcMapSwapInFrames:
+    str     x0, [sp, #-0x10]!
+    svc     #0xA4
+    ldr     x2, [sp], #0x10
+    str     x1, [x2]
+    ret
+
+/* Result svcUnmapSwapInFrames(u64 address, s32 num_pages) */
+.section    .text.svcUnmapSwapInFrames, "ax", %progbits
+.global     svcUnmapSwapInFrames
+.type       svcUnmapSwapInFrames, %function
+.balign 0x10
+svcUnmapSwapInFrames:
+    svc     #0xA5
+    ret
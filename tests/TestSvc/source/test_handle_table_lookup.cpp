@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "util_common.hpp"
+#include "util_scoped_heap.hpp"
+
+namespace ams::test {
+
+    namespace {
+
+        constexpr s32 NumIterationsPerThread = 0x4000;
+        constexpr s32 NumLookupsPerThread    = 0x10000;
+        constexpr size_t ThreadStackSize     = os::MemoryPageSize;
+
+        struct HandleLookupThreadArgument {
+            s32 core_id;
+            svc::Handle handle;
+            u64 thread_id;
+            s32 num_wrong_objects;
+            s32 num_unexpected_results;
+        };
+
+        constinit volatile bool g_start_lookups;
+        constinit volatile svc::Handle g_churned_handles[NumCores];
+
+        void TestHandleLookupThreadFunction(HandleLookupThreadArgument *arg) {
+            /* Wait until every thread is ready to look up handles. */
+            while (!g_start_lookups) {
+                __asm__ __volatile__("" ::: "memory");
+            }
+
+            for (s32 i = 0; i < NumIterationsPerThread; ++i) {
+                /* Open a new event, and publish its handle to the other threads. */
+                svc::Handle write_handle, read_handle;
+                if (R_FAILED(svc::CreateEvent(std::addressof(write_handle), std::addressof(read_handle)))) {
+                    ++arg->num_unexpected_results;
+                    continue;
+                }
+                g_churned_handles[arg->core_id] = read_handle;
+
+                /* Our own thread handle is never closed, so it must always resolve to our thread. */
+                u64 thread_id;
+                if (R_FAILED(svc::GetThreadId(std::addressof(thread_id), arg->handle)) || thread_id != arg->thread_id) {
+                    ++arg->num_wrong_objects;
+                }
+
+                /* Look up the handles that the other threads are opening and closing. */
+                for (s32 core = 0; core < NumCores; ++core) {
+                    const svc::Handle handle = g_churned_handles[core];
+                    if (handle == svc::InvalidHandle) {
+                        continue;
+                    }
+
+                    /* Churned handles only ever refer to events, so they must never resolve to a thread. */
+                    if (const Result result = svc::GetThreadId(std::addressof(thread_id), handle); R_SUCCEEDED(result)) {
+                        ++arg->num_wrong_objects;
+                    } else if (!svc::ResultInvalidHandle::Includes(result)) {
+                        ++arg->num_unexpected_results;
+                    }
+
+                    /* The handle either still refers to a live event, or has been closed. */
+                    if (const Result result = svc::ClearEvent(handle); R_FAILED(result) && !svc::ResultInvalidHandle::Includes(result)) {
+                        ++arg->num_unexpected_results;
+                    }
+                }
+
+                /* Close the event. */
+                g_churned_handles[arg->core_id] = svc::InvalidHandle;
+                if (R_FAILED(svc::CloseHandle(read_handle)) || R_FAILED(svc::CloseHandle(write_handle))) {
+                    ++arg->num_unexpected_results;
+                }
+            }
+
+            /* Exit the thread. */
+            svc::ExitThread();
+        }
+
+        struct HandleLookupBenchmarkThreadArgument {
+            svc::Handle handle;
+            s64 elapsed_ticks;
+        };
+
+        void BenchmarkHandleLookupThreadFunction(HandleLookupBenchmarkThreadArgument *arg) {
+            /* Wait until every thread is ready to look up handles. */
+            while (!g_start_lookups) {
+                __asm__ __volatile__("" ::: "memory");
+            }
+
+            /* Look up our own handle, so that each thread opens a different object in the same table. */
+            const s64 start_tick = svc::GetSystemTick();
+            for (s32 i = 0; i < NumLookupsPerThread; ++i) {
+                u64 thread_id;
+                svc::GetThreadId(std::addressof(thread_id), arg->handle);
+            }
+            arg->elapsed_ticks = svc::GetSystemTick() - start_tick;
+
+            /* Exit the thread. */
+            svc::ExitThread();
+        }
+
+        s64 MeasureHandleLookupTicks(uintptr_t stacks, s32 num_threads) {
+            svc::Handle thread_handles[NumCores];
+            HandleLookupBenchmarkThreadArgument args[NumCores] = {};
+
+            /* Create one thread per core. */
+            g_start_lookups = false;
+            for (s32 i = 0; i < num_threads; ++i) {
+                DOCTEST_CHECK(R_SUCCEEDED(svc::CreateThread(thread_handles + i, reinterpret_cast<uintptr_t>(&BenchmarkHandleLookupThreadFunction), reinterpret_cast<uintptr_t>(args + i), stacks + (i + 1) * ThreadStackSize, HighestTestPriority, i)));
+                args[i].handle = thread_handles[i];
+            }
+
+            /* Start the threads, and have them all start looking up handles at once. */
+            for (s32 i = 0; i < num_threads; ++i) {
+                DOCTEST_CHECK(R_SUCCEEDED(svc::StartThread(thread_handles[i])));
+            }
+            g_start_lookups = true;
+
+            /* Wait for the threads to exit, and close their handles. */
+            s64 max_elapsed_ticks = 0;
+            for (s32 i = 0; i < num_threads; ++i) {
+                s32 dummy;
+                DOCTEST_CHECK(R_SUCCEEDED(svc::WaitSynchronization(std::addressof(dummy), thread_handles + i, 1, -1)));
+                DOCTEST_CHECK(R_SUCCEEDED(svc::CloseHandle(thread_handles[i])));
+
+                max_elapsed_ticks = std::max(max_elapsed_ticks, args[i].elapsed_ticks);
+            }
+
+            return max_elapsed_ticks;
+        }
+
+    }
+
+    DOCTEST_TEST_CASE( "Looking up handles while other cores open and close handles never returns the wrong object" ) {
+        /* Create heap for the thread stacks. */
+        ScopedHeap heap(NumCores * ThreadStackSize);
+
+        svc::Handle thread_handles[NumCores];
+        HandleLookupThreadArgument args[NumCores] = {};
+
+        /* Create one thread per core. */
+        g_start_lookups = false;
+        for (s32 i = 0; i < NumCores; ++i) {
+            g_churned_handles[i] = svc::InvalidHandle;
+
+            DOCTEST_CHECK(R_SUCCEEDED(svc::CreateThread(thread_handles + i, reinterpret_cast<uintptr_t>(&TestHandleLookupThreadFunction), reinterpret_cast<uintptr_t>(args + i), heap.GetAddress() + (i + 1) * ThreadStackSize, HighestTestPriority, i)));
+            DOCTEST_CHECK(R_SUCCEEDED(svc::GetThreadId(std::addressof(args[i].thread_id), thread_handles[i])));
+            args[i].core_id = i;
+            args[i].handle  = thread_handles[i];
+        }
+
+        /* Start the threads, and have them all start churning handles at once. */
+        for (s32 i = 0; i < NumCores; ++i) {
+            DOCTEST_CHECK(R_SUCCEEDED(svc::StartThread(thread_handles[i])));
+        }
+        g_start_lookups = true;
+
+        /* Wait for the threads to exit, and close their handles. */
+        for (s32 i = 0; i < NumCores; ++i) {
+            s32 dummy;
+            DOCTEST_CHECK(R_SUCCEEDED(svc::WaitSynchronization(std::addressof(dummy), thread_handles + i, 1, -1)));
+            DOCTEST_CHECK(R_SUCCEEDED(svc::CloseHandle(thread_handles[i])));
+
+            /* Every lookup must have returned the right object, or reported the handle as invalid. */
+            DOCTEST_CHECK(args[i].num_wrong_objects == 0);
+            DOCTEST_CHECK(args[i].num_unexpected_results == 0);
+        }
+    }
+
+    DOCTEST_TEST_CASE( "Benchmark handle lookups from one core and from every core" ) {
+        /* Create heap for the thread stacks. */
+        ScopedHeap heap(NumCores * ThreadStackSize);
+
+        /* Measure lookups from a single core, and then from every core at once. */
+        const s64 uncontended_ticks = MeasureHandleLookupTicks(heap.GetAddress(), 1);
+        const s64 contended_ticks   = MeasureHandleLookupTicks(heap.GetAddress(), NumCores);
+
+        /* Report the throughput of each. */
+        /* NOTE: Timing depends on the load of the rest of the system, so the numbers are reported rather than checked. */
+        const s64 uncontended_lookups_per_second = (static_cast<s64>(NumLookupsPerThread) * svc::TicksPerSecond) / std::max<s64>(uncontended_ticks, 1);
+        const s64 contended_lookups_per_second   = (static_cast<s64>(NumLookupsPerThread) * NumCores * svc::TicksPerSecond) / std::max<s64>(contended_ticks, 1);
+
+        DOCTEST_MESSAGE("Handle lookups: " << uncontended_lookups_per_second << "/s on one core (" << uncontended_ticks << " ticks), " << contended_lookups_per_second << "/s on " << NumCores << " cores (" << contended_ticks << " ticks), " << NumLookupsPerThread << " lookups per core");
+    }
+
+}
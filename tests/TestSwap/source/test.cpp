@@ -0,0 +1,453 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+
+namespace ams {
+
+    namespace {
+
+        #define TEST_R_EXPECT(__EXPR__, __EXPECTED__)                                                                                                                        \
+        ({                                                                                                                                                                   \
+            const Result __test_result = (__EXPR__);                                                                                                                         \
+            if (!(__EXPECTED__ ::Includes(__test_result))) {                                                                                                                 \
+                printf("Unexpected result: %s gave 0x%08x (2%03d-%04d)\n", # __EXPR__, __test_result.GetValue(), __test_result.GetModule(), __test_result.GetDescription()); \
+                AMS_ABORT("Swap test failed");                                                                                                                               \
+            }                                                                                                                                                                \
+            __test_result;                                                                                                                                                   \
+        })
+
+        #define TEST_R_TRY(__EXPR__)                                                                                                                                         \
+        ({                                                                                                                                                                   \
+            const Result __test_result = (__EXPR__);                                                                                                                         \
+            if (R_FAILED(__test_result)) {                                                                                                                                   \
+                printf("Unexpected result: %s gave 0x%08x (2%03d-%04d)\n", # __EXPR__, __test_result.GetValue(), __test_result.GetModule(), __test_result.GetDescription()); \
+                AMS_ABORT("Swap test failed");                                                                                                                               \
+            }                                                                                                                                                                \
+            __test_result;                                                                                                                                                   \
+        })
+
+        /* NOTE: The partition's metadata takes up the first segment, so the storage holds one more segment than the partition has for data. */
+        constexpr size_t NumDataSegments = 8;
+        constexpr size_t StorageSize     = (NumDataSegments + 1) * swap::SwapPartition::SegmentSize;
+
+        /* NOTE: The store tests swap out enough pages to fill five of the eight data segments, leaving fewer free than cleaning wants. */
+        constexpr u64 TestProcessId           = 0x80;
+        constexpr u64 TestAddressBase         = 0x8000000;
+        constexpr size_t NumCompressiblePages = 0x10;
+        constexpr size_t NumTestPages         = NumCompressiblePages + 5 * swap::SwapPartition::SlotsPerSegment;
+        constexpr u64 NotSwapped              = std::numeric_limits<u64>::max();
+
+        alignas(os::MemoryPageSize) constinit u8 g_storage_memory[StorageSize];
+        alignas(os::MemoryPageSize) constinit u8 g_page_buffer[swap::SwapStore::MaxBatchPages * ams::svc::SwapPageSize];
+        alignas(os::MemoryPageSize) constinit u8 g_read_buffer[ams::svc::SwapReadaheadMaxPages * ams::svc::SwapPageSize];
+
+        fs::MemoryStorage g_memory_storage(g_storage_memory, sizeof(g_storage_memory));
+        swap::IoScheduler g_io_scheduler;
+        swap::SwapPartition g_partition;
+        swap::CompressedPool g_compressed_pool;
+        swap::SwapStore g_store;
+        swap::ReadaheadTracker g_readahead_tracker;
+
+        ams::svc::SwapEvictionInfo g_eviction_infos[swap::SwapStore::MaxBatchPages];
+        ams::svc::SwapEvictionCompletion g_eviction_completions[swap::SwapStore::MaxBatchPages];
+
+        /* NOTE: This stands in for the kernel's page tables, recording where each test page was swapped out to. */
+        u64 g_swap_offsets[NumTestPages];
+
+        constexpr u64 GetPageAddress(size_t index) {
+            return TestAddressBase + index * ams::svc::SwapPageSize;
+        }
+
+        void FillPage(void *dst, size_t index) {
+            u64 *words = static_cast<u64 *>(dst);
+
+            /* The first pages repeat their address, so that they compress well. */
+            if (index < NumCompressiblePages) {
+                std::fill(words, words + ams::svc::SwapPageSize / sizeof(u64), GetPageAddress(index));
+                return;
+            }
+
+            /* The rest are filled with a sequence seeded by their address, which doesn't compress. */
+            u64 state = GetPageAddress(index) | 1;
+            for (size_t i = 0; i < ams::svc::SwapPageSize / sizeof(u64); ++i) {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                words[i] = state;
+            }
+        }
+
+        bool IsPageIntact(const void *page, size_t index) {
+            alignas(os::MemoryPageSize) u8 expected[ams::svc::SwapPageSize];
+            FillPage(expected, index);
+            return std::memcmp(page, expected, sizeof(expected)) == 0;
+        }
+
+        Result RelocateSwappedPages(u64 *out_relocated_mask, const ams::svc::SwapRelocation *relocations, s32 num_relocations) {
+            /* Like the kernel, only move a page which is still swapped out at its old offset. */
+            u64 relocated_mask = 0;
+            for (s32 i = 0; i < num_relocations; ++i) {
+                const auto &relocation = relocations[i];
+                AMS_ABORT_UNLESS(relocation.process_id == TestProcessId);
+
+                const size_t index = (relocation.address - TestAddressBase) / ams::svc::SwapPageSize;
+                if (index < NumTestPages && g_swap_offsets[index] == relocation.old_offset) {
+                    g_swap_offsets[index] = relocation.new_offset;
+                    relocated_mask |= (static_cast<u64>(1) << i);
+                }
+            }
+
+            *out_relocated_mask = relocated_mask;
+            R_SUCCEED();
+        }
+
+        void EvictPages(size_t first_index, s32 count) {
+            AMS_ABORT_UNLESS(0 < count && count <= swap::SwapStore::MaxBatchPages);
+
+            /* Hand the store a batch of pages, as the kernel's eviction queue would. */
+            for (s32 i = 0; i < count; ++i) {
+                const size_t index = first_index + i;
+                g_eviction_infos[i] = { .process_id = TestProcessId, .address = GetPageAddress(index), .reserved = 0, .id = static_cast<u32>(index), .flags = ams::svc::SwapEvictionFlag_None };
+                FillPage(g_page_buffer + i * ams::svc::SwapPageSize, index);
+            }
+
+            g_store.WriteBatch(g_eviction_completions, g_eviction_infos, g_page_buffer, count);
+
+            /* Record where each page went, with the flag the kernel would add for the pool. */
+            for (s32 i = 0; i < count; ++i) {
+                const auto &completion = g_eviction_completions[i];
+                const size_t index     = completion.id;
+                AMS_ABORT_UNLESS(first_index <= index && index < first_index + count);
+
+                if (index < NumCompressiblePages) {
+                    AMS_ABORT_UNLESS(completion.status == ams::svc::SwapEvictionStatus_Compressed);
+                    AMS_ABORT_UNLESS(completion.stored_size < ams::svc::SwapPageSize);
+                    g_swap_offsets[index] = completion.sector_offset | ams::svc::SwapOffsetCompressedFlag;
+                } else {
+                    AMS_ABORT_UNLESS(completion.status == ams::svc::SwapEvictionStatus_Written);
+                    g_swap_offsets[index] = completion.sector_offset;
+                }
+            }
+        }
+
+        void ReleasePage(size_t index) {
+            g_store.Release(g_swap_offsets + index, 1);
+            g_swap_offsets[index] = NotSwapped;
+        }
+
+        void VerifySwappedPages() {
+            for (size_t i = 0; i < NumTestPages; ++i) {
+                if (g_swap_offsets[i] != NotSwapped) {
+                    TEST_R_TRY(g_store.ReadCurrentPages(g_read_buffer, g_swap_offsets[i], TestProcessId, GetPageAddress(i), 1));
+                    AMS_ABORT_UNLESS(IsPageIntact(g_read_buffer, i));
+                }
+            }
+        }
+
+        Result FormatPartition() {
+            std::memset(g_storage_memory, 0, sizeof(g_storage_memory));
+
+            R_TRY(swap::SwapPartition::Create(std::addressof(g_io_scheduler)));
+            R_RETURN(g_partition.Mount(std::addressof(g_io_scheduler)));
+        }
+
+        void DoIoSchedulerTests() {
+            /* Background accesses are made a chunk at a time, but must still complete as a whole. */
+            constexpr s64 Offset = ams::svc::SwapSectorSize;
+            static_assert(sizeof(g_page_buffer) > swap::IoScheduler::ChunkSize);
+
+            for (size_t i = 0; i < swap::SwapStore::MaxBatchPages; ++i) {
+                FillPage(g_page_buffer + i * ams::svc::SwapPageSize, NumCompressiblePages + i);
+            }
+
+            fs::SetPriorityRawOnCurrentThread(fs::PriorityRaw_Background);
+            TEST_R_TRY(g_io_scheduler.Write(Offset, g_page_buffer, sizeof(g_page_buffer)));
+            AMS_ABORT_UNLESS(std::memcmp(g_storage_memory + Offset, g_page_buffer, sizeof(g_page_buffer)) == 0);
+
+            /* Accesses of other priorities are made whole. */
+            std::memset(g_page_buffer, 0, sizeof(g_page_buffer));
+            fs::SetPriorityRawOnCurrentThread(fs::PriorityRaw_Realtime);
+            TEST_R_TRY(g_io_scheduler.Read(Offset, g_page_buffer, sizeof(g_page_buffer)));
+            AMS_ABORT_UNLESS(std::memcmp(g_storage_memory + Offset, g_page_buffer, sizeof(g_page_buffer)) == 0);
+
+            /* Accesses past the end of the storage fail, rather than hanging the thread which made them. */
+            TEST_R_EXPECT(g_io_scheduler.Read(StorageSize - ams::svc::SwapSectorSize, g_page_buffer, ams::svc::SwapPageSize), fs::ResultOutOfRange);
+
+            fs::SetPriorityRawOnCurrentThread(fs::PriorityRaw_Normal);
+        }
+
+        void DoSlotAllocationTests() {
+            constexpr u32 SlotsPerSegment = swap::SwapPartition::SlotsPerSegment;
+
+            TEST_R_TRY(FormatPartition());
+            AMS_ABORT_UNLESS(g_partition.GetNumSlots() == NumDataSegments * SlotsPerSegment);
+
+            /* Runs are handed out in order from the head of the log. */
+            u64 first, second;
+            AMS_ABORT_UNLESS(g_partition.AllocateRun(std::addressof(first), 0x10) == 0x10);
+            AMS_ABORT_UNLESS(g_partition.AllocateRun(std::addressof(second), 0x10) == 0x10);
+            AMS_ABORT_UNLESS(second == first + 0x10 * ams::svc::SwapSectorsPerPage);
+
+            /* A run ends at the end of its segment, so that it's never split between two. */
+            u64 rest;
+            AMS_ABORT_UNLESS(g_partition.AllocateRun(std::addressof(rest), SlotsPerSegment) == SlotsPerSegment - 0x20);
+            AMS_ABORT_UNLESS(rest == second + 0x10 * ams::svc::SwapSectorsPerPage);
+
+            /* A run which is freed as soon as it's handed out goes back to the head, so that the log has no hole. */
+            u64 run, again;
+            AMS_ABORT_UNLESS(g_partition.AllocateRun(std::addressof(run), 4) == 4);
+            g_partition.FreeRun(run, 4);
+            AMS_ABORT_UNLESS(g_partition.AllocateRun(std::addressof(again), 4) == 4);
+            AMS_ABORT_UNLESS(again == run);
+
+            /* Each slot records the page it holds. */
+            u64 process_id, address;
+            g_partition.SetOwner(again, TestProcessId, GetPageAddress(1));
+            AMS_ABORT_UNLESS(g_partition.IsOwnedBy(again, TestProcessId, GetPageAddress(1)));
+            AMS_ABORT_UNLESS(g_partition.GetOwner(std::addressof(process_id), std::addressof(address), again));
+            AMS_ABORT_UNLESS(process_id == TestProcessId && address == GetPageAddress(1));
+            AMS_ABORT_UNLESS(!g_partition.GetOwner(std::addressof(process_id), std::addressof(address), again + ams::svc::SwapSectorsPerPage));
+
+            /* Fill the partition, until only the segment reserved for cleaning is left. */
+            while (!g_partition.IsFull()) {
+                u64 offset;
+                AMS_ABORT_UNLESS(g_partition.AllocateRun(std::addressof(offset), SlotsPerSegment) > 0);
+            }
+
+            u64 offset;
+            AMS_ABORT_UNLESS(g_partition.AllocateRun(std::addressof(offset), 1) == 0);
+
+            /* Once every slot in a segment is freed, the segment can be written again. */
+            for (u32 i = 0; i < SlotsPerSegment; ++i) {
+                g_partition.Free(first + i * ams::svc::SwapSectorsPerPage);
+            }
+            AMS_ABORT_UNLESS(!g_partition.IsFull());
+            AMS_ABORT_UNLESS(g_partition.AllocateRun(std::addressof(offset), 1) == 1);
+            AMS_ABORT_UNLESS(offset == first);
+
+            /* Only cleaning may take the reserved segment. */
+            while (g_partition.AllocateRun(std::addressof(offset), SlotsPerSegment) > 0) {
+                /* ... */
+            }
+            AMS_ABORT_UNLESS(g_partition.IsFull());
+            AMS_ABORT_UNLESS(g_partition.AllocateRun(std::addressof(offset), 1, true) == 1);
+        }
+
+        void DoVerificationTests() {
+            TEST_R_TRY(FormatPartition());
+
+            /* Pages which are written read back intact. */
+            u64 offset;
+            AMS_ABORT_UNLESS(g_partition.AllocateRun(std::addressof(offset), 2) == 2);
+
+            FillPage(g_page_buffer, NumCompressiblePages);
+            FillPage(g_page_buffer + ams::svc::SwapPageSize, NumCompressiblePages + 1);
+            TEST_R_TRY(g_partition.WritePages(offset, g_page_buffer, 2));
+
+            TEST_R_TRY(g_partition.ReadPages(g_read_buffer, offset, 2));
+            AMS_ABORT_UNLESS(IsPageIntact(g_read_buffer, NumCompressiblePages));
+            AMS_ABORT_UNLESS(IsPageIntact(g_read_buffer + ams::svc::SwapPageSize, NumCompressiblePages + 1));
+
+            /* A single flipped bit fails verification, without affecting the page before it. */
+            g_storage_memory[(offset + ams::svc::SwapSectorsPerPage) * ams::svc::SwapSectorSize + 0x123] ^= 0x01;
+            TEST_R_EXPECT(g_partition.ReadPages(g_read_buffer, offset, 2), fs::ResultDataCorrupted);
+            TEST_R_TRY(g_partition.ReadPages(g_read_buffer, offset, 1));
+            AMS_ABORT_UNLESS(g_partition.GetStatistics().num_verification_failures == 1);
+
+            /* A freed slot's old contents never verify, even though they're intact. */
+            g_partition.Free(offset);
+            TEST_R_EXPECT(g_partition.ReadPages(g_read_buffer, offset, 1), fs::ResultDataCorrupted);
+
+            /* Nor do pages written before the partition was last mounted, as nothing from an earlier boot is still referenced. */
+            u64 old_offset;
+            AMS_ABORT_UNLESS(g_partition.AllocateRun(std::addressof(old_offset), 1) == 1);
+            TEST_R_TRY(g_partition.WritePages(old_offset, g_page_buffer, 1));
+            TEST_R_TRY(g_partition.Flush());
+
+            TEST_R_TRY(g_partition.Mount(std::addressof(g_io_scheduler)));
+            TEST_R_EXPECT(g_partition.ReadPages(g_read_buffer, old_offset, 1), fs::ResultDataCorrupted);
+
+            /* Storage which we didn't create is never mounted. */
+            std::memset(g_storage_memory, 0, ams::svc::SwapSectorSize);
+            TEST_R_EXPECT(g_partition.Mount(std::addressof(g_io_scheduler)), fs::ResultDataCorrupted);
+        }
+
+        void DoReadaheadTests() {
+            g_readahead_tracker.Initialize(8);
+            g_readahead_tracker.BeginBatch();
+
+            /* A process's first fault isn't read ahead. */
+            AMS_ABORT_UNLESS(g_readahead_tracker.GetReadaheadPages(TestProcessId, GetPageAddress(0), 0) == 1);
+            g_readahead_tracker.OnPagesRead(TestProcessId, GetPageAddress(0), 1);
+
+            /* A fault on the page after it is sequential, so it is. */
+            AMS_ABORT_UNLESS(g_readahead_tracker.GetReadaheadPages(TestProcessId, GetPageAddress(1), 0) == 8);
+
+            /* Faults elsewhere, by other processes, or on pages in the compressed pool aren't. */
+            AMS_ABORT_UNLESS(g_readahead_tracker.GetReadaheadPages(TestProcessId, GetPageAddress(100), 0) == 1);
+            AMS_ABORT_UNLESS(g_readahead_tracker.GetReadaheadPages(TestProcessId + 1, GetPageAddress(1), 0) == 1);
+            AMS_ABORT_UNLESS(g_readahead_tracker.GetReadaheadPages(TestProcessId, GetPageAddress(1), ams::svc::SwapOffsetCompressedFlag) == 1);
+
+            /* Pages read ahead are remembered until the batch ends, as other threads may fault on them too. */
+            g_readahead_tracker.OnPagesRead(TestProcessId, GetPageAddress(1), 8);
+            AMS_ABORT_UNLESS(g_readahead_tracker.IsPageRead(TestProcessId, GetPageAddress(1)));
+            AMS_ABORT_UNLESS(g_readahead_tracker.IsPageRead(TestProcessId, GetPageAddress(8)));
+            AMS_ABORT_UNLESS(!g_readahead_tracker.IsPageRead(TestProcessId, GetPageAddress(9)));
+            AMS_ABORT_UNLESS(!g_readahead_tracker.IsPageRead(TestProcessId + 1, GetPageAddress(1)));
+            AMS_ABORT_UNLESS(g_readahead_tracker.GetReadaheadPages(TestProcessId, GetPageAddress(9), 0) == 8);
+
+            g_readahead_tracker.BeginBatch();
+            AMS_ABORT_UNLESS(!g_readahead_tracker.IsPageRead(TestProcessId, GetPageAddress(1)));
+
+            /* Each process keeps its own stream, until more processes fault than there are streams. */
+            for (size_t i = 1; i < swap::ReadaheadTracker::NumStreams; ++i) {
+                g_readahead_tracker.OnPagesRead(TestProcessId + i, GetPageAddress(0), 1);
+            }
+            AMS_ABORT_UNLESS(g_readahead_tracker.GetReadaheadPages(TestProcessId, GetPageAddress(9), 0) == 8);
+
+            g_readahead_tracker.OnPagesRead(TestProcessId + swap::ReadaheadTracker::NumStreams, GetPageAddress(0), 1);
+            AMS_ABORT_UNLESS(g_readahead_tracker.GetReadaheadPages(TestProcessId, GetPageAddress(9), 0) == 1);
+
+            /* The readahead size is limited to what the kernel will map at once. */
+            g_readahead_tracker.Initialize(0x1000);
+            g_readahead_tracker.OnPagesRead(TestProcessId, GetPageAddress(0), 1);
+            AMS_ABORT_UNLESS(g_readahead_tracker.GetReadaheadPages(TestProcessId, GetPageAddress(1), 0) == swap::ReadaheadTracker::MaxReadaheadPages);
+        }
+
+        void DoStoreTests() {
+            constexpr u32 SlotsPerSegment = swap::SwapPartition::SlotsPerSegment;
+
+            TEST_R_TRY(FormatPartition());
+            g_compressed_pool.Initialize();
+            g_store.Initialize(std::addressof(g_partition), std::addressof(g_compressed_pool), RelocateSwappedPages);
+            std::fill(std::begin(g_swap_offsets), std::end(g_swap_offsets), NotSwapped);
+
+            /* Pages which compress well are kept in the compressed pool, and the rest are appended to the partition. */
+            for (size_t i = 0; i < NumTestPages; i += swap::SwapStore::MaxBatchPages) {
+                EvictPages(i, static_cast<s32>(std::min<size_t>(swap::SwapStore::MaxBatchPages, NumTestPages - i)));
+            }
+            TEST_R_TRY(g_store.Flush());
+            VerifySwappedPages();
+
+            /* Once a page has been released, it can no longer be read. */
+            const u64 released_offset = g_swap_offsets[0];
+            ReleasePage(0);
+            TEST_R_EXPECT(g_store.ReadCurrentPages(g_read_buffer, released_offset, TestProcessId, GetPageAddress(0), 1), svc::ResultNotFound);
+
+            /* Swapping out five of the eight segments leaves too few free, so the partition wants cleaning. */
+            AMS_ABORT_UNLESS(g_partition.NeedsCleaning());
+
+            /* Release most of the pages in the first two segments, as if they had been swapped back in. */
+            constexpr size_t KeepInterval = 0x10;
+            for (size_t i = 0; i < 2 * SlotsPerSegment; ++i) {
+                if ((i % KeepInterval) != 0) {
+                    ReleasePage(NumCompressiblePages + i);
+                }
+            }
+
+            /* Cleaning moves the pages still live in those segments to the head, so that they can be rewritten. */
+            const u64 kept_offset = g_swap_offsets[NumCompressiblePages];
+            const u64 num_written = g_partition.GetStatistics().num_pages_written;
+            for (size_t i = 0; i < 8 && g_partition.NeedsCleaning(); ++i) {
+                TEST_R_TRY(g_store.Clean());
+            }
+            AMS_ABORT_UNLESS(!g_partition.NeedsCleaning());
+            AMS_ABORT_UNLESS(g_partition.GetStatistics().num_pages_written - num_written == 2 * SlotsPerSegment / KeepInterval);
+
+            /* Every page is still where the kernel thinks it is, and intact. */
+            VerifySwappedPages();
+
+            /* A page which was moved can no longer be read through its old offset. */
+            AMS_ABORT_UNLESS(g_swap_offsets[NumCompressiblePages] != kept_offset);
+            TEST_R_EXPECT(g_store.ReadCurrentPages(g_read_buffer, kept_offset, TestProcessId, GetPageAddress(NumCompressiblePages), 1), svc::ResultNotFound);
+        }
+
+        void DoFaultTrace(const char *name, size_t stride) {
+            /* Replay faults on every swapped page, visiting them with the given stride, and reading ahead as sys-swap does. */
+            constexpr size_t BatchSize = ams::svc::SwapFaultRingCapacity;
+
+            g_readahead_tracker.Initialize(8);
+
+            size_t num_faults = 0, num_reads = 0, num_pages = 0;
+            const os::Tick start_tick = os::GetSystemTick();
+            for (size_t i = 0; i < NumTestPages; ++i) {
+                if ((i % BatchSize) == 0) {
+                    g_readahead_tracker.BeginBatch();
+                }
+
+                const size_t index = (i * stride) % NumTestPages;
+                if (g_swap_offsets[index] == NotSwapped) {
+                    continue;
+                }
+                ++num_faults;
+
+                /* Faults on pages read ahead are resolved without reading them again. */
+                const u64 address = GetPageAddress(index);
+                if (g_readahead_tracker.IsPageRead(TestProcessId, address)) {
+                    continue;
+                }
+
+                /* Like the kernel, only read ahead the following pages while their slots are contiguous. */
+                const u64 swap_offset = g_swap_offsets[index];
+                const s32 max_pages   = g_readahead_tracker.GetReadaheadPages(TestProcessId, address, swap_offset);
+
+                s32 run_pages = 1;
+                while (run_pages < max_pages && index + run_pages < NumTestPages && g_swap_offsets[index + run_pages] == swap_offset + run_pages * ams::svc::SwapSectorsPerPage) {
+                    ++run_pages;
+                }
+
+                TEST_R_TRY(g_store.ReadCurrentPages(g_read_buffer, swap_offset, TestProcessId, address, run_pages));
+                g_readahead_tracker.OnPagesRead(TestProcessId, address, run_pages);
+
+                ++num_reads;
+                num_pages += run_pages;
+            }
+            const TimeSpan elapsed = (os::GetSystemTick() - start_tick).ToTimeSpan();
+
+            printf("%s faults: %zu faults, %zu reads, %zu pages in %lld us (%lld ns/fault)\n", name, num_faults, num_reads, num_pages, static_cast<long long>(elapsed.GetMicroSeconds()), static_cast<long long>(elapsed.GetNanoSeconds() / std::max<size_t>(num_faults, 1)));
+        }
+
+        void DoFaultBenchmark() {
+            /* NOTE: The stride is coprime with the number of pages, so that the scattered trace visits each page once. */
+            static_assert(NumTestPages % 7919 != 0);
+
+            DoFaultTrace("Sequential", 1);
+            DoFaultTrace("Scattered", 7919);
+        }
+
+    }
+
+    void Main() {
+        fs::SetEnabledAutoAbort(false);
+
+        /* Every access to the swap storage goes through the I/O scheduler, as in sys-swap. */
+        R_ABORT_UNLESS(g_io_scheduler.Initialize(std::addressof(g_memory_storage), os::GetThreadPriority(os::GetCurrentThread())));
+
+        printf("Doing swap tests!\n");
+        DoIoSchedulerTests();
+        DoSlotAllocationTests();
+        DoVerificationTests();
+        DoReadaheadTests();
+        DoStoreTests();
+
+        printf("Doing swap fault benchmark!\n");
+        DoFaultBenchmark();
+
+        g_io_scheduler.Finalize();
+        printf("All tests completed!\n");
+    }
+
+}
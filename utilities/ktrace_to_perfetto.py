@@ -0,0 +1,143 @@
+#
+# Copyright (c) Atmosphère-NX
+#
+# This program is free software; you can redistribute it and/or modify it
+# under the terms and conditions of the GNU General Public License,
+# version 2, as published by the Free Software Foundation.
+#
+# This program is distributed in the hope it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+# more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# ktrace_to_perfetto.py: Converts kernel trace records to Chrome trace JSON, which Perfetto (ui.perfetto.dev) opens.
+# The input is either a dump of the whole buffer mapped by the KernelTraceBuffer capability, or a stream
+# of records copied out of its rings, as laid out in <vapours/svc/svc_types_trace.hpp>.
+
+import sys, json
+from struct import unpack as up
+
+KTRACE_MAGIC        = b'KTR1'
+KTRACE_RECORD_SIZE  = 0x40
+KTRACE_RING_HEADER  = 0x40
+
+DEFAULT_TICK_FREQUENCY = 19200000
+
+CORE_TRACK_PID = 0x10000
+
+TYPE_THREAD_SWITCH        =  1
+TYPE_SVC_ENTRY0           =  3
+TYPE_SVC_ENTRY1           =  4
+TYPE_SVC_EXIT0            =  5
+TYPE_SVC_EXIT1            =  6
+TYPE_INTERRUPT            =  7
+TYPE_SCHEDULE_UPDATE      = 11
+TYPE_CORE_MIGRATION       = 14
+TYPE_IPC_SEND             = 16
+TYPE_IPC_REPLY            = 17
+TYPE_PAGE_FAULT           = 18
+TYPE_SWAP_FAULT           = 19
+TYPE_SWAP_FAULT_RESOLVED  = 20
+
+class Record:
+    def __init__(self, data):
+        self.core_id, self.type, self.process_id, self.thread_id, self.tick = up('<BBHIQ', data[:0x10])
+        self.data = up('<6Q', data[0x10:KTRACE_RECORD_SIZE])
+
+def parse_records(data, start, count):
+    records = []
+    for i in range(count):
+        record = Record(data[start + i * KTRACE_RECORD_SIZE:start + (i + 1) * KTRACE_RECORD_SIZE])
+        if record.type != 0:
+            records.append(record)
+    return records
+
+def parse_buffer(data):
+    num_rings, ring_offset, ring_size = up('<III', data[4:0x10])
+    records = []
+    for i in range(num_rings):
+        ring = ring_offset + i * ring_size
+        head, count, core_id = up('<QII', data[ring:ring + 0x10])
+        # The record in slot head % count may be being overwritten, so take only the count - 1 before it.
+        first = max(0, head - (count - 1))
+        for index in range(first, head):
+            slot = ring + KTRACE_RING_HEADER + (index % count) * KTRACE_RECORD_SIZE
+            records.extend(parse_records(data, slot, 1))
+    return records
+
+def parse_input(data):
+    if data[:4] == KTRACE_MAGIC:
+        return parse_buffer(data)
+    assert len(data) % KTRACE_RECORD_SIZE == 0
+    return parse_records(data, 0, len(data) // KTRACE_RECORD_SIZE)
+
+def convert(records, tick_frequency):
+    records.sort(key=lambda r: r.tick)
+    events = []
+    to_us = lambda tick: tick * 1000000.0 / tick_frequency
+
+    def add(ph, name, pid, tid, tick, **kwargs):
+        event = { 'ph': ph, 'name': name, 'pid': pid, 'tid': tid, 'ts': to_us(tick) }
+        event.update(kwargs)
+        events.append(event)
+
+    # Name the tracks.
+    processes = set((r.process_id, r.thread_id) for r in records)
+    for process_id in sorted(set(p for p, t in processes)):
+        name = 'kernel' if process_id == 0xFFFF else 'process %d' % process_id
+        events.append({ 'ph': 'M', 'name': 'process_name', 'pid': process_id, 'args': { 'name': name } })
+    events.append({ 'ph': 'M', 'name': 'process_name', 'pid': CORE_TRACK_PID, 'args': { 'name': 'cores' } })
+    for core_id in sorted(set(r.core_id for r in records)):
+        events.append({ 'ph': 'M', 'name': 'thread_name', 'pid': CORE_TRACK_PID, 'tid': core_id, 'args': { 'name': 'core %d' % core_id } })
+
+    # Build the per-core scheduling slices from the thread switches, each lasting until the next switch on its core.
+    running = {}
+    for r in records:
+        if r.type != TYPE_THREAD_SWITCH:
+            continue
+        if r.core_id in running:
+            thread_id, tick = running[r.core_id]
+            add('X', 'thread %d' % thread_id, CORE_TRACK_PID, r.core_id, tick, dur=to_us(r.tick) - to_us(tick))
+        running[r.core_id] = (r.data[0], r.tick)
+
+    # Emit the per-thread events.
+    for r in records:
+        if r.type == TYPE_SVC_ENTRY0:
+            add('B', 'svc 0x%02X' % r.data[0], r.process_id, r.thread_id, r.tick, args={ 'x%d' % i: '0x%X' % v for i, v in enumerate(r.data[1:]) })
+        elif r.type == TYPE_SVC_EXIT0:
+            add('E', 'svc 0x%02X' % r.data[0], r.process_id, r.thread_id, r.tick, args={ 'x%d' % i: '0x%X' % v for i, v in enumerate(r.data[1:]) })
+        elif r.type == TYPE_SWAP_FAULT:
+            add('B', 'swap fault', r.process_id, r.thread_id, r.tick, args={ 'address': '0x%X' % r.data[0], 'sector_offset': '0x%X' % r.data[1] })
+        elif r.type == TYPE_SWAP_FAULT_RESOLVED:
+            add('E', 'swap fault', r.data[0] & 0xFFFF, r.data[1] & 0xFFFFFFFF, r.tick, args={ 'num_pages': r.data[3] })
+        elif r.type == TYPE_PAGE_FAULT:
+            add('i', 'page fault', r.process_id, r.thread_id, r.tick, s='t', args={ 'address': '0x%X' % r.data[0], 'esr': '0x%X' % r.data[1], 'pc': '0x%X' % r.data[2] })
+        elif r.type == TYPE_IPC_SEND:
+            add('i', 'ipc send', r.process_id, r.thread_id, r.tick, s='t', args={ 'session': '0x%X' % r.data[0], 'async': bool(r.data[1]) })
+        elif r.type == TYPE_IPC_REPLY:
+            add('i', 'ipc reply', r.process_id, r.thread_id, r.tick, s='t', args={ 'session': '0x%X' % r.data[0], 'client_thread': r.data[1], 'result': '0x%X' % r.data[2] })
+        elif r.type == TYPE_INTERRUPT:
+            add('i', 'interrupt %d' % r.data[0], CORE_TRACK_PID, r.core_id, r.tick, s='t')
+        elif r.type == TYPE_SCHEDULE_UPDATE:
+            add('i', 'schedule update', CORE_TRACK_PID, r.core_id, r.tick, s='t', args={ 'core': r.data[0], 'prev': r.data[1], 'next': r.data[2] })
+        elif r.type == TYPE_CORE_MIGRATION:
+            add('i', 'core migration', CORE_TRACK_PID, r.core_id, r.tick, s='t', args={ 'thread': r.data[0], 'prev': r.data[1], 'next': r.data[2], 'reason': r.data[3] })
+
+    return { 'traceEvents': events, 'displayTimeUnit': 'ns' }
+
+def main(argc, argv):
+    if argc not in (3, 4):
+        print('Usage: %s ktrace.bin trace.json [tick_frequency]' % argv[0])
+        return 1
+    tick_frequency = int(argv[3], 0) if argc == 4 else DEFAULT_TICK_FREQUENCY
+    with open(argv[1], 'rb') as f:
+        records = parse_input(f.read())
+    with open(argv[2], 'w') as f:
+        json.dump(convert(records, tick_frequency), f)
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main(len(sys.argv), sys.argv))